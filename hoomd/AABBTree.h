@@ -3,6 +3,7 @@
 
 #include "HOOMDMath.h"
 #include "VectorMath.h"
+#include <limits>
 #include <stack>
 #include <vector>
 
@@ -31,6 +32,24 @@ namespace detail
 const unsigned int NODE_CAPACITY = 16;        //!< Maximum number of particles in a node
 const unsigned int INVALID_NODE = 0xffffffff; //!< Invalid node index sentinel
 
+//! Number of children in a node of the wide BVH (one SIMD register of coordinates)
+#if defined(__AVX512F__) && HOOMD_LONGREAL_SIZE == 64
+const unsigned int WIDE_NODE_WIDTH = 8;
+#elif defined(__AVX__) && HOOMD_LONGREAL_SIZE == 32
+const unsigned int WIDE_NODE_WIDTH = 8;
+#else
+const unsigned int WIDE_NODE_WIDTH = 4;
+#endif
+
+//! Flag set in the child entries of wide nodes that refer to a leaf node of the binary tree
+const unsigned int WIDE_LEAF_FLAG = 0x80000000;
+
+//! Maximum number of entries in the traversal stack of the wide BVH
+const unsigned int WIDE_STACK_SIZE = 256;
+
+//! Default limit on the growth of the total node surface area before refit() asks for a rebuild
+const Scalar MAX_REFIT_AREA_RATIO = Scalar(1.2);
+
 #ifndef __HIPCC__
 
 //! Node in an AABBTree
@@ -59,6 +78,117 @@ struct PYBIND11_EXPORT AABBNode
     unsigned int num_particles;       //!< Number of particles contained in the node
     } __attribute__((aligned(32)));
 
+//! Node in the wide BVH of an AABBTree
+/*! A wide node stores the boxes of up to WIDE_NODE_WIDTH children in structure-of-arrays form, so
+    that one SIMD comparison per coordinate tests a query box against all children at once. Unused
+    child slots hold an inverted box that overlaps nothing.
+ */
+struct PYBIND11_EXPORT AABBWideNode
+    {
+    //! Default constructor
+    AABBWideNode()
+        {
+        for (unsigned int k = 0; k < WIDE_NODE_WIDTH; k++)
+            {
+            lower_x[k] = lower_y[k] = lower_z[k] = std::numeric_limits<Scalar>::max();
+            upper_x[k] = upper_y[k] = upper_z[k] = std::numeric_limits<Scalar>::lowest();
+            child[k] = INVALID_NODE;
+            }
+        }
+
+    //! Set the box of a child
+    void setChildAABB(unsigned int k, const AABB& aabb)
+        {
+        vec3<Scalar> lower = aabb.getLower();
+        vec3<Scalar> upper = aabb.getUpper();
+        lower_x[k] = lower.x;
+        lower_y[k] = lower.y;
+        lower_z[k] = lower.z;
+        upper_x[k] = upper.x;
+        upper_y[k] = upper.y;
+        upper_z[k] = upper.z;
+        }
+
+    //! Test which children overlap a query box
+    /*! \param lower Lower corner of the query box
+        \param upper Upper corner of the query box
+        \returns A mask with bit k set when child k overlaps the query box
+    */
+    inline unsigned int overlaps(const vec3<Scalar>& lower, const vec3<Scalar>& upper) const
+        {
+#if defined(__AVX512F__) && HOOMD_LONGREAL_SIZE == 64
+        __mmask8 r
+            = _mm512_cmp_pd_mask(_mm512_set1_pd(upper.x), _mm512_loadu_pd(lower_x), _CMP_LT_OQ);
+        r |= _mm512_cmp_pd_mask(_mm512_set1_pd(lower.x), _mm512_loadu_pd(upper_x), _CMP_GT_OQ);
+        r |= _mm512_cmp_pd_mask(_mm512_set1_pd(upper.y), _mm512_loadu_pd(lower_y), _CMP_LT_OQ);
+        r |= _mm512_cmp_pd_mask(_mm512_set1_pd(lower.y), _mm512_loadu_pd(upper_y), _CMP_GT_OQ);
+        r |= _mm512_cmp_pd_mask(_mm512_set1_pd(upper.z), _mm512_loadu_pd(lower_z), _CMP_LT_OQ);
+        r |= _mm512_cmp_pd_mask(_mm512_set1_pd(lower.z), _mm512_loadu_pd(upper_z), _CMP_GT_OQ);
+        return ~(unsigned int)r & 0xff;
+
+#elif defined(__AVX__) && HOOMD_LONGREAL_SIZE == 64
+        __m256d r = _mm256_cmp_pd(_mm256_set1_pd(upper.x), _mm256_loadu_pd(lower_x), _CMP_LT_OQ);
+        r = _mm256_or_pd(
+            r,
+            _mm256_cmp_pd(_mm256_set1_pd(lower.x), _mm256_loadu_pd(upper_x), _CMP_GT_OQ));
+        r = _mm256_or_pd(
+            r,
+            _mm256_cmp_pd(_mm256_set1_pd(upper.y), _mm256_loadu_pd(lower_y), _CMP_LT_OQ));
+        r = _mm256_or_pd(
+            r,
+            _mm256_cmp_pd(_mm256_set1_pd(lower.y), _mm256_loadu_pd(upper_y), _CMP_GT_OQ));
+        r = _mm256_or_pd(
+            r,
+            _mm256_cmp_pd(_mm256_set1_pd(upper.z), _mm256_loadu_pd(lower_z), _CMP_LT_OQ));
+        r = _mm256_or_pd(
+            r,
+            _mm256_cmp_pd(_mm256_set1_pd(lower.z), _mm256_loadu_pd(upper_z), _CMP_GT_OQ));
+        return ~(unsigned int)_mm256_movemask_pd(r) & 0xf;
+
+#elif defined(__AVX__) && HOOMD_LONGREAL_SIZE == 32
+        __m256 r = _mm256_cmp_ps(_mm256_set1_ps(upper.x), _mm256_loadu_ps(lower_x), _CMP_LT_OQ);
+        r = _mm256_or_ps(
+            r,
+            _mm256_cmp_ps(_mm256_set1_ps(lower.x), _mm256_loadu_ps(upper_x), _CMP_GT_OQ));
+        r = _mm256_or_ps(
+            r,
+            _mm256_cmp_ps(_mm256_set1_ps(upper.y), _mm256_loadu_ps(lower_y), _CMP_LT_OQ));
+        r = _mm256_or_ps(
+            r,
+            _mm256_cmp_ps(_mm256_set1_ps(lower.y), _mm256_loadu_ps(upper_y), _CMP_GT_OQ));
+        r = _mm256_or_ps(
+            r,
+            _mm256_cmp_ps(_mm256_set1_ps(upper.z), _mm256_loadu_ps(lower_z), _CMP_LT_OQ));
+        r = _mm256_or_ps(
+            r,
+            _mm256_cmp_ps(_mm256_set1_ps(lower.z), _mm256_loadu_ps(upper_z), _CMP_GT_OQ));
+        return ~(unsigned int)_mm256_movemask_ps(r) & 0xff;
+
+#else
+        unsigned int mask = 0;
+        for (unsigned int k = 0; k < WIDE_NODE_WIDTH; k++)
+            {
+            bool separated = upper.x < lower_x[k] || lower.x > upper_x[k] || upper.y < lower_y[k]
+                             || lower.y > upper_y[k] || upper.z < lower_z[k]
+                             || lower.z > upper_z[k];
+            mask |= (separated ? 0u : 1u) << k;
+            }
+        return mask;
+
+#endif
+        }
+
+    Scalar lower_x[WIDE_NODE_WIDTH]; //!< x coordinates of the lower corners of the children
+    Scalar lower_y[WIDE_NODE_WIDTH]; //!< y coordinates of the lower corners of the children
+    Scalar lower_z[WIDE_NODE_WIDTH]; //!< z coordinates of the lower corners of the children
+    Scalar upper_x[WIDE_NODE_WIDTH]; //!< x coordinates of the upper corners of the children
+    Scalar upper_y[WIDE_NODE_WIDTH]; //!< y coordinates of the upper corners of the children
+    Scalar upper_z[WIDE_NODE_WIDTH]; //!< z coordinates of the upper corners of the children
+
+    //! Index of the wide child node, or the binary leaf node index ORed with WIDE_LEAF_FLAG
+    unsigned int child[WIDE_NODE_WIDTH];
+    } __attribute__((aligned(64)));
+
 //! AABB Tree
 /*! An AABBTree stores a binary tree of AABBs. A leaf node stores up to NODE_CAPACITY particles by
    index. The bounding box of a leaf node surrounds all the bounding boxes of its contained
@@ -73,6 +203,10 @@ struct PYBIND11_EXPORT AABBNode
    periodically instead of continually updated.
     - buildTree : build an efficiently arranged tree given a complete set of AABBs, one for each
    particle.
+    - refit : recompute all node AABBs bottom up from a new set of AABBs for the same particles,
+   keeping the topology. Runs in O(N) time. The total surface area of the nodes measures the
+   quality of the tree: refit() reports when it has grown too much compared to the last build, and
+   the tree should then be rebuilt.
 
     **Implementation details**
 
@@ -86,12 +220,23 @@ struct PYBIND11_EXPORT AABBNode
     For performance, no recursive calls are used. Instead, each function is either turned into a
    loop if it uses tail recursion, or it uses a local stack to traverse the tree. The stack is
    cached between calls to limit the amount of dynamic memory allocation.
+
+    After the binary tree is built, buildTree() also collapses it into a wide BVH of AABBWideNode
+   nodes with up to WIDE_NODE_WIDTH children each. Every child of a wide node is either another
+   wide node or a leaf node of the binary tree, whose particles are read with getNodeParticle().
+   AABBTreeTraversal walks the wide BVH with a small stack and tests all children of a node with a
+   single SIMD overlap check. It visits the same leaves in the same order as the stackless
+   traversal of the binary tree with skip pointers, which remains available.
 */
 class PYBIND11_EXPORT AABBTree
     {
     public:
     //! Construct an AABBTree
-    AABBTree() : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0) { }
+    AABBTree()
+        : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0), m_build_area(0),
+          m_wide_depth(0)
+        {
+        }
 
     // Destructor
     ~AABBTree()
@@ -107,6 +252,10 @@ class PYBIND11_EXPORT AABBTree
         m_node_capacity = from.m_node_capacity;
         m_root = from.m_root;
         m_mapping = from.m_mapping;
+        m_build_area = from.m_build_area;
+        m_wide_nodes = from.m_wide_nodes;
+        m_wide_slot = from.m_wide_slot;
+        m_wide_depth = from.m_wide_depth;
 
         m_nodes = NULL;
 
@@ -131,6 +280,10 @@ class PYBIND11_EXPORT AABBTree
         m_node_capacity = from.m_node_capacity;
         m_root = from.m_root;
         m_mapping = from.m_mapping;
+        m_build_area = from.m_build_area;
+        m_wide_nodes = from.m_wide_nodes;
+        m_wide_slot = from.m_wide_slot;
+        m_wide_depth = from.m_wide_depth;
 
         if (m_nodes)
             free(m_nodes);
@@ -155,6 +308,11 @@ class PYBIND11_EXPORT AABBTree
     //! Build a tree smartly from a list of AABBs
     inline void buildTree(AABB* aabbs, unsigned int N);
 
+    //! Refit the tree to a new list of AABBs for the same particles
+    inline bool refit(const AABB* aabbs,
+                      unsigned int N,
+                      Scalar max_area_ratio = MAX_REFIT_AREA_RATIO);
+
     //! Find all particles that overlap with the query AABB
     inline unsigned int query(std::vector<unsigned int>& hits, const AABB& aabb) const;
 
@@ -235,12 +393,33 @@ class PYBIND11_EXPORT AABBTree
         return (m_nodes[node].particle_tags[j]);
         }
 
+    //! Get the number of nodes in the wide BVH
+    inline unsigned int getNumWideNodes() const
+        {
+        return (unsigned int)m_wide_nodes.size();
+        }
+
+    //! Get a node of the wide BVH
+    /*! \param node Index of the wide node. The root is node 0.
+     */
+    inline const AABBWideNode& getWideNode(unsigned int node) const
+        {
+        return m_wide_nodes[node];
+        }
+
+    //! Get the depth of the wide BVH
+    inline unsigned int getWideDepth() const
+        {
+        return m_wide_depth;
+        }
+
     private:
     AABBNode* m_nodes;                   //!< The nodes of the tree
     unsigned int m_num_nodes;            //!< Number of nodes
     unsigned int m_node_capacity;        //!< Capacity of the nodes array
     unsigned int m_root;                 //!< Index to the root node of the tree
     std::vector<unsigned int> m_mapping; //!< Reverse mapping to find node given a particle index
+    Scalar m_build_area;                 //!< Total surface area of the nodes after the last build
 
     /// Temporary index list used to build the AABB tree.
     std::vector<unsigned int> m_idx;
@@ -251,6 +430,10 @@ class PYBIND11_EXPORT AABBTree
     /// Temporary index list used when partitioning nodes.
     std::vector<AABB> m_aabb_right;
 
+    std::vector<AABBWideNode> m_wide_nodes; //!< Nodes of the wide BVH
+    std::vector<unsigned int> m_wide_slot;  //!< Wide node slot (node * width + k) of each node
+    unsigned int m_wide_depth;              //!< Number of levels in the wide BVH
+
     //! Initialize the tree to hold N particles
     inline void init(unsigned int N);
 
@@ -266,6 +449,113 @@ class PYBIND11_EXPORT AABBTree
 
     //! Update the skip value for a node
     inline unsigned int updateSkip(unsigned int idx);
+
+    //! Sum the surface areas of all nodes
+    inline Scalar totalArea() const;
+
+    //! Collapse the binary tree into the wide BVH
+    inline void buildWide();
+
+    //! Build a wide node from the binary subtree under a node
+    inline unsigned int buildWideNode(unsigned int idx, unsigned int depth);
+
+    //! Copy the AABB of a binary tree node into its slot in the wide BVH
+    inline void updateWideSlot(unsigned int idx)
+        {
+        unsigned int slot = m_wide_slot[idx];
+        if (slot != INVALID_NODE)
+            m_wide_nodes[slot / WIDE_NODE_WIDTH].setChildAABB(slot % WIDE_NODE_WIDTH,
+                                                              m_nodes[idx].aabb);
+        }
+    };
+
+//! Traversal of the wide BVH of an AABBTree
+/*! AABBTreeTraversal returns the leaf nodes of an AABBTree that overlap a query box, one at a time,
+    in the same order as the stackless traversal of the binary tree:
+
+    \code
+    AABBTreeTraversal traversal(tree, aabb);
+    for (unsigned int node = traversal.next(); node != INVALID_NODE; node = traversal.next())
+        {
+        for (unsigned int cur_p = 0; cur_p < tree.getNodeNumParticles(node); cur_p++)
+            ...
+        }
+    \endcode
+
+    Trees too deep for a stack of WIDE_STACK_SIZE entries are traversed with the skip pointers of
+    the binary tree instead.
+*/
+class AABBTreeTraversal
+    {
+    public:
+    //! Start a traversal
+    /*! \param tree Tree to traverse
+        \param aabb Query box
+    */
+    AABBTreeTraversal(const AABBTree& tree, const AABB& aabb)
+        : m_tree(tree), m_aabb(aabb), m_lower(aabb.getLower()), m_upper(aabb.getUpper()),
+          m_stack_size(0), m_node(0)
+        {
+        m_wide = tree.getWideDepth() * (WIDE_NODE_WIDTH - 1) + 1 <= WIDE_STACK_SIZE;
+        if (m_wide && tree.getNumWideNodes() > 0)
+            {
+            m_stack[0] = 0;
+            m_stack_size = 1;
+            }
+        }
+
+    //! Find the next leaf node that overlaps the query box
+    /*! \returns The index of the leaf node, or INVALID_NODE when the traversal is complete
+     */
+    __attribute__((always_inline)) inline unsigned int next()
+        {
+        if (m_wide)
+            {
+            while (m_stack_size > 0)
+                {
+                unsigned int entry = m_stack[--m_stack_size];
+                if (entry & WIDE_LEAF_FLAG)
+                    return entry & ~WIDE_LEAF_FLAG;
+
+                const AABBWideNode& node = m_tree.getWideNode(entry);
+                unsigned int mask = node.overlaps(m_lower, m_upper);
+
+                // push in reverse order so that the first child is visited first
+                for (unsigned int k = WIDE_NODE_WIDTH; k-- > 0;)
+                    {
+                    if (mask & (1u << k))
+                        m_stack[m_stack_size++] = node.child[k];
+                    }
+                }
+            return INVALID_NODE;
+            }
+
+        // stackless search of the binary tree
+        for (; m_node < m_tree.getNumNodes(); m_node++)
+            {
+            if (m_aabb.overlaps(m_tree.getNodeAABB(m_node)))
+                {
+                if (m_tree.isNodeLeaf(m_node))
+                    return m_node++;
+                }
+            else
+                {
+                // skip ahead
+                m_node += m_tree.getNodeSkip(m_node);
+                }
+            }
+        return INVALID_NODE;
+        }
+
+    private:
+    const AABBTree& m_tree;                //!< Tree to traverse
+    const AABB m_aabb;                     //!< Query box
+    const vec3<Scalar> m_lower;            //!< Lower corner of the query box
+    const vec3<Scalar> m_upper;            //!< Upper corner of the query box
+    bool m_wide;                           //!< True when traversing the wide BVH
+    unsigned int m_stack[WIDE_STACK_SIZE]; //!< Wide nodes and leaves left to visit
+    unsigned int m_stack_size;             //!< Number of entries on the stack
+    unsigned int m_node;                   //!< Current node of the binary traversal
     };
 
 /*! \param N Number of particles to allocate space for
@@ -287,42 +577,27 @@ inline void AABBTree::init(unsigned int N)
 
 /*! \param hits Output vector of positive hits.
     \param aabb The AABB to query
-    \returns the number of box overlap checks made during the recursion
+    \returns the number of leaf nodes that overlap *aabb*
 
     The *hits* vector is not cleared, elements are only added with push_back. query() traverses the
-   tree and finds all of the leaf nodes that intersect *aabb*. The index of each intersecting leaf
-   node is added to the hits vector.
+   tree and finds all of the leaf nodes that intersect *aabb*. The index of each particle in the
+   intersecting leaf nodes is added to the hits vector.
 */
 inline unsigned int AABBTree::query(std::vector<unsigned int>& hits, const AABB& aabb) const
     {
-    unsigned int box_overlap_counts = 0;
-
-    // avoid pointer indirection overhead of std::vector
-    AABBNode* nodes = &m_nodes[0];
+    unsigned int leaf_count = 0;
 
-    // stackless search
-    for (unsigned int current_node_idx = 0; current_node_idx < m_num_nodes; current_node_idx++)
+    AABBTreeTraversal traversal(*this, aabb);
+    for (unsigned int node_idx = traversal.next(); node_idx != INVALID_NODE;
+         node_idx = traversal.next())
         {
-        // cache current node pointer
-        const AABBNode& current_node = nodes[current_node_idx];
-
-        box_overlap_counts++;
-        if (aabb.overlaps(current_node.aabb))
-            {
-            if (current_node.left == INVALID_NODE)
-                {
-                for (unsigned int i = 0; i < current_node.num_particles; i++)
-                    hits.push_back(current_node.particles[i]);
-                }
-            }
-        else
-            {
-            // skip ahead
-            current_node_idx += current_node.skip;
-            }
+        leaf_count++;
+        const AABBNode& current_node = m_nodes[node_idx];
+        for (unsigned int i = 0; i < current_node.num_particles; i++)
+            hits.push_back(current_node.particles[i]);
         }
 
-    return box_overlap_counts;
+    return leaf_count;
     }
 
 /*! \param idx Particle index to update
@@ -343,6 +618,7 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
     if (!contains(m_nodes[node_idx].aabb, aabb))
         {
         m_nodes[node_idx].aabb = merge(m_nodes[node_idx].aabb, aabb);
+        updateWideSlot(node_idx);
 
         // update all parent node AABBs
         unsigned int current_node = m_nodes[node_idx].parent;
@@ -352,6 +628,7 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
             unsigned int right_idx = m_nodes[current_node].right;
 
             m_nodes[current_node].aabb = merge(m_nodes[left_idx].aabb, m_nodes[right_idx].aabb);
+            updateWideSlot(current_node);
             current_node = m_nodes[current_node].parent;
             }
         }
@@ -401,6 +678,59 @@ inline void AABBTree::buildTree(AABB* aabbs, unsigned int N)
 
     m_root = buildNode(aabbs, m_idx, 0, N, INVALID_NODE);
     updateSkip(m_root);
+    buildWide();
+    m_build_area = totalArea();
+    }
+
+/*! \param aabbs List of AABBs for each particle, indexed in the same way as in the last build
+    \param N Number of AABBs in the list
+    \param max_area_ratio Maximum ratio of the total node surface area to that of the last build
+    \returns true when the tree was refit and is still good to use, false when it must be rebuilt
+
+    refit() keeps the topology and particle assignment of the tree and recomputes the AABB of
+   every leaf from the AABBs of its particles, then the AABBs of the internal nodes bottom up. The
+   particle tags stored in the leaves are refreshed as well. Unlike update(), nodes may also shrink.
+
+    Every node is allocated after its parent in buildNode(), so visiting the nodes in reverse order
+   visits all children before their parents.
+
+    When \a N differs from the number of particles in the tree, refit() returns false without
+   modifying the tree. When the refit tree has a total node surface area larger than \a
+   max_area_ratio times that of the last build, queries are still correct but slower, and refit()
+   returns false to request a rebuild.
+
+    A refit tree finds the same set of overlapping particles as a tree built from the same AABBs,
+   but its leaves group the particles differently, so queries return them in a different order.
+   Results that are accumulated in query order, such as pair energies, match those of a rebuilt
+   tree only to within round off.
+*/
+inline bool AABBTree::refit(const AABB* aabbs, unsigned int N, Scalar max_area_ratio)
+    {
+    if (m_num_nodes == 0 || N != m_mapping.size())
+        return false;
+
+    for (unsigned int node_idx = m_num_nodes; node_idx-- > 0;)
+        {
+        AABBNode& node = m_nodes[node_idx];
+        if (node.left == INVALID_NODE)
+            {
+            AABB leaf_aabb = aabbs[node.particles[0]];
+            node.particle_tags[0] = aabbs[node.particles[0]].tag;
+            for (unsigned int i = 1; i < node.num_particles; i++)
+                {
+                leaf_aabb = merge(leaf_aabb, aabbs[node.particles[i]]);
+                node.particle_tags[i] = aabbs[node.particles[i]].tag;
+                }
+            node.aabb = leaf_aabb;
+            }
+        else
+            {
+            node.aabb = merge(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+            }
+        updateWideSlot(node_idx);
+        }
+
+    return totalArea() <= max_area_ratio * m_build_area;
     }
 
 /*! \param aabbs List of AABBs
@@ -565,6 +895,114 @@ inline unsigned int AABBTree::updateSkip(unsigned int idx)
         }
     }
 
+/*! buildWide() collapses the binary tree into the wide BVH. The root of the wide BVH is wide node
+    0. m_wide_slot maps every binary node that is a child of a wide node to its slot, so that
+    update() can keep the boxes of both trees in sync.
+*/
+inline void AABBTree::buildWide()
+    {
+    m_wide_nodes.clear();
+    m_wide_slot.assign(m_num_nodes, INVALID_NODE);
+    m_wide_depth = 0;
+
+    if (m_num_nodes == 0)
+        return;
+
+    buildWideNode(m_root, 1);
+    }
+
+/*! \param idx Index of the binary node at the root of the subtree
+    \param depth Level of the new wide node
+    \returns The index of the new wide node
+
+    The children of a wide node are found by repeatedly replacing the internal binary node with the
+    largest surface area by its two children until WIDE_NODE_WIDTH children are found or all are
+    leaves. Children stay in the order of the binary tree, so traversals of both trees visit leaves
+    in the same order.
+*/
+inline unsigned int AABBTree::buildWideNode(unsigned int idx, unsigned int depth)
+    {
+    unsigned int children[WIDE_NODE_WIDTH];
+    unsigned int n_children = 0;
+
+    if (isNodeLeaf(idx))
+        {
+        // only happens at the root when the whole tree is a single leaf
+        children[n_children++] = idx;
+        }
+    else
+        {
+        children[n_children++] = m_nodes[idx].left;
+        children[n_children++] = m_nodes[idx].right;
+        }
+
+    while (n_children < WIDE_NODE_WIDTH)
+        {
+        // find the internal child with the largest surface area
+        unsigned int open_k = INVALID_NODE;
+        Scalar max_area = Scalar(-1.0);
+        for (unsigned int k = 0; k < n_children; k++)
+            {
+            if (isNodeLeaf(children[k]))
+                continue;
+
+            vec3<Scalar> L = m_nodes[children[k]].aabb.getUpper()
+                             - m_nodes[children[k]].aabb.getLower();
+            Scalar area = L.x * L.y + L.y * L.z + L.z * L.x;
+            if (area > max_area)
+                {
+                max_area = area;
+                open_k = k;
+                }
+            }
+
+        if (open_k == INVALID_NODE)
+            break;
+
+        // replace it by its children in place
+        unsigned int node = children[open_k];
+        for (unsigned int k = n_children; k > open_k + 1; k--)
+            children[k] = children[k - 1];
+        children[open_k] = m_nodes[node].left;
+        children[open_k + 1] = m_nodes[node].right;
+        n_children++;
+        }
+
+    // note: recursive calls reallocate m_wide_nodes, so the node is filled in through its index
+    unsigned int wide_idx = (unsigned int)m_wide_nodes.size();
+    m_wide_nodes.push_back(AABBWideNode());
+    m_wide_depth = std::max(m_wide_depth, depth);
+
+    for (unsigned int k = 0; k < n_children; k++)
+        {
+        unsigned int child;
+        if (isNodeLeaf(children[k]))
+            child = children[k] | WIDE_LEAF_FLAG;
+        else
+            child = buildWideNode(children[k], depth + 1);
+
+        m_wide_nodes[wide_idx].child[k] = child;
+        m_wide_nodes[wide_idx].setChildAABB(k, m_nodes[children[k]].aabb);
+        m_wide_slot[children[k]] = wide_idx * WIDE_NODE_WIDTH + k;
+        }
+
+    return wide_idx;
+    }
+
+/*! \returns The sum of the surface areas of all nodes, which is proportional to the expected cost
+    of a query with a small box
+*/
+inline Scalar AABBTree::totalArea() const
+    {
+    Scalar area = 0;
+    for (unsigned int node_idx = 0; node_idx < m_num_nodes; node_idx++)
+        {
+        vec3<Scalar> L = m_nodes[node_idx].aabb.getUpper() - m_nodes[node_idx].aabb.getLower();
+        area += L.x * L.y + L.y * L.z + L.z * L.x;
+        }
+    return area;
+    }
+
 /*! Allocates a new node in the tree
  */
 inline unsigned int AABBTree::allocateNode()
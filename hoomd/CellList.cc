@@ -10,6 +10,11 @@
 
 #include <algorithm>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 
 namespace hoomd
@@ -19,7 +24,8 @@ namespace hoomd
 CellList::CellList(std::shared_ptr<SystemDefinition> sysdef)
     : Compute(sysdef), m_nominal_width(Scalar(1.0)), m_radius(1), m_compute_xyzf(true),
       m_compute_type_body(false), m_compute_orientation(false), m_compute_idx(false),
-      m_flag_charge(false), m_flag_type(false), m_sort_cell_list(false), m_compute_adj_list(true)
+      m_flag_charge(false), m_flag_type(false), m_sort_cell_list(false), m_compute_adj_list(true),
+      m_compact_layout(false), m_compact_size(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing CellList" << endl;
 
@@ -252,6 +258,24 @@ void CellList::initializeMemory()
     m_cell_size.swap(cell_size);
     TAG_ALLOCATION(m_cell_size);
 
+    // the compact layout stores only the binned particles, the padded layout Nmax per cell
+    size_t n_elements = m_cell_list_indexer.getNumElements();
+    if (m_compact_layout)
+        {
+        m_compact_size = std::max(m_pdata->getN() + m_pdata->getNGhosts(), 1u);
+        n_elements = m_compact_size;
+
+        GlobalArray<unsigned int> cell_start(m_cell_indexer.getNumElements(), m_exec_conf);
+        m_cell_start.swap(cell_start);
+        TAG_ALLOCATION(m_cell_start);
+        }
+    else
+        {
+        // array is not needed, discard it
+        GlobalArray<unsigned int> cell_start;
+        m_cell_start.swap(cell_start);
+        }
+
     if (m_compute_adj_list)
         {
         // if we have less than radius*2+1 cells in a direction, restrict to unique neighbors
@@ -289,7 +313,7 @@ void CellList::initializeMemory()
 
     if (m_compute_xyzf)
         {
-        GlobalArray<Scalar4> xyzf(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<Scalar4> xyzf(n_elements, m_exec_conf);
         m_xyzf.swap(xyzf);
         TAG_ALLOCATION(m_xyzf);
         }
@@ -301,7 +325,7 @@ void CellList::initializeMemory()
 
     if (m_compute_type_body)
         {
-        GlobalArray<uint2> type_body(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<uint2> type_body(n_elements, m_exec_conf);
         m_type_body.swap(type_body);
         TAG_ALLOCATION(m_type_body);
         }
@@ -314,7 +338,7 @@ void CellList::initializeMemory()
 
     if (m_compute_orientation)
         {
-        GlobalArray<Scalar4> orientation(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<Scalar4> orientation(n_elements, m_exec_conf);
         m_orientation.swap(orientation);
         TAG_ALLOCATION(m_orientation);
         }
@@ -327,7 +351,7 @@ void CellList::initializeMemory()
 
     if (m_compute_idx || m_sort_cell_list)
         {
-        GlobalArray<unsigned int> idx(m_cell_list_indexer.getNumElements(), m_exec_conf);
+        GlobalArray<unsigned int> idx(n_elements, m_exec_conf);
         m_idx.swap(idx);
         TAG_ALLOCATION(m_idx);
         }
@@ -414,24 +438,9 @@ void CellList::computeCellList()
                                      access_mode::read);
     const BoxDim& box = m_pdata->getBox();
 
-    // access the cell list data arrays
-    ArrayHandle<unsigned int> h_cell_size(m_cell_size,
-                                          access_location::host,
-                                          access_mode::overwrite);
-    ArrayHandle<Scalar4> h_xyzf(m_xyzf, access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar4> h_cell_orientation(m_orientation,
-                                            access_location::host,
-                                            access_mode::overwrite);
-    ArrayHandle<unsigned int> h_cell_idx(m_idx, access_location::host, access_mode::overwrite);
-    ArrayHandle<uint2> h_type_body(m_type_body, access_location::host, access_mode::overwrite);
-    uint3 conditions = make_uint3(0, 0, 0);
-
     // shorthand copies of the indexers
     Index3D ci = m_cell_indexer;
-    Index2D cli = m_cell_list_indexer;
-
-    // clear the bin sizes to 0
-    memset(h_cell_size.data, 0, sizeof(unsigned int) * m_cell_indexer.getNumElements());
+    const unsigned int n_cells = ci.getNumElements();
 
     Scalar3 ghost_width = getGhostWidth();
 
@@ -441,101 +450,239 @@ void CellList::computeCellList()
     // for each particle
     unsigned n_tot_particles = m_pdata->getN() + m_pdata->getNGhosts();
 
-    for (unsigned int n = 0; n < n_tot_particles; n++)
-        {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z))
-            {
-            conditions.y = n + 1;
-            continue;
-            }
+    // the particles are split into contiguous chunks, one per thread
+    unsigned int n_chunks = 1;
+#ifdef ENABLE_TBB
+    n_chunks = std::max(m_exec_conf->getNumThreads(), 1u);
+#endif
 
-        // find the bin each particle belongs in
-        Scalar3 f = box.makeFraction(p, ghost_width);
-        int ib = (int)(f.x * m_dim.x);
-        int jb = (int)(f.y * m_dim.y);
-        int kb = (int)(f.z * m_dim.z);
+    auto chunk_begin = [&](unsigned int chunk)
+    {
+        return (unsigned int)((uint64_t(n_tot_particles) * chunk) / n_chunks);
+    };
 
-        // check if the particle is inside the unit cell + ghost layer in all dimensions
-        if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001))
-            || (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001))
-            || (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)))
+    // call f(first, last) on ranges of [0, n), in parallel when there are multiple chunks
+    auto for_ranges = [&](unsigned int n, const auto& f)
+    {
+#ifdef ENABLE_TBB
+        if (n_chunks > 1)
             {
-            // if a ghost particle is out of bounds, silently ignore it
-            if (n < m_pdata->getN())
-                conditions.z = n + 1;
-            continue;
+            m_exec_conf->getTaskArena()->execute(
+                [&]
+                {
+                    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n),
+                                      [&](const tbb::blocked_range<unsigned int>& r)
+                                      { f(r.begin(), r.end()); });
+                });
+            return;
             }
+#endif
+        f(0, n);
+    };
+
+    // m_chunk_offset holds the per-chunk histograms followed by the total size of each cell
+    const unsigned int not_binned = 0xffffffff;
+    m_bin.resize(n_tot_particles);
+    m_chunk_offset.resize(size_t(n_chunks + 1) * n_cells);
+    unsigned int* cell_total = m_chunk_offset.data() + size_t(n_chunks) * n_cells;
+    std::vector<uint3> chunk_conditions(n_chunks, make_uint3(0, 0, 0));
+
+    // histogram: find the bin of each particle and count the particles of each chunk in each bin
+    for_ranges(
+        n_chunks,
+        [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int chunk = first; chunk < last; chunk++)
+                {
+                unsigned int* count = m_chunk_offset.data() + size_t(chunk) * n_cells;
+                std::fill(count, count + n_cells, 0u);
+                uint3 conditions = make_uint3(0, 0, 0);
+
+                for (unsigned int n = chunk_begin(chunk); n < chunk_begin(chunk + 1); n++)
+                    {
+                    m_bin[n] = not_binned;
+
+                    Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+                    if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z))
+                        {
+                        conditions.y = n + 1;
+                        continue;
+                        }
+
+                    // find the bin each particle belongs in
+                    Scalar3 f = box.makeFraction(p, ghost_width);
+                    int ib = (int)(f.x * m_dim.x);
+                    int jb = (int)(f.y * m_dim.y);
+                    int kb = (int)(f.z * m_dim.z);
+
+                    // check if the particle is inside the unit cell + ghost layer in all
+                    // dimensions
+                    if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001))
+                        || (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001))
+                        || (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)))
+                        {
+                        // if a ghost particle is out of bounds, silently ignore it
+                        if (n < m_pdata->getN())
+                            conditions.z = n + 1;
+                        continue;
+                        }
+
+                    // need to handle the case where the particle is exactly at the box hi
+                    if (ib == (int)m_dim.x && periodic.x)
+                        ib = 0;
+                    if (jb == (int)m_dim.y && periodic.y)
+                        jb = 0;
+                    if (kb == (int)m_dim.z && periodic.z)
+                        kb = 0;
+
+                    // sanity check
+                    assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z))
+                           || n >= m_pdata->getN());
+
+                    // all particles should be in a valid cell
+                    if (ib < 0 || ib >= (int)m_dim.x || jb < 0 || jb >= (int)m_dim.y || kb < 0
+                        || kb >= (int)m_dim.z)
+                        {
+                        // but ghost particles that are out of range should not produce an error
+                        if (n < m_pdata->getN())
+                            conditions.z = n + 1;
+                        continue;
+                        }
+
+                    // record its bin
+                    unsigned int bin = ci(ib, jb, kb);
+                    m_bin[n] = bin;
+                    count[bin]++;
+                    }
+
+                chunk_conditions[chunk] = conditions;
+                }
+        });
+
+    // exclusive scan over the chunks: the offset of each chunk's first particle in each cell
+    for_ranges(n_cells,
+               [&](unsigned int first, unsigned int last)
+               {
+                   for (unsigned int bin = first; bin < last; bin++)
+                       {
+                       unsigned int offset = 0;
+                       for (unsigned int chunk = 0; chunk < n_chunks; chunk++)
+                           {
+                           unsigned int& count = m_chunk_offset[size_t(chunk) * n_cells + bin];
+                           unsigned int chunk_count = count;
+                           count = offset;
+                           offset += chunk_count;
+                           }
+                       cell_total[bin] = offset;
+                       }
+               });
+
+    // the last particle flagged in serial order is the largest index flagged in any chunk
+    uint3 conditions = make_uint3(0, 0, 0);
+    for (unsigned int chunk = 0; chunk < n_chunks; chunk++)
+        {
+        conditions.y = max(conditions.y, chunk_conditions[chunk].y);
+        conditions.z = max(conditions.z, chunk_conditions[chunk].z);
+        }
 
-        // need to handle the case where the particle is exactly at the box hi
-        if (ib == (int)m_dim.x && periodic.x)
-            ib = 0;
-        if (jb == (int)m_dim.y && periodic.y)
-            jb = 0;
-        if (kb == (int)m_dim.z && periodic.z)
-            kb = 0;
-
-        // sanity check
-        assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z))
-               || n >= m_pdata->getN());
-
-        // record its bin
-        unsigned int bin = ci(ib, jb, kb);
+    unsigned int max_cell_size = 0;
+    unsigned int n_binned = 0;
+    for (unsigned int bin = 0; bin < n_cells; bin++)
+        {
+        max_cell_size = max(max_cell_size, cell_total[bin]);
+        n_binned += cell_total[bin];
+        }
 
-        // all particles should be in a valid cell
-        if (ib < 0 || ib >= (int)m_dim.x || jb < 0 || jb >= (int)m_dim.y || kb < 0
-            || kb >= (int)m_dim.z)
-            {
-            // but ghost particles that are out of range should not produce an error
-            if (n < m_pdata->getN())
-                conditions.z = n + 1;
-            continue;
-            }
+    // the cell sizes are known before the scatter, so grow the storage now instead of overflowing
+    if (m_compact_layout ? n_binned > m_compact_size : max_cell_size > m_Nmax)
+        {
+        m_Nmax = max(m_Nmax, max_cell_size);
+        initializeMemory();
+        }
 
-        // setup the flag value to store
-        Scalar flag;
-        if (m_flag_charge)
-            flag = h_charge.data[n];
-        else if (m_flag_type)
-            flag = h_pos.data[n].w;
-        else
-            flag = __int_as_scalar(n);
+    // access the cell list data arrays
+    ArrayHandle<unsigned int> h_cell_size(m_cell_size,
+                                          access_location::host,
+                                          access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cell_start(m_cell_start,
+                                           access_location::host,
+                                           access_mode::overwrite);
+    ArrayHandle<Scalar4> h_xyzf(m_xyzf, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_cell_orientation(m_orientation,
+                                            access_location::host,
+                                            access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cell_idx(m_idx, access_location::host, access_mode::overwrite);
+    ArrayHandle<uint2> h_type_body(m_type_body, access_location::host, access_mode::overwrite);
 
-        // store the bin entries
-        unsigned int offset = h_cell_size.data[bin];
+    std::copy(cell_total, cell_total + n_cells, h_cell_size.data);
 
-        if (offset < m_Nmax)
+    if (m_compact_layout)
+        {
+        unsigned int start = 0;
+        for (unsigned int bin = 0; bin < n_cells; bin++)
             {
-            if (m_compute_xyzf)
-                {
-                h_xyzf.data[cli(offset, bin)]
-                    = make_scalar4(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z, flag);
-                }
-
-            if (m_compute_type_body)
-                {
-                h_type_body.data[cli(offset, bin)]
-                    = make_uint2(__scalar_as_int(h_pos.data[n].w), h_body.data[n]);
-                }
+            h_cell_start.data[bin] = start;
+            start += cell_total[bin];
+            }
+        }
 
-            if (m_compute_orientation)
-                {
-                h_cell_orientation.data[cli(offset, bin)] = h_orientation.data[n];
-                }
+    Index2D cli = m_cell_list_indexer;
 
-            if (m_compute_idx)
+    // scatter: each chunk writes its particles in index order to its own range of each cell
+    for_ranges(
+        n_chunks,
+        [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int chunk = first; chunk < last; chunk++)
                 {
-                h_cell_idx.data[cli(offset, bin)] = n;
+                unsigned int* offset = m_chunk_offset.data() + size_t(chunk) * n_cells;
+
+                for (unsigned int n = chunk_begin(chunk); n < chunk_begin(chunk + 1); n++)
+                    {
+                    unsigned int bin = m_bin[n];
+                    if (bin == not_binned)
+                        continue;
+
+                    // setup the flag value to store
+                    Scalar flag;
+                    if (m_flag_charge)
+                        flag = h_charge.data[n];
+                    else if (m_flag_type)
+                        flag = h_pos.data[n].w;
+                    else
+                        flag = __int_as_scalar(n);
+
+                    // store the bin entries
+                    unsigned int k = m_compact_layout ? h_cell_start.data[bin] + offset[bin]
+                                                      : cli(offset[bin], bin);
+                    offset[bin]++;
+
+                    if (m_compute_xyzf)
+                        {
+                        h_xyzf.data[k] = make_scalar4(h_pos.data[n].x,
+                                                      h_pos.data[n].y,
+                                                      h_pos.data[n].z,
+                                                      flag);
+                        }
+
+                    if (m_compute_type_body)
+                        {
+                        h_type_body.data[k]
+                            = make_uint2(__scalar_as_int(h_pos.data[n].w), h_body.data[n]);
+                        }
+
+                    if (m_compute_orientation)
+                        {
+                        h_cell_orientation.data[k] = h_orientation.data[n];
+                        }
+
+                    if (m_compute_idx)
+                        {
+                        h_cell_idx.data[k] = n;
+                        }
+                    }
                 }
-            }
-        else
-            {
-            conditions.x = max((unsigned int)conditions.x, offset + 1);
-            }
-
-        // increment the cell occupancy counter
-        h_cell_size.data[bin]++;
-        }
+        });
 
         {
         // write out conditions
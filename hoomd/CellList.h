@@ -9,6 +9,7 @@
 
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 #include <memory>
+#include <vector>
 
 /*! \file CellList.h
     \brief Declares the CellList class
@@ -75,6 +76,15 @@ namespace hoomd
      - <code>cell_adj[cell_adj_indexer(offset,cidx)]</code> is the cell index for neighboring cell
    \c offset to \c cidx. \c offset can vary from 0 to (radius*2+1)^3-1 (typically 26 with radius 1)
 
+    <b>Compact layout:</b>
+    The padded Ncells x Nmax layout reserves Nmax slots in every cell, which wastes memory in
+   inhomogeneous systems. When setCompactLayout(true) is called, \c xyzf, \c type_body,
+   \c orientation, and \c idx are instead stored contiguously cell after cell (CSR). The
+   \c cell_start array returned by getCellStartArray() holds the exclusive prefix sum of
+   \c cell_size and <code>xyzf[cell_start[cidx] + offset]</code> is the data stored for particle
+   \c offset in cell \c cidx. getCellListIndexer() is not available in the compact layout. Only the
+   CPU implementation supports the compact layout.
+
     <b>Parameters:</b>
      - \c width - minimum width of a cell in any x,y,z direction
      - \c radius - integer radius of cells to generate in \c cell_adj (1,2,3,4,...)
@@ -95,6 +105,11 @@ namespace hoomd
     Condition flags are to be set during the computeCellList() call and will be checked by compute()
    which will then take the appropriate action. If possible, flags 1 and 2 should be set to the
    index of the particle causing the flag plus 1.
+
+    The CPU implementation bins the particles with a counting sort (histogram, exclusive scan,
+   scatter) that uses multiple threads when available. It knows the occupancy of every cell before
+   it writes the cell list, so it grows Nmax as needed and never sets the overflow condition. The
+   particles in each cell are in index order regardless of the number of threads.
 */
 class PYBIND11_EXPORT CellList : public Compute
     {
@@ -215,6 +230,19 @@ class PYBIND11_EXPORT CellList : public Compute
         m_params_changed = true;
         }
 
+    //! Specify if the cell list is to be stored in the compact (CSR) layout
+    virtual void setCompactLayout(bool compact_layout)
+        {
+        m_compact_layout = compact_layout;
+        m_params_changed = true;
+        }
+
+    //! Get whether the cell list is stored in the compact (CSR) layout
+    bool getCompactLayout() const
+        {
+        return m_compact_layout;
+        }
+
     //! Request a multi-GPU cell list
     virtual void setPerDevice(bool per_device)
         {
@@ -253,6 +281,10 @@ class PYBIND11_EXPORT CellList : public Compute
     //! Get an indexer to index into the cell lists
     const Index2D& getCellListIndexer() const
         {
+        if (m_compact_layout)
+            {
+            throw std::runtime_error("Cell list indexer not available in the compact layout");
+            }
         return m_cell_list_indexer;
         }
 
@@ -296,6 +328,16 @@ class PYBIND11_EXPORT CellList : public Compute
         throw std::runtime_error("Per-device cell size array not available in base class.\n");
         }
 
+    //! Get the index of the first element of each cell in the compact layout
+    const GlobalArray<unsigned int>& getCellStartArray() const
+        {
+        if (!m_compact_layout)
+            {
+            throw std::runtime_error("Cell start array only available in the compact layout");
+            }
+        return m_cell_start;
+        }
+
     //! Get the adjacency list
     const GlobalArray<unsigned int>& getCellAdjArray() const
         {
@@ -380,16 +422,23 @@ class PYBIND11_EXPORT CellList : public Compute
     Scalar3 m_ghost_width;       //!< Width of ghost layer sized for (on one side only)
 
     // values computed by compute()
-    GlobalArray<unsigned int> m_cell_size; //!< Number of members in each cell
-    GlobalArray<unsigned int> m_cell_adj;  //!< Cell adjacency list
-    GlobalArray<Scalar4> m_xyzf;           //!< Cell list with position and flags
-    GlobalArray<uint2> m_type_body;        //!< Cell list with type,body
-    GlobalArray<Scalar4> m_orientation;    //!< Cell list with orientation
-    GlobalArray<unsigned int> m_idx;       //!< Cell list with index
+    GlobalArray<unsigned int> m_cell_size;  //!< Number of members in each cell
+    GlobalArray<unsigned int> m_cell_start; //!< First element of each cell (compact layout only)
+    GlobalArray<unsigned int> m_cell_adj;   //!< Cell adjacency list
+    GlobalArray<Scalar4> m_xyzf;            //!< Cell list with position and flags
+    GlobalArray<uint2> m_type_body;         //!< Cell list with type,body
+    GlobalArray<Scalar4> m_orientation;     //!< Cell list with orientation
+    GlobalArray<unsigned int> m_idx;        //!< Cell list with index
     GlobalArray<uint3> m_conditions; //!< Condition flags set during the computeCellList() call
 
-    bool m_sort_cell_list;   //!< If true, sort cell list
-    bool m_compute_adj_list; //!< If true, compute the cell adjacency lists
+    bool m_sort_cell_list;       //!< If true, sort cell list
+    bool m_compute_adj_list;     //!< If true, compute the cell adjacency lists
+    bool m_compact_layout;       //!< If true, store the cell list in the compact (CSR) layout
+    unsigned int m_compact_size; //!< Number of elements allocated in the compact layout
+
+    // scratch space for the counting sort
+    std::vector<unsigned int> m_bin;          //!< Cell of each particle
+    std::vector<unsigned int> m_chunk_offset; //!< Offset of each chunk in each cell
 
 #ifdef ENABLE_MPI
     /// The system's communicator.
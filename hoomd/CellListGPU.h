@@ -42,6 +42,13 @@ class PYBIND11_EXPORT CellListGPU : public CellList
         m_params_changed = true;
         }
 
+    //! The GPU cell list is always stored in the padded layout
+    virtual void setCompactLayout(bool compact_layout)
+        {
+        if (compact_layout)
+            throw std::runtime_error("The compact cell list layout is not supported on the GPU.");
+        }
+
     //! Return true if we maintain a cell list per device
     virtual bool getPerDevice() const
         {
@@ -0,0 +1,92 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+/*! \file DeterministicReduce.h
+    \brief Declares the deterministicReduce helper used by threaded computes
+*/
+
+#ifndef __DETERMINISTIC_REDUCE_H__
+#define __DETERMINISTIC_REDUCE_H__
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ExecutionConfiguration.h"
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+#endif
+
+namespace hoomd
+    {
+namespace detail
+    {
+//! Number of items summed serially in each leaf of deterministicReduce
+const unsigned int deterministic_reduce_grain_size = 1024;
+
+//! Serial implementation of deterministicReduce on the range [first, last)
+template<class T, class Func, class Join>
+T deterministicReduceRange(unsigned int first,
+                           unsigned int last,
+                           const T& identity,
+                           const Func& f,
+                           const Join& join)
+    {
+    if (last - first > deterministic_reduce_grain_size)
+        {
+        unsigned int middle = first + (last - first) / 2;
+        return join(deterministicReduceRange(first, middle, identity, f, join),
+                    deterministicReduceRange(middle, last, identity, f, join));
+        }
+
+    return join(identity, f(first, last));
+    }
+
+//! Reduce over [0, n) with a result that does not depend on the number of threads
+/*! \param exec_conf Execution configuration that provides the task arena
+    \param n Number of items to reduce
+    \param identity Identity element of \a join
+    \param f Callable f(first, last) that returns the partial result of the items [first, last)
+    \param join Callable join(a, b) that combines two partial results
+
+    The range is split recursively in half until the pieces hold at most
+    deterministic_reduce_grain_size items. \a f sums each piece in a cache-sized block and the
+    partial results are combined pairwise up the tree. The tree depends only on \a n, so the result
+    is bitwise identical with any number of threads (and between the threaded and serial code
+    paths). Pairwise combination also bounds the round-off error to O(log n) instead of the O(n)
+    of a plain running sum.
+*/
+template<class T, class Func, class Join>
+T deterministicReduce(const ExecutionConfiguration& exec_conf,
+                      unsigned int n,
+                      const T& identity,
+                      const Func& f,
+                      const Join& join)
+    {
+#ifdef ENABLE_TBB
+    if (exec_conf.getNumThreads() > 1)
+        {
+        T result = identity;
+        exec_conf.getTaskArena()->execute(
+            [&]
+            {
+                result = tbb::parallel_deterministic_reduce(
+                    tbb::blocked_range<unsigned int>(0, n, deterministic_reduce_grain_size),
+                    identity,
+                    [&](const tbb::blocked_range<unsigned int>& r, T partial) -> T
+                    { return join(partial, f(r.begin(), r.end())); },
+                    join);
+            });
+        return result;
+        }
+#endif
+
+    return deterministicReduceRange(0, n, identity, f, join);
+    }
+
+    } // end namespace detail
+    } // end namespace hoomd
+
+#endif // __DETERMINISTIC_REDUCE_H__
@@ -0,0 +1,118 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+/*! \file ForEachRange.h
+    \brief Declares the forEachRange and forEachChunk helpers used by threaded CPU loops
+*/
+
+#ifndef __FOR_EACH_RANGE_H__
+#define __FOR_EACH_RANGE_H__
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ExecutionConfiguration.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+namespace hoomd
+    {
+namespace detail
+    {
+//! Call f(first, last) on contiguous ranges that cover [0, n)
+/*! \param exec_conf Execution configuration that provides the task arena
+    \param n Number of items
+    \param f Callable f(first, last) that processes the items [first, last)
+
+    The ranges are processed in parallel in the task arena of \a exec_conf when more than one CPU
+    thread is requested, so \a f may only write to the items (particles, cells, ...) indexed by its
+    own range. With one thread, \a f is called once on the whole range.
+*/
+template<class Func>
+void forEachRange(const ExecutionConfiguration& exec_conf, unsigned int n, const Func& f)
+    {
+#ifdef ENABLE_TBB
+    if (exec_conf.getNumThreads() > 1)
+        {
+        exec_conf.getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n),
+                                  [&](const tbb::blocked_range<unsigned int>& r)
+                                  { f(r.begin(), r.end()); });
+            });
+        return;
+        }
+#endif
+
+    f(0, n);
+    }
+
+//! Get the number of chunks to split \a n items into for forEachChunk()
+/*! Use one chunk when threading is disabled. Otherwise give each thread a few chunks of at least
+    4096 items to balance the load.
+
+    The number of chunks depends on the number of threads. Use forEachChunk() only for work whose
+    result does not depend on the chunk boundaries, such as counting and compaction.
+*/
+inline unsigned int getNumChunks(const ExecutionConfiguration& exec_conf, unsigned int n)
+    {
+    unsigned int n_chunks = 1;
+#ifdef ENABLE_TBB
+    if (exec_conf.getNumThreads() > 1)
+        n_chunks = std::max(1u, std::min(4 * exec_conf.getNumThreads(), n / 4096));
+#endif
+    return n_chunks;
+    }
+
+//! Call f(c, first, last) on each of \a n_chunks contiguous chunks of the range [0, \a n)
+/*! \param exec_conf Execution configuration that provides the task arena
+    \param n_chunks Number of chunks
+    \param n Number of items
+    \param f Callable f(c, first, last) that processes the items [first, last) of chunk c
+
+    Unlike forEachRange(), the chunk boundaries depend only on \a n and \a n_chunks, so callers
+    can keep per-chunk results (such as counts for a prefix sum) and pass over the same chunks
+    again. The chunks are processed in parallel in the task arena when \a n_chunks > 1.
+*/
+template<class Func>
+void forEachChunk(const ExecutionConfiguration& exec_conf,
+                  unsigned int n_chunks,
+                  unsigned int n,
+                  const Func& f)
+    {
+    auto chunk_begin = [n, n_chunks](unsigned int c)
+    { return (unsigned int)((uint64_t(n) * c) / n_chunks); };
+
+#ifdef ENABLE_TBB
+    if (n_chunks > 1)
+        {
+        exec_conf.getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_chunks, 1),
+                                  [&](const tbb::blocked_range<unsigned int>& r)
+                                  {
+                                      for (unsigned int c = r.begin(); c != r.end(); ++c)
+                                          f(c, chunk_begin(c), chunk_begin(c + 1));
+                                  });
+            });
+        return;
+        }
+#endif
+
+    for (unsigned int c = 0; c < n_chunks; ++c)
+        f(c, chunk_begin(c), chunk_begin(c + 1));
+    }
+
+    } // end namespace detail
+    } // end namespace hoomd
+
+#endif // __FOR_EACH_RANGE_H__
@@ -0,0 +1,239 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+/*! \file ForceScatterBuffers.h
+    \brief Declares the ForceScatterBuffers class used by threaded force computes
+*/
+
+#ifndef __FORCE_SCATTER_BUFFERS_H__
+#define __FORCE_SCATTER_BUFFERS_H__
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "HOOMDMath.h"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+namespace hoomd
+    {
+namespace detail
+    {
+//! Per-chunk force, torque, and virial buffers for threaded force computes
+/*! Threaded force computes that write to particles other than the one a thread owns (Newton's
+    third law, bonded groups, three-body terms, ...) cannot write directly to the output arrays.
+    ForceScatterBuffers splits the work into a fixed number of contiguous chunks and gives each
+    chunk a private copy of the per-particle force, torque, and virial arrays. Work on chunk \a c
+    writes only to the slices returned by getForce(c), getTorque(c), and getVirial(c).
+
+    reduce() sums the slices in chunk order. The work assignment and the summation order depend only
+    on the number of chunks, so the result is reproducible regardless of how the threads are
+    scheduled.
+
+    The force computes use one chunk per CPU thread. The floating point sums are therefore
+    associated differently for each thread count: results are bitwise reproducible for a given
+    number of threads, but differ from the serial code path (and between thread counts) by round
+    off. The slices take n_chunks * N force, torque, and virial entries, so the memory use grows
+    linearly with the number of threads. The serial code path does not use the buffers.
+
+    The buffers are kept between calls so that repeated force evaluations do not reallocate.
+*/
+class ForceScatterBuffers
+    {
+    public:
+    //! Set the chunk layout and allocate the buffers if needed
+    /*! \param n_chunks Number of independent chunks of work
+        \param N Number of particles in each slice
+        \param torque Set to true to allocate torque slices
+        \param virial Set to true to allocate virial slices
+    */
+    void resize(unsigned int n_chunks, unsigned int N, bool torque, bool virial)
+        {
+        m_n_chunks = n_chunks;
+        m_N = N;
+        m_has_torque = torque;
+        m_has_virial = virial;
+
+        size_t n_elem = size_t(n_chunks) * N;
+        if (m_force.size() < n_elem)
+            m_force.resize(n_elem);
+        if (m_has_torque && m_torque.size() < n_elem)
+            m_torque.resize(n_elem);
+        if (m_has_virial && m_virial.size() < 6 * n_elem)
+            m_virial.resize(6 * n_elem);
+        }
+
+    //! Get the number of chunks
+    unsigned int getNumChunks() const
+        {
+        return m_n_chunks;
+        }
+
+    //! Get the first particle index assigned to chunk \a c
+    /*! Chunks partition [0, \a n) into contiguous ranges of nearly equal size.
+     */
+    static unsigned int getChunkBegin(unsigned int c, unsigned int n_chunks, unsigned int n)
+        {
+        return (unsigned int)((uint64_t(n) * c) / n_chunks);
+        }
+
+    //! Zero the slices of chunk \a c
+    /*! Call this from the thread that works on chunk \a c so that the pages are first touched
+        (and placed) by that thread.
+    */
+    void zeroChunk(unsigned int c)
+        {
+        std::fill(getForce(c), getForce(c) + m_N, make_scalar4(0, 0, 0, 0));
+        if (m_has_torque)
+            std::fill(getTorque(c), getTorque(c) + m_N, make_scalar4(0, 0, 0, 0));
+        if (m_has_virial)
+            std::fill(getVirial(c), getVirial(c) + 6 * size_t(m_N), Scalar(0.0));
+        }
+
+    //! Get the force slice of chunk \a c
+    Scalar4* getForce(unsigned int c)
+        {
+        return m_force.data() + size_t(c) * m_N;
+        }
+
+    //! Get the torque slice of chunk \a c
+    Scalar4* getTorque(unsigned int c)
+        {
+        return m_has_torque ? m_torque.data() + size_t(c) * m_N : nullptr;
+        }
+
+    //! Get the virial slice of chunk \a c
+    /*! The virial slice is a 6 x N array with pitch getVirialPitch().
+     */
+    Scalar* getVirial(unsigned int c)
+        {
+        return m_has_virial ? m_virial.data() + 6 * size_t(c) * m_N : nullptr;
+        }
+
+    //! Get the pitch of the virial slices
+    size_t getVirialPitch() const
+        {
+        return m_N;
+        }
+
+    //! Add the chunk-ordered sum of the slices for particles [first, last) to the output arrays
+    /*! \param first First particle index to reduce
+        \param last One past the last particle index to reduce
+        \param force Output force array
+        \param torque Output torque array (ignored when torque slices are not allocated)
+        \param virial Output virial array (ignored when virial slices are not allocated)
+        \param virial_pitch Pitch of the output virial array
+    */
+    void reduceRange(unsigned int first,
+                     unsigned int last,
+                     Scalar4* force,
+                     Scalar4* torque,
+                     Scalar* virial,
+                     size_t virial_pitch)
+        {
+        for (unsigned int i = first; i < last; ++i)
+            {
+            Scalar4 f = make_scalar4(0, 0, 0, 0);
+            Scalar4 t = make_scalar4(0, 0, 0, 0);
+            Scalar v[6] = {0, 0, 0, 0, 0, 0};
+
+            for (unsigned int c = 0; c < m_n_chunks; ++c)
+                {
+                const Scalar4 fc = getForce(c)[i];
+                f.x += fc.x;
+                f.y += fc.y;
+                f.z += fc.z;
+                f.w += fc.w;
+
+                if (m_has_torque)
+                    {
+                    const Scalar4 tc = getTorque(c)[i];
+                    t.x += tc.x;
+                    t.y += tc.y;
+                    t.z += tc.z;
+                    }
+
+                if (m_has_virial)
+                    {
+                    const Scalar* vc = getVirial(c);
+                    for (unsigned int k = 0; k < 6; ++k)
+                        v[k] += vc[k * m_N + i];
+                    }
+                }
+
+            force[i].x += f.x;
+            force[i].y += f.y;
+            force[i].z += f.z;
+            force[i].w += f.w;
+
+            if (m_has_torque && torque)
+                {
+                torque[i].x += t.x;
+                torque[i].y += t.y;
+                torque[i].z += t.z;
+                }
+
+            if (m_has_virial && virial)
+                {
+                for (unsigned int k = 0; k < 6; ++k)
+                    virial[k * virial_pitch + i] += v[k];
+                }
+            }
+        }
+
+#ifdef ENABLE_TBB
+    //! Process all chunks in parallel
+    /*! \param n_items Number of work items to split into getNumChunks() contiguous chunks
+        \param f Callable f(c, first, last) that processes the work items [first, last) of chunk c
+
+        Each chunk is zeroed before \a f is called on it. Call from inside the task arena.
+    */
+    template<class Func> void parallelForChunks(unsigned int n_items, const Func& f)
+        {
+        const unsigned int n_chunks = m_n_chunks;
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_chunks, 1),
+                          [&](const tbb::blocked_range<unsigned int>& r)
+                          {
+                              for (unsigned int c = r.begin(); c != r.end(); ++c)
+                                  {
+                                  zeroChunk(c);
+                                  f(c,
+                                    getChunkBegin(c, n_chunks, n_items),
+                                    getChunkBegin(c + 1, n_chunks, n_items));
+                                  }
+                          });
+        }
+
+    //! Add the chunk-ordered sum of all slices to the output arrays in parallel
+    /*! Call from inside the task arena.
+     */
+    void reduce(Scalar4* force, Scalar4* torque, Scalar* virial, size_t virial_pitch)
+        {
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned int>(0, m_N),
+            [&](const tbb::blocked_range<unsigned int>& r)
+            { reduceRange(r.begin(), r.end(), force, torque, virial, virial_pitch); });
+        }
+#endif
+
+    private:
+    unsigned int m_n_chunks = 0;  //!< Number of chunks
+    unsigned int m_N = 0;         //!< Number of particles in each slice
+    bool m_has_torque = false;    //!< True when torque slices are in use
+    bool m_has_virial = false;    //!< True when virial slices are in use
+    std::vector<Scalar4> m_force;  //!< Force slices
+    std::vector<Scalar4> m_torque; //!< Torque slices
+    std::vector<Scalar> m_virial;  //!< Virial slices
+    };
+
+    } // end namespace detail
+    } // end namespace hoomd
+
+#endif // __FORCE_SCATTER_BUFFERS_H__
@@ -11,6 +11,11 @@
 #include "Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 #include <pybind11/stl_bind.h>
 PYBIND11_MAKE_OPAQUE(std::vector<std::shared_ptr<hoomd::ForceConstraint>>);
 PYBIND11_MAKE_OPAQUE(std::vector<std::shared_ptr<hoomd::ForceCompute>>);
@@ -171,80 +176,28 @@ void Integrator::computeNetForce(uint64_t timestep)
         }
 
     Scalar external_virial[6];
-    Scalar external_energy;
-        {
-        // access the net force and virial arrays
-        const GlobalArray<Scalar4>& net_force = m_pdata->getNetForce();
-        const GlobalArray<Scalar>& net_virial = m_pdata->getNetVirial();
-        const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
-        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_net_torque(net_torque,
-                                          access_location::host,
-                                          access_mode::overwrite);
-
-        // start by zeroing the net force and virial arrays
-        memset((void*)h_net_force.data, 0, sizeof(Scalar4) * net_force.getNumElements());
-        memset((void*)h_net_virial.data, 0, sizeof(Scalar) * net_virial.getNumElements());
-        memset((void*)h_net_torque.data, 0, sizeof(Scalar4) * net_torque.getNumElements());
-
-        for (unsigned int i = 0; i < 6; ++i)
-            external_virial[i] = Scalar(0.0);
+    for (unsigned int i = 0; i < 6; ++i)
+        external_virial[i] = Scalar(0.0);
 
-        external_energy = Scalar(0.0);
+    Scalar external_energy = Scalar(0.0);
 
-        // now, add up the net forces
-        // also sum up forces for ghosts, in case they are needed by the communicator
-        unsigned int nparticles = m_pdata->getN() + m_pdata->getNGhosts();
-        size_t net_virial_pitch = net_virial.getPitch();
-
-        assert(nparticles <= net_force.getNumElements());
-        assert(6 * nparticles <= net_virial.getNumElements());
-        assert(nparticles <= net_torque.getNumElements());
+    // now, add up the net forces
+    std::vector<ForceCompute*> forces;
+    for (const auto& force : m_forces)
+        {
+        forces.push_back(force.get());
 
-        for (const auto& force : m_forces)
+        for (unsigned int k = 0; k < 6; k++)
             {
-            const GlobalArray<Scalar4>& h_force_array = force->getForceArray();
-            const GlobalArray<Scalar>& h_virial_array = force->getVirialArray();
-            const GlobalArray<Scalar4>& h_torque_array = force->getTorqueArray();
-
-            assert(nparticles <= h_force_array.getNumElements());
-            assert(6 * nparticles <= h_virial_array.getNumElements());
-            assert(nparticles <= h_torque_array.getNumElements());
-
-            ArrayHandle<Scalar4> h_force(h_force_array, access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_virial(h_virial_array, access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_torque(h_torque_array, access_location::host, access_mode::read);
-
-            size_t virial_pitch = h_virial_array.getPitch();
-            for (unsigned int j = 0; j < nparticles; j++)
-                {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
-
-                for (unsigned int k = 0; k < 6; k++)
-                    {
-                    h_net_virial.data[k * net_virial_pitch + j]
-                        += h_virial.data[k * virial_pitch + j];
-                    }
-                }
-
-            for (unsigned int k = 0; k < 6; k++)
-                {
-                external_virial[k] += force->getExternalVirial(k);
-                }
-
-            external_energy += force->getExternalEnergy();
+            external_virial[k] += force->getExternalVirial(k);
             }
+
+        external_energy += force->getExternalEnergy();
         }
 
+    // also sum up forces for ghosts, in case they are needed by the communicator
+    sumNetForce(forces, m_pdata->getN() + m_pdata->getNGhosts(), true);
+
     for (unsigned int k = 0; k < 6; k++)
         {
         m_pdata->setExternalVirial(k, external_virial[k]);
@@ -271,69 +224,155 @@ void Integrator::computeNetForce(uint64_t timestep)
         constraint_force->compute(timestep);
         }
 
+    // now, add up the net forces
+    std::vector<ForceCompute*> constraint_forces;
+    for (const auto& constraint_force : m_constraint_forces)
         {
-        // access the net force and virial arrays
-        const GlobalArray<Scalar4>& net_force = m_pdata->getNetForce();
-        const GlobalArray<Scalar>& net_virial = m_pdata->getNetVirial();
-        const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
-        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_net_torque(net_torque,
-                                          access_location::host,
-                                          access_mode::readwrite);
-        size_t net_virial_pitch = net_virial.getPitch();
+        constraint_forces.push_back(constraint_force.get());
 
-        // now, add up the net forces
-        unsigned int nparticles = m_pdata->getN();
-        assert(nparticles <= net_force.getNumElements());
-        assert(6 * nparticles <= net_virial.getNumElements());
-        for (const auto& constraint_force : m_constraint_forces)
+        for (unsigned int k = 0; k < 6; k++)
             {
-            const GlobalArray<Scalar4>& h_force_array = constraint_force->getForceArray();
-            const GlobalArray<Scalar>& h_virial_array = constraint_force->getVirialArray();
-            const GlobalArray<Scalar4>& h_torque_array = constraint_force->getTorqueArray();
-            ArrayHandle<Scalar4> h_force(h_force_array, access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_virial(h_virial_array, access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_torque(h_torque_array, access_location::host, access_mode::read);
-            size_t virial_pitch = h_virial_array.getPitch();
-
-            assert(nparticles <= h_force_array.getNumElements());
-            assert(6 * nparticles <= h_virial_array.getNumElements());
-            assert(nparticles <= h_torque_array.getNumElements());
-
-            for (unsigned int j = 0; j < nparticles; j++)
-                {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
+            external_virial[k] += constraint_force->getExternalVirial(k);
+            }
 
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
+        external_energy += constraint_force->getExternalEnergy();
+        }
 
-                for (unsigned int k = 0; k < 6; k++)
-                    {
-                    h_net_virial.data[k * net_virial_pitch + j]
-                        += h_virial.data[k * virial_pitch + j];
-                    }
-                }
+    sumNetForce(constraint_forces, m_pdata->getN(), false);
+
+    for (unsigned int k = 0; k < 6; k++)
+        {
+        m_pdata->setExternalVirial(k, external_virial[k]);
+        }
+
+    m_pdata->setExternalEnergy(external_energy);
+    }
+
+/** @param forces Force computes to sum
+    @param nparticles Number of particles to sum
+    @param zero Set to true to overwrite the net arrays, false to add to them
+
+    The net force, torque, and virial of each particle are accumulated in registers over all force
+    computes and written once, instead of sweeping the net arrays once per force compute. Each
+    particle sums the forces in the order given, so the result does not depend on the number of
+    threads.
+*/
+void Integrator::sumNetForce(const std::vector<ForceCompute*>& forces,
+                             unsigned int nparticles,
+                             bool zero)
+    {
+    // access the net force and virial arrays
+    const GlobalArray<Scalar4>& net_force = m_pdata->getNetForce();
+    const GlobalArray<Scalar>& net_virial = m_pdata->getNetVirial();
+    const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
+    access_mode::Enum mode = zero ? access_mode::overwrite : access_mode::readwrite;
+    ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, mode);
+    ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, mode);
+    ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, mode);
+    size_t net_virial_pitch = net_virial.getPitch();
+
+    assert(nparticles <= net_force.getNumElements());
+    assert(6 * nparticles <= net_virial.getNumElements());
+    assert(nparticles <= net_torque.getNumElements());
+
+    // access all of the force arrays up front so that they are streamed together
+    const size_t n_forces = forces.size();
+    std::vector<std::unique_ptr<ArrayHandle<Scalar4>>> force_handles(n_forces);
+    std::vector<std::unique_ptr<ArrayHandle<Scalar>>> virial_handles(n_forces);
+    std::vector<std::unique_ptr<ArrayHandle<Scalar4>>> torque_handles(n_forces);
+    std::vector<const Scalar4*> h_force(n_forces);
+    std::vector<const Scalar*> h_virial(n_forces);
+    std::vector<const Scalar4*> h_torque(n_forces);
+    std::vector<size_t> virial_pitch(n_forces);
+
+    for (size_t i = 0; i < n_forces; i++)
+        {
+        const GlobalArray<Scalar4>& h_force_array = forces[i]->getForceArray();
+        const GlobalArray<Scalar>& h_virial_array = forces[i]->getVirialArray();
+        const GlobalArray<Scalar4>& h_torque_array = forces[i]->getTorqueArray();
+
+        assert(nparticles <= h_force_array.getNumElements());
+        assert(6 * nparticles <= h_virial_array.getNumElements());
+        assert(nparticles <= h_torque_array.getNumElements());
+
+        force_handles[i].reset(
+            new ArrayHandle<Scalar4>(h_force_array, access_location::host, access_mode::read));
+        virial_handles[i].reset(
+            new ArrayHandle<Scalar>(h_virial_array, access_location::host, access_mode::read));
+        torque_handles[i].reset(
+            new ArrayHandle<Scalar4>(h_torque_array, access_location::host, access_mode::read));
+        h_force[i] = force_handles[i]->data;
+        h_virial[i] = virial_handles[i]->data;
+        h_torque[i] = torque_handles[i]->data;
+        virial_pitch[i] = h_virial_array.getPitch();
+        }
+
+    auto sum_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int j = first; j < last; j++)
+            {
+            Scalar4 f = zero ? make_scalar4(0, 0, 0, 0) : h_net_force.data[j];
+            Scalar4 t = zero ? make_scalar4(0, 0, 0, 0) : h_net_torque.data[j];
+            Scalar v[6];
             for (unsigned int k = 0; k < 6; k++)
+                v[k] = zero ? Scalar(0.0) : h_net_virial.data[k * net_virial_pitch + j];
+
+            for (size_t i = 0; i < n_forces; i++)
                 {
-                external_virial[k] += constraint_force->getExternalVirial(k);
+                const Scalar4 force = h_force[i][j];
+                f.x += force.x;
+                f.y += force.y;
+                f.z += force.z;
+                f.w += force.w;
+
+                const Scalar4 torque = h_torque[i][j];
+                t.x += torque.x;
+                t.y += torque.y;
+                t.z += torque.z;
+                t.w += torque.w;
+
+                for (unsigned int k = 0; k < 6; k++)
+                    v[k] += h_virial[i][k * virial_pitch[i] + j];
                 }
 
-            external_energy += constraint_force->getExternalEnergy();
+            h_net_force.data[j] = f;
+            h_net_torque.data[j] = t;
+            for (unsigned int k = 0; k < 6; k++)
+                h_net_virial.data[k * net_virial_pitch + j] = v[k];
             }
-        }
+    };
 
-    for (unsigned int k = 0; k < 6; k++)
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
         {
-        m_pdata->setExternalVirial(k, external_virial[k]);
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+                                  [&](const tbb::blocked_range<unsigned int>& r)
+                                  { sum_range(r.begin(), r.end()); });
+            });
+        }
+    else
+#endif
+        {
+        sum_range(0, nparticles);
         }
 
-    m_pdata->setExternalEnergy(external_energy);
+    if (zero)
+        {
+        // zero the remainder of the net arrays
+        std::fill(h_net_force.data + nparticles,
+                  h_net_force.data + net_force.getNumElements(),
+                  make_scalar4(0, 0, 0, 0));
+        std::fill(h_net_torque.data + nparticles,
+                  h_net_torque.data + net_torque.getNumElements(),
+                  make_scalar4(0, 0, 0, 0));
+        for (unsigned int k = 0; k < 6; k++)
+            std::fill(h_net_virial.data + k * net_virial_pitch + nparticles,
+                      h_net_virial.data + (k + 1) * net_virial_pitch,
+                      Scalar(0.0));
+        }
     }
 
 #ifdef ENABLE_HIP
@@ -195,6 +195,10 @@ class PYBIND11_EXPORT Integrator : public Updater
     /// helper function to compute net force/virial
     virtual void computeNetForce(uint64_t timestep);
 
+    /// helper function to add the force, torque, and virial arrays of several forces to the net
+    /// arrays in a single pass
+    void sumNetForce(const std::vector<ForceCompute*>& forces, unsigned int nparticles, bool zero);
+
 #ifdef ENABLE_HIP
     /// helper function to compute net force/virial on the GPU
     virtual void computeNetForceGPU(uint64_t timestep);
@@ -3,6 +3,7 @@
 
 #include "ParticleGroup.h"
 
+#include "hoomd/ForEachRange.h"
 #include "hoomd/RNGIdentifiers.h"
 #include "hoomd/RandomNumbers.h"
 
@@ -527,6 +528,13 @@ void ParticleGroup::buildTagHash()
         }
     }
 
+namespace detail
+    {
+//! Rebuild the index list from the member tags when the group has fewer members than this fraction
+//! of the local particles
+const unsigned int rebuild_from_tags_ratio = 16;
+    } // end namespace detail
+
 /*! \pre m_member_tags has been filled out, listing all particle tags in the group
     \pre memory has been allocated for m_is_member and m_member_idx
     \post m_is_member is updated so that it reflects the current indices of the particles in the
@@ -550,27 +558,86 @@ void ParticleGroup::rebuildIndexList()
         ArrayHandle<unsigned int> h_is_member(m_is_member,
                                               access_location::host,
                                               access_mode::readwrite);
-        ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag,
-                                                  access_location::host,
-                                                  access_mode::read);
-        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(),
-                                        access_location::host,
-                                        access_mode::read);
         ArrayHandle<unsigned int> h_member_idx(m_member_idx,
                                                access_location::host,
                                                access_mode::readwrite);
         unsigned int nparticles = m_pdata->getN();
+        unsigned int n_member_tags = (unsigned int)m_member_tags.getNumElements();
         unsigned int cur_member = 0;
-        for (unsigned int idx = 0; idx < nparticles; idx++)
+
+        if (uint64_t(n_member_tags) * detail::rebuild_from_tags_ratio < nparticles)
+            {
+            // the group is small compared to the local particles, so look up the current index of
+            // each member tag instead of scanning every particle
+            ArrayHandle<unsigned int> h_member_tags(m_member_tags,
+                                                    access_location::host,
+                                                    access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(),
+                                             access_location::host,
+                                             access_mode::read);
+            memset(h_is_member.data, 0, sizeof(unsigned int) * nparticles);
+            for (unsigned int member = 0; member < n_member_tags; member++)
+                {
+                unsigned int idx = h_rtag.data[h_member_tags.data[member]];
+                if (idx < nparticles)
+                    {
+                    h_is_member.data[idx] = 1;
+                    h_member_idx.data[cur_member] = idx;
+                    cur_member++;
+                    }
+                }
+
+            // the index list is in index order
+            std::sort(h_member_idx.data, h_member_idx.data + cur_member);
+            }
+        else
             {
-            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-            unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
-            h_is_member.data[idx] = is_member;
-            if (is_member)
+            ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag,
+                                                      access_location::host,
+                                                      access_mode::read);
+            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(),
+                                            access_location::host,
+                                            access_mode::read);
+
+            // flag the members and count them in contiguous chunks of particles, then write each
+            // chunk's members starting at the number of members in the chunks before it
+            const unsigned int n_chunks = detail::getNumChunks(*m_exec_conf, nparticles);
+            std::vector<unsigned int> chunk_offset(n_chunks + 1, 0);
+
+            auto count_chunk = [&](unsigned int chunk, unsigned int first, unsigned int last)
+                {
+                unsigned int count = 0;
+                for (unsigned int idx = first; idx < last; idx++)
+                    {
+                    assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+                    unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
+                    h_is_member.data[idx] = is_member;
+                    count += is_member;
+                    }
+                chunk_offset[chunk + 1] = count;
+                };
+            detail::forEachChunk(*m_exec_conf, n_chunks, nparticles, count_chunk);
+
+            for (unsigned int chunk = 0; chunk < n_chunks; chunk++)
                 {
-                h_member_idx.data[cur_member] = idx;
-                cur_member++;
+                chunk_offset[chunk + 1] += chunk_offset[chunk];
                 }
+
+            auto compact_chunk = [&](unsigned int chunk, unsigned int first, unsigned int last)
+                {
+                unsigned int member = chunk_offset[chunk];
+                for (unsigned int idx = first; idx < last; idx++)
+                    {
+                    if (h_is_member.data[idx])
+                        {
+                        h_member_idx.data[member] = idx;
+                        member++;
+                        }
+                    }
+                };
+            detail::forEachChunk(*m_exec_conf, n_chunks, nparticles, compact_chunk);
+
+            cur_member = chunk_offset[n_chunks];
             }
 
         m_num_local_members = cur_member;
@@ -27,9 +27,14 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <cassert>
 #include <limits>
 #include <type_traits>
 
+#if !defined(__HIPCC__) && !defined(__CUDACC_RTC__) && (defined(__AVX2__) || defined(__AVX512F__))
+#include <immintrin.h>
+#endif
+
 namespace r123
     {
 using std::make_signed;
@@ -269,6 +274,241 @@ DEVICE inline r123::Philox4x32::ctr_type RandomGenerator::operator()()
     return u;
     }
 
+#if !defined(__HIPCC__) && !defined(__CUDACC_RTC__)
+//! Number of RNG streams that RandomGeneratorBatch generates together
+/*! One batch fills a vector register of 32-bit integers of the widest instruction set enabled at
+    compile time (e.g. with -march=native). Without AVX2, emulating the vector code is slower than
+    RandomGenerator, so builds without AVX2 use a width of 1 and generate all values on demand.
+*/
+#if defined(__AVX512F__)
+const unsigned int rng_batch_width = 16;
+#elif defined(__AVX2__)
+const unsigned int rng_batch_width = 8;
+#else
+const unsigned int rng_batch_width = 1;
+#endif
+
+namespace detail
+    {
+#if defined(__AVX2__) || defined(__AVX512F__)
+//! Perform one Philox4x32 round on rng_batch_width counters
+/*! \param ctr Counters, one word per row and one stream per column. Replaced by the outputs.
+    \param key Round key
+
+    The vector instruction sets have no 32 x 32 -> 64 bit multiply on all lanes, so the even and odd
+    lanes are multiplied separately and the high and low halves blended back together. Compilers do
+    not find this on their own.
+*/
+inline void philox4x32_round_batch(uint32_t ctr[4][rng_batch_width],
+                                   const r123::Philox4x32::key_type& key)
+    {
+#if defined(__AVX512F__)
+    const __m512i m0 = _mm512_set1_epi32(PHILOX_M4x32_0);
+    const __m512i m1 = _mm512_set1_epi32(PHILOX_M4x32_1);
+    __m512i c0 = _mm512_loadu_si512(ctr[0]);
+    __m512i c2 = _mm512_loadu_si512(ctr[2]);
+
+    __m512i even_0 = _mm512_mul_epu32(c0, m0);
+    __m512i odd_0 = _mm512_mul_epu32(_mm512_srli_epi64(c0, 32), m0);
+    __m512i even_1 = _mm512_mul_epu32(c2, m1);
+    __m512i odd_1 = _mm512_mul_epu32(_mm512_srli_epi64(c2, 32), m1);
+
+    __m512i hi_0 = _mm512_mask_blend_epi32(0xaaaa, _mm512_srli_epi64(even_0, 32), odd_0);
+    __m512i lo_0 = _mm512_mask_blend_epi32(0xaaaa, even_0, _mm512_slli_epi64(odd_0, 32));
+    __m512i hi_1 = _mm512_mask_blend_epi32(0xaaaa, _mm512_srli_epi64(even_1, 32), odd_1);
+    __m512i lo_1 = _mm512_mask_blend_epi32(0xaaaa, even_1, _mm512_slli_epi64(odd_1, 32));
+
+    __m512i c1 = _mm512_loadu_si512(ctr[1]);
+    __m512i c3 = _mm512_loadu_si512(ctr[3]);
+    __m512i key_0 = _mm512_set1_epi32(key.v[0]);
+    __m512i key_1 = _mm512_set1_epi32(key.v[1]);
+    _mm512_storeu_si512(ctr[0], _mm512_xor_si512(_mm512_xor_si512(hi_1, c1), key_0));
+    _mm512_storeu_si512(ctr[1], lo_1);
+    _mm512_storeu_si512(ctr[2], _mm512_xor_si512(_mm512_xor_si512(hi_0, c3), key_1));
+    _mm512_storeu_si512(ctr[3], lo_0);
+
+#else
+    const __m256i m0 = _mm256_set1_epi32(PHILOX_M4x32_0);
+    const __m256i m1 = _mm256_set1_epi32(PHILOX_M4x32_1);
+    __m256i c0 = _mm256_loadu_si256((const __m256i*)ctr[0]);
+    __m256i c1 = _mm256_loadu_si256((const __m256i*)ctr[1]);
+    __m256i c2 = _mm256_loadu_si256((const __m256i*)ctr[2]);
+    __m256i c3 = _mm256_loadu_si256((const __m256i*)ctr[3]);
+
+    __m256i even_0 = _mm256_mul_epu32(c0, m0);
+    __m256i odd_0 = _mm256_mul_epu32(_mm256_srli_epi64(c0, 32), m0);
+    __m256i even_1 = _mm256_mul_epu32(c2, m1);
+    __m256i odd_1 = _mm256_mul_epu32(_mm256_srli_epi64(c2, 32), m1);
+
+    __m256i hi_0 = _mm256_blend_epi32(_mm256_srli_epi64(even_0, 32), odd_0, 0xaa);
+    __m256i lo_0 = _mm256_blend_epi32(even_0, _mm256_slli_epi64(odd_0, 32), 0xaa);
+    __m256i hi_1 = _mm256_blend_epi32(_mm256_srli_epi64(even_1, 32), odd_1, 0xaa);
+    __m256i lo_1 = _mm256_blend_epi32(even_1, _mm256_slli_epi64(odd_1, 32), 0xaa);
+
+    __m256i key_0 = _mm256_set1_epi32(key.v[0]);
+    __m256i key_1 = _mm256_set1_epi32(key.v[1]);
+    _mm256_storeu_si256((__m256i*)ctr[0], _mm256_xor_si256(_mm256_xor_si256(hi_1, c1), key_0));
+    _mm256_storeu_si256((__m256i*)ctr[1], lo_1);
+    _mm256_storeu_si256((__m256i*)ctr[2], _mm256_xor_si256(_mm256_xor_si256(hi_0, c3), key_1));
+    _mm256_storeu_si256((__m256i*)ctr[3], lo_0);
+#endif
+    }
+
+//! Evaluate Philox4x32-10 for several batches of rng_batch_width counters with the same key
+/*! \param ctr Counters of each batch. Replaced by the outputs.
+    \param n Number of batches
+    \param key Key shared by all streams
+
+    Performs the same rounds as r123::Philox4x32 on all lanes. The rounds of the batches are
+    interleaved because each round depends on the result of the previous one: one batch alone
+    leaves the vector units idle while waiting on the multiplies.
+*/
+inline void
+philox4x32_batch(uint32_t ctr[][4][rng_batch_width], unsigned int n, r123::Philox4x32::key_type key)
+    {
+    for (unsigned int round = 0; round < 10; round++)
+        {
+        if (round > 0)
+            {
+            key.v[0] += PHILOX_W32_0;
+            key.v[1] += PHILOX_W32_1;
+            }
+
+        for (unsigned int i = 0; i < n; i++)
+            philox4x32_round_batch(ctr[i], key);
+        }
+    }
+#endif
+    } // namespace detail
+
+//! Random number generator for one stream of a RandomGeneratorBatch
+/*! BatchedRandomGenerator returns the values that RandomGenerator would return for the same Seed
+    and Counter. The first values come from the batch, any further values are generated one at a
+    time. Use it with all the distributions in this file in place of RandomGenerator.
+*/
+class BatchedRandomGenerator
+    {
+    public:
+    /** Construct a generator for one stream of a batch
+
+        @param values First word of the first pregenerated value of the stream.
+        @param n_values Number of pregenerated values.
+        @param key RNG key.
+        @param counter Initial value of the RNG counter.
+    */
+    BatchedRandomGenerator(const uint32_t* values,
+                           unsigned int n_values,
+                           const r123::Philox4x32::key_type& key,
+                           const r123::Philox4x32::ctr_type& counter)
+        : m_values(values), m_n_values(n_values), m_index(0), m_key(key), m_ctr(counter)
+        {
+        }
+
+    /// Generate uniformly distributed 128-bit values
+    inline r123::Philox4x32::ctr_type operator()()
+        {
+        r123::Philox4x32::ctr_type u;
+        if (m_index < m_n_values)
+            {
+            const uint32_t* value = m_values + m_index * 4 * rng_batch_width;
+            u = {{value[0],
+                  value[rng_batch_width],
+                  value[2 * rng_batch_width],
+                  value[3 * rng_batch_width]}};
+            }
+        else
+            {
+            r123::Philox4x32 rng;
+            u = rng(m_ctr, m_key);
+            }
+        m_index++;
+        m_ctr.v[0] += 1;
+        return u;
+        }
+
+    private:
+    const uint32_t* m_values;         //!< Pregenerated values, rng_batch_width words apart
+    unsigned int m_n_values;          //!< Number of pregenerated values
+    unsigned int m_index;             //!< Number of values returned so far
+    r123::Philox4x32::key_type m_key; //!< RNG key
+    r123::Philox4x32::ctr_type m_ctr; //!< RNG counter
+    };
+
+//! Philox random number generator for a batch of streams
+/*! Code that creates one RandomGenerator per particle (or pair) from the same Seed draws a few
+    values from each of many streams. RandomGeneratorBatch generates the first values of
+    rng_batch_width such streams together, with the Philox rounds for all streams in SIMD
+    registers. getGenerator() then returns a generator for each stream that produces bitwise the
+    same values as RandomGenerator:
+
+    \code
+    RandomGeneratorBatch<3> rng_batch;
+    rng_batch.generate(seed, n, [&](unsigned int k) { return Counter(tag[first + k]); });
+    for (unsigned int k = 0; k < n; k++)
+        {
+        BatchedRandomGenerator rng = rng_batch.getGenerator(k);
+        Scalar x = UniformDistribution<Scalar>()(rng);
+        }
+    \endcode
+
+    \tparam max_values Maximum number of values generated for each stream.
+*/
+template<unsigned int max_values> class RandomGeneratorBatch
+    {
+    public:
+    /** Generate the first values of a batch of streams
+
+        @param seed RNG seed shared by all streams.
+        @param n Number of streams in the batch, at most rng_batch_width.
+        @param counter Function that returns the initial Counter of stream k.
+        @param n_values Number of values to generate for each stream, at most max_values.
+    */
+    template<class CounterFunction>
+    inline void generate(const Seed& seed,
+                         unsigned int n,
+                         CounterFunction counter,
+                         unsigned int n_values = max_values)
+        {
+        assert(n <= rng_batch_width);
+        assert(n_values <= max_values);
+
+        m_key = seed.getKey();
+        for (unsigned int k = 0; k < rng_batch_width; k++)
+            {
+            // fill the unused lanes with the last stream
+            const Counter ctr = counter(k < n ? k : n - 1);
+            for (unsigned int w = 0; w < 4; w++)
+                m_ctr[w][k] = ctr.getCounter().v[w];
+            }
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+        m_n_values = n_values;
+        for (unsigned int i = 0; i < n_values; i++)
+            for (unsigned int w = 0; w < 4; w++)
+                for (unsigned int k = 0; k < rng_batch_width; k++)
+                    m_values[i][w][k] = m_ctr[w][k] + (w == 0 ? i : 0);
+
+        detail::philox4x32_batch(m_values, n_values, m_key);
+#else
+        m_n_values = 0;
+#endif
+        }
+
+    /// Get a random number generator for stream k
+    inline BatchedRandomGenerator getGenerator(unsigned int k) const
+        {
+        r123::Philox4x32::ctr_type ctr = {{m_ctr[0][k], m_ctr[1][k], m_ctr[2][k], m_ctr[3][k]}};
+        return BatchedRandomGenerator(&m_values[0][0][k], m_n_values, m_key, ctr);
+        }
+
+    private:
+    r123::Philox4x32::key_type m_key;                  //!< RNG key
+    uint32_t m_ctr[4][rng_batch_width];                //!< Initial counter of each stream
+    uint32_t m_values[max_values][4][rng_batch_width]; //!< Values of each stream
+    unsigned int m_n_values = 0;                       //!< Number of values in m_values
+    };
+#endif
+
 namespace detail
     {
 //! Generate a uniform random uint32_t
@@ -7,6 +7,7 @@
 
 #include "SFCPackTuner.h"
 #include "Communicator.h"
+#include "ForEachRange.h"
 
 #include <algorithm>
 #include <fstream>
@@ -31,6 +32,8 @@ SFCPackTuner::SFCPackTuner(std::shared_ptr<SystemDefinition> sysdef,
 
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_sort_order_alt.resize(m_pdata->getMaxN());
+    m_particle_bins_alt.resize(m_pdata->getMaxN());
 
     // set the default grid
     // Grid dimension must always be a power of 2 and determines the memory usage for
@@ -61,6 +64,8 @@ void SFCPackTuner::reallocate()
     {
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_sort_order_alt.resize(m_pdata->getMaxN());
+    m_particle_bins_alt.resize(m_pdata->getMaxN());
     }
 
 /*! Destructor
@@ -120,168 +125,262 @@ void SFCPackTuner::applySortOrder()
     {
     assert(m_pdata);
     assert(m_sort_order.size() >= m_pdata->getN());
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(),
-                               access_location::host,
-                               access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(),
-                               access_location::host,
-                               access_mode::readwrite);
-    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(),
-                                 access_location::host,
-                                 access_mode::readwrite);
-    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(),
-                                 access_location::host,
-                                 access_mode::readwrite);
-    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(),
-                                   access_location::host,
-                                   access_mode::readwrite);
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(),
-                                     access_location::host,
-                                     access_mode::readwrite);
-    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(),
-                                  access_location::host,
-                                  access_mode::readwrite);
-    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(),
-                                   access_location::host,
-                                   access_mode::readwrite);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(),
-                                    access_location::host,
-                                    access_mode::readwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(),
-                                     access_location::host,
-                                     access_mode::readwrite);
-
-    // construct a temporary holding array for the sorted data
-    Scalar4* scal4_tmp = new Scalar4[m_pdata->getN()];
-
-    // sort positions and types
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_pos.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_pos.data[i] = scal4_tmp[i];
-
-    // sort velocities and mass
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_vel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_vel.data[i] = scal4_tmp[i];
-
-    Scalar3* scal3_tmp = new Scalar3[m_pdata->getN()];
-    // sort accelerations
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_accel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_accel.data[i] = scal3_tmp[i];
-
-    Scalar* scal_tmp = new Scalar[m_pdata->getN()];
-    // sort charge
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_charge.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_charge.data[i] = scal_tmp[i];
-
-    // sort diameter
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_diameter.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_diameter.data[i] = scal_tmp[i];
-
-    // sort angular momentum
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_angmom.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_angmom.data[i] = scal4_tmp[i];
-
-    // sort moment of inertia
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_inertia.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+
+    // nothing to do when the particles are already in order
+    if (m_sort_order_is_identity)
         {
-        h_inertia.data[i] = scal3_tmp[i];
+        return;
         }
 
-        // in case anyone access it from frame to frame, sort the net virial
         {
+        // access alternate arrays to write to
+        ArrayHandle<Scalar4> h_pos_alt(m_pdata->getAltPositions(),
+                                       access_location::host,
+                                       access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel_alt(m_pdata->getAltVelocities(),
+                                       access_location::host,
+                                       access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel_alt(m_pdata->getAltAccelerations(),
+                                         access_location::host,
+                                         access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge_alt(m_pdata->getAltCharges(),
+                                         access_location::host,
+                                         access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter_alt(m_pdata->getAltDiameters(),
+                                           access_location::host,
+                                           access_mode::overwrite);
+        ArrayHandle<int3> h_image_alt(m_pdata->getAltImages(),
+                                      access_location::host,
+                                      access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body_alt(m_pdata->getAltBodies(),
+                                             access_location::host,
+                                             access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag_alt(m_pdata->getAltTags(),
+                                            access_location::host,
+                                            access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation_alt(m_pdata->getAltOrientationArray(),
+                                               access_location::host,
+                                               access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom_alt(m_pdata->getAltAngularMomentumArray(),
+                                          access_location::host,
+                                          access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia_alt(m_pdata->getAltMomentsOfInertiaArray(),
+                                           access_location::host,
+                                           access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial_alt(m_pdata->getAltNetVirial(),
+                                             access_location::host,
+                                             access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force_alt(m_pdata->getAltNetForce(),
+                                             access_location::host,
+                                             access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque_alt(m_pdata->getAltNetTorqueArray(),
+                                              access_location::host,
+                                              access_mode::overwrite);
+
+        // access live particle data to read from
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(),
+                                   access_location::host,
+                                   access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(),
+                                     access_location::host,
+                                     access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(),
+                                     access_location::host,
+                                     access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(),
+                                       access_location::host,
+                                       access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(),
+                                         access_location::host,
+                                         access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(),
+                                        access_location::host,
+                                        access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
+                                           access_location::host,
+                                           access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(),
+                                      access_location::host,
+                                      access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(),
+                                       access_location::host,
+                                       access_mode::read);
         ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(),
                                          access_location::host,
-                                         access_mode::readwrite);
-        size_t virial_pitch = m_pdata->getNetVirial().getPitch();
-
-        for (unsigned int j = 0; j < 6; j++)
-            {
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                scal_tmp[i] = h_net_virial.data[j * virial_pitch + m_sort_order[i]];
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                h_net_virial.data[j * virial_pitch + i] = scal_tmp[i];
-            }
-        }
-
-        // sort net force, net torque, and orientation
-        {
+                                         access_mode::read);
         ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(),
                                          access_location::host,
-                                         access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_force.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_force.data[i] = scal4_tmp[i];
-        }
-
-        {
+                                         access_mode::read);
         ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(),
                                           access_location::host,
-                                          access_mode::readwrite);
+                                          access_mode::read);
 
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_torque.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_torque.data[i] = scal4_tmp[i];
-        }
+        // access rtags
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(),
+                                         access_location::host,
+                                         access_mode::readwrite);
 
-        {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
-                                           access_location::host,
-                                           access_mode::readwrite);
+        const unsigned int N = m_pdata->getN();
+        const unsigned int n_total = N + m_pdata->getNGhosts();
+        const size_t virial_pitch = m_pdata->getNetVirial().getPitch();
 
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_orientation.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_orientation.data[i] = scal4_tmp[i];
+        // gather all per-particle arrays in one pass and re-build rtags
+        detail::forEachChunk(
+            *m_exec_conf,
+            detail::getNumChunks(*m_exec_conf, n_total),
+            n_total,
+            [&](unsigned int c, unsigned int first, unsigned int last)
+            {
+                for (unsigned int idx = first; idx < last; idx++)
+                    {
+                    // apply sorted order only for local ptls
+                    unsigned int old_idx = (idx < N ? m_sort_order[idx] : idx);
+
+                    h_pos_alt.data[idx] = h_pos.data[old_idx];
+                    h_vel_alt.data[idx] = h_vel.data[old_idx];
+                    h_accel_alt.data[idx] = h_accel.data[old_idx];
+                    h_charge_alt.data[idx] = h_charge.data[old_idx];
+                    h_diameter_alt.data[idx] = h_diameter.data[old_idx];
+                    h_image_alt.data[idx] = h_image.data[old_idx];
+                    h_body_alt.data[idx] = h_body.data[old_idx];
+                    unsigned int tag = h_tag.data[old_idx];
+                    h_tag_alt.data[idx] = tag;
+                    h_orientation_alt.data[idx] = h_orientation.data[old_idx];
+                    h_angmom_alt.data[idx] = h_angmom.data[old_idx];
+                    h_inertia_alt.data[idx] = h_inertia.data[old_idx];
+                    for (unsigned int j = 0; j < 6; j++)
+                        h_net_virial_alt.data[j * virial_pitch + idx]
+                            = h_net_virial.data[j * virial_pitch + old_idx];
+                    h_net_force_alt.data[idx] = h_net_force.data[old_idx];
+                    h_net_torque_alt.data[idx] = h_net_torque.data[old_idx];
+
+                    if (idx < N)
+                        {
+                        // update rtag to point to particle position in new arrays
+                        h_rtag.data[tag] = idx;
+                        }
+                    }
+            });
         }
 
-    // sort image
-    int3* int3_tmp = new int3[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        int3_tmp[i] = h_image.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_image.data[i] = int3_tmp[i];
-
-    // sort body
-    unsigned int* uint_tmp = new unsigned int[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_body.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_body.data[i] = uint_tmp[i];
-
-    // sort global tag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_tag.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_tag.data[i] = uint_tmp[i];
-
-    // rebuild global rtag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // make alternate arrays current
+    m_pdata->swapPositions();
+    m_pdata->swapVelocities();
+    m_pdata->swapAccelerations();
+    m_pdata->swapCharges();
+    m_pdata->swapDiameters();
+    m_pdata->swapImages();
+    m_pdata->swapBodies();
+    m_pdata->swapTags();
+    m_pdata->swapOrientations();
+    m_pdata->swapAngularMomenta();
+    m_pdata->swapMomentsOfInertia();
+    m_pdata->swapNetVirial();
+    m_pdata->swapNetForce();
+    m_pdata->swapNetTorque();
+    }
+
+/*! \param max_bin Largest curve index in m_particle_bins
+
+    Computes m_sort_order with a stable least significant digit radix sort of m_particle_bins.
+    Each pass counts the digits in every chunk of particles, scans the counts to find where each
+    chunk writes each digit, and scatters the chunks independently. The sort is stable, so the
+    result is the same as sorting (bin, index) pairs and does not depend on the number of chunks.
+*/
+void SFCPackTuner::sortParticleBins(unsigned int max_bin)
+    {
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_chunks = detail::getNumChunks(*m_exec_conf, N);
+
+    // particles that have not left their bins since the last sort are still in order
+    std::vector<char> chunk_sorted(n_chunks);
+    detail::forEachChunk(*m_exec_conf,
+                         n_chunks,
+                         N,
+                         [&](unsigned int c, unsigned int first, unsigned int last)
+                         {
+                             chunk_sorted[c] = true;
+                             for (unsigned int i = std::max(first, 1u); i < last; i++)
+                                 {
+                                 if (m_particle_bins[i - 1] > m_particle_bins[i])
+                                     {
+                                     chunk_sorted[c] = false;
+                                     break;
+                                     }
+                                 }
+                         });
+    m_sort_order_is_identity
+        = std::all_of(chunk_sorted.begin(), chunk_sorted.end(), [](char b) { return b; });
+    if (m_sort_order_is_identity)
+        return;
+
+    const unsigned int radix_bits = 8;
+    const unsigned int n_buckets = 1 << radix_bits;
+    m_radix_offsets.resize(size_t(n_chunks) * n_buckets);
+
+    unsigned int* bins_in = m_particle_bins.data();
+    unsigned int* bins_out = m_particle_bins_alt.data();
+    unsigned int* order_in = m_sort_order.data();
+    unsigned int* order_out = m_sort_order_alt.data();
+
+    for (unsigned int shift = 0; shift < 32 && (shift == 0 || (max_bin >> shift) != 0);
+         shift += radix_bits)
         {
-        h_rtag.data[h_tag.data[i]] = i;
+        const bool first_pass = shift == 0;
+
+        // count the digits in each chunk
+        detail::forEachChunk(
+            *m_exec_conf,
+            n_chunks,
+            N,
+            [&](unsigned int c, unsigned int first, unsigned int last)
+            {
+                unsigned int* count = m_radix_offsets.data() + size_t(c) * n_buckets;
+                std::fill(count, count + n_buckets, 0);
+                for (unsigned int i = first; i < last; i++)
+                    count[(bins_in[i] >> shift) & (n_buckets - 1)]++;
+            });
+
+        // scan the counts in digit-major order to get the output offset of each chunk and digit
+        unsigned int offset = 0;
+        for (unsigned int d = 0; d < n_buckets; d++)
+            {
+            for (unsigned int c = 0; c < n_chunks; c++)
+                {
+                unsigned int& chunk_offset = m_radix_offsets[size_t(c) * n_buckets + d];
+                unsigned int count = chunk_offset;
+                chunk_offset = offset;
+                offset += count;
+                }
+            }
+
+        // scatter each chunk to its slots, preserving the order within each digit
+        detail::forEachChunk(
+            *m_exec_conf,
+            n_chunks,
+            N,
+            [&](unsigned int c, unsigned int first, unsigned int last)
+            {
+                unsigned int* chunk_offset = m_radix_offsets.data() + size_t(c) * n_buckets;
+                for (unsigned int i = first; i < last; i++)
+                    {
+                    unsigned int pos = chunk_offset[(bins_in[i] >> shift) & (n_buckets - 1)]++;
+                    bins_out[pos] = bins_in[i];
+                    order_out[pos] = first_pass ? i : order_in[i];
+                    }
+            });
+
+        std::swap(bins_in, bins_out);
+        std::swap(order_in, order_out);
         }
 
-    delete[] scal_tmp;
-    delete[] scal4_tmp;
-    delete[] scal3_tmp;
-    delete[] uint_tmp;
-    delete[] int3_tmp;
+    // the result of the last pass is in order_in
+    if (order_in != m_sort_order.data())
+        m_sort_order.swap(m_sort_order_alt);
     }
 
 namespace detail
@@ -501,41 +600,41 @@ void SFCPackTuner::getSortedOrder2D()
                                    access_location::host,
                                    access_mode::read);
 
-        // for each particle
-        for (unsigned int n = 0; n < m_pdata->getN(); n++)
+        const unsigned int N = m_pdata->getN();
+        detail::forEachChunk(
+            *m_exec_conf,
+            detail::getNumChunks(*m_exec_conf, N),
+            N,
+            [&](unsigned int c, unsigned int first, unsigned int last)
             {
-            // find the bin each particle belongs in
-            Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-            Scalar3 f = box.makeFraction(p, make_scalar3(0.0, 0.0, 0.0));
-            int ib = (unsigned int)(f.x * m_grid) % m_grid;
-            int jb = (unsigned int)(f.y * m_grid) % m_grid;
-
-            // if the particle is slightly outside, move back into grid
-            if (ib < 0)
-                ib = 0;
-            if (ib >= (int)m_grid)
-                ib = m_grid - 1;
-
-            if (jb < 0)
-                jb = 0;
-            if (jb >= (int)m_grid)
-                jb = m_grid - 1;
-
-            // record its bin
-            unsigned int bin = ib * m_grid + jb;
-
-            m_particle_bins[n] = std::pair<unsigned int, unsigned int>(bin, n);
-            }
+                // for each particle
+                for (unsigned int n = first; n < last; n++)
+                    {
+                    // find the bin each particle belongs in
+                    Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+                    Scalar3 f = box.makeFraction(p, make_scalar3(0.0, 0.0, 0.0));
+                    int ib = (unsigned int)(f.x * m_grid) % m_grid;
+                    int jb = (unsigned int)(f.y * m_grid) % m_grid;
+
+                    // if the particle is slightly outside, move back into grid
+                    if (ib < 0)
+                        ib = 0;
+                    if (ib >= (int)m_grid)
+                        ib = m_grid - 1;
+
+                    if (jb < 0)
+                        jb = 0;
+                    if (jb >= (int)m_grid)
+                        jb = m_grid - 1;
+
+                    // record its bin
+                    m_particle_bins[n] = ib * m_grid + jb;
+                    }
+            });
         }
 
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    // sort the particles by bin
+    sortParticleBins(m_grid * m_grid - 1);
     }
 
 void SFCPackTuner::getSortedOrder3D()
@@ -608,45 +707,47 @@ void SFCPackTuner::getSortedOrder3D()
                                                 access_location::host,
                                                 access_mode::read);
 
-    // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
+    const unsigned int N = m_pdata->getN();
+    detail::forEachChunk(
+        *m_exec_conf,
+        detail::getNumChunks(*m_exec_conf, N),
+        N,
+        [&](unsigned int c, unsigned int first, unsigned int last)
         {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p, make_scalar3(0.0, 0.0, 0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
-        int kb = (unsigned int)(f.z * m_grid) % m_grid;
-
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0)
-            ib = 0;
-        if (ib >= (int)m_grid)
-            ib = m_grid - 1;
-
-        if (jb < 0)
-            jb = 0;
-        if (jb >= (int)m_grid)
-            jb = m_grid - 1;
-
-        if (kb < 0)
-            kb = 0;
-        if (kb >= (int)m_grid)
-            kb = m_grid - 1;
-
-        // record its bin
-        unsigned int bin = ib * (m_grid * m_grid) + jb * m_grid + kb;
-
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(h_traversal_order.data[bin], n);
-        }
-
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+            // for each particle
+            for (unsigned int n = first; n < last; n++)
+                {
+                Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+                Scalar3 f = box.makeFraction(p, make_scalar3(0.0, 0.0, 0.0));
+                int ib = (unsigned int)(f.x * m_grid) % m_grid;
+                int jb = (unsigned int)(f.y * m_grid) % m_grid;
+                int kb = (unsigned int)(f.z * m_grid) % m_grid;
+
+                // if the particle is slightly outside, move back into grid
+                if (ib < 0)
+                    ib = 0;
+                if (ib >= (int)m_grid)
+                    ib = m_grid - 1;
+
+                if (jb < 0)
+                    jb = 0;
+                if (jb >= (int)m_grid)
+                    jb = m_grid - 1;
+
+                if (kb < 0)
+                    kb = 0;
+                if (kb >= (int)m_grid)
+                    kb = m_grid - 1;
+
+                // record its bin
+                unsigned int bin = ib * (m_grid * m_grid) + jb * m_grid + kb;
+
+                m_particle_bins[n] = h_traversal_order.data[bin];
+                }
+        });
+
+    // sort the particles by their position along the curve
+    sortParticleBins(m_grid * m_grid * m_grid - 1);
     }
 
 void SFCPackTuner::writeTraversalOrder(const std::string& fname,
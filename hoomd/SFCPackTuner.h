@@ -111,10 +111,17 @@ class PYBIND11_EXPORT SFCPackTuner : public Tuner
     virtual void reallocate();
 
     private:
-    std::vector<unsigned int> m_sort_order; //!< Generated sort order of the particles
-    std::vector<std::pair<unsigned int, unsigned int>> m_particle_bins; //!< Binned particles
+    std::vector<unsigned int> m_sort_order;        //!< Generated sort order of the particles
+    std::vector<unsigned int> m_particle_bins;     //!< Curve index of the bin of each particle
+    std::vector<unsigned int> m_sort_order_alt;    //!< Scratch space for the radix sort
+    std::vector<unsigned int> m_particle_bins_alt; //!< Scratch space for the radix sort
+    std::vector<unsigned int> m_radix_offsets;     //!< Per-chunk digit offsets for the radix sort
+    bool m_sort_order_is_identity = false;         //!< True when the particles are already sorted
     std::shared_ptr<Trigger> m_trigger;
 
+    //! Sort the particles by the curve index of their bins
+    void sortParticleBins(unsigned int max_bin);
+
 #ifdef ENABLE_MPI
     /// The systems's communicator.
     std::shared_ptr<Communicator> m_comm;
@@ -7,6 +7,7 @@
 #include "hoomd/Autotuner.h"
 #include "hoomd/CellList.h"
 #include "hoomd/Compute.h"
+#include "hoomd/DeterministicReduce.h"
 
 #include "IntegratorHPMCMono.h"
 #include "hoomd/RNGIdentifiers.h"
@@ -122,7 +123,6 @@ template<class Shape> void ComputeFreeVolume<Shape>::compute(uint64_t timestep)
 template<class Shape> void ComputeFreeVolume<Shape>::computeFreeVolume(uint64_t timestep)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
     unsigned int ndim = this->m_sysdef->getNDimensions();
 
     this->m_exec_conf->msg->notice(5) << "HPMC computing free volume " << timestep << std::endl;
@@ -164,98 +164,102 @@ template<class Shape> void ComputeFreeVolume<Shape>::computeFreeVolume(uint64_t
         n_sample /= this->m_exec_conf->getNRanks();
 #endif
 
-        for (unsigned int i = 0; i < n_sample; i++)
+        // each sample draws from its own random number stream, so the samples are independent and
+        // the count does not depend on the number of threads
+        auto sample_range = [&](unsigned int first, unsigned int last)
             {
-            // select a random particle coordinate in the box
-            hoomd::RandomGenerator rng_i(
-                hoomd::Seed(hoomd::RNGIdentifier::ComputeFreeVolume, timestep, seed),
-                hoomd::Counter(m_exec_conf->getRank(), i));
-
-            Scalar xrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
-            Scalar yrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
-            Scalar zrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
-            if (this->m_sysdef->getNDimensions() == 2)
+            unsigned int range_overlap_count = 0;
+            unsigned int err_count = 0;
+            for (unsigned int i = first; i < last; i++)
                 {
-                zrand = 0;
-                }
-            Scalar3 f = make_scalar3(xrand, yrand, zrand);
-            vec3<Scalar> pos_i = vec3<Scalar>(box.makeCoordinates(f));
-
-            Shape shape_i(quat<Scalar>(), params[m_type]);
-            if (shape_i.hasOrientation())
-                {
-                shape_i.orientation = generateRandomOrientation(rng_i, ndim);
-                }
+                // select a random particle coordinate in the box
+                hoomd::RandomGenerator rng_i(
+                    hoomd::Seed(hoomd::RNGIdentifier::ComputeFreeVolume, timestep, seed),
+                    hoomd::Counter(m_exec_conf->getRank(), i));
+
+                Scalar xrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
+                Scalar yrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
+                Scalar zrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
+                if (this->m_sysdef->getNDimensions() == 2)
+                    {
+                    zrand = 0;
+                    }
+                Scalar3 f = make_scalar3(xrand, yrand, zrand);
+                vec3<Scalar> pos_i = vec3<Scalar>(box.makeCoordinates(f));
 
-            // check for overlaps with particles in the system state
-            bool overlap = false;
-            hoomd::detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0, 0, 0));
+                Shape shape_i(quat<Scalar>(), params[m_type]);
+                if (shape_i.hasOrientation())
+                    {
+                    shape_i.orientation = generateRandomOrientation(rng_i, ndim);
+                    }
 
-            // All image boxes (including the primary)
-            const unsigned int n_images = (unsigned int)image_list.size();
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-                {
-                vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
-                hoomd::detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i_image);
+                // check for overlaps with particles in the system state
+                bool overlap = false;
+                hoomd::detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0, 0, 0));
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                     cur_node_idx++)
+                // All image boxes (including the primary)
+                const unsigned int n_images = (unsigned int)image_list.size();
+                for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                     {
-                    if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                    vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+                    hoomd::detail::AABB aabb = aabb_i_local;
+                    aabb.translate(pos_i_image);
+
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next();
+                         cur_node_idx != hoomd::detail::INVALID_NODE;
+                         cur_node_idx = traversal.next())
                         {
-                        if (aabb_tree.isNodeLeaf(cur_node_idx))
+                        for (unsigned int cur_p = 0;
+                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                             cur_p++)
                             {
-                            for (unsigned int cur_p = 0;
-                                 cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                 cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                            // read in its position and orientation
+                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
+                            Scalar4 postype_j;
+                            Scalar4 orientation_j;
 
-                                // load the position and orientation of the j particle
-                                postype_j = h_postype.data[j];
-                                orientation_j = h_orientation.data[j];
+                            // load the position and orientation of the j particle
+                            postype_j = h_postype.data[j];
+                            orientation_j = h_orientation.data[j];
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                            // put particles in coordinate system of particle i
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
 
-                                if (h_overlaps.data[overlap_idx(m_type, typ_j)]
-                                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, err_count))
-                                    {
-                                    overlap = true;
-                                    break;
-                                    }
+                            if (h_overlaps.data[overlap_idx(m_type, typ_j)]
+                                && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                                && test_overlap(r_ij, shape_i, shape_j, err_count))
+                                {
+                                overlap = true;
+                                break;
                                 }
                             }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                        }
+
+                        if (overlap)
+                            break;
+                        } // end loop over AABB nodes
 
                     if (overlap)
                         break;
-                    } // end loop over AABB nodes
+                    } // end loop over images
 
                 if (overlap)
-                    break;
-                } // end loop over images
-
-            if (overlap)
-                {
-                overlap_count++;
-                }
-            } // end loop through all particles
+                    {
+                    range_overlap_count++;
+                    }
+                } // end loop through all samples
+            return range_overlap_count;
+            };
+        overlap_count = hoomd::detail::deterministicReduce(*m_exec_conf,
+                                                           n_sample,
+                                                           0u,
+                                                           sample_range,
+                                                           std::plus<unsigned int>());
 
         } // end lexical scope
 
@@ -7,6 +7,7 @@
 #include "hoomd/Autotuner.h"
 #include "hoomd/CellList.h"
 #include "hoomd/Compute.h"
+#include "hoomd/ForEachRange.h"
 
 #include "HPMCCounters.h"
 #include "IntegratorHPMCMono.h"
@@ -168,6 +169,11 @@ template<class Shape> class ComputeSDF : public Compute
     std::vector<double> m_hist_expansion;   //!< Raw histogram data
     std::vector<double> m_sdf_expansion;    //!< Computed SDF
 
+    std::vector<size_t> m_particle_bin_compression;    //!< Compression bin of each particle
+    std::vector<double> m_particle_weight_compression; //!< Compression weight of each particle
+    std::vector<size_t> m_particle_bin_expansion;      //!< Expansion bin of each particle
+    std::vector<double> m_particle_weight_expansion;   //!< Expansion weight of each particle
+
     //! Find the maximum particle separation beyond which all interactions are zero
     Scalar getMaxInteractionDiameter();
     Scalar m_last_max_diam; //!< Last recorded maximum diameter
@@ -347,10 +353,18 @@ template<class Shape> Scalar ComputeSDF<Shape>::getMaxInteractionDiameter()
       - The integrator performs the ghost exchange (with the ghost width extra that we add)
 
     This function is a wrapper that calls the appropriate method depending on whether a binary or
-    linear search is required.
+    linear search is required. The search methods process the particles in parallel and record the
+    bin and weight of each particle. countHistogram() then adds them to the histograms in particle
+    order so that the result does not depend on the number of threads.
 */
 template<class Shape> void ComputeSDF<Shape>::countHistogram(uint64_t timestep)
     {
+    const unsigned int N = m_pdata->getN();
+    m_particle_bin_compression.resize(N);
+    m_particle_weight_compression.resize(N);
+    m_particle_bin_expansion.resize(N);
+    m_particle_weight_expansion.resize(N);
+
     if (m_mc->hasPairInteractions() || m_shape_requires_expansion_moves)
         {
         countHistogramLinearSearch(timestep);
@@ -359,6 +373,20 @@ template<class Shape> void ComputeSDF<Shape>::countHistogram(uint64_t timestep)
         {
         countHistogramBinarySearch(timestep);
         }
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (m_particle_bin_compression[i] < m_hist_compression.size()
+            && m_particle_weight_compression[i] <= 1.0)
+            {
+            m_hist_compression[m_particle_bin_compression[i]] += m_particle_weight_compression[i];
+            }
+        if (m_particle_bin_expansion[i] < m_hist_expansion.size()
+            && m_particle_weight_expansion[i] <= 1.0)
+            {
+            m_hist_expansion[m_particle_bin_expansion[i]] += m_particle_weight_expansion[i];
+            }
+        }
     } // end countHistogram()
 
 template<class Shape> void ComputeSDF<Shape>::countHistogramBinarySearch(uint64_t timestep)
@@ -381,79 +409,73 @@ template<class Shape> void ComputeSDF<Shape>::countHistogramBinarySearch(uint64_
     const std::vector<param_type, hoomd::detail::managed_allocator<param_type>>& params
         = m_mc->getParams();
 
-    // loop through N particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // loop through N particles, each particle only writes its own histogram contribution
+    auto count_range = [&](unsigned int first, unsigned int last)
         {
-        size_t min_bin = m_hist_compression.size();
-        // read in the current position and orientation
-        Scalar4 postype_i = h_postype.data[i];
-        const quat<LongReal> orientation_i(h_orientation.data[i]);
-        Shape shape_i(orientation_i, params[__scalar_as_int(postype_i.w)]);
-        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
-
-        // construct the AABB around the particle's circumsphere
-        // pad with enough extra width so that when scaled by xmax, found particles might touch
-        hoomd::detail::AABB aabb_i_local(vec3<Scalar>(0, 0, 0),
-                                         shape_i.getCircumsphereDiameter() / Scalar(2)
-                                             + extra_width);
-
-        size_t n_images = image_list.size();
-        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        for (unsigned int i = first; i < last; i++)
             {
-            vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
-            hoomd::detail::AABB aabb = aabb_i_local;
-            aabb.translate(pos_i_image);
-
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                 cur_node_idx++)
+            size_t min_bin = m_hist_compression.size();
+            // read in the current position and orientation
+            Scalar4 postype_i = h_postype.data[i];
+            const quat<LongReal> orientation_i(h_orientation.data[i]);
+            Shape shape_i(orientation_i, params[__scalar_as_int(postype_i.w)]);
+            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+            // construct the AABB around the particle's circumsphere
+            // pad with enough extra width so that when scaled by xmax, found particles might touch
+            hoomd::detail::AABB aabb_i_local(vec3<Scalar>(0, 0, 0),
+                                             shape_i.getCircumsphereDiameter() / Scalar(2)
+                                                 + extra_width);
+
+            size_t n_images = image_list.size();
+            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                 {
-                if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+                hoomd::detail::AABB aabb = aabb_i_local;
+                aabb.translate(pos_i_image);
+
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                for (unsigned int cur_node_idx = traversal.next();
+                     cur_node_idx != hoomd::detail::INVALID_NODE;
+                     cur_node_idx = traversal.next())
                     {
-                    if (aabb_tree.isNodeLeaf(cur_node_idx))
+                    for (unsigned int cur_p = 0;
+                         cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                         cur_p++)
                         {
-                        for (unsigned int cur_p = 0;
-                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                             cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
+                            continue;
 
-                            Scalar4 postype_j = h_postype.data[j];
-                            const quat<LongReal> orientation_j(h_orientation.data[j]);
+                        Scalar4 postype_j = h_postype.data[j];
+                        const quat<LongReal> orientation_j(h_orientation.data[j]);
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                            size_t bin = computeBin(r_ij,
-                                                    orientation_i,
-                                                    orientation_j,
-                                                    params[__scalar_as_int(postype_i.w)],
-                                                    params[__scalar_as_int(postype_j.w)]);
+                        size_t bin = computeBin(r_ij,
+                                                orientation_i,
+                                                orientation_j,
+                                                params[__scalar_as_int(postype_i.w)],
+                                                params[__scalar_as_int(postype_j.w)]);
 
-                            if (bin >= 0)
-                                {
-                                min_bin = std::min(min_bin, bin);
-                                }
+                        if (bin >= 0)
+                            {
+                            min_bin = std::min(min_bin, bin);
                             }
                         }
-                    }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                    }
-                } // end loop over AABB nodes
-            } // end loop over images
-        if (min_bin < m_hist_compression.size())
-            {
-            m_hist_compression[min_bin]++;
-            }
-        } // end loop over all particles
+                    } // end loop over AABB nodes
+                } // end loop over images
+            m_particle_bin_compression[i] = min_bin;
+            m_particle_weight_compression[i] = 1.0;
+            m_particle_bin_expansion[i] = m_hist_expansion.size();
+            } // end loop over all particles
+        };
+    hoomd::detail::forEachRange(*m_exec_conf, m_pdata->getN(), count_range);
     } // end countHistogramBinarySearch()
 
 template<class Shape> void ComputeSDF<Shape>::countHistogramLinearSearch(uint64_t timestep)
@@ -491,214 +513,206 @@ template<class Shape> void ComputeSDF<Shape>::countHistogramLinearSearch(uint64_
     // For each of particle i's neighbors, we find the scaling that produces the first overlap.
     // For each neighbor, we do a brute force search from the scaling corresponding to bin 0
     // up to the minimum bin that we've already found for particle i.
-    // Then we add to m_hist_compression[min_bin] the negative Mayer-function corresponding to the
-    // type of overlap corresponding to particle i's first overlap.
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // Then we record the bin and the negative Mayer-function corresponding to the type of overlap
+    // corresponding to particle i's first overlap. Each particle only writes its own entries.
+    auto count_range = [&](unsigned int first, unsigned int last)
         {
-        size_t min_bin_compression = m_hist_compression.size();
-        size_t min_bin_expansion = m_hist_expansion.size();
-        double hist_weight_ptl_i_compression = 2.0;
-        double hist_weight_ptl_i_expansion = 2.0;
-
-        // read in the current position and orientation
-        const Scalar4 postype_i = h_postype.data[i];
-        const quat<LongReal> orientation_i(h_orientation.data[i]);
-        const int typ_i = __scalar_as_int(postype_i.w);
-        const Shape shape_i(orientation_i, params[__scalar_as_int(postype_i.w)]);
-        const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
-
-        // construct the AABB around the particle's circumsphere
-        // pad with enough extra width so that when scaled by xmax, found particles might touch
-        const LongReal R_query = std::max(shape_i.getCircumsphereDiameter() * LongReal(0.5),
-                                          pair_energy_search_radius[typ_i] - min_core_radius);
-        hoomd::detail::AABB aabb_i_local(vec3<Scalar>(0, 0, 0), R_query + extra_width);
-
-        const size_t n_images = image_list.size();
-        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        for (unsigned int i = first; i < last; i++)
             {
-            vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
-            hoomd::detail::AABB aabb = aabb_i_local;
-            aabb.translate(pos_i_image);
-
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                 cur_node_idx++)
+            size_t min_bin_compression = m_hist_compression.size();
+            size_t min_bin_expansion = m_hist_expansion.size();
+            double hist_weight_ptl_i_compression = 2.0;
+            double hist_weight_ptl_i_expansion = 2.0;
+
+            // read in the current position and orientation
+            const Scalar4 postype_i = h_postype.data[i];
+            const quat<LongReal> orientation_i(h_orientation.data[i]);
+            const int typ_i = __scalar_as_int(postype_i.w);
+            const Shape shape_i(orientation_i, params[__scalar_as_int(postype_i.w)]);
+            const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+            // construct the AABB around the particle's circumsphere
+            // pad with enough extra width so that when scaled by xmax, found particles might touch
+            const LongReal R_query = std::max(shape_i.getCircumsphereDiameter() * LongReal(0.5),
+                                              pair_energy_search_radius[typ_i] - min_core_radius);
+            hoomd::detail::AABB aabb_i_local(vec3<Scalar>(0, 0, 0), R_query + extra_width);
+
+            const size_t n_images = image_list.size();
+            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                 {
-                if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+                hoomd::detail::AABB aabb = aabb_i_local;
+                aabb.translate(pos_i_image);
+
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                for (unsigned int cur_node_idx = traversal.next();
+                     cur_node_idx != hoomd::detail::INVALID_NODE;
+                     cur_node_idx = traversal.next())
                     {
-                    if (aabb_tree.isNodeLeaf(cur_node_idx))
+                    for (unsigned int cur_p = 0;
+                         cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                         cur_p++)
                         {
-                        for (unsigned int cur_p = 0;
-                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                             cur_p++)
+                        // read in its position and orientation
+                        unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
                             {
-                            // read in its position and orientation
-                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                            continue;
+                            }
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
+                        const Scalar4 postype_j = h_postype.data[j];
+                        const quat<LongReal> orientation_j(h_orientation.data[j]);
+                        const int typ_j = __scalar_as_int(postype_j.w);
+
+                        // put particles in coordinate system of particle i
+                        const vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        // energy of pair interaction in unperturbed state
+                        double u_ij_0 = 0.0;
+                        u_ij_0 = m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
+                                                            r_ij,
+                                                            typ_i,
+                                                            shape_i.orientation,
+                                                            h_diameter.data[i],
+                                                            h_charge.data[i],
+                                                            typ_j,
+                                                            orientation_j,
+                                                            h_diameter.data[j],
+                                                            h_charge.data[j]);
+
+                        // first do compressions
+                        for (size_t bin_to_sample = 0; bin_to_sample < min_bin_compression;
+                             bin_to_sample++)
+                            {
+                            const double scale_factor
+                                = m_dx * static_cast<double>(bin_to_sample + 1);
+
+                            // check for hard overlaps
+                            // if there is one for a given scale value, there is no need to
+                            // check for any soft overlaps from m_mc.m_patch
+                            bool hard_overlap = detail::test_scaled_overlap<Shape>(
+                                r_ij,
+                                orientation_i,
+                                orientation_j,
+                                params[__scalar_as_int(postype_i.w)],
+                                params[__scalar_as_int(postype_j.w)],
+                                scale_factor);
+                            if (hard_overlap)
                                 {
-                                continue;
-                                }
-
-                            const Scalar4 postype_j = h_postype.data[j];
-                            const quat<LongReal> orientation_j(h_orientation.data[j]);
-                            const int typ_j = __scalar_as_int(postype_j.w);
-
-                            // put particles in coordinate system of particle i
-                            const vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-
-                            double u_ij_0 = 0.0; // energy of pair interaction in unperturbed state
-                            u_ij_0 = m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
-                                                                r_ij,
-                                                                typ_i,
-                                                                shape_i.orientation,
-                                                                h_diameter.data[i],
-                                                                h_charge.data[i],
-                                                                typ_j,
-                                                                orientation_j,
-                                                                h_diameter.data[j],
-                                                                h_charge.data[j]);
-
-                            // first do compressions
-                            for (size_t bin_to_sample = 0; bin_to_sample < min_bin_compression;
-                                 bin_to_sample++)
+                                hist_weight_ptl_i_compression = 1.0; // = 1-e^(-\infty)
+                                min_bin_compression = bin_to_sample;
+                                } // end if (hard_overlap)
+
+                            // if no hard overlap, check for a soft overlap if we have
+                            // patches
+                            if (!hard_overlap)
                                 {
-                                const double scale_factor
-                                    = m_dx * static_cast<double>(bin_to_sample + 1);
-
-                                // check for hard overlaps
-                                // if there is one for a given scale value, there is no need to
-                                // check for any soft overlaps from m_mc.m_patch
-                                bool hard_overlap = detail::test_scaled_overlap<Shape>(
-                                    r_ij,
-                                    orientation_i,
+                                // compute the energy at this size of the perturbation and
+                                // compare to the energy in the unperturbed state
+                                const vec3<Scalar> r_ij_scaled
+                                    = r_ij * (Scalar(1.0) - scale_factor);
+                                double u_ij_new = m_mc->computeOnePairEnergy(
+                                    dot(r_ij_scaled, r_ij_scaled),
+                                    r_ij_scaled,
+                                    typ_i,
+                                    shape_i.orientation,
+                                    h_diameter.data[i],
+                                    h_charge.data[i],
+                                    typ_j,
                                     orientation_j,
-                                    params[__scalar_as_int(postype_i.w)],
-                                    params[__scalar_as_int(postype_j.w)],
-                                    scale_factor);
-                                if (hard_overlap)
+                                    h_diameter.data[j],
+                                    h_charge.data[j]);
+                                // if energy has changed, there is a new soft overlap
+                                // add the appropriate weight to the appropriate bin of the
+                                // histogram and break out of the loop over bins
+                                if (u_ij_new != u_ij_0)
                                     {
-                                    hist_weight_ptl_i_compression = 1.0; // = 1-e^(-\infty)
                                     min_bin_compression = bin_to_sample;
-                                    } // end if (hard_overlap)
-
-                                // if no hard overlap, check for a soft overlap if we have
-                                // patches
-                                if (!hard_overlap)
-                                    {
-                                    // compute the energy at this size of the perturbation and
-                                    // compare to the energy in the unperturbed state
-                                    const vec3<Scalar> r_ij_scaled
-                                        = r_ij * (Scalar(1.0) - scale_factor);
-                                    double u_ij_new
-                                        = m_mc->computeOnePairEnergy(dot(r_ij_scaled, r_ij_scaled),
-                                                                     r_ij_scaled,
-                                                                     typ_i,
-                                                                     shape_i.orientation,
-                                                                     h_diameter.data[i],
-                                                                     h_charge.data[i],
-                                                                     typ_j,
-                                                                     orientation_j,
-                                                                     h_diameter.data[j],
-                                                                     h_charge.data[j]);
-                                    // if energy has changed, there is a new soft overlap
-                                    // add the appropriate weight to the appropriate bin of the
-                                    // histogram and break out of the loop over bins
-                                    if (u_ij_new != u_ij_0)
+                                    if (u_ij_new < u_ij_0)
+                                        {
+                                        hist_weight_ptl_i_compression = 0;
+                                        }
+                                    else
                                         {
-                                        min_bin_compression = bin_to_sample;
-                                        if (u_ij_new < u_ij_0)
-                                            {
-                                            hist_weight_ptl_i_compression = 0;
-                                            }
-                                        else
-                                            {
-                                            hist_weight_ptl_i_compression
-                                                = 1.0 - fast::exp(-(u_ij_new - u_ij_0));
-                                            }
+                                        hist_weight_ptl_i_compression
+                                            = 1.0 - fast::exp(-(u_ij_new - u_ij_0));
                                         }
-                                    } // end if (!hard_overlap)
-                                } // end loop over bins for compression
+                                    }
+                                } // end if (!hard_overlap)
+                            } // end loop over bins for compression
 
-                            // do expansions
-                            for (size_t bin_to_sample = 0; bin_to_sample < min_bin_expansion;
-                                 bin_to_sample++)
+                        // do expansions
+                        for (size_t bin_to_sample = 0; bin_to_sample < min_bin_expansion;
+                             bin_to_sample++)
+                            {
+                            const double scale_factor
+                                = -m_dx * static_cast<double>(bin_to_sample + 1);
+
+                            // check for hard overlaps
+                            // if there is one for a given scale value, there is no need to
+                            // check for any soft overlaps from m_mc.m_patch
+                            bool hard_overlap = detail::test_scaled_overlap<Shape>(
+                                r_ij,
+                                orientation_i,
+                                orientation_j,
+                                params[__scalar_as_int(postype_i.w)],
+                                params[__scalar_as_int(postype_j.w)],
+                                scale_factor);
+                            if (hard_overlap)
                                 {
-                                const double scale_factor
-                                    = -m_dx * static_cast<double>(bin_to_sample + 1);
-
-                                // check for hard overlaps
-                                // if there is one for a given scale value, there is no need to
-                                // check for any soft overlaps from m_mc.m_patch
-                                bool hard_overlap = detail::test_scaled_overlap<Shape>(
-                                    r_ij,
-                                    orientation_i,
+                                hist_weight_ptl_i_expansion = 1.0; // = 1-e^(-\infty)
+                                min_bin_expansion = bin_to_sample;
+                                } // end if (hard_overlap)
+
+                            // if no hard overlap, check for a soft overlap if necessary
+                            if (!hard_overlap)
+                                {
+                                // compute the energy at this size of the perturbation and
+                                // compare to the energy in the unperturbed state
+                                const vec3<Scalar> r_ij_scaled
+                                    = r_ij * (Scalar(1.0) - scale_factor);
+                                double u_ij_new = m_mc->computeOnePairEnergy(
+                                    dot(r_ij_scaled, r_ij_scaled),
+                                    r_ij_scaled,
+                                    typ_i,
+                                    shape_i.orientation,
+                                    h_diameter.data[i],
+                                    h_charge.data[i],
+                                    typ_j,
                                     orientation_j,
-                                    params[__scalar_as_int(postype_i.w)],
-                                    params[__scalar_as_int(postype_j.w)],
-                                    scale_factor);
-                                if (hard_overlap)
+                                    h_diameter.data[j],
+                                    h_charge.data[j]);
+                                // if energy has changed, there is a new soft overlap
+                                // add the appropriate weight to the appropriate bin of the
+                                // histogram and break out of the loop over bins
+                                if (u_ij_new != u_ij_0)
                                     {
-                                    hist_weight_ptl_i_expansion = 1.0; // = 1-e^(-\infty)
                                     min_bin_expansion = bin_to_sample;
-                                    } // end if (hard_overlap)
-
-                                // if no hard overlap, check for a soft overlap if necessary
-                                if (!hard_overlap)
-                                    {
-                                    // compute the energy at this size of the perturbation and
-                                    // compare to the energy in the unperturbed state
-                                    const vec3<Scalar> r_ij_scaled
-                                        = r_ij * (Scalar(1.0) - scale_factor);
-                                    double u_ij_new
-                                        = m_mc->computeOnePairEnergy(dot(r_ij_scaled, r_ij_scaled),
-                                                                     r_ij_scaled,
-                                                                     typ_i,
-                                                                     shape_i.orientation,
-                                                                     h_diameter.data[i],
-                                                                     h_charge.data[i],
-                                                                     typ_j,
-                                                                     orientation_j,
-                                                                     h_diameter.data[j],
-                                                                     h_charge.data[j]);
-                                    // if energy has changed, there is a new soft overlap
-                                    // add the appropriate weight to the appropriate bin of the
-                                    // histogram and break out of the loop over bins
-                                    if (u_ij_new != u_ij_0)
+                                    if (u_ij_new < u_ij_0)
                                         {
-                                        min_bin_expansion = bin_to_sample;
-                                        if (u_ij_new < u_ij_0)
-                                            {
-                                            hist_weight_ptl_i_expansion = 0;
-                                            }
-                                        else
-                                            {
-                                            hist_weight_ptl_i_expansion
-                                                = 1.0 - fast::exp(-(u_ij_new - u_ij_0));
-                                            }
+                                        hist_weight_ptl_i_expansion = 0;
                                         }
-                                    } // end if (!hard_overlap)
-                                } // end loop over histogram bins for expansions
-                            }
+                                    else
+                                        {
+                                        hist_weight_ptl_i_expansion
+                                            = 1.0 - fast::exp(-(u_ij_new - u_ij_0));
+                                        }
+                                    }
+                                } // end if (!hard_overlap)
+                            } // end loop over histogram bins for expansions
                         }
-                    }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                    }
-                } // end loop over AABB nodes
-            } // end loop over images
-        if (min_bin_compression < m_hist_compression.size() && hist_weight_ptl_i_compression <= 1.0)
-            {
-            m_hist_compression[min_bin_compression] += hist_weight_ptl_i_compression;
-            }
-        if (min_bin_expansion < m_hist_expansion.size() && hist_weight_ptl_i_expansion <= 1.0)
-            {
-            m_hist_expansion[min_bin_expansion] += hist_weight_ptl_i_expansion;
-            }
-        } // end loop over all particles
+                    } // end loop over AABB nodes
+                } // end loop over images
+            m_particle_bin_compression[i] = min_bin_compression;
+            m_particle_weight_compression[i] = hist_weight_ptl_i_compression;
+            m_particle_bin_expansion[i] = min_bin_expansion;
+            m_particle_weight_expansion[i] = hist_weight_ptl_i_expansion;
+            } // end loop over all particles
+        };
+    hoomd::detail::forEachRange(*m_exec_conf, m_pdata->getN(), count_range);
     } // end countHistogramLinearSearch()
 
 /*! \param r_ij Vector pointing from particle i to j (already wrapped into the box)
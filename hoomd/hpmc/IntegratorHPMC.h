@@ -332,6 +332,21 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         return m_nselect;
         }
 
+    //! Set the checkerboard flag
+    /*! \param checkerboard Set to true to perform the CPU trial moves on a checkerboard of cells
+     */
+    void setCheckerboard(bool checkerboard)
+        {
+        m_checkerboard = checkerboard;
+        }
+
+    //! Get the checkerboard flag
+    //! \returns true when the CPU trial moves are performed on a checkerboard of cells
+    bool getCheckerboard()
+        {
+        return m_checkerboard;
+        }
+
     //! Get performance in moves per second
     virtual double getMPS()
         {
@@ -595,6 +610,7 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
     protected:
     unsigned int m_translation_move_probability; //!< Fraction of moves that are translation moves.
     unsigned int m_nselect;                      //!< Number of particles to select for trial moves
+    bool m_checkerboard;                         //!< True to use checkerboard CPU trial moves
 
     GPUVector<Scalar> m_d; //!< Maximum move displacement by type
     GPUVector<Scalar> m_a; //!< Maximum angular displacement by type
@@ -17,6 +17,7 @@
 #include "IntegratorHPMC.h"
 #include "Moves.h"
 #include "hoomd/AABBTree.h"
+#include "hoomd/CellList.h"
 #include "GSDHPMCSchema.h"
 #include "hoomd/Index1D.h"
 #include "hoomd/RandomNumbers.h"
@@ -445,6 +446,7 @@ class IntegratorHPMCMono : public IntegratorHPMC
         hoomd::detail::AABB* m_aabbs;                      //!< list of AABBs, one per particle
         unsigned int m_aabbs_capacity;              //!< Capacity of m_aabbs list
         bool m_aabb_tree_invalid;                   //!< Flag if the aabb tree has been invalidated
+        bool m_aabb_tree_sorted;                    //!< Flag if the particles were reordered since the aabb tree was built
 
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
@@ -456,6 +458,12 @@ class IntegratorHPMCMono : public IntegratorHPMC
         /// Cached shape radius by type.
         std::vector<LongReal> m_shape_circumsphere_radius;
 
+        /* Checkerboard related data members */
+
+        std::shared_ptr<CellList> m_checkerboard_cl;                  //!< Cell list for checkerboard trial moves
+        std::vector< std::vector<unsigned int> > m_checkerboard_sets; //!< Occupied cells in each set of active cells
+        bool m_checkerboard_warning_issued;                           //!< True if the checkerboard fallback warning has been issued
+
         /* Depletants related data members */
 
         GlobalVector<Scalar> m_fugacity;            //!< Average depletant number density in free volume, per type
@@ -472,6 +480,12 @@ class IntegratorHPMCMono : public IntegratorHPMC
             uint64_t timestep, hoomd::RandomGenerator& rng_depletants,
             unsigned int seed_i_old, unsigned int seed_i_new);
 
+        //! Compute the cell list and the sets of active cells for checkerboard trial moves
+        bool setupCheckerboard(uint64_t timestep, bool has_depletants);
+
+        //! Perform nselect trial moves per local particle on a checkerboard of cells
+        void updateCheckerboard(uint64_t timestep, hpmc_counters_t& counters);
+
         //! Set the nominal width appropriate for looped moves
         virtual void updateCellWidth();
 
@@ -495,6 +509,8 @@ class IntegratorHPMCMono : public IntegratorHPMC
         virtual void slotSorted()
             {
             m_aabb_tree_invalid = true;
+            // the tree topology no longer matches the particle order, refitting it would be slow
+            m_aabb_tree_sorted = true;
             }
     };
 
@@ -506,6 +522,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_image_list_valid(false),
               m_hasOrientation(true),
               m_extra_image_width(0.0),
+              m_checkerboard_warning_issued(false),
               m_fugacity(m_exec_conf),
               m_ntrial(m_exec_conf)
     {
@@ -535,6 +552,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     m_aabbs = NULL;
     m_aabbs_capacity = 0;
     m_aabb_tree_invalid = true;
+    m_aabb_tree_sorted = true;
 
     m_fugacity.resize(this->m_pdata->getNTypes(), 0.0);
     m_ntrial.resize(m_fugacity.getNumElements(), 1);
@@ -628,13 +646,6 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
     m_update_order.resize(m_pdata->getN());
     m_update_order.shuffle(timestep, m_sysdef->getSeed(), m_exec_conf->getRank());
 
-    // update the AABB Tree
-    buildAABBTree();
-    // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
-    limitMoveDistances();
-    // update the image list
-    updateImageList();
-
     bool has_depletants = false;
     for (unsigned int i = 0; i < m_fugacity.getNumElements(); ++i)
         {
@@ -645,6 +656,17 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
             }
         }
 
+    // checkerboard trial moves find neighbors in a cell list instead of the AABB tree
+    bool checkerboard = m_checkerboard && setupCheckerboard(timestep, has_depletants);
+
+    // update the AABB Tree
+    if (!checkerboard)
+        buildAABBTree();
+    // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
+    limitMoveDistances();
+    // update the image list
+    updateImageList();
+
     // Combine the three seeds to generate RNG for poisson distribution
     hoomd::RandomGenerator rng_depletants(hoomd::Seed(hoomd::RNGIdentifier::HPMCDepletants,
                                                       timestep,
@@ -670,8 +692,12 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
         m_max_pair_additive_cutoff.push_back(getMaxPairInteractionAdditiveRCut(type));
         }
 
-    // loop over local particles nselect times
-    for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
+    if (checkerboard)
+        updateCheckerboard(timestep, counters);
+
+    // loop over local particles nselect times, unless the checkerboard sweeps already did
+    const unsigned int n_serial_sweeps = checkerboard ? 0 : m_nselect;
+    for (unsigned int i_nselect = 0; i_nselect < n_serial_sweeps; i_nselect++)
         {
         // access particle data and system box
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
@@ -777,78 +803,68 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
                 hoomd::detail::AABB aabb = aabb_i_local;
                 aabb.translate(pos_i_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree, aabb);
+                for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                     {
-                    if (aabb.overlaps(m_aabb_tree.getNodeAABB(cur_node_idx)))
+                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                         {
-                        if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                Scalar4 postype_j;
-                                quat<LongReal> orientation_j;
+                        Scalar4 postype_j;
+                        quat<LongReal> orientation_j;
 
-                                // handle j==i situations
-                                if ( j != i )
-                                    {
-                                    // load the position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = quat<LongReal>(h_orientation.data[j]);
-                                    }
-                                else
-                                    {
-                                    if (cur_image == 0)
-                                        {
-                                        // in the first image, skip i == j
-                                        continue;
-                                        }
-                                    else
-                                        {
-                                        // If this is particle i and we are in an outside image, use the translated position and orientation
-                                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
-                                        orientation_j = shape_i.orientation;
-                                        }
-                                    }
+                        // handle j==i situations
+                        if ( j != i )
+                            {
+                            // load the position and orientation of the j particle
+                            postype_j = h_postype.data[j];
+                            orientation_j = quat<LongReal>(h_orientation.data[j]);
+                            }
+                        else
+                            {
+                            if (cur_image == 0)
+                                {
+                                // in the first image, skip i == j
+                                continue;
+                                }
+                            else
+                                {
+                                // If this is particle i and we are in an outside image, use the translated position and orientation
+                                postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+                                orientation_j = shape_i.orientation;
+                                }
+                            }
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(orientation_j, m_params[typ_j]);
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(orientation_j, m_params[typ_j]);
 
-                                LongReal r_squared = dot(r_ij, r_ij);
-                                LongReal max_overlap_distance = m_shape_circumsphere_radius[typ_i] + m_shape_circumsphere_radius[typ_j];
+                        LongReal r_squared = dot(r_ij, r_ij);
+                        LongReal max_overlap_distance = m_shape_circumsphere_radius[typ_i] + m_shape_circumsphere_radius[typ_j];
 
-                                counters.overlap_checks++;
-                                if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
-                                    && r_squared < max_overlap_distance * max_overlap_distance
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
-                                    {
-                                    overlap = true;
-                                    break;
-                                    }
+                        counters.overlap_checks++;
+                        if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
+                            && r_squared < max_overlap_distance * max_overlap_distance
+                            && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                            {
+                            overlap = true;
+                            break;
+                            }
 
-                                // deltaU = U_old - U_new: subtract energy of new configuration
-                                patch_field_energy_diff -= computeOnePairEnergy(r_squared, r_ij, typ_i,
-                                                        shape_i.orientation,
-                                                        h_diameter.data[i],
-                                                        h_charge.data[i],
-                                                        typ_j,
-                                                        shape_j.orientation,
-                                                        h_diameter.data[j],
-                                                        h_charge.data[j]
-                                                        );
-                                }
-                           }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                        // deltaU = U_old - U_new: subtract energy of new configuration
+                        patch_field_energy_diff -= computeOnePairEnergy(r_squared, r_ij, typ_i,
+                                                shape_i.orientation,
+                                                h_diameter.data[i],
+                                                h_charge.data[i],
+                                                typ_j,
+                                                shape_j.orientation,
+                                                h_diameter.data[j],
+                                                h_charge.data[j]
+                                                );
                         }
 
                     if (overlap)
@@ -868,66 +884,56 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
                     hoomd::detail::AABB aabb = aabb_i_local;
                     aabb.translate(pos_i_image);
 
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                         {
-                        if (aabb.overlaps(m_aabb_tree.getNodeAABB(cur_node_idx)))
+                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                             {
-                            if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                            // read in its position and orientation
+                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                            Scalar4 postype_j;
+                            quat<LongReal> orientation_j;
+
+                            // handle j==i situations
+                            if ( j != i )
                                 {
-                                for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                // load the position and orientation of the j particle
+                                postype_j = h_postype.data[j];
+                                orientation_j = quat<LongReal>(h_orientation.data[j]);
+                                }
+                            else
+                                {
+                                if (cur_image == 0)
                                     {
-                                    // read in its position and orientation
-                                    unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    quat<LongReal> orientation_j;
-
-                                    // handle j==i situations
-                                    if ( j != i )
-                                        {
-                                        // load the position and orientation of the j particle
-                                        postype_j = h_postype.data[j];
-                                        orientation_j = quat<LongReal>(h_orientation.data[j]);
-                                        }
-                                    else
-                                        {
-                                        if (cur_image == 0)
-                                            {
-                                            // in the first image, skip i == j
-                                            continue;
-                                            }
-                                        else
-                                            {
-                                            // If this is particle i and we are in an outside image, use the translated position and orientation
-                                            postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
-                                            orientation_j = shape_old.orientation;
-                                            }
-                                        }
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(orientation_j, m_params[typ_j]);
-
-                                    // deltaU = U_old - U_new: add energy of old configuration
-                                    patch_field_energy_diff += computeOnePairEnergy(dot(r_ij, r_ij),
-                                                            r_ij,
-                                                            typ_i,
-                                                            shape_old.orientation,
-                                                            h_diameter.data[i],
-                                                            h_charge.data[i],
-                                                            typ_j,
-                                                            shape_j.orientation,
-                                                            h_diameter.data[j],
-                                                            h_charge.data[j]);
+                                    // in the first image, skip i == j
+                                    continue;
+                                    }
+                                else
+                                    {
+                                    // If this is particle i and we are in an outside image, use the translated position and orientation
+                                    postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
+                                    orientation_j = shape_old.orientation;
                                     }
                                 }
-                            }
-                        else
-                            {
-                            // skip ahead
-                            cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+
+                            // put particles in coordinate system of particle i
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            Shape shape_j(orientation_j, m_params[typ_j]);
+
+                            // deltaU = U_old - U_new: add energy of old configuration
+                            patch_field_energy_diff += computeOnePairEnergy(dot(r_ij, r_ij),
+                                                    r_ij,
+                                                    typ_i,
+                                                    shape_old.orientation,
+                                                    h_diameter.data[i],
+                                                    h_charge.data[i],
+                                                    typ_j,
+                                                    shape_j.orientation,
+                                                    h_diameter.data[j],
+                                                    h_charge.data[j]);
                             }
                         }  // end loop over AABB nodes
                     } // end loop over images
@@ -1025,9 +1031,12 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
             }
         }
 
-    // perform the grid shift
+    // perform the grid shift, which moves the cell boundaries for the checkerboard and the domain boundaries with MPI
+    bool shift_grid = checkerboard;
     #ifdef ENABLE_MPI
-    if (m_sysdef->isDomainDecomposed())
+    shift_grid = shift_grid || m_sysdef->isDomainDecomposed();
+    #endif
+    if (shift_grid)
         {
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
         ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
@@ -1054,7 +1063,6 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
             }
         this->m_pdata->translateOrigin(shift);
         }
-    #endif
 
     // migrate and exchange particles
     communicate(true);
@@ -1068,6 +1076,384 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
     m_mps = double(run_counters.getNMoves()) / cur_time;
     }
 
+/*! \param timestep Current time step
+    \param has_depletants True when implicit depletants are enabled
+    \returns true when the trial moves can be performed on a checkerboard of cells
+
+    The cells are at least as wide as the interaction range and trial moves that leave their cell
+    are rejected. Two active cells of the same set are separated by an inactive cell, so particles in
+    different active cells of one set never interact and the cells can be updated concurrently.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::setupCheckerboard(uint64_t timestep, bool has_depletants)
+    {
+    if (has_depletants)
+        {
+        if (!m_checkerboard_warning_issued)
+            {
+            m_exec_conf->msg->warning() << "Checkerboard trial moves do not support implicit depletants, "
+                                        << "performing serial trial moves." << std::endl;
+            m_checkerboard_warning_issued = true;
+            }
+        return false;
+        }
+
+    if (!m_checkerboard_cl)
+        {
+        m_checkerboard_cl = std::make_shared<CellList>(m_sysdef);
+        m_checkerboard_cl->setRadius(1);
+        m_checkerboard_cl->setComputeXYZF(false);
+        m_checkerboard_cl->setComputeIdx(true);
+        m_checkerboard_cl->setCompactLayout(true);
+        // an even number of cells keeps the parity of the cells consistent across periodic boundaries
+        m_checkerboard_cl->setMultiple(2);
+        }
+
+    if (m_checkerboard_cl->getNominalWidth() != m_nominal_width)
+        m_checkerboard_cl->setNominalWidth(m_nominal_width);
+
+    m_checkerboard_cl->compute(timestep);
+
+    // the minimum image convention needs at least two cells in every direction
+    const uint3 dim = m_checkerboard_cl->getDim();
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    if (dim.x < 2 || dim.y < 2 || (ndim == 3 && dim.z < 2))
+        {
+        if (!m_checkerboard_warning_issued)
+            {
+            m_exec_conf->msg->warning() << "Box is too small for checkerboard trial moves, "
+                                        << "performing serial trial moves." << std::endl;
+            m_checkerboard_warning_issued = true;
+            }
+        return false;
+        }
+
+    // sort the occupied cells into 4 (2D) or 8 (3D) sets of cells with the same parity
+    const Index3D& ci = m_checkerboard_cl->getCellIndexer();
+    ArrayHandle<unsigned int> h_cell_size(m_checkerboard_cl->getCellSizeArray(), access_location::host, access_mode::read);
+
+    m_checkerboard_sets.resize(ndim == 3 ? 8 : 4);
+    for (auto& cells : m_checkerboard_sets)
+        cells.clear();
+
+    for (unsigned int k = 0; k < dim.z; k++)
+        for (unsigned int j = 0; j < dim.y; j++)
+            for (unsigned int i = 0; i < dim.x; i++)
+                {
+                unsigned int cell = ci(i, j, k);
+                if (h_cell_size.data[cell] > 0)
+                    m_checkerboard_sets[(i % 2) + 2 * (j % 2) + 4 * (k % 2)].push_back(cell);
+                }
+
+    return true;
+    }
+
+/*! \param timestep Current time step
+    \param counters Counters to accumulate the trial move statistics in
+
+    Each of the nselect sweeps visits the sets of active cells in a random order. The cells of one set
+    are updated in parallel and the particles in one cell are moved sequentially, in forward or reverse
+    order. Particle i draws its trial move from the same random number stream as in the serial sweep,
+    so the trajectory does not depend on the number of threads.
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::updateCheckerboard(uint64_t timestep, hpmc_counters_t& counters)
+    {
+    const BoxDim box = m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+    uint16_t seed = m_sysdef->getSeed();
+    const unsigned int N = m_pdata->getN();
+
+    #ifdef ENABLE_MPI
+    // compute the width of the active region
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar3 ghost_fraction = m_nominal_width / npd;
+    #endif
+
+    // access particle data
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+    //access move sizes
+    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
+
+    // access interaction matrix
+    ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
+
+    // access the cell list, the particles stay in their cells for the whole time step
+    ArrayHandle<unsigned int> h_cell_size(m_checkerboard_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start(m_checkerboard_cl->getCellStartArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_idx(m_checkerboard_cl->getIndexArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_adj(m_checkerboard_cl->getCellAdjArray(), access_location::host, access_mode::read);
+    const Index3D ci = m_checkerboard_cl->getCellIndexer();
+    const Index2D cadji = m_checkerboard_cl->getCellAdjIndexer();
+    const uint3 dim = m_checkerboard_cl->getDim();
+    const Scalar3 ghost_width = m_checkerboard_cl->getGhostWidth();
+
+    // find the cell that contains a trial position, positions outside of the cell grid return an invalid cell
+    auto get_cell = [&](const vec3<Scalar>& pos) {
+        Scalar3 f = box.makeFraction(vec_to_scalar3(pos), ghost_width);
+        int ib = (int)slow::floor(f.x * dim.x);
+        int jb = (int)slow::floor(f.y * dim.y);
+        int kb = (int)slow::floor(f.z * dim.z);
+        if (ib < 0 || ib >= (int)dim.x || jb < 0 || jb >= (int)dim.y || kb < 0 || kb >= (int)dim.z)
+            return 0xffffffff;
+        return ci(ib, jb, kb);
+        };
+
+    // perform trial moves for the local particles in one cell
+    auto update_cell = [&](unsigned int cell, unsigned int i_nselect, hpmc_counters_t& cell_counters) {
+        // move the particles in the cell in forward or reverse order
+        hoomd::RandomGenerator rng_cell(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoCheckerboardCell, timestep, seed),
+                                        hoomd::Counter(cell, m_exec_conf->getRank(), i_nselect));
+        bool reverse = hoomd::UniformIntDistribution(1)(rng_cell);
+
+        const unsigned int start = h_cell_start.data[cell];
+        const unsigned int size = h_cell_size.data[cell];
+        for (unsigned int cur_particle = 0; cur_particle < size; cur_particle++)
+            {
+            unsigned int i = h_cell_idx.data[start + (reverse ? size - 1 - cur_particle : cur_particle)];
+
+            // ghost particles are never moved
+            if (i >= N)
+                continue;
+
+            // read in the current position and orientation
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+            #ifdef ENABLE_MPI
+            if (m_sysdef->isDomainDecomposed())
+                {
+                // only move particle if active
+                if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
+                    continue;
+                }
+            #endif
+
+            // make a trial move for i
+            hoomd::RandomGenerator rng_i(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoTrialMove, timestep, seed),
+                                         hoomd::Counter(i, m_exec_conf->getRank(), i_nselect));
+            int typ_i = __scalar_as_int(postype_i.w);
+            Shape shape_i(quat<LongReal>(h_orientation.data[i]), m_params[typ_i]);
+            unsigned int move_type_select = hoomd::UniformIntDistribution(0xffff)(rng_i);
+            bool move_type_translate = !shape_i.hasOrientation() || (move_type_select < m_translation_move_probability);
+
+            Shape shape_old(shape_i.orientation, m_params[typ_i]);
+            vec3<Scalar> pos_old = pos_i;
+
+            if (move_type_translate)
+                {
+                // skip if no overlap check is required
+                if (h_d.data[typ_i] == 0.0)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        cell_counters.translate_accept_count++;
+                    continue;
+                    }
+
+                move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
+
+                #ifdef ENABLE_MPI
+                if (m_sysdef->isDomainDecomposed())
+                    {
+                    // check if particle has moved into the ghost layer, and skip if it is
+                    if (!isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
+                        continue;
+                    }
+                #endif
+
+                // reject moves out of the cell, they could interact with particles in other active cells
+                if (get_cell(pos_i) != cell)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        cell_counters.translate_reject_count++;
+                    continue;
+                    }
+                }
+            else
+                {
+                if (h_a.data[typ_i] == 0.0)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        cell_counters.rotate_accept_count++;
+                    continue;
+                    }
+
+                if (ndim == 2)
+                    move_rotate<2>(shape_i.orientation, rng_i, h_a.data[typ_i]);
+                else
+                    move_rotate<3>(shape_i.orientation, rng_i, h_a.data[typ_i]);
+                }
+
+            bool overlap = false;
+
+            // patch + field interaction deltaU
+            double patch_field_energy_diff = 0;
+
+            // check for overlaps with the particles in the neighboring cells and compute the pair energy difference
+            const unsigned int n_adj = cadji.getW();
+            for (unsigned int cur_adj = 0; cur_adj < n_adj && !overlap; cur_adj++)
+                {
+                unsigned int neigh_cell = h_cell_adj.data[cadji(cur_adj, cell)];
+                unsigned int neigh_start = h_cell_start.data[neigh_cell];
+                unsigned int neigh_size = h_cell_size.data[neigh_cell];
+
+                for (unsigned int cur_neigh = 0; cur_neigh < neigh_size; cur_neigh++)
+                    {
+                    unsigned int j = h_cell_idx.data[neigh_start + cur_neigh];
+                    if (j == i)
+                        continue;
+
+                    // load the position and orientation of the j particle
+                    Scalar4 postype_j = h_postype.data[j];
+                    quat<LongReal> orientation_j(h_orientation.data[j]);
+                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                    Shape shape_j(orientation_j, m_params[typ_j]);
+
+                    // put particles in coordinate system of particle i, the cells are wide enough that
+                    // only the nearest image can interact
+                    vec3<Scalar> r_ij = box.minImage(vec3<Scalar>(postype_j) - pos_i);
+
+                    LongReal r_squared = dot(r_ij, r_ij);
+                    LongReal max_overlap_distance = m_shape_circumsphere_radius[typ_i] + m_shape_circumsphere_radius[typ_j];
+
+                    cell_counters.overlap_checks++;
+                    if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
+                        && r_squared < max_overlap_distance * max_overlap_distance
+                        && test_overlap(r_ij, shape_i, shape_j, cell_counters.overlap_err_count))
+                        {
+                        overlap = true;
+                        break;
+                        }
+
+                    if (hasPairInteractions())
+                        {
+                        vec3<Scalar> r_ij_old = box.minImage(vec3<Scalar>(postype_j) - pos_old);
+
+                        // deltaU = U_old - U_new
+                        patch_field_energy_diff += computeOnePairEnergy(dot(r_ij_old, r_ij_old),
+                                                r_ij_old,
+                                                typ_i,
+                                                shape_old.orientation,
+                                                h_diameter.data[i],
+                                                h_charge.data[i],
+                                                typ_j,
+                                                shape_j.orientation,
+                                                h_diameter.data[j],
+                                                h_charge.data[j]);
+                        patch_field_energy_diff -= computeOnePairEnergy(r_squared,
+                                                r_ij,
+                                                typ_i,
+                                                shape_i.orientation,
+                                                h_diameter.data[i],
+                                                h_charge.data[i],
+                                                typ_j,
+                                                shape_j.orientation,
+                                                h_diameter.data[j],
+                                                h_charge.data[j]);
+                        }
+                    }
+                } // end loop over neighboring cells
+
+            // Add external energetic contribution if there are no overlaps
+            if (!overlap)
+                {
+                // Legacy external field energy difference
+                if (m_external)
+                    {
+                    patch_field_energy_diff -= m_external->energydiff(timestep, i, pos_old, shape_old, pos_i, shape_i);
+                    }
+
+                // U_old - U_new
+                patch_field_energy_diff +=
+                    this->computeOneExternalEnergy(typ_i, pos_old, shape_old.orientation, h_charge.data[i], false) -
+                    this->computeOneExternalEnergy(typ_i, pos_i, shape_i.orientation, h_charge.data[i], true);
+                }
+
+            bool accept = !overlap && hoomd::detail::generate_canonical<double>(rng_i) < slow::exp(patch_field_energy_diff);
+
+            if (accept)
+                {
+                // increment accept counter and assign new position
+                if (!shape_i.ignoreStatistics())
+                    {
+                    if (move_type_translate)
+                        cell_counters.translate_accept_count++;
+                    else
+                        cell_counters.rotate_accept_count++;
+                    }
+
+                // update position of particle
+                h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
+
+                if (shape_i.hasOrientation())
+                    {
+                    h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                    }
+                }
+            else
+                {
+                if (!shape_i.ignoreStatistics())
+                    {
+                    // increment reject counter
+                    if (move_type_translate)
+                        cell_counters.translate_reject_count++;
+                    else
+                        cell_counters.rotate_reject_count++;
+                    }
+                }
+            } // end loop over particles in the cell
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific<hpmc_counters_t> thread_counters;
+    #endif
+
+    const unsigned int n_sets = (unsigned int)m_checkerboard_sets.size();
+    std::vector<unsigned int> set_order(n_sets);
+
+    for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
+        {
+        // visit the sets of active cells in a random order
+        hoomd::RandomGenerator rng_sets(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoCheckerboardSets, timestep, seed),
+                                        hoomd::Counter(m_exec_conf->getRank(), i_nselect));
+        for (unsigned int cur_set = 0; cur_set < n_sets; cur_set++)
+            set_order[cur_set] = cur_set;
+        for (unsigned int cur_set = n_sets - 1; cur_set > 0; cur_set--)
+            std::swap(set_order[cur_set], set_order[hoomd::UniformIntDistribution(cur_set)(rng_sets)]);
+
+        for (unsigned int cur_set = 0; cur_set < n_sets; cur_set++)
+            {
+            const std::vector<unsigned int>& cells = m_checkerboard_sets[set_order[cur_set]];
+
+            #ifdef ENABLE_TBB
+            m_exec_conf->getTaskArena()->execute([&]{
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, cells.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t cur_cell = r.begin(); cur_cell != r.end(); ++cur_cell)
+                    update_cell(cells[cur_cell], i_nselect, thread_counters.local());
+                });
+            });
+            #else
+            for (size_t cur_cell = 0; cur_cell < cells.size(); ++cur_cell)
+                update_cell(cells[cur_cell], i_nselect, counters);
+            #endif
+            }
+        } // end loop over nselect
+
+    #ifdef ENABLE_TBB
+    // reduce counters
+    for (auto i = thread_counters.begin(); i != thread_counters.end(); ++i)
+        {
+        counters = counters + *i;
+        }
+    #endif
+    }
+
 /*! \param timestep current step
     \param early_exit exit at first overlap found if true
     \returns number of overlaps if early_exit=false, 1 if early_exit=true
@@ -1111,52 +1497,42 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
             hoomd::detail::AABB aabb = aabb_i_local;
             aabb.translate(pos_i_image);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree, aabb);
+            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                 {
-                if (aabb.overlaps(m_aabb_tree.getNodeAABB(cur_node_idx)))
+                for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                     {
-                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                        {
-                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                    // read in its position and orientation
+                    unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
+                    // skip i==j in the 0 image
+                    if (cur_image == 0 && i == j)
+                        continue;
 
-                            Scalar4 postype_j = h_postype.data[j];
-                            Scalar4 orientation_j = h_orientation.data[j];
+                    Scalar4 postype_j = h_postype.data[j];
+                    Scalar4 orientation_j = h_orientation.data[j];
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                    // put particles in coordinate system of particle i
+                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                            unsigned int typ_j = __scalar_as_int(postype_j.w);
-                            Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                    Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
 
-                            if (h_tag.data[i] <= h_tag.data[j]
-                                && h_overlaps.data[m_overlap_idx(typ_i,typ_j)]
-                                && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                && test_overlap(r_ij, shape_i, shape_j, err_count)
-                                && test_overlap(-r_ij, shape_j, shape_i, err_count))
-                                {
-                                overlap_count++;
-                                if (early_exit)
-                                    {
-                                    // exit early from loop over neighbor particles
-                                    break;
-                                    }
-                                }
+                    if (h_tag.data[i] <= h_tag.data[j]
+                        && h_overlaps.data[m_overlap_idx(typ_i,typ_j)]
+                        && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                        && test_overlap(r_ij, shape_i, shape_j, err_count)
+                        && test_overlap(-r_ij, shape_j, shape_i, err_count))
+                        {
+                        overlap_count++;
+                        if (early_exit)
+                            {
+                            // exit early from loop over neighbor particles
+                            break;
                             }
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
 
                 if (overlap_count && early_exit)
                     {
@@ -1252,68 +1628,58 @@ double IntegratorHPMCMono<Shape>::computePairEnergy(uint64_t timestep, std::shar
             hoomd::detail::AABB aabb = aabb_i_local;
             aabb.translate(pos_i_image);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree, aabb);
+            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                 {
-                if (aabb.overlaps(m_aabb_tree.getNodeAABB(cur_node_idx)))
+                for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                     {
-                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                        {
-                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                    // read in its position and orientation
+                    unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
+                    // skip i==j in the 0 image
+                    if (cur_image == 0 && i == j)
+                        continue;
 
-                            const Scalar4 postype_j = h_postype.data[j];
-                            const quat<LongReal> orientation_j(h_orientation.data[j]);
-                            unsigned int typ_j = __scalar_as_int(postype_j.w);
-                            const Scalar d_j = h_diameter.data[j];
-                            const Scalar charge_j = h_charge.data[j];
+                    const Scalar4 postype_j = h_postype.data[j];
+                    const quat<LongReal> orientation_j(h_orientation.data[j]);
+                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                    const Scalar d_j = h_diameter.data[j];
+                    const Scalar charge_j = h_charge.data[j];
 
-                            // put particles in coordinate system of particle i
-                            const vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                    // put particles in coordinate system of particle i
+                    const vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                            // count unique pairs within range
-                            if (h_tag.data[i] <= h_tag.data[j])
-                                {
-                                LongReal r_squared = dot(r_ij, r_ij);
-                                if (selected_pair && r_squared < selected_pair->getRCutSquaredTotal(typ_i, typ_j))
-                                    {
-                                    energy += selected_pair->energy(r_squared,
-                                                                    r_ij,
-                                                                    typ_i,
-                                                                    orientation_i,
-                                                                    h_charge.data[i],
-                                                                    typ_j,
-                                                                    orientation_j,
-                                                                    h_charge.data[j]);
-                                    }
-                                else
-                                    {
-                                    energy += computeOnePairEnergy(r_squared,
-                                        r_ij,
-                                        typ_i,
-                                        orientation_i,
-                                        d_i,
-                                        charge_i,
-                                        typ_j,
-                                        orientation_j,
-                                        d_j,
-                                        charge_j);
-                                    }
-                                }
+                    // count unique pairs within range
+                    if (h_tag.data[i] <= h_tag.data[j])
+                        {
+                        LongReal r_squared = dot(r_ij, r_ij);
+                        if (selected_pair && r_squared < selected_pair->getRCutSquaredTotal(typ_i, typ_j))
+                            {
+                            energy += selected_pair->energy(r_squared,
+                                                            r_ij,
+                                                            typ_i,
+                                                            orientation_i,
+                                                            h_charge.data[i],
+                                                            typ_j,
+                                                            orientation_j,
+                                                            h_charge.data[j]);
+                            }
+                        else
+                            {
+                            energy += computeOnePairEnergy(r_squared,
+                                r_ij,
+                                typ_i,
+                                orientation_i,
+                                d_i,
+                                charge_i,
+                                typ_j,
+                                orientation_j,
+                                d_j,
+                                charge_j);
                             }
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
 
                 } // end loop over AABB nodes
             } // end loop over images
@@ -1712,10 +2078,16 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
 
     buildAABBTree() relies on the member variable m_aabb_tree_invalid to work correctly. Any time particles
     are moved (and not updated with m_aabb_tree->update()) or the particle list changes order, m_aabb_tree_invalid
-    needs to be set to true. Then buildAABBTree() will know to rebuild the tree from scratch on the next call. Typically
-    this is on the next timestep. But in some cases (i.e. NPT), the tree may need to be rebuilt several times in a
+    needs to be set to true. Then buildAABBTree() will know to update the tree on the next call. Typically
+    this is on the next timestep. But in some cases (i.e. NPT), the tree may need to be updated several times in a
     single step because of box volume moves.
 
+    When the number of particles and ghosts is unchanged and the particles have not been sorted since the last build,
+    buildAABBTree() refits the existing tree to the new particle AABBs in O(N) time. It rebuilds the tree from scratch
+    when the refit tree has degraded too much (see AABBTree::refit()), so that particles that diffuse away from their
+    original neighbors do not slow down the overlap checks. A refit tree finds the same overlaps as a rebuilt one, but
+    visits them in a different order, so summed pair energies may differ from those of a rebuilt tree by round off.
+
     Subclasses that override update() or other methods must be user to set m_aabb_tree_invalid appropriately, or
     erroneous simulations will result.
 
@@ -1763,7 +2135,12 @@ const hoomd::detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
                         m_aabbs[i] = hoomd::detail::AABB(vec3<Scalar>(h_postype.data[i]), radius);
                         }
                     }
-                m_aabb_tree.buildTree(m_aabbs, n_aabb);
+                if (m_aabb_tree_sorted || !m_aabb_tree.refit(m_aabbs, n_aabb))
+                    {
+                    m_exec_conf->msg->notice(9) << "Rebuilding AABB tree" << std::endl;
+                    m_aabb_tree.buildTree(m_aabbs, n_aabb);
+                    }
+                m_aabb_tree_sorted = false;
                 }
             }
 
@@ -1858,48 +2235,38 @@ std::vector<std::pair<unsigned int, unsigned int> > IntegratorHPMCMono<Shape>::m
             hoomd::detail::AABB aabb = aabb_i_local;
             aabb.translate(pos_i_image);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree, aabb);
+            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                 {
-                if (aabb.overlaps(m_aabb_tree.getNodeAABB(cur_node_idx)))
+                for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                     {
-                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                        {
-                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                    // read in its position and orientation
+                    unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                {
-                                continue;
-                                }
+                    // skip i==j in the 0 image
+                    if (cur_image == 0 && i == j)
+                        {
+                        continue;
+                        }
 
-                            Scalar4 postype_j = h_postype.data[j];
-                            Scalar4 orientation_j = h_orientation.data[j];
+                    Scalar4 postype_j = h_postype.data[j];
+                    Scalar4 orientation_j = h_orientation.data[j];
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                    // put particles in coordinate system of particle i
+                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                            Shape shape_j(quat<Scalar>(orientation_j), m_params[__scalar_as_int(postype_j.w)]);
+                    Shape shape_j(quat<Scalar>(orientation_j), m_params[__scalar_as_int(postype_j.w)]);
 
-                            if (h_tag.data[i] <= h_tag.data[j]
-                                && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                && test_overlap(r_ij, shape_i, shape_j, err_count)
-                                && test_overlap(-r_ij, shape_j, shape_i, err_count))
-                                {
-                                overlap_vector.push_back(std::make_pair(h_tag.data[i],
-                                                                        h_tag.data[j]));
-                                }
-                            }
+                    if (h_tag.data[i] <= h_tag.data[j]
+                        && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                        && test_overlap(r_ij, shape_i, shape_j, err_count)
+                        && test_overlap(-r_ij, shape_j, shape_i, err_count))
+                        {
+                        overlap_vector.push_back(std::make_pair(h_tag.data[i],
+                                                                h_tag.data[j]));
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
                 } // end loop over AABB nodes
             } // end loop over images
         } // end loop over particles
@@ -2014,61 +2381,51 @@ inline bool IntegratorHPMCMono<Shape>::checkDepletantOverlap(unsigned int i, vec
             hoomd::detail::AABB aabb = aabb_local;
             aabb.translate(pos_i_old_image);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree, aabb);
+            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                 {
-                if (aabb.overlaps(this->m_aabb_tree.getNodeAABB(cur_node_idx)))
+                for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                     {
-                    if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
-                        {
-                        for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                    // read in its position and orientation
+                    unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                            if (i == j && cur_image == 0) continue;
+                    if (i == j && cur_image == 0) continue;
 
-                            // load the old position and orientation of the j particle
-                            Scalar4 postype_j = h_postype[j];
-                            vec3<Scalar> pos_j(postype_j);
+                    // load the old position and orientation of the j particle
+                    Scalar4 postype_j = h_postype[j];
+                    vec3<Scalar> pos_j(postype_j);
 
-                            unsigned int typ_j = __scalar_as_int(postype_j.w);
-                            Shape shape_j(quat<Scalar>(), this->m_params[typ_j]);
-                            if (shape_j.hasOrientation())
-                                shape_j.orientation = quat<Scalar>(h_orientation[j]);
+                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                    Shape shape_j(quat<Scalar>(), this->m_params[typ_j]);
+                    if (shape_j.hasOrientation())
+                        shape_j.orientation = quat<Scalar>(h_orientation[j]);
 
-                            // get shape OBB
-                            detail::OBB obb_j = shape_j.getOBB(pos_j-this->m_image_list[cur_image]);
+                    // get shape OBB
+                    detail::OBB obb_j = shape_j.getOBB(pos_j-this->m_image_list[cur_image]);
 
-                            // extend by depletant radius
-                            Shape shape_test_a(quat<Scalar>(), m_params[type_a]);
+                    // extend by depletant radius
+                    Shape shape_test_a(quat<Scalar>(), m_params[type_a]);
 
-                            obb_j.lengths.x += r_dep_sample;
-                            obb_j.lengths.y += r_dep_sample;
-                            obb_j.lengths.z += r_dep_sample;
+                    obb_j.lengths.x += r_dep_sample;
+                    obb_j.lengths.y += r_dep_sample;
+                    obb_j.lengths.z += r_dep_sample;
 
-                            // check excluded volume overlap
-                            bool overlap_excluded = (h_overlaps[this->m_overlap_idx(type_a,typ_j)]
-                                    && detail::overlap(obb_j, obb_i_old));
+                    // check excluded volume overlap
+                    bool overlap_excluded = (h_overlaps[this->m_overlap_idx(type_a,typ_j)]
+                            && detail::overlap(obb_j, obb_i_old));
 
-                            if (overlap_excluded)
-                                {
-                                // cache the translated position of particle j. If i's image is cur_image, then j's
-                                // image is the negative of that (and we use i's untranslated position below)
-                                pos_j_old.push_back(pos_j-this->m_image_list[cur_image]);
-                                orientation_j_old.push_back(shape_j.orientation);
-                                type_j_old.push_back(typ_j);
-                                tag_j_old.push_back(h_tag[j]);
-                                seed_j_old.push_back(__scalar_as_int(h_vel[j].x));
-                                }
-                            }
+                    if (overlap_excluded)
+                        {
+                        // cache the translated position of particle j. If i's image is cur_image, then j's
+                        // image is the negative of that (and we use i's untranslated position below)
+                        pos_j_old.push_back(pos_j-this->m_image_list[cur_image]);
+                        orientation_j_old.push_back(shape_j.orientation);
+                        type_j_old.push_back(typ_j);
+                        tag_j_old.push_back(h_tag[j]);
+                        seed_j_old.push_back(__scalar_as_int(h_vel[j].x));
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
                 }  // end loop over AABB nodes
             } // end loop over images
 
@@ -2091,80 +2448,70 @@ inline bool IntegratorHPMCMono<Shape>::checkDepletantOverlap(unsigned int i, vec
             hoomd::detail::AABB aabb = aabb_local;
             aabb.translate(pos_i_image);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree, aabb);
+            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                 {
-                if (aabb.overlaps(this->m_aabb_tree.getNodeAABB(cur_node_idx)))
+                for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                     {
-                    if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    // read in its position and orientation
+                    unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                    unsigned int typ_j;
+                    vec3<Scalar> pos_j;
+                    if (i == j)
                         {
-                        for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        if (cur_image == 0)
+                            continue;
+                        else
                             {
-                            // read in its position and orientation
-                            unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                            unsigned int typ_j;
-                            vec3<Scalar> pos_j;
-                            if (i == j)
-                                {
-                                if (cur_image == 0)
-                                    continue;
-                                else
-                                    {
-                                    pos_j = pos_i;
-                                    typ_j = typ_i;
-                                    }
-                                }
-                            else
-                                {
-                                // load the old position and orientation of the j particle
-                                Scalar4 postype_j = h_postype[j];
-                                pos_j = vec3<Scalar>(postype_j);
-                                typ_j = __scalar_as_int(postype_j.w);
-                                }
+                            pos_j = pos_i;
+                            typ_j = typ_i;
+                            }
+                        }
+                    else
+                        {
+                        // load the old position and orientation of the j particle
+                        Scalar4 postype_j = h_postype[j];
+                        pos_j = vec3<Scalar>(postype_j);
+                        typ_j = __scalar_as_int(postype_j.w);
+                        }
 
-                            Shape shape_j(quat<Scalar>(), this->m_params[typ_j]);
+                    Shape shape_j(quat<Scalar>(), this->m_params[typ_j]);
 
-                            if (shape_j.hasOrientation())
-                                {
-                                if (i == j)
-                                    shape_j.orientation = shape_i.orientation;
-                                else
-                                    shape_j.orientation = quat<Scalar>(h_orientation[j]);
-                                }
+                    if (shape_j.hasOrientation())
+                        {
+                        if (i == j)
+                            shape_j.orientation = shape_i.orientation;
+                        else
+                            shape_j.orientation = quat<Scalar>(h_orientation[j]);
+                        }
 
-                            // get shape OBB
-                            detail::OBB obb_j = shape_j.getOBB(pos_j-this->m_image_list[cur_image]);
+                    // get shape OBB
+                    detail::OBB obb_j = shape_j.getOBB(pos_j-this->m_image_list[cur_image]);
 
-                            // extend by depletant radius
-                            Shape shape_test_a(quat<Scalar>(), m_params[type_a]);
+                    // extend by depletant radius
+                    Shape shape_test_a(quat<Scalar>(), m_params[type_a]);
 
-                            obb_j.lengths.x += r_dep_sample;
-                            obb_j.lengths.y += r_dep_sample;
-                            obb_j.lengths.z += r_dep_sample;
+                    obb_j.lengths.x += r_dep_sample;
+                    obb_j.lengths.y += r_dep_sample;
+                    obb_j.lengths.z += r_dep_sample;
 
-                            // check excluded volume overlap
-                            bool overlap_excluded = h_overlaps[this->m_overlap_idx(type_a,typ_j)] &&
-                                detail::overlap(obb_j, obb_i_new);
+                    // check excluded volume overlap
+                    bool overlap_excluded = h_overlaps[this->m_overlap_idx(type_a,typ_j)] &&
+                        detail::overlap(obb_j, obb_i_new);
 
-                            if (overlap_excluded)
-                                {
-                                // cache the translated position of particle j. If i's image is cur_image, then j's
-                                // image is the negative of that (and we use i's untranslated position below)
-                                pos_j_new.push_back(pos_j-this->m_image_list[cur_image]);
-                                orientation_j_new.push_back(shape_j.orientation);
-                                type_j_new.push_back(typ_j);
-                                tag_j_new.push_back(h_tag[j]);
-                                seed_j_new.push_back(__scalar_as_int(h_vel[j].x));
-                                }
-                            }
+                    if (overlap_excluded)
+                        {
+                        // cache the translated position of particle j. If i's image is cur_image, then j's
+                        // image is the negative of that (and we use i's untranslated position below)
+                        pos_j_new.push_back(pos_j-this->m_image_list[cur_image]);
+                        orientation_j_new.push_back(shape_j.orientation);
+                        type_j_new.push_back(typ_j);
+                        tag_j_new.push_back(h_tag[j]);
+                        seed_j_new.push_back(__scalar_as_int(h_vel[j].x));
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
                 }  // end loop over AABB nodes
             } // end loop over images
 
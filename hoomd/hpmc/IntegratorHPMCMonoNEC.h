@@ -666,69 +666,60 @@ bool IntegratorHPMCMonoNEC<Shape>::checkForOverlap(unsigned int i,
         hoomd::detail::AABB aabb = aabb_i_local;
         aabb.translate(pos_i_image);
 
-        // stackless search
-        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes();
-             cur_node_idx++)
+        // traverse the wide BVH of the tree
+        hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree, aabb);
+        for (unsigned int cur_node_idx = traversal.next();
+             cur_node_idx != hoomd::detail::INVALID_NODE;
+             cur_node_idx = traversal.next())
             {
-            if (aabb.overlaps(this->m_aabb_tree.getNodeAABB(cur_node_idx)))
+            for (unsigned int cur_p = 0;
+                 cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx);
+                 cur_p++)
                 {
-                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
-                    {
-                    for (unsigned int cur_p = 0;
-                         cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx);
-                         cur_p++)
-                        {
-                        // read in its position and orientation
-                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                // read in its position and orientation
+                unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                        Scalar4 postype_j;
-                        Scalar4 orientation_j;
+                Scalar4 postype_j;
+                Scalar4 orientation_j;
 
-                        // handle j==i situations
-                        if (j != i)
-                            {
-                            // load the position and orientation of the j particle
-                            postype_j = h_postype.data[j];
-                            orientation_j = h_orientation.data[j];
-                            }
-                        else
-                            {
-                            if (cur_image == 0)
-                                {
-                                // in the first image, skip i == j
-                                continue;
-                                }
-                            else
-                                {
-                                // If this is particle i and we are in an outside image, use the
-                                // translated position and orientation
-                                postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
-                                orientation_j = quat_to_scalar4(shape_i.orientation);
-                                }
-                            }
+                // handle j==i situations
+                if (j != i)
+                    {
+                    // load the position and orientation of the j particle
+                    postype_j = h_postype.data[j];
+                    orientation_j = h_orientation.data[j];
+                    }
+                else
+                    {
+                    if (cur_image == 0)
+                        {
+                        // in the first image, skip i == j
+                        continue;
+                        }
+                    else
+                        {
+                        // If this is particle i and we are in an outside image, use the
+                        // translated position and orientation
+                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+                        orientation_j = quat_to_scalar4(shape_i.orientation);
+                        }
+                    }
 
-                        // put particles in coordinate system of particle i
-                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                // put particles in coordinate system of particle i
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                        unsigned int typ_j = __scalar_as_int(postype_j.w);
-                        Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
 
-                        counters.overlap_checks++;
-                        if (h_overlaps.data[this->m_overlap_idx(typ_i, typ_j)]
-                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                            && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
-                            {
-                            overlap = true;
-                            break;
-                            }
-                        }
+                counters.overlap_checks++;
+                if (h_overlaps.data[this->m_overlap_idx(typ_i, typ_j)]
+                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                    {
+                    overlap = true;
+                    break;
                     }
                 }
-            else
-                {
-                // skip ahead
-                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
-                }
 
             if (overlap)
                 break;
@@ -777,105 +768,96 @@ double IntegratorHPMCMonoNEC<Shape>::sweepDistance(vec3<Scalar>& direction,
         hoomd::detail::AABB aabb = aabb_i_test;
         aabb.translate(pos_i_image);
 
-        // stackless search
-        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes();
-             cur_node_idx++)
+        // traverse the wide BVH of the tree
+        hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree, aabb);
+        for (unsigned int cur_node_idx = traversal.next();
+             cur_node_idx != hoomd::detail::INVALID_NODE;
+             cur_node_idx = traversal.next())
             {
-            if (aabb.overlaps(this->m_aabb_tree.getNodeAABB(cur_node_idx)))
+            for (unsigned int cur_p = 0;
+                 cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx);
+                 cur_p++)
                 {
-                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                // read in its position and orientation
+                unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                Scalar4 postype_j;
+                Scalar4 orientation_j;
+
+                // handle j==i situations
+                if (j != i)
                     {
-                    for (unsigned int cur_p = 0;
-                         cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx);
-                         cur_p++)
+                    // load the position and orientation of the j particle
+                    postype_j = h_postype.data[j];
+                    orientation_j = h_orientation.data[j];
+                    }
+                else
+                    {
+                    if (cur_image == 0)
                         {
-                        // read in its position and orientation
-                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                        Scalar4 postype_j;
-                        Scalar4 orientation_j;
+                        // in the first image, skip i == j
+                        continue;
+                        }
+                    else
+                        {
+                        // If this is particle i and we are in an outside image, use the
+                        // translated position and orientation
+                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+                        orientation_j = quat_to_scalar4(shape_i.orientation);
+                        }
+                    }
 
-                        // handle j==i situations
-                        if (j != i)
-                            {
-                            // load the position and orientation of the j particle
-                            postype_j = h_postype.data[j];
-                            orientation_j = h_orientation.data[j];
-                            }
-                        else
-                            {
-                            if (cur_image == 0)
-                                {
-                                // in the first image, skip i == j
-                                continue;
-                                }
-                            else
-                                {
-                                // If this is particle i and we are in an outside image, use the
-                                // translated position and orientation
-                                postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
-                                orientation_j = quat_to_scalar4(shape_i.orientation);
-                                }
-                            }
+                // put particles in coordinate system of particle i
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
-                        // put particles in coordinate system of particle i
-                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
 
-                        unsigned int typ_j = __scalar_as_int(postype_j.w);
-                        Shape shape_j(quat<Scalar>(orientation_j), this->m_params[typ_j]);
+                nec_counters.distance_queries++;
 
-                        nec_counters.distance_queries++;
+                if (h_overlaps.data[this->m_overlap_idx(typ_i, typ_j)])
+                    {
+                    double maxR = shape_i.getCircumsphereDiameter()
+                                  + shape_j.getCircumsphereDiameter();
+                    maxR /= 2;
+                    maxR += sweepableDistance;
 
-                        if (h_overlaps.data[this->m_overlap_idx(typ_i, typ_j)])
+                    if (dot(r_ij, r_ij) < maxR * maxR)
+                        {
+                        double newDist = sweep_distance(r_ij,
+                                                        shape_i,
+                                                        shape_j,
+                                                        direction,
+                                                        nec_counters.overlap_err_count,
+                                                        newCollisionPlaneVector);
+
+                        if (newDist >= 0.0 and newDist < sweepableDistance)
                             {
-                            double maxR = shape_i.getCircumsphereDiameter()
-                                          + shape_j.getCircumsphereDiameter();
-                            maxR /= 2;
-                            maxR += sweepableDistance;
-
-                            if (dot(r_ij, r_ij) < maxR * maxR)
+                            collisionPlaneVector = newCollisionPlaneVector;
+                            sweepableDistance = newDist;
+                            next = j;
+                            }
+                        else
+                            {
+                            if (newDist < -3.5) // resultOverlapping = -3.0;
                                 {
-                                double newDist = sweep_distance(r_ij,
-                                                                shape_i,
-                                                                shape_j,
-                                                                direction,
-                                                                nec_counters.overlap_err_count,
-                                                                newCollisionPlaneVector);
-
-                                if (newDist >= 0.0 and newDist < sweepableDistance)
+                                if (dot(r_ij, direction) > 0)
                                     {
                                     collisionPlaneVector = newCollisionPlaneVector;
-                                    sweepableDistance = newDist;
                                     next = j;
+                                    sweepableDistance = 0.0;
                                     }
-                                else
-                                    {
-                                    if (newDist < -3.5) // resultOverlapping = -3.0;
-                                        {
-                                        if (dot(r_ij, direction) > 0)
-                                            {
-                                            collisionPlaneVector = newCollisionPlaneVector;
-                                            next = j;
-                                            sweepableDistance = 0.0;
-                                            }
-                                        }
-
-                                    if (newDist == sweepableDistance)
-                                        {
-                                        this->m_exec_conf->msg->error()
-                                            << "Two particles with the same distance\n";
-                                        }
-                                    }
+                                }
+
+                            if (newDist == sweepableDistance)
+                                {
+                                this->m_exec_conf->msg->error()
+                                    << "Two particles with the same distance\n";
                                 }
                             }
                         }
                     }
                 }
-            else
-                {
-                // skip ahead
-                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
-                }
             } // end loop over AABB nodes
         } // end loop over images
 
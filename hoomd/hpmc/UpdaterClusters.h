@@ -557,48 +557,38 @@ inline void UpdaterClusters<Shape>::checkDepletantOverlap(unsigned int i, vec3<S
                 hoomd::detail::AABB aabb = aabb_local;
                 aabb.translate(pos_i_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree_old.getNumNodes(); cur_node_idx++)
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree_old, aabb);
+                for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                     {
-                    if (aabb.overlaps(this->m_aabb_tree_old.getNodeAABB(cur_node_idx)))
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
                         {
-                        if (this->m_aabb_tree_old.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = this->m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = this->m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
 
-                                if (i == j && cur_image == 0) continue;
+                        if (i == j && cur_image == 0) continue;
 
-                                // load the position and orientation of the j particle
-                                vec3<Scalar> pj = vec3<Scalar>(h_postype_backup[j]);
-                                unsigned int typ_j = __scalar_as_int(h_postype_backup[j].w);
-                                Shape shape_j(quat<Scalar>(h_orientation_backup[j]), params[typ_j]);
+                        // load the position and orientation of the j particle
+                        vec3<Scalar> pj = vec3<Scalar>(h_postype_backup[j]);
+                        unsigned int typ_j = __scalar_as_int(h_postype_backup[j].w);
+                        Shape shape_j(quat<Scalar>(h_orientation_backup[j]), params[typ_j]);
 
-                                // check excluded volume overlap
-                                bool overlap_excluded = h_overlaps[overlap_idx(type_a,typ_j)] &&
-                                    h_overlaps[overlap_idx(type_b,typ_j)] &&
-                                    excludedVolumeOverlap(shape_i, shape_j, pj-pos_i_image, r_dep_sample,
-                                    ndim, detail::SamplingMethod::accurate);
+                        // check excluded volume overlap
+                        bool overlap_excluded = h_overlaps[overlap_idx(type_a,typ_j)] &&
+                            h_overlaps[overlap_idx(type_b,typ_j)] &&
+                            excludedVolumeOverlap(shape_i, shape_j, pj-pos_i_image, r_dep_sample,
+                            ndim, detail::SamplingMethod::accurate);
 
-                                if (overlap_excluded)
-                                    {
-                                    // cache the translated position of particle j. If i's image is cur_image, then j's
-                                    // image is the negative of that (and we use i's untranslated position below)
-                                    pos_j.push_back(pj-image_list[cur_image]);
-                                    orientation_j.push_back(shape_j.orientation);
-                                    type_j.push_back(typ_j);
-                                    idx_j.push_back(j);
-                                    }
-                                }
+                        if (overlap_excluded)
+                            {
+                            // cache the translated position of particle j. If i's image is cur_image, then j's
+                            // image is the negative of that (and we use i's untranslated position below)
+                            pos_j.push_back(pj-image_list[cur_image]);
+                            orientation_j.push_back(shape_j.orientation);
+                            type_j.push_back(typ_j);
+                            idx_j.push_back(j);
                             }
                         }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += this->m_aabb_tree_old.getNodeSkip(cur_node_idx);
-                        }
                     }  // end loop over AABB nodes
                 } // end loop over images
 
@@ -903,45 +893,35 @@ inline void UpdaterClusters<Shape>::checkDepletantOverlap(unsigned int i, vec3<S
                         hoomd::detail::AABB aabb = aabb_a_local;
                         aabb.translate(pos_test_image);
 
-                        // stackless search
-                        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree_old.getNumNodes(); cur_node_idx++)
+                        // traverse the wide BVH of the tree
+                        hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree_old, aabb);
+                        for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                             {
-                            if (aabb.overlaps(this->m_aabb_tree_old.getNodeAABB(cur_node_idx)))
+                            for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
                                 {
-                                if (this->m_aabb_tree_old.isNodeLeaf(cur_node_idx))
+                                // read in its position and orientation
+                                unsigned int j = this->m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
+
+                                // load the position and orientation of the j particle
+                                vec3<Scalar> pj = vec3<Scalar>(h_postype_backup[j]);
+                                unsigned int typ_j = __scalar_as_int(h_postype_backup[j].w);
+                                Shape shape_j(quat<Scalar>(h_orientation_backup[j]), params[typ_j]);
+
+                                // check excluded volume overlap
+                                vec3<Scalar> r_jk(pos_test_image - pj);
+                                ShortReal rsq = (ShortReal) dot(r_jk,r_jk);
+                                ShortReal DaDb = shape_test_transf_a.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+                                unsigned int err = 0;
+                                if (h_overlaps[overlap_idx(type_a, typ_j)] &&
+                                    (rsq*ShortReal(4.0) <= DaDb * DaDb) &&
+                                    test_overlap(r_jk, shape_j, shape_test_transf_a, err) &&
+                                    ((type_a == type_b) || (h_overlaps[overlap_idx(type_b, typ_j)] &&
+                                    test_overlap(r_jk, shape_j, shape_test_transf_b, err))))
                                     {
-                                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
-                                        {
-                                        // read in its position and orientation
-                                        unsigned int j = this->m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
-
-                                        // load the position and orientation of the j particle
-                                        vec3<Scalar> pj = vec3<Scalar>(h_postype_backup[j]);
-                                        unsigned int typ_j = __scalar_as_int(h_postype_backup[j].w);
-                                        Shape shape_j(quat<Scalar>(h_orientation_backup[j]), params[typ_j]);
-
-                                        // check excluded volume overlap
-                                        vec3<Scalar> r_jk(pos_test_image - pj);
-                                        ShortReal rsq = (ShortReal) dot(r_jk,r_jk);
-                                        ShortReal DaDb = shape_test_transf_a.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
-                                        unsigned int err = 0;
-                                        if (h_overlaps[overlap_idx(type_a, typ_j)] &&
-                                            (rsq*ShortReal(4.0) <= DaDb * DaDb) &&
-                                            test_overlap(r_jk, shape_j, shape_test_transf_a, err) &&
-                                            ((type_a == type_b) || (h_overlaps[overlap_idx(type_b, typ_j)] &&
-                                            test_overlap(r_jk, shape_j, shape_test_transf_b, err))))
-                                            {
-                                            overlap_old = true;
-                                            break;
-                                            }
-                                        }
+                                    overlap_old = true;
+                                    break;
                                     }
                                 }
-                            else
-                                {
-                                // skip ahead
-                                cur_node_idx += this->m_aabb_tree_old.getNodeSkip(cur_node_idx);
-                                }
                             }  // end loop over AABB nodes
                         if (overlap_old)
                             break;
@@ -956,45 +936,35 @@ inline void UpdaterClusters<Shape>::checkDepletantOverlap(unsigned int i, vec3<S
                             hoomd::detail::AABB aabb = aabb_b_local;
                             aabb.translate(pos_test_image);
 
-                            // stackless search
-                            for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree_old.getNumNodes(); cur_node_idx++)
+                            // traverse the wide BVH of the tree
+                            hoomd::detail::AABBTreeTraversal traversal(this->m_aabb_tree_old, aabb);
+                            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                                 {
-                                if (aabb.overlaps(this->m_aabb_tree_old.getNodeAABB(cur_node_idx)))
+                                for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
                                     {
-                                    if (this->m_aabb_tree_old.isNodeLeaf(cur_node_idx))
+                                    // read in its position and orientation
+                                    unsigned int j = this->m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
+
+                                    // load the position and orientation of the j particle
+                                    vec3<Scalar> pj = vec3<Scalar>(h_postype_backup[j]);
+                                    unsigned int typ_j = __scalar_as_int(h_postype_backup[j].w);
+                                    Shape shape_j(quat<Scalar>(h_orientation_backup[j]), params[typ_j]);
+
+                                    // check excluded volume overlap
+                                    vec3<Scalar> r_jk(pos_test_image - pj);
+                                    ShortReal rsq = (ShortReal) dot(r_jk,r_jk);
+                                    ShortReal DaDb = shape_test_transf_b.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+                                    unsigned int err = 0;
+                                    if (h_overlaps[overlap_idx(type_b, typ_j)] &&
+                                        (rsq*ShortReal(4.0) <= DaDb * DaDb) &&
+                                        test_overlap(r_jk, shape_j, shape_test_transf_b, err) &&
+                                        h_overlaps[overlap_idx(type_b, typ_j)] &&
+                                        test_overlap(r_jk, shape_j, shape_test_transf_b, err))
                                         {
-                                        for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
-                                            {
-                                            // read in its position and orientation
-                                            unsigned int j = this->m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
-
-                                            // load the position and orientation of the j particle
-                                            vec3<Scalar> pj = vec3<Scalar>(h_postype_backup[j]);
-                                            unsigned int typ_j = __scalar_as_int(h_postype_backup[j].w);
-                                            Shape shape_j(quat<Scalar>(h_orientation_backup[j]), params[typ_j]);
-
-                                            // check excluded volume overlap
-                                            vec3<Scalar> r_jk(pos_test_image - pj);
-                                            ShortReal rsq = (ShortReal) dot(r_jk,r_jk);
-                                            ShortReal DaDb = shape_test_transf_b.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
-                                            unsigned int err = 0;
-                                            if (h_overlaps[overlap_idx(type_b, typ_j)] &&
-                                                (rsq*ShortReal(4.0) <= DaDb * DaDb) &&
-                                                test_overlap(r_jk, shape_j, shape_test_transf_b, err) &&
-                                                h_overlaps[overlap_idx(type_b, typ_j)] &&
-                                                test_overlap(r_jk, shape_j, shape_test_transf_b, err))
-                                                {
-                                                overlap_old = true;
-                                                break;
-                                                }
-                                            }
+                                        overlap_old = true;
+                                        break;
                                         }
                                     }
-                                else
-                                    {
-                                    // skip ahead
-                                    cur_node_idx += this->m_aabb_tree_old.getNodeSkip(cur_node_idx);
-                                    }
                                 }  // end loop over AABB nodes
                             if (overlap_old)
                                 break;
@@ -1221,65 +1191,55 @@ void UpdaterClusters<Shape>::findInteractions(uint64_t timestep, const quat<Scal
                 hoomd::detail::AABB aabb_i_image = aabb_local;
                 aabb_i_image.translate(pos_i_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree_old.getNumNodes(); cur_node_idx++)
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree_old, aabb_i_image);
+                for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                     {
-                    if (aabb_i_image.overlaps(m_aabb_tree_old.getNodeAABB(cur_node_idx)))
+                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
                         {
-                        if (m_aabb_tree_old.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
 
-                                if (i == j && cur_image == 0) continue;
+                        if (i == j && cur_image == 0) continue;
 
-                                // load the position and orientation of the j particle
-                                vec3<Scalar> pos_j = vec3<Scalar>(h_postype_backup.data[j]);
-                                unsigned int typ_j = __scalar_as_int(h_postype_backup.data[j].w);
+                        // load the position and orientation of the j particle
+                        vec3<Scalar> pos_j = vec3<Scalar>(h_postype_backup.data[j]);
+                        unsigned int typ_j = __scalar_as_int(h_postype_backup.data[j].w);
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = pos_j - pos_i_image;
-                                Scalar rsq_ij = dot(r_ij, r_ij);
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = pos_j - pos_i_image;
+                        Scalar rsq_ij = dot(r_ij, r_ij);
 
-                                Scalar rcut_ij = r_cut_patch + extent_i + 0.5*m_mc->getMaxPairInteractionAdditiveRCut(typ_j);
+                        Scalar rcut_ij = r_cut_patch + extent_i + 0.5*m_mc->getMaxPairInteractionAdditiveRCut(typ_j);
 
-                                if (rsq_ij <= rcut_ij*rcut_ij)
-                                    {
-                                    // the particle pair
-                                    auto p = std::make_pair(i,j);
+                        if (rsq_ij <= rcut_ij*rcut_ij)
+                            {
+                            // the particle pair
+                            auto p = std::make_pair(i,j);
 
-                                    // if particle interacts in different image already, add to that energy
-                                    LongReal U = 0.0;
-                                        {
-                                        auto it_energy = m_energy_old_old.find(p);
-                                        if (it_energy != m_energy_old_old.end())
-                                            U = it_energy->second;
-                                        }
+                            // if particle interacts in different image already, add to that energy
+                            LongReal U = 0.0;
+                                {
+                                auto it_energy = m_energy_old_old.find(p);
+                                if (it_energy != m_energy_old_old.end())
+                                    U = it_energy->second;
+                                }
 
-                                    U += m_mc->computeOnePairEnergy(rsq_ij,
-                                                        r_ij, typ_i,
-                                                        orientation_i,
-                                                        d_i,
-                                                        charge_i,
-                                                        typ_j,
-                                                        quat<LongReal>(h_orientation_backup.data[j]),
-                                                        h_diameter.data[j],
-                                                        h_charge.data[j]);
-
-                                    // update map
-                                    m_energy_old_old[p] = U;
-                                    } // end if overlap
-
-                                } // end loop over AABB tree leaf
-                            } // end is leaf
-                        } // end if overlap
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += m_aabb_tree_old.getNodeSkip(cur_node_idx);
-                        }
+                            U += m_mc->computeOnePairEnergy(rsq_ij,
+                                                r_ij, typ_i,
+                                                orientation_i,
+                                                d_i,
+                                                charge_i,
+                                                typ_j,
+                                                quat<LongReal>(h_orientation_backup.data[j]),
+                                                h_diameter.data[j],
+                                                h_charge.data[j]);
+
+                            // update map
+                            m_energy_old_old[p] = U;
+                            } // end if overlap
+
+                        } // end loop over AABB tree leaf
 
                     } // end loop over nodes
 
@@ -1322,52 +1282,42 @@ void UpdaterClusters<Shape>::findInteractions(uint64_t timestep, const quat<Scal
             hoomd::detail::AABB aabb_i_image = aabb_i_local;
             aabb_i_image.translate(pos_i_image);
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree_old.getNumNodes(); cur_node_idx++)
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree_old, aabb_i_image);
+            for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                 {
-                if (aabb_i_image.overlaps(m_aabb_tree_old.getNodeAABB(cur_node_idx)))
+                for (unsigned int cur_p = 0; cur_p < m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
                     {
-                    if (m_aabb_tree_old.isNodeLeaf(cur_node_idx))
-                        {
-                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
+                    // read in its position and orientation
+                    unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
 
-                            if (i == j && cur_image == 0) continue;
+                    if (i == j && cur_image == 0) continue;
 
-                            // load the position and orientation of the j particle
-                            vec3<Scalar> pos_j = vec3<Scalar>(h_postype_backup.data[j]);
-                            unsigned int typ_j = __scalar_as_int(h_postype_backup.data[j].w);
-                            Shape shape_j(quat<Scalar>(h_orientation_backup.data[j]), params[typ_j]);
+                    // load the position and orientation of the j particle
+                    vec3<Scalar> pos_j = vec3<Scalar>(h_postype_backup.data[j]);
+                    unsigned int typ_j = __scalar_as_int(h_postype_backup.data[j].w);
+                    Shape shape_j(quat<Scalar>(h_orientation_backup.data[j]), params[typ_j]);
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = pos_j - pos_i_image;
+                    // put particles in coordinate system of particle i
+                    vec3<Scalar> r_ij = pos_j - pos_i_image;
 
-                            // check for circumsphere overlap
-                            Scalar r_excl_j = shape_j.getCircumsphereDiameter()/Scalar(2.0);
-                            Scalar RaRb = r_excl_i + r_excl_j;
-                            Scalar rsq_ij = dot(r_ij, r_ij);
+                    // check for circumsphere overlap
+                    Scalar r_excl_j = shape_j.getCircumsphereDiameter()/Scalar(2.0);
+                    Scalar RaRb = r_excl_i + r_excl_j;
+                    Scalar rsq_ij = dot(r_ij, r_ij);
 
-                            unsigned int err = 0;
-                            if (rsq_ij <= RaRb*RaRb)
-                                {
-                                if (h_overlaps.data[overlap_idx(typ_i,typ_j)]
-                                    && test_overlap(r_ij, shape_i, shape_j, err))
-                                    {
-                                    // add connection
-                                    m_overlap.insert(std::make_pair(i,j));
-                                    } // end if overlap
-                                }
+                    unsigned int err = 0;
+                    if (rsq_ij <= RaRb*RaRb)
+                        {
+                        if (h_overlaps.data[overlap_idx(typ_i,typ_j)]
+                            && test_overlap(r_ij, shape_i, shape_j, err))
+                            {
+                            // add connection
+                            m_overlap.insert(std::make_pair(i,j));
+                            } // end if overlap
+                        }
 
-                            } // end loop over AABB tree leaf
-                        } // end is leaf
-                    } // end if overlap
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += m_aabb_tree_old.getNodeSkip(cur_node_idx);
-                    }
+                    } // end loop over AABB tree leaf
 
                 } // end loop over nodes
             } // end loop over images
@@ -1387,65 +1337,55 @@ void UpdaterClusters<Shape>::findInteractions(uint64_t timestep, const quat<Scal
                 hoomd::detail::AABB aabb_i_image = aabb_local;
                 aabb_i_image.translate(pos_i_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree_old.getNumNodes(); cur_node_idx++)
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree_old, aabb_i_image);
+                for (unsigned int cur_node_idx = traversal.next(); cur_node_idx != hoomd::detail::INVALID_NODE; cur_node_idx = traversal.next())
                     {
-                    if (aabb_i_image.overlaps(m_aabb_tree_old.getNodeAABB(cur_node_idx)))
+                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
                         {
-                        if (m_aabb_tree_old.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree_old.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
 
-                                if (i == j && cur_image == 0) continue;
+                        if (i == j && cur_image == 0) continue;
 
-                                vec3<Scalar> pos_j(h_postype_backup.data[j]);
-                                unsigned int typ_j = __scalar_as_int(h_postype_backup.data[j].w);
+                        vec3<Scalar> pos_j(h_postype_backup.data[j]);
+                        unsigned int typ_j = __scalar_as_int(h_postype_backup.data[j].w);
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = pos_j - pos_i_image;
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = pos_j - pos_i_image;
 
-                                // check for excluded volume sphere overlap
-                                Scalar rsq_ij = dot(r_ij, r_ij);
+                        // check for excluded volume sphere overlap
+                        Scalar rsq_ij = dot(r_ij, r_ij);
 
-                                Scalar rcut_ij = r_cut_patch + extent_i + 0.5*m_mc->getMaxPairInteractionAdditiveRCut(typ_j);
+                        Scalar rcut_ij = r_cut_patch + extent_i + 0.5*m_mc->getMaxPairInteractionAdditiveRCut(typ_j);
 
-                                if (rsq_ij <= rcut_ij*rcut_ij)
-                                    {
-                                    auto p = std::make_pair(i, j);
+                        if (rsq_ij <= rcut_ij*rcut_ij)
+                            {
+                            auto p = std::make_pair(i, j);
 
-                                    // if particle interacts in different image already, add to that energy
-                                    LongReal U = 0.0;
-                                        {
-                                        auto it_energy = m_energy_new_old.find(p);
-                                        if (it_energy != m_energy_new_old.end())
-                                            U = it_energy->second;
-                                        }
+                            // if particle interacts in different image already, add to that energy
+                            LongReal U = 0.0;
+                                {
+                                auto it_energy = m_energy_new_old.find(p);
+                                if (it_energy != m_energy_new_old.end())
+                                    U = it_energy->second;
+                                }
 
-                                    U += m_mc->computeOnePairEnergy(rsq_ij,
-                                                        r_ij,
-                                                        typ_i,
-                                                        shape_i.orientation,
-                                                        h_diameter.data[i],
-                                                        h_charge.data[i],
-                                                        typ_j,
-                                                        quat<LongReal>(h_orientation_backup.data[j]),
-                                                        h_diameter.data[j],
-                                                        h_charge.data[j]);
-
-                                    // update map
-                                    m_energy_new_old[p] = U;
-                                    }
-                                } // end loop over AABB tree leaf
-                            } // end is leaf
-                        } // end if overlap
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += m_aabb_tree_old.getNodeSkip(cur_node_idx);
-                        }
+                            U += m_mc->computeOnePairEnergy(rsq_ij,
+                                                r_ij,
+                                                typ_i,
+                                                shape_i.orientation,
+                                                h_diameter.data[i],
+                                                h_charge.data[i],
+                                                typ_j,
+                                                quat<LongReal>(h_orientation_backup.data[j]),
+                                                h_diameter.data[j],
+                                                h_charge.data[j]);
+
+                            // update map
+                            m_energy_new_old[p] = U;
+                            }
+                        } // end loop over AABB tree leaf
 
                     } // end loop over nodes
 
@@ -5,6 +5,7 @@
 #define __UPDATER_MUVT_H__
 
 #include "hoomd/HOOMDMPI.h"
+#include "hoomd/ForEachRange.h"
 #include "hoomd/Updater.h"
 #include "hoomd/Variant.h"
 #include "hoomd/VectorMath.h"
@@ -147,6 +148,26 @@ template<class Shape> class UpdaterMuVT : public Updater
         return m_n_trial;
         }
 
+    //! Set the number of insertion and removal moves per update (grand canonical ensemble only)
+    void setBatchSize(unsigned int batch_size)
+        {
+        if (batch_size == 0)
+            {
+            throw std::domain_error("batch_size must be greater than zero.");
+            }
+        if (batch_size > 1 && m_gibbs)
+            {
+            throw std::runtime_error("batch_size > 1 is not supported in the Gibbs ensemble.");
+            }
+        m_batch_size = batch_size;
+        }
+
+    //! Get the number of insertion and removal moves per update
+    unsigned int getBatchSize()
+        {
+        return m_batch_size;
+        }
+
     //! Get the current counter values
     hpmc_muvt_counters_t getCounters(unsigned int mode = 0);
 
@@ -178,6 +199,7 @@ template<class Shape> class UpdaterMuVT : public Updater
     GPUVector<Scalar> m_diameter_backup;     //!< Backup of particle diameters for volume move
 
     unsigned int m_n_trial;
+    unsigned int m_batch_size; //!< Number of insertion and removal moves per update
 
     /*! Check for overlaps of a fictitious particle
      * \param timestep Current time step
@@ -193,6 +215,21 @@ template<class Shape> class UpdaterMuVT : public Updater
                                    quat<Scalar> orientation,
                                    Scalar& lnboltzmann);
 
+    //! Check for overlaps of a fictitious particle with the local particles
+    bool tryInsertParticleLocal(unsigned int type,
+                                const vec3<Scalar>& pos,
+                                const quat<Scalar>& orientation,
+                                const hoomd::detail::AABBTree* aabb_tree,
+                                const Scalar4* h_postype,
+                                const Scalar4* h_orientation,
+                                const Scalar* h_diameter,
+                                const Scalar* h_charge,
+                                const unsigned int* h_overlaps,
+                                Scalar& lnboltzmann);
+
+    //! Perform a batch of insertion and removal moves in the grand canonical ensemble
+    void updateBatch(uint64_t timestep);
+
     /*! Try removing a particle
         \param timestep Current time step
         \param tag Tag of particle being removed
@@ -334,7 +371,8 @@ UpdaterMuVT<Shape>::UpdaterMuVT(std::shared_ptr<SystemDefinition> sysdef,
                                 std::shared_ptr<IntegratorHPMCMono<Shape>> mc,
                                 unsigned int npartition)
     : Updater(sysdef, trigger), m_mc(mc), m_npartition(npartition), m_gibbs(false),
-      m_max_vol_rescale(0.1), m_volume_move_probability(0.5), m_gibbs_other(0), m_n_trial(1)
+      m_max_vol_rescale(0.1), m_volume_move_probability(0.5), m_gibbs_other(0), m_n_trial(1),
+      m_batch_size(1)
     {
     m_fugacity.resize(m_pdata->getNTypes(), std::shared_ptr<Variant>(new VariantConstant(0.0)));
     m_type_map.resize(m_pdata->getNTypes());
@@ -685,58 +723,49 @@ bool UpdaterMuVT<Shape>::boxResizeAndScale(uint64_t timestep,
                     upper = vec3<Scalar>(new_box.makeCoordinates(f));
                     aabb = hoomd::detail::AABB(lower, upper);
 
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                         cur_node_idx++)
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next();
+                         cur_node_idx != hoomd::detail::INVALID_NODE;
+                         cur_node_idx = traversal.next())
                         {
-                        if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                        for (unsigned int cur_p = 0;
+                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                             cur_p++)
                             {
-                            if (aabb_tree.isNodeLeaf(cur_node_idx))
+                            // read in its position and orientation
+                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                            Scalar4 postype_j;
+                            Scalar4 orientation_j;
+
+                            // load the old position and orientation of the j particle
+                            postype_j = h_postype.data[j];
+                            orientation_j = h_orientation.data[j];
+
+                            // compute the particle position scaled in the old box
+                            f = new_box.makeFraction(
+                                make_scalar3(postype_j.x, postype_j.y, postype_j.z));
+                            vec3<Scalar> pos_j_old(old_box.makeCoordinates(f));
+
+                            // put particles in coordinate system of particle i
+                            vec3<Scalar> r_ij = pos_j_old - pos_test_image_old;
+
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+
+                            if (h_overlaps.data[overlap_idx(typ_j, type_d)]
+                                && check_circumsphere_overlap(r_ij, shape_test, shape_j)
+                                && test_overlap(r_ij, shape_test, shape_j, err_count))
                                 {
-                                for (unsigned int cur_p = 0;
-                                     cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                     cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
-
-                                    // load the old position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
-
-                                    // compute the particle position scaled in the old box
-                                    f = new_box.makeFraction(
-                                        make_scalar3(postype_j.x, postype_j.y, postype_j.z));
-                                    vec3<Scalar> pos_j_old(old_box.makeCoordinates(f));
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = pos_j_old - pos_test_image_old;
-
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
-
-                                    if (h_overlaps.data[overlap_idx(typ_j, type_d)]
-                                        && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                        && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                        {
-                                        overlap = true;
-
-                                        // depletant is ignored for any overlap in the old
-                                        // configuration
-                                        overlap_old = true;
-                                        break;
-                                        }
-                                    }
+                                overlap = true;
+
+                                // depletant is ignored for any overlap in the old
+                                // configuration
+                                overlap_old = true;
+                                break;
                                 }
                             }
-                        else
-                            {
-                            // skip ahead
-                            cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                            }
                         if (overlap)
                             break;
                         } // end loop over AABB nodes
@@ -762,51 +791,40 @@ bool UpdaterMuVT<Shape>::boxResizeAndScale(uint64_t timestep,
                         hoomd::detail::AABB aabb = aabb_test_local;
                         aabb.translate(pos_test_image);
 
-                        // stackless search
-                        for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                             cur_node_idx++)
+                        // traverse the wide BVH of the tree
+                        hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                        for (unsigned int cur_node_idx = traversal.next();
+                             cur_node_idx != hoomd::detail::INVALID_NODE;
+                             cur_node_idx = traversal.next())
                             {
-                            if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                            for (unsigned int cur_p = 0;
+                                 cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                                 cur_p++)
                                 {
-                                if (aabb_tree.isNodeLeaf(cur_node_idx))
+                                // read in its position and orientation
+                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                                Scalar4 postype_j;
+                                Scalar4 orientation_j;
+
+                                // load the new position and orientation of the j particle
+                                postype_j = h_postype.data[j];
+                                orientation_j = h_orientation.data[j];
+
+                                // put particles in coordinate system of particle i
+                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
+
+                                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+
+                                if (h_overlaps.data[overlap_idx(typ_j, type_d)]
+                                    && check_circumsphere_overlap(r_ij, shape_test, shape_j)
+                                    && test_overlap(r_ij, shape_test, shape_j, err_count))
                                     {
-                                    for (unsigned int cur_p = 0;
-                                         cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                         cur_p++)
-                                        {
-                                        // read in its position and orientation
-                                        unsigned int j
-                                            = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                        Scalar4 postype_j;
-                                        Scalar4 orientation_j;
-
-                                        // load the new position and orientation of the j particle
-                                        postype_j = h_postype.data[j];
-                                        orientation_j = h_orientation.data[j];
-
-                                        // put particles in coordinate system of particle i
-                                        vec3<Scalar> r_ij
-                                            = vec3<Scalar>(postype_j) - pos_test_image;
-
-                                        unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                        Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
-
-                                        if (h_overlaps.data[overlap_idx(typ_j, type_d)]
-                                            && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                            && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                            {
-                                            overlap = true;
-                                            break;
-                                            }
-                                        }
+                                    overlap = true;
+                                    break;
                                     }
                                 }
-                            else
-                                {
-                                // skip ahead
-                                cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                                }
 
                             } // end loop over AABB nodes
 
@@ -863,6 +881,12 @@ template<class Shape> void UpdaterMuVT<Shape>::update(uint64_t timestep)
 
     m_exec_conf->msg->notice(10) << "UpdaterMuVT update: " << timestep << std::endl;
 
+    if (m_batch_size > 1)
+        {
+        updateBatch(timestep);
+        return;
+        }
+
     // initialize random number generator
     unsigned int group = (m_exec_conf->getPartition() / m_npartition);
 
@@ -1039,8 +1063,7 @@ template<class Shape> void UpdaterMuVT<Shape>::update(uint64_t timestep)
                 {
                 const std::vector<typename Shape::param_type,
                                   hoomd::detail::managed_allocator<typename Shape::param_type>>&
-                    params
-                    = m_mc->getParams();
+                    params = m_mc->getParams();
                 const typename Shape::param_type& param = params[type];
 
                 // Propose a random position uniformly in the box
@@ -1626,6 +1649,332 @@ template<class Shape> void UpdaterMuVT<Shape>::update(uint64_t timestep)
 #endif
     }
 
+/*! \param timestep Current simulation step
+
+    updateBatch() performs m_batch_size insertion and removal moves, each with its own random number
+    stream. The overlap checks of the insertion trials dominate the cost, and most trials are
+    rejected in dense systems. updateBatch() checks all insertion trials against the current
+    configuration in parallel, then applies the moves in order until one is accepted. An accepted
+    move inserts or removes one particle, so only the remaining trials whose neighbor query AABB
+    (or one of its periodic images) overlaps the AABB of that particle are checked again. The other
+    trials keep their results. The moves are the same as applying them one after another (up to
+    round-off in the order of the pair energy sums), and do not depend on the number of threads.
+*/
+template<class Shape> void UpdaterMuVT<Shape>::updateBatch(uint64_t timestep)
+    {
+    if (m_sysdef->isDomainDecomposed())
+        {
+        throw std::runtime_error("batch_size > 1 is not supported with domain decomposition.");
+        }
+
+    for (unsigned int type_d = 0; type_d < m_pdata->getNTypes(); ++type_d)
+        {
+        if (m_mc->getDepletantFugacity(type_d) != 0.0)
+            {
+            throw std::runtime_error("batch_size > 1 is not supported with depletants.");
+            }
+        }
+
+    auto get_fugacity = [&](unsigned int type)
+        {
+        Scalar fugacity = (*m_fugacity[type])(timestep);
+
+        // sanity check
+        if (fugacity <= Scalar(0.0))
+            {
+            m_exec_conf->msg->error() << "Fugacity has to be greater than zero." << std::endl;
+            throw std::runtime_error("Error in UpdaterMuVT");
+            }
+        return fugacity;
+        };
+
+    //! A trial move in the batch
+    struct Trial
+        {
+        hoomd::RandomGenerator rng; //!< Random number stream of this move
+        bool insert;                //!< True for an insertion, false for a removal
+        unsigned int type;          //!< Type of the inserted or removed particle
+        vec3<Scalar> pos;           //!< Position of the inserted particle
+        quat<Scalar> orientation;   //!< Orientation of the inserted particle
+        bool nonzero;               //!< True if the inserted particle does not overlap
+        Scalar lnboltzmann;         //!< Log of the Boltzmann weight of the inserted particle
+        };
+
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    const unsigned int group = (m_exec_conf->getPartition() / m_npartition);
+    const auto& params = m_mc->getParams();
+    assert(m_transfer_types.size() > 0);
+
+    // choose the kind of each move, and the type, position, and orientation of inserted particles
+    std::vector<Trial> trials;
+    trials.reserve(m_batch_size);
+    for (unsigned int i = 0; i < m_batch_size; i++)
+        {
+        Trial trial {hoomd::RandomGenerator(hoomd::Seed(hoomd::RNGIdentifier::UpdaterMuVTBatch,
+                                                        timestep,
+                                                        this->m_sysdef->getSeed()),
+                                            hoomd::Counter(group, i)),
+                     false,
+                     0,
+                     vec3<Scalar>(),
+                     quat<Scalar>(),
+                     false,
+                     Scalar(0.0)};
+
+        trial.insert = hoomd::UniformIntDistribution(1)(trial.rng);
+        trial.type = m_transfer_types[hoomd::UniformIntDistribution(
+            (unsigned int)(m_transfer_types.size() - 1))(trial.rng)];
+
+        if (trial.insert)
+            {
+            // Propose a random position uniformly in the box
+            Scalar3 f;
+            f.x = hoomd::detail::generate_canonical<Scalar>(trial.rng);
+            f.y = hoomd::detail::generate_canonical<Scalar>(trial.rng);
+            if (ndim == 2)
+                {
+                f.z = Scalar(0.5);
+                }
+            else
+                {
+                f.z = hoomd::detail::generate_canonical<Scalar>(trial.rng);
+                }
+            trial.pos = vec3<Scalar>(m_pdata->getGlobalBox().makeCoordinates(f));
+
+            Shape shape_test(quat<Scalar>(), params[trial.type]);
+            if (shape_test.hasOrientation())
+                {
+                trial.orientation = generateRandomOrientation(trial.rng, ndim);
+                }
+            }
+
+        trials.push_back(trial);
+        }
+
+    // AABB that tryInsertParticleLocal() queries the AABB tree with for an inserted particle
+    auto get_query_aabb = [&](const Trial& trial)
+        {
+        Shape shape(trial.orientation, params[trial.type]);
+        LongReal r_cut_patch(0.0);
+        if (m_mc->hasPairInteractions())
+            {
+            r_cut_patch = m_mc->getMaxPairEnergyRCutNonAdditive()
+                          + LongReal(0.5) * m_mc->getMaxPairInteractionAdditiveRCut(trial.type);
+            }
+        LongReal R_query = std::max(shape.getCircumsphereDiameter() / LongReal(2.0),
+                                    r_cut_patch - m_mc->getMinCoreDiameter() / LongReal(2.0));
+        return hoomd::detail::AABB(trial.pos, R_query);
+        };
+
+    // AABB of the particle with the given tag in the AABB tree, see
+    // IntegratorHPMCMono::buildAABBTree()
+    auto get_particle_aabb = [&](unsigned int tag)
+        {
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(),
+                                         access_location::host,
+                                         access_mode::read);
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                       access_location::host,
+                                       access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
+                                           access_location::host,
+                                           access_mode::read);
+        unsigned int idx = h_rtag.data[tag];
+        vec3<Scalar> pos(h_postype.data[idx]);
+        unsigned int type = __scalar_as_int(h_postype.data[idx].w);
+        Shape shape(quat<Scalar>(h_orientation.data[idx]), params[type]);
+        if (!m_mc->hasPairInteractions())
+            {
+            return shape.getAABB(pos);
+            }
+        LongReal radius = std::max(shape.getCircumsphereDiameter() / LongReal(2.0),
+                                   LongReal(0.5) * m_mc->getMaxPairInteractionAdditiveRCut(type));
+        return hoomd::detail::AABB(pos, radius);
+        };
+
+    // insertion trials to check against the current configuration
+    std::vector<unsigned int> check_list;
+    for (unsigned int i = 0; i < m_batch_size; i++)
+        {
+        if (trials[i].insert)
+            {
+            check_list.push_back(i);
+            }
+        }
+
+    unsigned int first = 0;
+    while (first < m_batch_size)
+        {
+        if (!check_list.empty())
+            {
+            // we cannot rely on a valid AABB tree when there are 0 particles
+            const hoomd::detail::AABBTree* aabb_tree = nullptr;
+            if (m_pdata->getN() + m_pdata->getNGhosts() > 0)
+                {
+                aabb_tree = &m_mc->buildAABBTree();
+                }
+            m_mc->updateImageList();
+
+            ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                           access_location::host,
+                                           access_mode::read);
+            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
+                                               access_location::host,
+                                               access_mode::read);
+            ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(),
+                                           access_location::host,
+                                           access_mode::read);
+            ArrayHandle<Scalar> h_charge(m_pdata->getCharges(),
+                                         access_location::host,
+                                         access_mode::read);
+            ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(),
+                                                 access_location::host,
+                                                 access_mode::read);
+
+            auto check_range = [&](unsigned int range_first, unsigned int range_last)
+                {
+                for (unsigned int k = range_first; k < range_last; k++)
+                    {
+                    Trial& trial = trials[check_list[k]];
+                    trial.nonzero = tryInsertParticleLocal(trial.type,
+                                                           trial.pos,
+                                                           trial.orientation,
+                                                           aabb_tree,
+                                                           h_postype.data,
+                                                           h_orientation.data,
+                                                           h_diameter.data,
+                                                           h_charge.data,
+                                                           h_overlaps.data,
+                                                           trial.lnboltzmann);
+                    }
+                };
+            hoomd::detail::forEachRange(*m_exec_conf,
+                                        (unsigned int)check_list.size(),
+                                        check_range);
+            }
+
+        // apply the moves in order until one of them changes the configuration
+        bool accept = false;
+        hoomd::detail::AABB changed_aabb;
+        for (; first < m_batch_size && !accept; first++)
+            {
+            Trial& trial = trials[first];
+            Scalar V = m_pdata->getGlobalBox().getVolume();
+            unsigned int nptl_type = getNumParticlesType(trial.type);
+
+            if (trial.insert)
+                {
+                // acceptance probability
+                Scalar lnboltzmann = log(get_fugacity(trial.type) * V / (Scalar)(nptl_type + 1));
+                if (trial.nonzero)
+                    {
+                    lnboltzmann += trial.lnboltzmann;
+                    accept = (hoomd::detail::generate_canonical<double>(trial.rng)
+                              < exp(lnboltzmann));
+                    }
+
+                if (accept)
+                    {
+                    // create a new particle with given type
+                    unsigned int tag = m_pdata->addParticle(trial.type);
+
+                    // setPosition() takes into account the grid shift, so subtract that one
+                    Scalar3 p = vec_to_scalar3(trial.pos) - m_pdata->getOrigin();
+                    int3 tmp = make_int3(0, 0, 0);
+                    m_pdata->getGlobalBox().wrap(p, tmp);
+                    m_pdata->setPosition(tag, p);
+
+                    Shape shape_test(trial.orientation, params[trial.type]);
+                    if (shape_test.hasOrientation())
+                        {
+                        m_pdata->setOrientation(tag, quat_to_scalar4(trial.orientation));
+                        }
+                    changed_aabb = get_particle_aabb(tag);
+                    m_count_total.insert_accept_count++;
+                    }
+                else
+                    {
+                    m_count_total.insert_reject_count++;
+                    }
+                }
+            else
+                {
+                // choose a random particle of the chosen type
+                unsigned int tag = UINT_MAX;
+                if (nptl_type)
+                    {
+                    unsigned int type_offset
+                        = hoomd::UniformIntDistribution(nptl_type - 1)(trial.rng);
+                    tag = getNthTypeTag(trial.type, type_offset);
+                    }
+
+                // acceptance probability
+                Scalar lnboltzmann = -log(get_fugacity(trial.type));
+                bool nonzero = nptl_type > 0;
+                if (nonzero)
+                    {
+                    lnboltzmann += log((Scalar)nptl_type / V);
+                    }
+
+                // get weight for removal
+                Scalar lnb(0.0);
+                if (tryRemoveParticle(timestep, tag, lnb))
+                    {
+                    lnboltzmann += lnb;
+                    }
+                else
+                    {
+                    nonzero = false;
+                    }
+
+                if (nonzero)
+                    {
+                    accept = (hoomd::detail::generate_canonical<double>(trial.rng)
+                              < exp(lnboltzmann));
+                    }
+
+                if (accept)
+                    {
+                    changed_aabb = get_particle_aabb(tag);
+                    m_pdata->removeParticle(tag);
+                    m_count_total.remove_accept_count++;
+                    }
+                else
+                    {
+                    m_count_total.remove_reject_count++;
+                    }
+                }
+            }
+
+        // only the remaining insertion trials that can see the inserted or removed particle need to
+        // be checked again
+        check_list.clear();
+        if (accept)
+            {
+            const auto& image_list = m_mc->updateImageList();
+            for (unsigned int i = first; i < m_batch_size; i++)
+                {
+                if (!trials[i].insert)
+                    {
+                    continue;
+                    }
+
+                hoomd::detail::AABB aabb_query = get_query_aabb(trials[i]);
+                for (const auto& image : image_list)
+                    {
+                    hoomd::detail::AABB aabb = aabb_query;
+                    aabb.translate(image);
+                    if (aabb.overlaps(changed_aabb))
+                        {
+                        check_list.push_back(i);
+                        break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
 template<class Shape>
 bool UpdaterMuVT<Shape>::tryRemoveParticle(uint64_t timestep, unsigned int tag, Scalar& lnboltzmann)
     {
@@ -1750,50 +2099,41 @@ bool UpdaterMuVT<Shape>::tryRemoveParticle(uint64_t timestep, unsigned int tag,
                     hoomd::detail::AABB aabb = aabb_local;
                     aabb.translate(pos_image);
 
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                         cur_node_idx++)
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next();
+                         cur_node_idx != hoomd::detail::INVALID_NODE;
+                         cur_node_idx = traversal.next())
                         {
-                        if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
-                            {
-                            if (aabb_tree.isNodeLeaf(cur_node_idx))
-                                {
-                                for (unsigned int cur_p = 0;
-                                     cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                     cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j = h_postype.data[j];
-                                    quat<LongReal> orientation_j(h_orientation.data[j]);
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_image;
-
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-
-                                    // we computed the self-interaction above
-                                    if (h_tag.data[j] == tag)
-                                        continue;
-
-                                    lnboltzmann += m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
-                                                                              r_ij,
-                                                                              type,
-                                                                              orientation,
-                                                                              diameter,
-                                                                              charge,
-                                                                              typ_j,
-                                                                              orientation_j,
-                                                                              h_diameter.data[j],
-                                                                              h_charge.data[j]);
-                                    }
-                                }
-                            }
-                        else
+                        for (unsigned int cur_p = 0;
+                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                             cur_p++)
                             {
-                            // skip ahead
-                            cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
+                            // read in its position and orientation
+                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                            Scalar4 postype_j = h_postype.data[j];
+                            quat<LongReal> orientation_j(h_orientation.data[j]);
+
+                            // put particles in coordinate system of particle i
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_image;
+
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+
+                            // we computed the self-interaction above
+                            if (h_tag.data[j] == tag)
+                                continue;
+
+                            lnboltzmann += m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
+                                                                      r_ij,
+                                                                      type,
+                                                                      orientation,
+                                                                      diameter,
+                                                                      charge,
+                                                                      typ_j,
+                                                                      orientation_j,
+                                                                      h_diameter.data[j],
+                                                                      h_charge.data[j]);
                             }
                         } // end loop over AABB nodes
                     } // end loop over images
@@ -1917,12 +2257,33 @@ bool UpdaterMuVT<Shape>::tryRemoveParticle(uint64_t timestep, unsigned int tag,
     return nonzero;
     }
 
+/*! \param type Type of the fictitious particle
+    \param pos Position of the fictitious particle
+    \param orientation Orientation of the fictitious particle
+    \param aabb_tree AABB tree of the local particles (nullptr when there are none)
+    \param h_postype Positions and types of the local particles
+    \param h_orientation Orientations of the local particles
+    \param h_diameter Diameters of the local particles
+    \param h_charge Charges of the local particles
+    \param h_overlaps Interaction matrix
+    \param lnboltzmann Log of Boltzmann weight of the insertion (return value)
+    \returns True if the fictitious particle does not overlap
+
+    tryInsertParticleLocal() only reads from its arguments, the image list, and the integrator
+    parameters. Multiple threads may call it concurrently after the caller has built the AABB tree
+    and the image list.
+*/
 template<class Shape>
-bool UpdaterMuVT<Shape>::tryInsertParticle(uint64_t timestep,
-                                           unsigned int type,
-                                           vec3<Scalar> pos,
-                                           quat<Scalar> orientation,
-                                           Scalar& lnboltzmann)
+bool UpdaterMuVT<Shape>::tryInsertParticleLocal(unsigned int type,
+                                                const vec3<Scalar>& pos,
+                                                const quat<Scalar>& orientation,
+                                                const hoomd::detail::AABBTree* aabb_tree,
+                                                const Scalar4* h_postype,
+                                                const Scalar4* h_orientation,
+                                                const Scalar* h_diameter,
+                                                const Scalar* h_charge,
+                                                const unsigned int* h_overlaps,
+                                                Scalar& lnboltzmann)
     {
     // do we have to compute a wall contribution?
     auto field = m_mc->getExternalField();
@@ -1932,212 +2293,210 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(uint64_t timestep,
 
     unsigned int overlap = 0;
 
-    bool is_local = true;
-#ifdef ENABLE_MPI
-    if (this->m_pdata->getDomainDecomposition())
+    // get some data structures from the integrator
+    auto& image_list = m_mc->updateImageList();
+    const unsigned int n_images = (unsigned int)image_list.size();
+    auto& params = m_mc->getParams();
+
+    const Index2D& overlap_idx = m_mc->getOverlapIndexer();
+
+    LongReal r_cut_patch(0.0);
+
+    unsigned int p = m_exec_conf->getPartition() % m_npartition;
+
+    if (has_field && (!m_gibbs || p == 0))
         {
-        const BoxDim global_box = this->m_pdata->getGlobalBox();
-        ArrayHandle<unsigned int> h_cart_ranks(
-            this->m_pdata->getDomainDecomposition()->getCartRanks(),
-            access_location::host,
-            access_mode::read);
-        is_local = this->m_exec_conf->getRank()
-                   == this->m_pdata->getDomainDecomposition()->placeParticle(global_box,
-                                                                             vec_to_scalar3(pos),
-                                                                             h_cart_ranks.data);
+        lnboltzmann += m_mc->computeOneExternalEnergy(type, pos, orientation, 0.0, true);
+
+        const BoxDim& box = this->m_pdata->getGlobalBox();
+        lnboltzmann -= field->energy(box,
+                                     type,
+                                     pos,
+                                     quat<float>(orientation),
+                                     1.0, // diameter i
+                                     0.0  // charge i
+        );
+
+        lnboltzmann += m_mc->computeOneExternalEnergy(type, pos, orientation, 0.0, true);
         }
-#endif
 
-    unsigned int nptl_local = m_pdata->getN() + m_pdata->getNGhosts();
-
-    if (is_local)
+    if (m_mc->hasPairInteractions())
         {
-        // get some data structures from the integrator
-        auto& image_list = m_mc->updateImageList();
-        const unsigned int n_images = (unsigned int)image_list.size();
-        auto& params = m_mc->getParams();
+        r_cut_patch = m_mc->getMaxPairEnergyRCutNonAdditive()
+                      + LongReal(0.5) * m_mc->getMaxPairInteractionAdditiveRCut(type);
+        }
 
-        const Index2D& overlap_idx = m_mc->getOverlapIndexer();
+    unsigned int err_count = 0;
 
-        LongReal r_cut_patch(0.0);
+    // check for overlaps with the periodic images of the particle itself
+    Shape shape(orientation, params[type]);
 
-        unsigned int p = m_exec_conf->getPartition() % m_npartition;
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_image = pos + image_list[cur_image];
 
-        if (has_field && (!m_gibbs || p == 0))
+        if (cur_image != 0)
             {
-            lnboltzmann += m_mc->computeOneExternalEnergy(type, pos, orientation, 0.0, true);
-
-            const BoxDim& box = this->m_pdata->getGlobalBox();
-            lnboltzmann -= field->energy(box,
-                                         type,
-                                         pos,
-                                         quat<float>(orientation),
-                                         1.0, // diameter i
-                                         0.0  // charge i
-            );
+            // check for self-overlap with all images except the original
+            vec3<Scalar> r_ij = pos - pos_image;
+            if (h_overlaps[overlap_idx(type, type)]
+                && check_circumsphere_overlap(r_ij, shape, shape)
+                && test_overlap(r_ij, shape, shape, err_count))
+                {
+                overlap = 1;
+                break;
+                }
 
-            lnboltzmann += m_mc->computeOneExternalEnergy(type, pos, orientation, 0.0, true);
+            // self-energy
+            lnboltzmann -= m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
+                                                      r_ij,
+                                                      type,
+                                                      orientation,
+                                                      1.0, // diameter i
+                                                      0.0, // charge i
+                                                      type,
+                                                      orientation,
+                                                      1.0, // diameter i
+                                                      0.0  // charge i
+            );
             }
+        }
 
-        if (m_mc->hasPairInteractions())
+    // we cannot rely on a valid AABB tree when there are 0 particles
+    if (!overlap && aabb_tree)
+        {
+        // Check particle against AABB tree for neighbors
+        LongReal R_query = std::max(shape.getCircumsphereDiameter() / LongReal(2.0),
+                                    r_cut_patch - m_mc->getMinCoreDiameter() / LongReal(2.0));
+        hoomd::detail::AABB aabb_local = hoomd::detail::AABB(vec3<Scalar>(0, 0, 0), R_query);
+
+        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
             {
-            r_cut_patch = m_mc->getMaxPairEnergyRCutNonAdditive()
-                          + LongReal(0.5) * m_mc->getMaxPairInteractionAdditiveRCut(type);
-            }
+            vec3<Scalar> pos_image = pos + image_list[cur_image];
 
-        unsigned int err_count = 0;
+            hoomd::detail::AABB aabb = aabb_local;
+            aabb.translate(pos_image);
 
-            {
-            // check for overlaps
-            ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
-                                           access_location::host,
-                                           access_mode::read);
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
-                                               access_location::host,
-                                               access_mode::read);
-            ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(),
-                                           access_location::host,
-                                           access_mode::read);
-            ArrayHandle<Scalar> h_charge(m_pdata->getCharges(),
-                                         access_location::host,
-                                         access_mode::read);
+            // traverse the wide BVH of the tree
+            hoomd::detail::AABBTreeTraversal traversal(*aabb_tree, aabb);
+            for (unsigned int cur_node_idx = traversal.next();
+                 cur_node_idx != hoomd::detail::INVALID_NODE;
+                 cur_node_idx = traversal.next())
+                {
+                for (unsigned int cur_p = 0;
+                     cur_p < aabb_tree->getNodeNumParticles(cur_node_idx);
+                     cur_p++)
+                    {
+                    // read in its position and orientation
+                    unsigned int j = aabb_tree->getNodeParticle(cur_node_idx, cur_p);
 
-            ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(),
-                                                 access_location::host,
-                                                 access_mode::read);
+                    Scalar4 postype_j = h_postype[j];
+                    quat<LongReal> orientation_j(h_orientation[j]);
 
-            // read in the current position and orientation
-            Shape shape(orientation, params[type]);
+                    // put particles in coordinate system of particle i
+                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_image;
 
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-                {
-                vec3<Scalar> pos_image = pos + image_list[cur_image];
+                    unsigned int typ_j = __scalar_as_int(postype_j.w);
+                    Shape shape_j(orientation_j, params[typ_j]);
 
-                if (cur_image != 0)
-                    {
-                    // check for self-overlap with all images except the original
-                    vec3<Scalar> r_ij = pos - pos_image;
-                    if (h_overlaps.data[overlap_idx(type, type)]
-                        && check_circumsphere_overlap(r_ij, shape, shape)
-                        && test_overlap(r_ij, shape, shape, err_count))
+                    if (h_overlaps[overlap_idx(type, typ_j)]
+                        && check_circumsphere_overlap(r_ij, shape, shape_j)
+                        && test_overlap(r_ij, shape, shape_j, err_count))
                         {
                         overlap = 1;
                         break;
                         }
 
-                    // self-energy
                     lnboltzmann -= m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
                                                               r_ij,
                                                               type,
                                                               orientation,
                                                               1.0, // diameter i
                                                               0.0, // charge i
-                                                              type,
-                                                              orientation,
-                                                              1.0, // diameter i
-                                                              0.0  // charge i
-                    );
+                                                              typ_j,
+                                                              orientation_j,
+                                                              h_diameter[j],
+                                                              h_charge[j]);
                     }
-                }
-            }
-
-        // we cannot rely on a valid AABB tree when there are 0 particles
-        if (!overlap && nptl_local > 0)
-            {
-            // Check particle against AABB tree for neighbors
-            const hoomd::detail::AABBTree& aabb_tree = m_mc->buildAABBTree();
 
-            ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
-                                           access_location::host,
-                                           access_mode::read);
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
-                                               access_location::host,
-                                               access_mode::read);
-            ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(),
-                                           access_location::host,
-                                           access_mode::read);
-            ArrayHandle<Scalar> h_charge(m_pdata->getCharges(),
-                                         access_location::host,
-                                         access_mode::read);
-            ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(),
-                                                 access_location::host,
-                                                 access_mode::read);
-
-            Shape shape(orientation, params[type]);
-            LongReal R_query = std::max(shape.getCircumsphereDiameter() / LongReal(2.0),
-                                        r_cut_patch - m_mc->getMinCoreDiameter() / LongReal(2.0));
-            hoomd::detail::AABB aabb_local = hoomd::detail::AABB(vec3<Scalar>(0, 0, 0), R_query);
+                if (overlap)
+                    {
+                    break;
+                    }
+                } // end loop over AABB nodes
 
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+            if (overlap)
                 {
-                vec3<Scalar> pos_image = pos + image_list[cur_image];
-
-                hoomd::detail::AABB aabb = aabb_local;
-                aabb.translate(pos_image);
-
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                     cur_node_idx++)
-                    {
-                    if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
-                        {
-                        if (aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0;
-                                 cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                 cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                break;
+                }
+            } // end loop over images
+        } // end if aabb_tree
 
-                                Scalar4 postype_j = h_postype.data[j];
-                                quat<LongReal> orientation_j(h_orientation.data[j]);
+    return !overlap;
+    }
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_image;
+template<class Shape>
+bool UpdaterMuVT<Shape>::tryInsertParticle(uint64_t timestep,
+                                           unsigned int type,
+                                           vec3<Scalar> pos,
+                                           quat<Scalar> orientation,
+                                           Scalar& lnboltzmann)
+    {
+    lnboltzmann = Scalar(0.0);
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(orientation_j, params[typ_j]);
+    unsigned int overlap = 0;
 
-                                if (h_overlaps.data[overlap_idx(type, typ_j)]
-                                    && check_circumsphere_overlap(r_ij, shape, shape_j)
-                                    && test_overlap(r_ij, shape, shape_j, err_count))
-                                    {
-                                    overlap = 1;
-                                    break;
-                                    }
+    bool is_local = true;
+#ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        {
+        const BoxDim global_box = this->m_pdata->getGlobalBox();
+        ArrayHandle<unsigned int> h_cart_ranks(
+            this->m_pdata->getDomainDecomposition()->getCartRanks(),
+            access_location::host,
+            access_mode::read);
+        is_local = this->m_exec_conf->getRank()
+                   == this->m_pdata->getDomainDecomposition()->placeParticle(global_box,
+                                                                             vec_to_scalar3(pos),
+                                                                             h_cart_ranks.data);
+        }
+#endif
 
-                                lnboltzmann -= m_mc->computeOnePairEnergy(dot(r_ij, r_ij),
-                                                                          r_ij,
-                                                                          type,
-                                                                          orientation,
-                                                                          1.0, // diameter i
-                                                                          0.0, // charge i
-                                                                          typ_j,
-                                                                          orientation_j,
-                                                                          h_diameter.data[j],
-                                                                          h_charge.data[j]);
-                                }
-                            }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                        }
+    if (is_local)
+        {
+        // we cannot rely on a valid AABB tree when there are 0 particles
+        const hoomd::detail::AABBTree* aabb_tree = nullptr;
+        if (m_pdata->getN() + m_pdata->getNGhosts() > 0)
+            {
+            aabb_tree = &m_mc->buildAABBTree();
+            }
 
-                    if (overlap)
-                        {
-                        break;
-                        }
-                    } // end loop over AABB nodes
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                       access_location::host,
+                                       access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
+                                           access_location::host,
+                                           access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(),
+                                       access_location::host,
+                                       access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(),
+                                     access_location::host,
+                                     access_mode::read);
+        ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(),
+                                             access_location::host,
+                                             access_mode::read);
 
-                if (overlap)
-                    {
-                    break;
-                    }
-                } // end loop over images
-            } // end if nptl_local > 0
+        overlap = !tryInsertParticleLocal(type,
+                                          pos,
+                                          orientation,
+                                          aabb_tree,
+                                          h_postype.data,
+                                          h_orientation.data,
+                                          h_diameter.data,
+                                          h_charge.data,
+                                          h_overlaps.data,
+                                          lnboltzmann);
         } // end if local
 
 #ifdef ENABLE_MPI
@@ -2423,49 +2782,40 @@ bool UpdaterMuVT<Shape>::moveDepletantsIntoNewPosition(uint64_t timestep,
                     hoomd::detail::AABB aabb = aabb_test_local;
                     aabb.translate(pos_test_image);
 
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                         cur_node_idx++)
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next();
+                         cur_node_idx != hoomd::detail::INVALID_NODE;
+                         cur_node_idx = traversal.next())
                         {
-                        if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                        for (unsigned int cur_p = 0;
+                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                             cur_p++)
                             {
-                            if (aabb_tree.isNodeLeaf(cur_node_idx))
-                                {
-                                for (unsigned int cur_p = 0;
-                                     cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                     cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                            // read in its position and orientation
+                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
+                            Scalar4 postype_j;
+                            Scalar4 orientation_j;
 
-                                    // load the old position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
+                            // load the old position and orientation of the j particle
+                            postype_j = h_postype.data[j];
+                            orientation_j = h_orientation.data[j];
 
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
+                            // put particles in coordinate system of particle i
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
 
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
 
-                                    if (h_overlaps.data[overlap_idx(type_d, typ_j)]
-                                        && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                        && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                        {
-                                        overlap_old = true;
-                                        break;
-                                        }
-                                    }
+                            if (h_overlaps.data[overlap_idx(type_d, typ_j)]
+                                && check_circumsphere_overlap(r_ij, shape_test, shape_j)
+                                && test_overlap(r_ij, shape_test, shape_j, err_count))
+                                {
+                                overlap_old = true;
+                                break;
                                 }
                             }
-                        else
-                            {
-                            // skip ahead
-                            cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                            }
                         if (overlap_old)
                             break;
                         } // end loop over AABB nodes
@@ -2622,54 +2972,45 @@ bool UpdaterMuVT<Shape>::moveDepletantsIntoOldPosition(uint64_t timestep,
                     hoomd::detail::AABB aabb = aabb_test_local;
                     aabb.translate(pos_test_image);
 
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                         cur_node_idx++)
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next();
+                         cur_node_idx != hoomd::detail::INVALID_NODE;
+                         cur_node_idx = traversal.next())
                         {
-                        if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                        for (unsigned int cur_p = 0;
+                             cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                             cur_p++)
                             {
-                            if (aabb_tree.isNodeLeaf(cur_node_idx))
+                            // read in its position and orientation
+                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                            Scalar4 postype_j;
+                            Scalar4 orientation_j;
+
+                            // load the old position and orientation of the j particle
+                            postype_j = h_postype.data[j];
+                            orientation_j = h_orientation.data[j];
+
+                            if (h_tag.data[j] == tag)
                                 {
-                                for (unsigned int cur_p = 0;
-                                     cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                     cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
-
-                                    // load the old position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
-
-                                    if (h_tag.data[j] == tag)
-                                        {
-                                        // do not check against old particle configuration
-                                        continue;
-                                        }
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
-
-                                    unsigned int type = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), params[type]);
-
-                                    if (h_overlaps.data[overlap_idx(type_d, type)]
-                                        && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                        && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                        {
-                                        overlap_old = true;
-                                        break;
-                                        }
-                                    }
+                                // do not check against old particle configuration
+                                continue;
+                                }
+
+                            // put particles in coordinate system of particle i
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
+
+                            unsigned int type = __scalar_as_int(postype_j.w);
+                            Shape shape_j(quat<Scalar>(orientation_j), params[type]);
+
+                            if (h_overlaps.data[overlap_idx(type_d, type)]
+                                && check_circumsphere_overlap(r_ij, shape_test, shape_j)
+                                && test_overlap(r_ij, shape_test, shape_j, err_count))
+                                {
+                                overlap_old = true;
+                                break;
                                 }
-                            }
-                        else
-                            {
-                            // skip ahead
-                            cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
                             }
 
                         if (overlap_old)
@@ -2839,49 +3180,40 @@ unsigned int UpdaterMuVT<Shape>::countDepletantOverlapsInNewPosition(uint64_t ti
                 hoomd::detail::AABB aabb = aabb_test_local;
                 aabb.translate(pos_test_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                     cur_node_idx++)
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                for (unsigned int cur_node_idx = traversal.next();
+                     cur_node_idx != hoomd::detail::INVALID_NODE;
+                     cur_node_idx = traversal.next())
                     {
-                    if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                    for (unsigned int cur_p = 0;
+                         cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                         cur_p++)
                         {
-                        if (aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0;
-                                 cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                 cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
+                        Scalar4 postype_j;
+                        Scalar4 orientation_j;
 
-                                // load the old position and orientation of the j particle
-                                postype_j = h_postype.data[j];
-                                orientation_j = h_orientation.data[j];
+                        // load the old position and orientation of the j particle
+                        postype_j = h_postype.data[j];
+                        orientation_j = h_orientation.data[j];
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
 
-                                if (h_overlaps.data[overlap_idx(type_d, typ_j)]
-                                    && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                    && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                    {
-                                    overlap_old = true;
-                                    break;
-                                    }
-                                }
+                        if (h_overlaps.data[overlap_idx(type_d, typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_test, shape_j)
+                            && test_overlap(r_ij, shape_test, shape_j, err_count))
+                            {
+                            overlap_old = true;
+                            break;
                             }
                         }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                        }
                     if (overlap_old)
                         break;
                     } // end loop over AABB nodes
@@ -3025,49 +3357,40 @@ unsigned int UpdaterMuVT<Shape>::countDepletantOverlaps(uint64_t timestep,
                 hoomd::detail::AABB aabb = aabb_test_local;
                 aabb.translate(pos_test_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes();
-                     cur_node_idx++)
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(aabb_tree, aabb);
+                for (unsigned int cur_node_idx = traversal.next();
+                     cur_node_idx != hoomd::detail::INVALID_NODE;
+                     cur_node_idx = traversal.next())
                     {
-                    if (aabb.overlaps(aabb_tree.getNodeAABB(cur_node_idx)))
+                    for (unsigned int cur_p = 0;
+                         cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
+                         cur_p++)
                         {
-                        if (aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0;
-                                 cur_p < aabb_tree.getNodeNumParticles(cur_node_idx);
-                                 cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
+                        Scalar4 postype_j;
+                        Scalar4 orientation_j;
 
-                                // load the old position and orientation of the j particle
-                                postype_j = h_postype.data[j];
-                                orientation_j = h_orientation.data[j];
+                        // load the old position and orientation of the j particle
+                        postype_j = h_postype.data[j];
+                        orientation_j = h_orientation.data[j];
 
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
 
-                                if (h_overlaps.data[overlap_idx(typ_j, type_d)]
-                                    && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                    && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                    {
-                                    overlap = true;
-                                    break;
-                                    }
-                                }
+                        if (h_overlaps.data[overlap_idx(typ_j, type_d)]
+                            && check_circumsphere_overlap(r_ij, shape_test, shape_j)
+                            && test_overlap(r_ij, shape_test, shape_j, err_count))
+                            {
+                            overlap = true;
+                            break;
                             }
                         }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                        }
                     if (overlap)
                         break;
                     } // end loop over AABB nodes
@@ -3123,6 +3446,9 @@ template<class Shape> void export_UpdaterMuVT(pybind11::module& m, const std::st
                       &UpdaterMuVT<Shape>::getTransferTypes,
                       &UpdaterMuVT<Shape>::setTransferTypes)
         .def_property("ntrial", &UpdaterMuVT<Shape>::getNTrial, &UpdaterMuVT<Shape>::setNTrial)
+        .def_property("batch_size",
+                      &UpdaterMuVT<Shape>::getBatchSize,
+                      &UpdaterMuVT<Shape>::setBatchSize)
         .def_property_readonly("N", &UpdaterMuVT<Shape>::getN)
         .def("getCounters", &UpdaterMuVT<Shape>::getCounters);
     }
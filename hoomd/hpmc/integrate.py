@@ -100,7 +100,11 @@ implementations, trial moves are performed in parallel for particles in active
 domains while leaving particles on the border fixed (see `Anderson 2016
 <https://dx.doi.org/10.1016/j.cpc.2016.02.024>`_ for a full description). As a
 consequence, a single timestep may perform more or less than ``nselect`` trial
-moves per particle when using the parallel code paths. Monitor the number of
+moves per particle when using the parallel code paths. Set
+`HPMCIntegrator.checkerboard` to `True` to use a similar scheme on the CPU: each
+of the ``nselect`` sweeps visits the 4 (2D) or 8 (3D) sets of non-adjacent cells
+in a random order and moves the particles in the cells of one set in parallel,
+rejecting trial moves that leave the cell. Monitor the number of
 trial moves performed with `HPMCIntegrator.translate_moves` and
 `HPMCIntegrator.rotate_moves`.
 
@@ -315,8 +319,10 @@ class HPMCIntegrator(Integrator):
 
     .. rubric:: Threading
 
-    HPMC integrators use threaded execution on multiple CPU cores only when
-    placing implicit depletants (``depletant_fugacity != 0``).
+    HPMC integrators use threaded execution on multiple CPU cores when placing
+    implicit depletants (``depletant_fugacity != 0``) and when `checkerboard`
+    is `True`. Checkerboard trial moves produce the same trajectory for any
+    number of threads.
 
     .. deprecated:: 4.4.0
 
@@ -365,6 +371,13 @@ class HPMCIntegrator(Integrator):
         nselect (int): Number of trial moves to perform per particle per
             timestep.
 
+        checkerboard (bool): Set to `True` to perform the trial moves on the
+            CPU in parallel over a checkerboard of cells (**default:**
+            `False`). The CPU falls back to the serial trial moves when the
+            box is less than two cells wide in any direction or when placing
+            implicit depletants. Ignored on the GPU. The NEC integrators in
+            `hoomd.hpmc.nec.integrate` raise a `ValueError` when set to `True`.
+
     .. rubric:: Attributes
     """
     _ext_module = _hpmc
@@ -379,7 +392,8 @@ class HPMCIntegrator(Integrator):
         # Set base parameter dict for hpmc integrators
         param_dict = ParameterDict(
             translation_move_probability=float(translation_move_probability),
-            nselect=int(nselect))
+            nselect=int(nselect),
+            checkerboard=False)
         self._param_dict.update(param_dict)
         self._pair_potential = None
         self._external_potential = None
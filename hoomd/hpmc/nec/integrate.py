@@ -18,6 +18,11 @@ class HPMCNECIntegrator(HPMCIntegrator):
     integrators. The attributes documented here are available to all HPMC
     integrators.
 
+    Newtonian event chains move the particles serially, so NEC integrators do
+    not support checkerboard trial moves and raise a `ValueError` when
+    `checkerboard <hoomd.hpmc.integrate.HPMCIntegrator.checkerboard>` is set
+    to `True`.
+
     Warning:
         This class should not be instantiated by users. The class can be used
         for `isinstance` or `issubclass` checks.
@@ -40,11 +45,14 @@ class HPMCNECIntegrator(HPMCIntegrator):
                 float, postprocess=self._process_chain_probability),
             chain_time=OnlyTypes(float, postprocess=self._process_chain_time),
             update_fraction=OnlyTypes(
-                float, postprocess=self._process_update_fraction))
+                float, postprocess=self._process_update_fraction),
+            checkerboard=OnlyTypes(bool,
+                                   postprocess=self._process_checkerboard))
         self._param_dict.update(param_dict)
         self.chain_probability = chain_probability
         self.chain_time = chain_time
         self.update_fraction = update_fraction
+        self.checkerboard = False
 
     @staticmethod
     def _process_chain_probability(value):
@@ -72,6 +80,14 @@ class HPMCNECIntegrator(HPMCIntegrator):
                 "update_fraction has to be between 0 and 1. (got {})".format(
                     value))
 
+    @staticmethod
+    def _process_checkerboard(value):
+        if not value:
+            return value
+        else:
+            raise ValueError(
+                "NEC integrators do not support checkerboard trial moves.")
+
     @property
     def nec_counters(self):
         """Trial move counters.
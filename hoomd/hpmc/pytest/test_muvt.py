@@ -29,6 +29,7 @@ valid_attrs = [
     ("transfer_types", ["A"]),
     ("transfer_types", ["B"]),
     ("transfer_types", ["A", "B"]),
+    ("batch_size", 8),
 ]
 
 
@@ -172,6 +173,85 @@ def test_insertion_removal(device, simulation_factory,
     assert muvt.N["B"] > 0
 
 
+@pytest.mark.serial
+def test_batch_insertion_removal(device, simulation_factory,
+                                 lattice_snapshot_factory):
+    """Test that MuVT inserts and removes particles in batches."""
+    sim = simulation_factory(
+        lattice_snapshot_factory(particle_types=["A", "B"],
+                                 dimensions=3,
+                                 a=4,
+                                 n=7,
+                                 r=0.1))
+
+    mc = hoomd.hpmc.integrate.Sphere(default_d=0.1, default_a=0.1)
+    mc.shape["A"] = dict(diameter=1.1)
+    mc.shape["B"] = dict(diameter=1.3)
+    sim.operations.integrator = mc
+
+    muvt = hoomd.hpmc.update.MuVT(trigger=hoomd.trigger.Periodic(5),
+                                  transfer_types=["B"])
+    muvt.batch_size = 16
+    muvt.fugacity["B"] = 1
+    sim.operations.updaters.append(muvt)
+
+    sim.run(20)
+    assert sum(muvt.insert_moves) > 0
+    assert sum(muvt.remove_moves) > 0
+    assert muvt.N["B"] > 0
+    assert mc.overlaps == 0
+
+
+@pytest.mark.serial
+@pytest.mark.cpu
+@pytest.mark.skipif(not hoomd.version.tbb_enabled,
+                    reason="HOOMD was compiled without TBB support")
+def test_batch_threads(device, simulation_factory, lattice_snapshot_factory):
+    """Test that batched MuVT moves do not depend on the number of threads."""
+    snap = lattice_snapshot_factory(particle_types=["A", "B"],
+                                    dimensions=3,
+                                    a=2,
+                                    n=7,
+                                    r=0.1)
+
+    num_cpu_threads = device.num_cpu_threads
+    results = []
+    try:
+        for num_threads in (1, 4):
+            device.num_cpu_threads = num_threads
+            sim = simulation_factory(snap)
+
+            mc = hoomd.hpmc.integrate.Sphere(default_d=0.1, default_a=0.1)
+            mc.shape["A"] = dict(diameter=1.1)
+            mc.shape["B"] = dict(diameter=1.3)
+            sim.operations.integrator = mc
+
+            muvt = hoomd.hpmc.update.MuVT(trigger=hoomd.trigger.Periodic(1),
+                                          transfer_types=["B"])
+            muvt.batch_size = 16
+            muvt.fugacity["B"] = 1
+            sim.operations.updaters.append(muvt)
+
+            sim.run(50)
+            assert mc.overlaps == 0
+
+            final = sim.state.get_snapshot()
+            results.append((muvt.N, muvt.insert_moves, muvt.remove_moves,
+                            final.particles.position.copy(),
+                            final.particles.typeid.copy()))
+    finally:
+        device.num_cpu_threads = num_cpu_threads
+
+    serial, threaded = results
+    assert sum(serial[1]) > 0
+    assert sum(serial[2]) > 0
+    assert serial[0] == threaded[0]
+    assert serial[1] == threaded[1]
+    assert serial[2] == threaded[2]
+    numpy.testing.assert_array_equal(serial[3], threaded[3])
+    numpy.testing.assert_array_equal(serial[4], threaded[4])
+
+
 @pytest.mark.cpu
 @pytest.mark.skipif(not hoomd.version.llvm_enabled, reason="LLVM not enabled")
 def test_jit_remove_insert(device, simulation_factory,
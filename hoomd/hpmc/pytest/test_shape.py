@@ -151,6 +151,53 @@ def test_moves(simulation_factory, lattice_snapshot_factory, test_moves_args):
         assert accepted_rejected_rot > 0
 
 
+@pytest.mark.parametrize("n_dimensions", [2, 3])
+def test_checkerboard(device, simulation_factory, lattice_snapshot_factory,
+                      n_dimensions):
+    """Test that checkerboard trial moves are valid and thread independent."""
+    if isinstance(device, hoomd.device.GPU):
+        pytest.skip("Checkerboard trial moves apply only to the CPU")
+
+    snap = lattice_snapshot_factory(dimensions=n_dimensions, a=1.5, n=8)
+
+    num_cpu_threads = device.num_cpu_threads
+    thread_counts = (1, 4) if hoomd.version.tbb_enabled else (1,)
+    positions = []
+    try:
+        for num_threads in thread_counts:
+            if hoomd.version.tbb_enabled:
+                device.num_cpu_threads = num_threads
+            mc = hoomd.hpmc.integrate.Sphere(default_d=0.2)
+            mc.shape['A'] = dict(diameter=1)
+            mc.checkerboard = True
+            sim = simulation_factory(snap)
+            sim.operations.integrator = mc
+            sim.run(20)
+
+            assert mc.checkerboard
+            assert mc.overlaps == 0
+            assert sum(mc.translate_moves) > 0
+            positions.append(sim.state.get_snapshot().particles.position)
+    finally:
+        if hoomd.version.tbb_enabled:
+            device.num_cpu_threads = num_cpu_threads
+
+    if positions[0] is not None:
+        for position in positions[1:]:
+            np.testing.assert_array_equal(positions[0], position)
+
+
+def test_checkerboard_nec():
+    """Test that NEC integrators reject checkerboard trial moves."""
+    mc = hoomd.hpmc.nec.integrate.Sphere()
+    assert not mc.checkerboard
+    mc.checkerboard = False
+
+    with pytest.raises(ValueError):
+        mc.checkerboard = True
+    assert not mc.checkerboard
+
+
 def test_kernel_parameters(simulation_factory, lattice_snapshot_factory,
                            test_moves_args):
     integrator = test_moves_args[0]
@@ -105,3 +105,181 @@ UP_TEST(bigger)
         UP_ASSERT(in(i, hits));
         }
     }
+
+//! List the leaf nodes that overlap aabb with the stackless traversal of the binary tree
+std::vector<unsigned int> binary_leaves(const AABBTree& tree, const AABB& aabb)
+    {
+    std::vector<unsigned int> leaves;
+    for (unsigned int cur_node_idx = 0; cur_node_idx < tree.getNumNodes(); cur_node_idx++)
+        {
+        if (aabb.overlaps(tree.getNodeAABB(cur_node_idx)))
+            {
+            if (tree.isNodeLeaf(cur_node_idx))
+                leaves.push_back(cur_node_idx);
+            }
+        else
+            {
+            cur_node_idx += tree.getNodeSkip(cur_node_idx);
+            }
+        }
+    return leaves;
+    }
+
+//! List the leaf nodes that overlap aabb with the traversal of the wide BVH
+std::vector<unsigned int> wide_leaves(const AABBTree& tree, const AABB& aabb)
+    {
+    std::vector<unsigned int> leaves;
+    AABBTreeTraversal traversal(tree, aabb);
+    for (unsigned int node = traversal.next(); node != INVALID_NODE; node = traversal.next())
+        leaves.push_back(node);
+    return leaves;
+    }
+
+UP_TEST(wide)
+    {
+    hoomd::RandomGenerator rng(hoomd::Seed(0, 1, 2), hoomd::Counter(4, 5, 6));
+
+    for (unsigned int N : {1, 16, 17, 100, 5000})
+        {
+        std::vector<vec3<Scalar>> points(N);
+        std::vector<AABB> aabbs(N);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            points[i] = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                     hoomd::detail::generate_canonical<float>(rng),
+                                     hoomd::detail::generate_canonical<float>(rng))
+                        * Scalar(100);
+            aabbs[i] = AABB(points[i], Scalar(1.0));
+            }
+
+        AABBTree tree;
+        tree.buildTree(aabbs.data(), N);
+
+        // the wide traversal visits the same leaves in the same order
+        for (unsigned int i = 0; i < N; i++)
+            {
+            AABB query(points[i], Scalar(3.0));
+            UP_ASSERT(wide_leaves(tree, query) == binary_leaves(tree, query));
+            }
+
+        // also after the boxes grow with update()
+        for (unsigned int i = 0; i < N; i++)
+            {
+            points[i] += vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                      hoomd::detail::generate_canonical<float>(rng),
+                                      hoomd::detail::generate_canonical<float>(rng));
+            tree.update(i, AABB(points[i], Scalar(1.0)));
+            }
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            AABB query(points[i], Scalar(3.0));
+            UP_ASSERT(wide_leaves(tree, query) == binary_leaves(tree, query));
+            }
+
+        // and for copies of the tree
+        AABBTree copy(tree);
+        AABB query(vec3<Scalar>(50, 50, 50), Scalar(20.0));
+        UP_ASSERT(wide_leaves(copy, query) == binary_leaves(tree, query));
+        }
+    }
+
+UP_TEST(refit)
+    {
+    const unsigned int N = 1000;
+    hoomd::RandomGenerator rng(hoomd::Seed(0, 1, 2), hoomd::Counter(4, 5, 6));
+
+    std::vector<vec3<Scalar>> points(N);
+    std::vector<AABB> aabbs(N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                 hoomd::detail::generate_canonical<float>(rng),
+                                 hoomd::detail::generate_canonical<float>(rng))
+                    * Scalar(100);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        aabbs[i].tag = i;
+        }
+
+    AABBTree tree;
+    tree.buildTree(aabbs.data(), N);
+
+    // refit() needs the same number of particles
+    UP_ASSERT(!tree.refit(aabbs.data(), N - 1));
+
+    // small moves keep the tree quality, and the refit tree finds all particles
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] += vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                  hoomd::detail::generate_canonical<float>(rng),
+                                  hoomd::detail::generate_canonical<float>(rng))
+                     * Scalar(0.1);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        aabbs[i].tag = N + i;
+        }
+    UP_ASSERT(tree.refit(aabbs.data(), N));
+
+    std::vector<unsigned int> hits;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        hits.clear();
+        tree.query(hits, AABB(points[i], Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        }
+
+    // the leaves carry the new tags and every node is tight around its children
+    for (unsigned int node = 0; node < tree.getNumNodes(); node++)
+        {
+        AABB aabb;
+        if (tree.isNodeLeaf(node))
+            {
+            aabb = aabbs[tree.getNodeParticle(node, 0)];
+            for (unsigned int j = 0; j < tree.getNodeNumParticles(node); j++)
+                {
+                unsigned int i = tree.getNodeParticle(node, j);
+                UP_ASSERT_EQUAL(tree.getNodeParticleTag(node, j), N + i);
+                aabb = merge(aabb, aabbs[i]);
+                }
+            }
+        else
+            {
+            aabb = merge(tree.getNodeAABB(tree.getNodeLeft(node)),
+                         tree.getNodeAABB(tree.getNode(node).right));
+            }
+        vec3<Scalar> lower = tree.getNodeAABB(node).getLower();
+        vec3<Scalar> upper = tree.getNodeAABB(node).getUpper();
+        UP_ASSERT(lower == aabb.getLower() && upper == aabb.getUpper());
+        }
+
+    // the refit tree finds the same set of overlapping particles as a tree built from the new
+    // AABBs, but the leaves group the particles differently and the trees visit them in a different
+    // order, so compare the sorted overlaps
+    AABBTree rebuilt;
+    rebuilt.buildTree(aabbs.data(), N);
+    auto find_overlaps = [&](const AABBTree& t, const AABB& aabb)
+    {
+        std::vector<unsigned int> candidates, overlaps;
+        t.query(candidates, aabb);
+        for (unsigned int j : candidates)
+            {
+            if (aabb.overlaps(aabbs[j]))
+                overlaps.push_back(j);
+            }
+        std::sort(overlaps.begin(), overlaps.end());
+        return overlaps;
+    };
+    for (unsigned int i = 0; i < N; i++)
+        {
+        AABB aabb(points[i], Scalar(3.0));
+        UP_ASSERT(find_overlaps(tree, aabb) == find_overlaps(rebuilt, aabb));
+        }
+
+    // the wide BVH follows the refit
+    AABB query(vec3<Scalar>(50, 50, 50), Scalar(20.0));
+    UP_ASSERT(wide_leaves(tree, query) == binary_leaves(tree, query));
+
+    // scrambling the particles degrades the tree past the threshold
+    for (unsigned int i = 0; i < N; i++)
+        aabbs[i] = AABB(points[(i * 7919) % N], Scalar(1.0));
+    UP_ASSERT(!tree.refit(aabbs.data(), N));
+    }
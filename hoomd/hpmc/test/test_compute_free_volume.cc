@@ -0,0 +1,88 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/CellList.h"
+#include "hoomd/hpmc/ComputeFreeVolume.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <memory>
+
+using namespace hoomd;
+using namespace std;
+using namespace hoomd::hpmc;
+
+/*! \file test_compute_free_volume.cc
+    \brief Checks that ComputeFreeVolume gives the same result with any number of threads
+    \ingroup unit_tests
+*/
+
+//! Estimate the free volume of a sphere system with \a num_threads threads
+Scalar compute_free_volume(unsigned int num_threads)
+    {
+    const unsigned int N = 4000;
+    const unsigned int n = 16;
+    const Scalar a = Scalar(1.2);
+    const Scalar L = a * n;
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+#endif
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        // a jittered lattice without overlaps
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int ix = i % n, iy = (i / n) % n, iz = i / (n * n);
+            h_pos.data[i].x = -L / 2 + (ix + Scalar(0.5)) * a + Scalar(0.05) * sin(Scalar(i));
+            h_pos.data[i].y = -L / 2 + (iy + Scalar(0.5)) * a + Scalar(0.05) * cos(Scalar(i));
+            h_pos.data[i].z = -L / 2 + (iz + Scalar(0.5)) * a + Scalar(0.05) * sin(Scalar(3 * i));
+            }
+        }
+
+    std::shared_ptr<IntegratorHPMCMono<ShapeSphere>> mc(
+        new IntegratorHPMCMono<ShapeSphere>(sysdef));
+    SphereParams params;
+    params.radius = Scalar(0.5);
+    params.ignore = false;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->prepRun(0);
+
+    std::shared_ptr<CellList> cl(new CellList(sysdef));
+    std::shared_ptr<ComputeFreeVolume<ShapeSphere>> free_volume(
+        new ComputeFreeVolume<ShapeSphere>(sysdef, mc, cl));
+    // enough samples that they are split over many threads
+    free_volume->setNumSamples(200000);
+    free_volume->compute(5);
+    return free_volume->getFreeVolume();
+    }
+
+#ifdef ENABLE_TBB
+//! The free volume estimate does not depend on the number of threads
+UP_TEST(compute_free_volume_threads)
+    {
+    Scalar serial = compute_free_volume(1);
+
+    // the estimate is a nonzero fraction of the box volume
+    const Scalar L = Scalar(1.2 * 16);
+    UP_ASSERT(serial > Scalar(0.0));
+    UP_ASSERT(serial < L * L * L);
+
+    for (unsigned int num_threads : {2, 3, 8})
+        UP_ASSERT_EQUAL(compute_free_volume(num_threads), serial);
+    }
+#endif
@@ -0,0 +1,147 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/ComputeSDF.h"
+#include "hoomd/hpmc/PairPotential.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <memory>
+#include <vector>
+
+using namespace hoomd;
+using namespace std;
+using namespace hoomd::hpmc;
+
+/*! \file test_compute_sdf.cc
+    \brief Checks that ComputeSDF gives the same histograms with any number of threads
+    \ingroup unit_tests
+*/
+
+//! Soft repulsion that puts ComputeSDF in its pair potential mode
+class SoftRepulsion : public PairPotential
+    {
+    public:
+    SoftRepulsion(std::shared_ptr<SystemDefinition> sysdef) : PairPotential(sysdef)
+        {
+        notifyRCutChanged();
+        }
+
+    virtual LongReal energy(const LongReal r_squared,
+                            const vec3<LongReal>& r_ij,
+                            const unsigned int type_i,
+                            const quat<LongReal>& q_i,
+                            const LongReal charge_i,
+                            const unsigned int type_j,
+                            const quat<LongReal>& q_j,
+                            const LongReal charge_j) const
+        {
+        LongReal s6 = 1 / (r_squared * r_squared * r_squared);
+        return LongReal(0.3) * (s6 * s6 - s6);
+        }
+
+    virtual LongReal computeRCutNonAdditive(unsigned int type_i, unsigned int type_j) const
+        {
+        return 1.6;
+        }
+    };
+
+//! ComputeSDF that exposes the computed histograms
+class ComputeSDFSphere : public ComputeSDF<ShapeSphere>
+    {
+    public:
+    using ComputeSDF<ShapeSphere>::ComputeSDF;
+
+    const std::vector<double>& getCompression()
+        {
+        return m_sdf_compression;
+        }
+
+    const std::vector<double>& getExpansion()
+        {
+        return m_sdf_expansion;
+        }
+    };
+
+//! Compute the SDF of a dense sphere system with \a num_threads threads
+std::vector<double> compute_sdf(unsigned int num_threads, bool pair_potential)
+    {
+    const unsigned int N = 4000;
+    const unsigned int n = 16;
+    const Scalar a = Scalar(1.02);
+    const Scalar L = a * n;
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+#endif
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        // a jittered lattice without overlaps, with many pairs close to contact
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int ix = i % n, iy = (i / n) % n, iz = i / (n * n);
+            h_pos.data[i].x = -L / 2 + (ix + Scalar(0.5)) * a + Scalar(0.004) * sin(Scalar(i));
+            h_pos.data[i].y = -L / 2 + (iy + Scalar(0.5)) * a + Scalar(0.004) * cos(Scalar(i));
+            h_pos.data[i].z = -L / 2 + (iz + Scalar(0.5)) * a + Scalar(0.004) * sin(Scalar(3 * i));
+            }
+        }
+
+    std::shared_ptr<IntegratorHPMCMono<ShapeSphere>> mc(
+        new IntegratorHPMCMono<ShapeSphere>(sysdef));
+    SphereParams params;
+    params.radius = Scalar(0.5);
+    params.ignore = false;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    if (pair_potential)
+        mc->getPairPotentials().push_back(std::make_shared<SoftRepulsion>(sysdef));
+    mc->prepRun(0);
+
+    std::shared_ptr<ComputeSDFSphere> sdf(new ComputeSDFSphere(sysdef, mc, 0.02, 1e-4));
+    sdf->compute(0);
+
+    std::vector<double> result(sdf->getCompression());
+    result.insert(result.end(), sdf->getExpansion().begin(), sdf->getExpansion().end());
+    return result;
+    }
+
+//! Check that the histograms are not empty and do not depend on the number of threads
+void sdf_thread_test(bool pair_potential)
+    {
+    std::vector<double> serial = compute_sdf(1, pair_potential);
+
+    double sum = 0;
+    for (double value : serial)
+        sum += value;
+    UP_ASSERT(sum > 0);
+
+    for (unsigned int num_threads : {2, 3, 8})
+        UP_ASSERT(compute_sdf(num_threads, pair_potential) == serial);
+    }
+
+#ifdef ENABLE_TBB
+//! Hard spheres
+UP_TEST(compute_sdf_threads)
+    {
+    sdf_thread_test(false);
+    }
+
+//! Spheres with a pair potential
+UP_TEST(compute_sdf_pair_threads)
+    {
+    sdf_thread_test(true);
+    }
+#endif
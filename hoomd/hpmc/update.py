@@ -409,6 +409,10 @@ class MuVT(Updater):
           (applies to Gibbs ensemble)
         ntrial (float): (**default**: 1) Number of configurational bias attempts
           to swap depletants
+        batch_size (int): (**default**: 1) Number of insertion and removal
+          moves per update. When greater than 1, `MuVT` checks the insertion
+          moves of a batch for overlaps in parallel threads. Not supported in
+          the Gibbs ensemble, with depletants, or with domain decomposition.
         fugacity (`TypeParameter` [ ``particle type``, `float`]):
             Particle fugacity
             :math:`[\mathrm{volume}^{-1}]` (**default:** 0).
@@ -424,7 +428,7 @@ class MuVT(Updater):
 
         self.ngibbs = int(ngibbs)
 
-        _default_dict = dict(ntrial=1)
+        _default_dict = dict(ntrial=1, batch_size=1)
         param_dict = ParameterDict(
             transfer_types=list(transfer_types),
             max_volume_rescale=float(max_volume_rescale),
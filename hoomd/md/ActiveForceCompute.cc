@@ -247,18 +247,33 @@ void ActiveForceCompute::rotationalDiffusion(Scalar rotational_diffusion, uint64
     assert(h_tag.data != NULL);
 
     const auto rotation_constant = slow::sqrt(2.0 * rotational_diffusion * m_deltaT);
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
+
+    // generate the random numbers for rng_batch_width particles at a time
+    const unsigned int group_size = m_group->getNumMembers();
+    const hoomd::Seed rng_seed(hoomd::RNGIdentifier::ActiveForceCompute,
+                               timestep,
+                               m_sysdef->getSeed());
+    hoomd::RandomGeneratorBatch<3> rng_batch;
+    auto rng_counter = [&](unsigned int i)
+    { return hoomd::Counter(h_tag.data[m_group->getMemberIndex(i)]); };
+
+    for (unsigned int i = 0; i < group_size; i++)
         {
         unsigned int idx = m_group->getMemberIndex(i);
         unsigned int type = __scalar_as_int(h_pos.data[idx].w);
 
+        unsigned int batch_idx = i % hoomd::rng_batch_width;
+        if (batch_idx == 0)
+            {
+            rng_batch.generate(rng_seed,
+                               std::min(hoomd::rng_batch_width, group_size - i),
+                               [&](unsigned int k) { return rng_counter(i + k); },
+                               m_sysdef->getNDimensions() == 2 ? 1 : 3);
+            }
+
         if (h_f_actVec.data[type].w != 0)
             {
-            unsigned int ptag = h_tag.data[idx];
-            hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::ActiveForceCompute,
-                                                   timestep,
-                                                   m_sysdef->getSeed()),
-                                       hoomd::Counter(ptag));
+            hoomd::BatchedRandomGenerator rng = rng_batch.getGenerator(batch_idx);
 
             quat<Scalar> quati(h_orientation.data[idx]);
 
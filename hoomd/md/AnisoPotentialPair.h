@@ -15,10 +15,16 @@
 
 #include "NeighborList.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 
 #include "hoomd/ManagedArray.h"
 #include "hoomd/VectorMath.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*! \file AnisoPotentialPair.h
     \brief Defines the template class for anisotropic pair potentials
     \details The heart of the code that computes anisotropic pair potentials is in this file.
@@ -234,6 +240,11 @@ template<class aniso_evaluator> class AnisoPotentialPair : public ForceCompute
     /// r_cut (not squared) given to the neighbor list
     std::shared_ptr<GlobalArray<Scalar>> m_r_cut_nlist;
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation with half neighbor lists
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
     };
@@ -513,157 +524,226 @@ void AnisoPotentialPair<aniso_evaluator>::computeForces(uint64_t timestep)
         PDataFlags flags = this->m_pdata->getFlags();
         bool compute_virial = flags[pdata_flag::pressure_tensor];
 
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
-            {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            Scalar4 quat_i = h_orientation.data[i];
-
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // access charge (if needed)
-            Scalar qi = Scalar(0.0);
-            if (aniso_evaluator::needsCharge())
-                qi = h_charge.data[i];
-
-            // initialize current particle force, torque, potential energy, and virial to 0
-            Scalar fxi = Scalar(0.0);
-            Scalar fyi = Scalar(0.0);
-            Scalar fzi = Scalar(0.0);
-            Scalar txi = Scalar(0.0);
-            Scalar tyi = Scalar(0.0);
-            Scalar tzi = Scalar(0.0);
-            Scalar pei = Scalar(0.0);
-            Scalar virialxxi = 0.0;
-            Scalar virialxyi = 0.0;
-            Scalar virialxzi = 0.0;
-            Scalar virialyyi = 0.0;
-            Scalar virialyzi = 0.0;
-            Scalar virialzzi = 0.0;
-
-            // loop over all of the neighbors of this particle
-            const size_t myHead = h_head_list.data[i];
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
-            for (unsigned int k = 0; k < size; k++)
+        // compute the forces and torques on particles [first, last) (and their neighbors when using
+        // a half neighbor list)
+        auto compute_range = [&](unsigned int first,
+                                 unsigned int last,
+                                 Scalar4* force_out,
+                                 Scalar4* torque_out,
+                                 Scalar* virial,
+                                 size_t virial_pitch)
+        {
+            for (unsigned int i = first; i < last; i++)
                 {
-                // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-                unsigned int j = h_nlist.data[myHead + k];
-                assert(j < m_pdata->getN() + m_pdata->getNGhosts());
-
-                // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-                Scalar3 dx = pi - pj;
-                Scalar4 quat_j = h_orientation.data[j];
+                // access the particle's position and type (MEM TRANSFER: 4 scalars)
+                Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+                unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+                Scalar4 quat_i = h_orientation.data[i];
 
-                // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-                unsigned int typej = __scalar_as_int(h_pos.data[j].w);
-                assert(typej < m_pdata->getNTypes());
+                // sanity check
+                assert(typei < m_pdata->getNTypes());
 
                 // access charge (if needed)
-                Scalar qj = Scalar(0.0);
-                if (aniso_evaluator::needsCharge())
-                    qj = h_charge.data[j];
-
-                // apply periodic boundary conditions
-                dx = box.minImage(dx);
-
-                // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                const param_type& param = m_params[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
-
-                // design specifies that energies are shifted if
-                // shift mode is set to shift
-                bool energy_shift = false;
-                if (m_shift_mode == shift)
-                    energy_shift = true;
-
-                // compute the force and potential energy
-                Scalar3 force = make_scalar3(0.0, 0.0, 0.0);
-                Scalar3 torque_i = make_scalar3(0.0, 0.0, 0.0);
-                Scalar3 torque_j = make_scalar3(0.0, 0.0, 0.0);
-
-                Scalar pair_eng = Scalar(0.0);
-
-                aniso_evaluator eval(dx, quat_i, quat_j, rcutsq, param);
-
+                Scalar qi = Scalar(0.0);
                 if (aniso_evaluator::needsCharge())
-                    eval.setCharge(qi, qj);
-                if (aniso_evaluator::needsShape())
-                    eval.setShape(&m_shape_params[typei], &m_shape_params[typej]);
-                if (aniso_evaluator::needsTags())
-                    eval.setTags(h_tag.data[i], h_tag.data[j]);
-
-                bool evaluated = eval.evaluate(force, pair_eng, energy_shift, torque_i, torque_j);
-
-                if (evaluated)
+                    qi = h_charge.data[i];
+
+                // initialize current particle force, torque, potential energy, and virial to 0
+                Scalar fxi = Scalar(0.0);
+                Scalar fyi = Scalar(0.0);
+                Scalar fzi = Scalar(0.0);
+                Scalar txi = Scalar(0.0);
+                Scalar tyi = Scalar(0.0);
+                Scalar tzi = Scalar(0.0);
+                Scalar pei = Scalar(0.0);
+                Scalar virialxxi = 0.0;
+                Scalar virialxyi = 0.0;
+                Scalar virialxzi = 0.0;
+                Scalar virialyyi = 0.0;
+                Scalar virialyzi = 0.0;
+                Scalar virialzzi = 0.0;
+
+                // loop over all of the neighbors of this particle
+                const size_t myHead = h_head_list.data[i];
+                const unsigned int size = (unsigned int)h_n_neigh.data[i];
+                for (unsigned int k = 0; k < size; k++)
                     {
-                    Scalar3 force2 = Scalar(0.5) * force;
-
-                    // add the force, potential energy and virial to the particle i
-                    // (FLOPS: 8)
-                    fxi += force.x;
-                    fyi += force.y;
-                    fzi += force.z;
-                    txi += torque_i.x;
-                    tyi += torque_i.y;
-                    tzi += torque_i.z;
-                    pei += pair_eng * Scalar(0.5);
-
-                    if (compute_virial)
+                    // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                    unsigned int j = h_nlist.data[myHead + k];
+                    assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+                    // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                    Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+                    Scalar3 dx = pi - pj;
+                    Scalar4 quat_j = h_orientation.data[j];
+
+                    // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
+                    unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+                    assert(typej < m_pdata->getNTypes());
+
+                    // access charge (if needed)
+                    Scalar qj = Scalar(0.0);
+                    if (aniso_evaluator::needsCharge())
+                        qj = h_charge.data[j];
+
+                    // apply periodic boundary conditions
+                    dx = box.minImage(dx);
+
+                    // get parameters for this type pair
+                    unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                    const param_type& param = m_params[typpair_idx];
+                    Scalar rcutsq = h_rcutsq.data[typpair_idx];
+
+                    // design specifies that energies are shifted if
+                    // shift mode is set to shift
+                    bool energy_shift = false;
+                    if (m_shift_mode == shift)
+                        energy_shift = true;
+
+                    // compute the force and potential energy
+                    Scalar3 force = make_scalar3(0.0, 0.0, 0.0);
+                    Scalar3 torque_i = make_scalar3(0.0, 0.0, 0.0);
+                    Scalar3 torque_j = make_scalar3(0.0, 0.0, 0.0);
+
+                    Scalar pair_eng = Scalar(0.0);
+
+                    aniso_evaluator eval(dx, quat_i, quat_j, rcutsq, param);
+
+                    if (aniso_evaluator::needsCharge())
+                        eval.setCharge(qi, qj);
+                    if (aniso_evaluator::needsShape())
+                        eval.setShape(&m_shape_params[typei], &m_shape_params[typej]);
+                    if (aniso_evaluator::needsTags())
+                        eval.setTags(h_tag.data[i], h_tag.data[j]);
+
+                    bool evaluated
+                        = eval.evaluate(force, pair_eng, energy_shift, torque_i, torque_j);
+
+                    if (evaluated)
                         {
-                        virialxxi += dx.x * force2.x;
-                        virialxyi += dx.y * force2.x;
-                        virialxzi += dx.z * force2.x;
-                        virialyyi += dx.y * force2.y;
-                        virialyzi += dx.z * force2.y;
-                        virialzzi += dx.z * force2.z;
-                        }
+                        Scalar3 force2 = Scalar(0.5) * force;
+
+                        // add the force, potential energy and virial to the particle i
+                        // (FLOPS: 8)
+                        fxi += force.x;
+                        fyi += force.y;
+                        fzi += force.z;
+                        txi += torque_i.x;
+                        tyi += torque_i.y;
+                        tzi += torque_i.z;
+                        pei += pair_eng * Scalar(0.5);
 
-                    // add the force to particle j if we are using the third law (MEM TRANSFER: 10
-                    // scalars / FLOPS: 8)
-                    if (third_law)
-                        {
-                        h_force.data[j].x -= force.x;
-                        h_force.data[j].y -= force.y;
-                        h_force.data[j].z -= force.z;
-                        h_torque.data[j].x += torque_j.x;
-                        h_torque.data[j].y += torque_j.y;
-                        h_torque.data[j].z += torque_j.z;
-                        h_force.data[j].w += pair_eng * Scalar(0.5);
                         if (compute_virial)
                             {
-                            h_virial.data[0 * m_virial_pitch + j] += dx.x * force2.x;
-                            h_virial.data[1 * m_virial_pitch + j] += dx.y * force2.x;
-                            h_virial.data[2 * m_virial_pitch + j] += dx.z * force2.x;
-                            h_virial.data[3 * m_virial_pitch + j] += dx.y * force2.y;
-                            h_virial.data[4 * m_virial_pitch + j] += dx.z * force2.y;
-                            h_virial.data[5 * m_virial_pitch + j] += dx.z * force2.z;
+                            virialxxi += dx.x * force2.x;
+                            virialxyi += dx.y * force2.x;
+                            virialxzi += dx.z * force2.x;
+                            virialyyi += dx.y * force2.y;
+                            virialyzi += dx.z * force2.y;
+                            virialzzi += dx.z * force2.z;
+                            }
+
+                        // add the force to particle j if we are using the third law (MEM
+                        // TRANSFER: 10 scalars / FLOPS: 8)
+                        if (third_law)
+                            {
+                            force_out[j].x -= force.x;
+                            force_out[j].y -= force.y;
+                            force_out[j].z -= force.z;
+                            torque_out[j].x += torque_j.x;
+                            torque_out[j].y += torque_j.y;
+                            torque_out[j].z += torque_j.z;
+                            force_out[j].w += pair_eng * Scalar(0.5);
+                            if (compute_virial)
+                                {
+                                virial[0 * virial_pitch + j] += dx.x * force2.x;
+                                virial[1 * virial_pitch + j] += dx.y * force2.x;
+                                virial[2 * virial_pitch + j] += dx.z * force2.x;
+                                virial[3 * virial_pitch + j] += dx.y * force2.y;
+                                virial[4 * virial_pitch + j] += dx.z * force2.y;
+                                virial[5 * virial_pitch + j] += dx.z * force2.z;
+                                }
                             }
                         }
                     }
+
+                // finally, increment the force, potential energy and virial for particle i
+                force_out[i].x += fxi;
+                force_out[i].y += fyi;
+                force_out[i].z += fzi;
+                torque_out[i].x += txi;
+                torque_out[i].y += tyi;
+                torque_out[i].z += tzi;
+                force_out[i].w += pei;
+                if (compute_virial)
+                    {
+                    virial[0 * virial_pitch + i] += virialxxi;
+                    virial[1 * virial_pitch + i] += virialxyi;
+                    virial[2 * virial_pitch + i] += virialxzi;
+                    virial[3 * virial_pitch + i] += virialyyi;
+                    virial[4 * virial_pitch + i] += virialyzi;
+                    virial[5 * virial_pitch + i] += virialzzi;
+                    }
                 }
+        };
 
-            // finally, increment the force, potential energy and virial for particle i
-            h_force.data[i].x += fxi;
-            h_force.data[i].y += fyi;
-            h_force.data[i].z += fzi;
-            h_torque.data[i].x += txi;
-            h_torque.data[i].y += tyi;
-            h_torque.data[i].z += tzi;
-            h_force.data[i].w += pei;
-            if (compute_virial)
+#ifdef ENABLE_TBB
+        if (m_exec_conf->getNumThreads() > 1)
+            {
+            const unsigned int N = m_pdata->getN();
+            m_exec_conf->getTaskArena()->execute(
+                [&]
                 {
-                h_virial.data[0 * m_virial_pitch + i] += virialxxi;
-                h_virial.data[1 * m_virial_pitch + i] += virialxyi;
-                h_virial.data[2 * m_virial_pitch + i] += virialxzi;
-                h_virial.data[3 * m_virial_pitch + i] += virialyyi;
-                h_virial.data[4 * m_virial_pitch + i] += virialyzi;
-                h_virial.data[5 * m_virial_pitch + i] += virialzzi;
-                }
+                    if (third_law)
+                        {
+                        // forces and torques are also applied to j: accumulate each chunk of
+                        // particles in its own buffer and sum the buffers in a fixed order
+                        m_scatter_buffers.resize(m_exec_conf->getNumThreads(),
+                                                 N,
+                                                 true,
+                                                 compute_virial);
+                        m_scatter_buffers.parallelForChunks(
+                            N,
+                            [&](unsigned int c, unsigned int first, unsigned int last)
+                            {
+                                compute_range(first,
+                                              last,
+                                              m_scatter_buffers.getForce(c),
+                                              m_scatter_buffers.getTorque(c),
+                                              m_scatter_buffers.getVirial(c),
+                                              m_scatter_buffers.getVirialPitch());
+                            });
+                        m_scatter_buffers.reduce(h_force.data,
+                                                 h_torque.data,
+                                                 h_virial.data,
+                                                 m_virial_pitch);
+                        }
+                    else
+                        {
+                        // with a full neighbor list, each thread writes only to the particles it
+                        // owns
+                        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+                                          [&](const tbb::blocked_range<unsigned int>& r)
+                                          {
+                                              compute_range(r.begin(),
+                                                            r.end(),
+                                                            h_force.data,
+                                                            h_torque.data,
+                                                            h_virial.data,
+                                                            m_virial_pitch);
+                                          });
+                        }
+                });
+            }
+        else
+#endif
+            {
+            compute_range(0,
+                          m_pdata->getN(),
+                          h_force.data,
+                          h_torque.data,
+                          h_virial.data,
+                          m_virial_pitch);
             }
         }
     }
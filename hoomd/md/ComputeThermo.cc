@@ -6,6 +6,7 @@
 */
 
 #include "ComputeThermo.h"
+#include "hoomd/DeterministicReduce.h"
 #include "hoomd/VectorMath.h"
 
 #ifdef ENABLE_MPI
@@ -96,82 +97,85 @@ void ComputeThermo::computeProperties()
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::read);
 
-    // total kinetic energy
-    double ke_trans_total = 0.0;
-
     PDataFlags flags = m_pdata->getFlags();
+    const bool pressure_tensor = flags[pdata_flag::pressure_tensor];
+    const bool rotational_kinetic_energy = flags[pdata_flag::rotational_kinetic_energy];
 
-    double pressure_kinetic_xx = 0.0;
-    double pressure_kinetic_xy = 0.0;
-    double pressure_kinetic_xz = 0.0;
-    double pressure_kinetic_yy = 0.0;
-    double pressure_kinetic_yz = 0.0;
-    double pressure_kinetic_zz = 0.0;
-
-    if (flags[pdata_flag::pressure_tensor])
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
+                                       access_location::host,
+                                       access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(),
+                                  access_location::host,
+                                  access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(),
+                                   access_location::host,
+                                   access_mode::read);
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                            access_location::host,
+                                            access_mode::read);
+    size_t virial_pitch = net_virial.getPitch();
+
+    //! Partial sums over a range of group members
+    struct ThermoSums
         {
-        // Calculate kinetic part of pressure tensor
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        double kinetic[6] = {0, 0, 0, 0, 0, 0}; //!< Kinetic part of the pressure tensor
+        double ke_trans = 0.0;                  //!< Twice the translational kinetic energy
+        double ke_rot = 0.0;                    //!< Twice the rotational kinetic energy
+        double pe = 0.0;                        //!< Potential energy
+        double virial[6] = {0, 0, 0, 0, 0, 0};  //!< Virial tensor
+
+        ThermoSums operator+(const ThermoSums& b) const
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+            ThermoSums r;
+            for (unsigned int k = 0; k < 6; k++)
                 {
-                double mass = h_vel.data[j].w;
-                pressure_kinetic_xx += mass * ((double)h_vel.data[j].x * (double)h_vel.data[j].x);
-                pressure_kinetic_xy += mass * ((double)h_vel.data[j].x * (double)h_vel.data[j].y);
-                pressure_kinetic_xz += mass * ((double)h_vel.data[j].x * (double)h_vel.data[j].z);
-                pressure_kinetic_yy += mass * ((double)h_vel.data[j].y * (double)h_vel.data[j].y);
-                pressure_kinetic_yz += mass * ((double)h_vel.data[j].y * (double)h_vel.data[j].z);
-                pressure_kinetic_zz += mass * ((double)h_vel.data[j].z * (double)h_vel.data[j].z);
+                r.kinetic[k] = kinetic[k] + b.kinetic[k];
+                r.virial[k] = virial[k] + b.virial[k];
                 }
+            r.ke_trans = ke_trans + b.ke_trans;
+            r.ke_rot = ke_rot + b.ke_rot;
+            r.pe = pe + b.pe;
+            return r;
             }
-        // kinetic energy = 1/2 trace of kinetic part of pressure tensor
-        ke_trans_total
-            = Scalar(0.5) * (pressure_kinetic_xx + pressure_kinetic_yy + pressure_kinetic_zz);
-        }
-    else
-        {
-        // total kinetic energy
-        #pragma omp simd
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        };
+
+    // sum all per-particle quantities in one pass over a block of group members
+    auto sum_range = [&](unsigned int first, unsigned int last)
+    {
+        ThermoSums sums;
+        for (unsigned int group_idx = first; group_idx < last; group_idx++)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
-                {
-                ke_trans_total += (double)h_vel.data[j].w
-                                  * ((double)h_vel.data[j].x * (double)h_vel.data[j].x
-                                     + (double)h_vel.data[j].y * (double)h_vel.data[j].y
-                                     + (double)h_vel.data[j].z * (double)h_vel.data[j].z);
-                }
-            }
+            unsigned int j = h_index_array.data[group_idx];
 
-        ke_trans_total *= Scalar(0.5);
-        }
+            // ignore rigid body constituent particles in the sum
+            if (!(h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j]))
+                continue;
 
-    // total rotational kinetic energy
-    double ke_rot_total = 0.0;
+            double mass = h_vel.data[j].w;
+            double vx = h_vel.data[j].x;
+            double vy = h_vel.data[j].y;
+            double vz = h_vel.data[j].z;
 
-    if (flags[pdata_flag::rotational_kinetic_energy])
-        {
-        // Calculate rotational part of kinetic energy
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(),
-                                           access_location::host,
-                                           access_mode::read);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(),
-                                      access_location::host,
-                                      access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(),
-                                       access_location::host,
-                                       access_mode::read);
+            if (pressure_tensor)
+                {
+                // kinetic part of the pressure tensor
+                sums.kinetic[0] += mass * (vx * vx);
+                sums.kinetic[1] += mass * (vx * vy);
+                sums.kinetic[2] += mass * (vx * vz);
+                sums.kinetic[3] += mass * (vy * vy);
+                sums.kinetic[4] += mass * (vy * vz);
+                sums.kinetic[5] += mass * (vz * vz);
+
+                // upper triangular virial tensor
+                for (unsigned int k = 0; k < 6; k++)
+                    sums.virial[k] += (double)h_net_virial.data[j + k * virial_pitch];
+                }
+            else
+                {
+                sums.ke_trans += mass * (vx * vx + vy * vy + vz * vz);
+                }
 
-        #pragma omp simd
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+            if (rotational_kinetic_energy)
                 {
                 Scalar3 I = h_inertia.data[j];
                 quat<Scalar> q(h_orientation.data[j]);
@@ -182,38 +186,56 @@ void ComputeThermo::computeProperties()
                 // carries angular momentum
                 if (I.x > 0)
                     {
-                    ke_rot_total += s.v.x * s.v.x / I.x;
+                    sums.ke_rot += s.v.x * s.v.x / I.x;
                     }
                 if (I.y > 0)
                     {
-                    ke_rot_total += s.v.y * s.v.y / I.y;
+                    sums.ke_rot += s.v.y * s.v.y / I.y;
                     }
                 if (I.z > 0)
                     {
-                    ke_rot_total += s.v.z * s.v.z / I.z;
+                    sums.ke_rot += s.v.z * s.v.z / I.z;
                     }
                 }
+
+            sums.pe += (double)h_net_force.data[j].w;
             }
+        return sums;
+    };
+
+    // the blocked pairwise reduction gives the same result with any number of threads
+    ThermoSums sums = hoomd::detail::deterministicReduce(
+        *m_exec_conf,
+        group_size,
+        ThermoSums(),
+        sum_range,
+        [](const ThermoSums& a, const ThermoSums& b) { return a + b; });
+
+    double pressure_kinetic_xx = sums.kinetic[0];
+    double pressure_kinetic_xy = sums.kinetic[1];
+    double pressure_kinetic_xz = sums.kinetic[2];
+    double pressure_kinetic_yy = sums.kinetic[3];
+    double pressure_kinetic_yz = sums.kinetic[4];
+    double pressure_kinetic_zz = sums.kinetic[5];
 
-        ke_rot_total /= Scalar(2.0);
+    // total kinetic energy
+    double ke_trans_total;
+    if (pressure_tensor)
+        {
+        // kinetic energy = 1/2 trace of kinetic part of pressure tensor
+        ke_trans_total
+            = Scalar(0.5) * (pressure_kinetic_xx + pressure_kinetic_yy + pressure_kinetic_zz);
         }
-
-    // total potential energy
-    double pe_total = 0.0;
-
-    #pragma omp simd reduction(+:pe_total)
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    else
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-
-        // ignore rigid body constituent particles in the sum
-        if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
-            {
-            pe_total += (double)h_net_force.data[j].w;
-            }
+        ke_trans_total = Scalar(0.5) * sums.ke_trans;
         }
 
-    pe_total += m_pdata->getExternalEnergy();
+    // total rotational kinetic energy
+    double ke_rot_total = sums.ke_rot / Scalar(2.0);
+
+    // total potential energy
+    double pe_total = sums.pe + m_pdata->getExternalEnergy();
 
     double W = 0.0;
     double virial_xx = m_pdata->getExternalVirial(0);
@@ -223,25 +245,14 @@ void ComputeThermo::computeProperties()
     double virial_yz = m_pdata->getExternalVirial(4);
     double virial_zz = m_pdata->getExternalVirial(5);
 
-    if (flags[pdata_flag::pressure_tensor])
+    if (pressure_tensor)
         {
-        // Calculate upper triangular virial tensor
-        size_t virial_pitch = net_virial.getPitch();
-        #pragma omp simd reduction(+:virial_xx, virial_xy, virial_xz, virial_yy, virial_yz, virial_zz)
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
-                {
-                virial_xx += (double)h_net_virial.data[j + 0 * virial_pitch];
-                virial_xy += (double)h_net_virial.data[j + 1 * virial_pitch];
-                virial_xz += (double)h_net_virial.data[j + 2 * virial_pitch];
-                virial_yy += (double)h_net_virial.data[j + 3 * virial_pitch];
-                virial_yz += (double)h_net_virial.data[j + 4 * virial_pitch];
-                virial_zz += (double)h_net_virial.data[j + 5 * virial_pitch];
-                }
-            }
+        virial_xx += sums.virial[0];
+        virial_xy += sums.virial[1];
+        virial_xz += sums.virial[2];
+        virial_yy += sums.virial[3];
+        virial_yz += sums.virial[4];
+        virial_zz += sums.virial[5];
 
         // isotropic virial = 1/3 trace of virial tensor
         W = Scalar(1. / 3.) * (virial_xx + virial_yy + virial_zz);
@@ -6,6 +6,7 @@
 */
 
 #include "ComputeThermoHMA.h"
+#include "hoomd/DeterministicReduce.h"
 #include "hoomd/VectorMath.h"
 
 #ifdef ENABLE_MPI
@@ -130,31 +131,67 @@ void ComputeThermoHMA::computeProperties()
         {
         volume = L.x * L.y * L.z;
         }
-    double pe_total = 0.0, p_HMA = 0.0;
     double fV = (m_harmonicPressure / m_temperature - group_size / box.getVolume())
                 / (D * (group_size - 1));
-    double W = 0;
     size_t virial_pitch = net_virial.getPitch();
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                            access_location::host,
+                                            access_mode::read);
+
+    //! Partial sums over a range of group members
+    struct HMASums
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        unsigned int tag = h_tag.data[group_idx];
-        pe_total += (double)h_net_force.data[j].w;
-        W += Scalar(1. / D)
-             * ((double)h_net_virial.data[j + 0 * virial_pitch]
-                + (double)h_net_virial.data[j + 3 * virial_pitch]
-                + (double)h_net_virial.data[j + 5 * virial_pitch]);
-
-        Scalar4 pos4 = h_pos.data[group_idx];
-        Scalar3 pos3 = make_scalar3(pos4.x, pos4.y, pos4.z);
-        Scalar3 dr = box.shift(pos3, h_image.data[group_idx]) - h_lattice_site.data[tag];
-        double fdr = 0;
-        fdr += (double)h_net_force.data[group_idx].x * dr.x;
-        fdr += (double)h_net_force.data[group_idx].y * dr.y;
-        fdr += (double)h_net_force.data[group_idx].z * dr.z;
-        pe_total += 0.5 * fdr;
-        p_HMA += fV * fdr;
-        }
+        double pe = 0.0;    //!< Potential energy plus the harmonic correction
+        double p_HMA = 0.0; //!< Anharmonic pressure correction
+        double W = 0.0;     //!< Isotropic virial
+
+        HMASums operator+(const HMASums& b) const
+            {
+            HMASums r;
+            r.pe = pe + b.pe;
+            r.p_HMA = p_HMA + b.p_HMA;
+            r.W = W + b.W;
+            return r;
+            }
+        };
+
+    // sum all per-particle quantities in one pass over a block of group members
+    auto sum_range = [&](unsigned int first, unsigned int last)
+    {
+        HMASums sums;
+        for (unsigned int group_idx = first; group_idx < last; group_idx++)
+            {
+            unsigned int j = h_index_array.data[group_idx];
+            unsigned int tag = h_tag.data[group_idx];
+            sums.pe += (double)h_net_force.data[j].w;
+            sums.W += Scalar(1. / D)
+                      * ((double)h_net_virial.data[j + 0 * virial_pitch]
+                         + (double)h_net_virial.data[j + 3 * virial_pitch]
+                         + (double)h_net_virial.data[j + 5 * virial_pitch]);
+
+            Scalar4 pos4 = h_pos.data[group_idx];
+            Scalar3 pos3 = make_scalar3(pos4.x, pos4.y, pos4.z);
+            Scalar3 dr = box.shift(pos3, h_image.data[group_idx]) - h_lattice_site.data[tag];
+            double fdr = 0;
+            fdr += (double)h_net_force.data[group_idx].x * dr.x;
+            fdr += (double)h_net_force.data[group_idx].y * dr.y;
+            fdr += (double)h_net_force.data[group_idx].z * dr.z;
+            sums.pe += 0.5 * fdr;
+            sums.p_HMA += fV * fdr;
+            }
+        return sums;
+    };
+
+    // the blocked pairwise reduction gives the same result with any number of threads
+    HMASums sums = hoomd::detail::deterministicReduce(
+        *m_exec_conf,
+        group_size,
+        HMASums(),
+        sum_range,
+        [](const HMASums& a, const HMASums& b) { return a + b; });
+
+    double pe_total = sums.pe, p_HMA = sums.p_HMA;
+    double W = sums.W;
     pe_total += 1.5 * (group_size - 1) * m_temperature;
     pe_total += m_pdata->getExternalEnergy();
 
@@ -135,7 +135,8 @@ class EvaluatorPairDPDThermoDPD
         \param _params Per type pair parameters of this potential
     */
     DEVICE EvaluatorPairDPDThermoDPD(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
-        : rsq(_rsq), rcutsq(_rcutsq), a(_params.A), gamma(_params.gamma)
+        : rsq(_rsq), rcutsq(_rcutsq), a(_params.A), gamma(_params.gamma), m_alpha(0),
+          m_has_alpha(false)
         {
         }
 
@@ -167,6 +168,18 @@ class EvaluatorPairDPDThermoDPD
         m_T = Temp;
         }
 
+    //! Set the random number of the pair
+    /*! \param alpha Uniform random number in [-1, 1] drawn from the RNG stream of the pair
+
+        evalForceEnergyThermo() uses \a alpha instead of drawing it, so that callers can generate
+        the random numbers of many pairs together.
+    */
+    DEVICE void setAlpha(Scalar alpha)
+        {
+        m_alpha = alpha;
+        m_has_alpha = true;
+        }
+
     //! Yukawa doesn't use charge
     DEVICE static bool needsCharge()
         {
@@ -234,25 +247,29 @@ class EvaluatorPairDPDThermoDPD
 
             // force calculation
 
-            unsigned int m_oi, m_oj;
-            // initialize the RNG
-            if (m_i > m_j)
+            Scalar alpha = m_alpha;
+            if (!m_has_alpha)
                 {
-                m_oi = m_j;
-                m_oj = m_i;
-                }
-            else
-                {
-                m_oi = m_i;
-                m_oj = m_j;
-                }
+                unsigned int m_oi, m_oj;
+                // initialize the RNG
+                if (m_i > m_j)
+                    {
+                    m_oi = m_j;
+                    m_oj = m_i;
+                    }
+                else
+                    {
+                    m_oi = m_i;
+                    m_oj = m_j;
+                    }
 
-            hoomd::RandomGenerator rng(
-                hoomd::Seed(hoomd::RNGIdentifier::EvaluatorPairDPDThermo, m_timestep, m_seed),
-                hoomd::Counter(m_oi, m_oj));
+                hoomd::RandomGenerator rng(
+                    hoomd::Seed(hoomd::RNGIdentifier::EvaluatorPairDPDThermo, m_timestep, m_seed),
+                    hoomd::Counter(m_oi, m_oj));
 
-            // Generate a single random number
-            Scalar alpha = hoomd::UniformDistribution<Scalar>(-1, 1)(rng);
+                // Generate a single random number
+                alpha = hoomd::UniformDistribution<Scalar>(-1, 1)(rng);
+                }
 
             // conservative dpd
             // force_divr = FDIV(a,r)*(Scalar(1.0) - r*rcutinv);
@@ -314,6 +331,8 @@ class EvaluatorPairDPDThermoDPD
     Scalar m_T;          //!< Temperature for Themostat
     Scalar m_dot;        //!< Velocity difference dotted with displacement vector
     Scalar m_deltaT;     //!<  timestep size stored from constructor
+    Scalar m_alpha;      //!< Random number of the pair set by setAlpha()
+    bool m_has_alpha;    //!< True when setAlpha() has been called
     };
 
 #undef DEVICE
@@ -125,7 +125,8 @@ class EvaluatorPairDPDThermoLJ
     */
     DEVICE EvaluatorPairDPDThermoLJ(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
         : rsq(_rsq), rcutsq(_rcutsq), lj1(_params.epsilon_x_4 * _params.sigma_6 * _params.sigma_6),
-          lj2(_params.epsilon_x_4 * _params.sigma_6), gamma(_params.gamma)
+          lj2(_params.epsilon_x_4 * _params.sigma_6), gamma(_params.gamma), m_alpha(0),
+          m_has_alpha(false)
         {
         }
 
@@ -157,6 +158,18 @@ class EvaluatorPairDPDThermoLJ
         m_T = Temp;
         }
 
+    //! Set the random number of the pair
+    /*! \param alpha Uniform random number in [-1, 1] drawn from the RNG stream of the pair
+
+        evalForceEnergyThermo() uses \a alpha instead of drawing it, so that callers can generate
+        the random numbers of many pairs together.
+    */
+    DEVICE void setAlpha(Scalar alpha)
+        {
+        m_alpha = alpha;
+        m_has_alpha = true;
+        }
+
     //! LJ doesn't use charge
     DEVICE static bool needsCharge()
         {
@@ -228,25 +241,29 @@ class EvaluatorPairDPDThermoLJ
 
             // force calculation
 
-            unsigned int m_oi, m_oj;
-            // initialize the RNG
-            if (m_i > m_j)
+            Scalar alpha = m_alpha;
+            if (!m_has_alpha)
                 {
-                m_oi = m_j;
-                m_oj = m_i;
+                unsigned int m_oi, m_oj;
+                // initialize the RNG
+                if (m_i > m_j)
+                    {
+                    m_oi = m_j;
+                    m_oj = m_i;
+                    }
+                else
+                    {
+                    m_oi = m_i;
+                    m_oj = m_j;
+                    }
+
+                hoomd::RandomGenerator rng(
+                    hoomd::Seed(hoomd::RNGIdentifier::EvaluatorPairDPDThermo, m_timestep, m_seed),
+                    hoomd::Counter(m_oi, m_oj));
+
+                // Generate a single random number
+                alpha = hoomd::UniformDistribution<Scalar>(-1, 1)(rng);
                 }
-            else
-                {
-                m_oi = m_i;
-                m_oj = m_j;
-                }
-
-            hoomd::RandomGenerator rng(
-                hoomd::Seed(hoomd::RNGIdentifier::EvaluatorPairDPDThermo, m_timestep, m_seed),
-                hoomd::Counter(m_oi, m_oj));
-
-            // Generate a single random number
-            Scalar alpha = hoomd::UniformDistribution<Scalar>(-1, 1)(rng);
 
             // conservative lj
             force_divr = r2inv * r6inv * (Scalar(12.0) * lj1 * r6inv - Scalar(6.0) * lj2);
@@ -313,6 +330,8 @@ class EvaluatorPairDPDThermoLJ
     Scalar m_T;          //!< Temperature for Themostat
     Scalar m_dot;        //!< Velocity difference dotted with displacement vector
     Scalar m_deltaT;     //!<  timestep size stored from constructor
+    Scalar m_alpha;      //!< Random number of the pair set by setAlpha()
+    bool m_has_alpha;    //!< True when setAlpha() has been called
     };
 
 #undef DEVICE
@@ -171,6 +171,62 @@ class EvaluatorPairExpandedLJ
             return false;
         }
 
+#ifndef __HIPCC__
+    //! Evaluate the force and energy of a batch of pairs
+    /*! See EvaluatorPairLJ::evalForceAndEnergyBatch() for the arguments. Lanes with r <= delta
+        produce non-finite intermediate values that are masked out like the lanes beyond the cutoff.
+    */
+    template<unsigned int width>
+    static void evalForceAndEnergyBatch(const Scalar* rsq,
+                                        const Scalar* rcutsq,
+                                        const unsigned int* param_idx,
+                                        const param_type* params,
+                                        Scalar* force_divr,
+                                        Scalar* pair_eng,
+                                        bool energy_shift)
+        {
+        Scalar lj1[width];
+        Scalar lj2[width];
+        Scalar delta[width];
+        for (unsigned int l = 0; l < width; l++)
+            {
+            const param_type& param = params[param_idx[l]];
+            lj1[l] = param.epsilon_x_4 * param.sigma_6 * param.sigma_6;
+            lj2[l] = param.epsilon_x_4 * param.sigma_6;
+            delta[l] = param.delta;
+            }
+
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int l = 0; l < width; l++)
+            {
+            Scalar rinv = fast::rsqrt(rsq[l]);
+            Scalar r = Scalar(1.0) / rinv;
+            Scalar rmd = r - delta[l];
+            Scalar rmdinv = Scalar(1.0) / rmd;
+            Scalar rmd2inv = rmdinv * rmdinv;
+            Scalar rmd6inv = rmd2inv * rmd2inv * rmd2inv;
+            force_divr[l] = rinv * rmdinv * rmd6inv
+                            * (Scalar(12.0) * lj1[l] * rmd6inv - Scalar(6.0) * lj2[l]);
+            pair_eng[l] = rmd6inv * (lj1[l] * rmd6inv - lj2[l]);
+
+            Scalar r_cut = fast::sqrt(rcutsq[l]);
+            Scalar r_cut_shifted = r_cut - delta[l];
+            Scalar r_cut_shifted_inv = Scalar(1.0) / r_cut_shifted;
+
+            Scalar r_cut2_inv = r_cut_shifted_inv * r_cut_shifted_inv;
+            Scalar r_cut6_inv = r_cut2_inv * r_cut2_inv * r_cut2_inv;
+            pair_eng[l] -= shift * r_cut6_inv * (lj1[l] * r_cut6_inv - lj2[l]);
+            }
+
+        for (unsigned int l = 0; l < width; l++)
+            {
+            bool evaluated = rsq[l] < rcutsq[l] && lj1[l] != 0;
+            force_divr[l] = evaluated ? force_divr[l] : Scalar(0.0);
+            pair_eng[l] = evaluated ? pair_eng[l] : Scalar(0.0);
+            }
+        }
+#endif
+
     DEVICE Scalar evalPressureLRCIntegral()
         {
         return 0;
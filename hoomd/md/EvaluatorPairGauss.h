@@ -144,6 +144,49 @@ class EvaluatorPairGauss
             return false;
         }
 
+#ifndef __HIPCC__
+    //! Evaluate the force and energy of a batch of pairs
+    /*! See EvaluatorPairLJ::evalForceAndEnergyBatch() for the arguments.
+     */
+    template<unsigned int width>
+    static void evalForceAndEnergyBatch(const Scalar* rsq,
+                                        const Scalar* rcutsq,
+                                        const unsigned int* param_idx,
+                                        const param_type* params,
+                                        Scalar* force_divr,
+                                        Scalar* pair_eng,
+                                        bool energy_shift)
+        {
+        Scalar epsilon[width];
+        Scalar sigma[width];
+        for (unsigned int l = 0; l < width; l++)
+            {
+            epsilon[l] = params[param_idx[l]].epsilon;
+            sigma[l] = params[param_idx[l]].sigma;
+            }
+
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int l = 0; l < width; l++)
+            {
+            Scalar sigma_sq = sigma[l] * sigma[l];
+            Scalar r_over_sigma_sq = rsq[l] / sigma_sq;
+            Scalar exp_val = fast::exp(-Scalar(1.0) / Scalar(2.0) * r_over_sigma_sq);
+
+            force_divr[l] = epsilon[l] / sigma_sq * exp_val;
+            pair_eng[l] = epsilon[l] * exp_val;
+            pair_eng[l] -= shift * epsilon[l]
+                           * fast::exp(-Scalar(1.0) / Scalar(2.0) * rcutsq[l] / sigma_sq);
+            }
+
+        for (unsigned int l = 0; l < width; l++)
+            {
+            bool evaluated = rsq[l] < rcutsq[l];
+            force_divr[l] = evaluated ? force_divr[l] : Scalar(0.0);
+            pair_eng[l] = evaluated ? pair_eng[l] : Scalar(0.0);
+            }
+        }
+#endif
+
     DEVICE Scalar evalPressureLRCIntegral()
         {
         return 0;
@@ -211,6 +211,62 @@ class EvaluatorPairLJ
             return false;
         }
 
+#ifndef __HIPCC__
+    //! Evaluate the force and energy of a batch of pairs
+    /*! \param rsq Squared distance of each pair
+        \param rcutsq Squared cutoff radius of each pair
+        \param param_idx Index of the parameters of each pair in \a params
+        \param params Per type pair parameters
+        \param force_divr Output: force divided by r of each pair
+        \param pair_eng Output: energy of each pair
+        \param energy_shift If true, shift the energy of every pair to 0 at the cutoff
+
+        Computes the same values as evalForceAndEnergy() for \a width pairs. The loop has no
+        branches so that the compiler can vectorize it. Pairs that evalForceAndEnergy() does not
+        evaluate get zero force and energy.
+    */
+    template<unsigned int width>
+    static void evalForceAndEnergyBatch(const Scalar* rsq,
+                                        const Scalar* rcutsq,
+                                        const unsigned int* param_idx,
+                                        const param_type* params,
+                                        Scalar* force_divr,
+                                        Scalar* pair_eng,
+                                        bool energy_shift)
+        {
+        // gather the parameters of the pairs
+        Scalar lj1[width];
+        Scalar lj2[width];
+        for (unsigned int l = 0; l < width; l++)
+            {
+            const param_type& param = params[param_idx[l]];
+            lj1[l] = param.epsilon_x_4 * param.sigma_6 * param.sigma_6;
+            lj2[l] = param.epsilon_x_4 * param.sigma_6;
+            }
+
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int l = 0; l < width; l++)
+            {
+            Scalar r2inv = Scalar(1.0) / rsq[l];
+            Scalar r6inv = r2inv * r2inv * r2inv;
+            force_divr[l] = r2inv * r6inv * Scalar(6.0) * (Scalar(2.0) * lj1[l] * r6inv - lj2[l]);
+            pair_eng[l] = r6inv * (lj1[l] * r6inv - lj2[l]);
+
+            Scalar rcut2inv = Scalar(1.0) / rcutsq[l];
+            Scalar rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+            pair_eng[l] -= shift * rcut6inv * (lj1[l] * rcut6inv - lj2[l]);
+            }
+
+        // zero the pairs that evalForceAndEnergy() does not evaluate
+        for (unsigned int l = 0; l < width; l++)
+            {
+            bool evaluated = rsq[l] < rcutsq[l] && lj1[l] != 0;
+            force_divr[l] = evaluated ? force_divr[l] : Scalar(0.0);
+            pair_eng[l] = evaluated ? pair_eng[l] : Scalar(0.0);
+            }
+        }
+#endif
+
     DEVICE Scalar evalPressureLRCIntegral()
         {
         if (rcutsq == 0)
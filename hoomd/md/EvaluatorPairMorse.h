@@ -141,6 +141,54 @@ class EvaluatorPairMorse
             return false;
         }
 
+#ifndef __HIPCC__
+    //! Evaluate the force and energy of a batch of pairs
+    /*! See EvaluatorPairLJ::evalForceAndEnergyBatch() for the arguments.
+     */
+    template<unsigned int width>
+    static void evalForceAndEnergyBatch(const Scalar* rsq,
+                                        const Scalar* rcutsq,
+                                        const unsigned int* param_idx,
+                                        const param_type* params,
+                                        Scalar* force_divr,
+                                        Scalar* pair_eng,
+                                        bool energy_shift)
+        {
+        Scalar D0[width];
+        Scalar alpha[width];
+        Scalar r0[width];
+        for (unsigned int l = 0; l < width; l++)
+            {
+            const param_type& param = params[param_idx[l]];
+            D0[l] = param.D0;
+            alpha[l] = param.alpha;
+            r0[l] = param.r0;
+            }
+
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int l = 0; l < width; l++)
+            {
+            Scalar r = fast::sqrt(rsq[l]);
+            Scalar Exp_factor = fast::exp(-alpha[l] * (r - r0[l]));
+
+            pair_eng[l] = D0[l] * Exp_factor * (Exp_factor - Scalar(2.0));
+            force_divr[l]
+                = Scalar(2.0) * D0[l] * alpha[l] * Exp_factor * (Exp_factor - Scalar(1.0)) / r;
+
+            Scalar rcut = fast::sqrt(rcutsq[l]);
+            Scalar Exp_factor_cut = fast::exp(-alpha[l] * (rcut - r0[l]));
+            pair_eng[l] -= shift * D0[l] * Exp_factor_cut * (Exp_factor_cut - Scalar(2.0));
+            }
+
+        for (unsigned int l = 0; l < width; l++)
+            {
+            bool evaluated = rsq[l] < rcutsq[l];
+            force_divr[l] = evaluated ? force_divr[l] : Scalar(0.0);
+            pair_eng[l] = evaluated ? pair_eng[l] : Scalar(0.0);
+            }
+        }
+#endif
+
     DEVICE Scalar evalPressureLRCIntegral()
         {
         return 0;
@@ -193,6 +193,65 @@ class EvaluatorPairTable
         return true;
         }
 
+#ifndef __HIPCC__
+    //! Evaluate the force and energy of a batch of pairs
+    /*! See EvaluatorPairLJ::evalForceAndEnergyBatch() for the arguments. Table potentials do not
+        support energy shifting. Lanes outside [rmin, rcut) read the first table entry and are
+        masked out.
+    */
+    template<unsigned int width>
+    static void evalForceAndEnergyBatch(const Scalar* rsq,
+                                        const Scalar* rcutsq,
+                                        const unsigned int* param_idx,
+                                        const param_type* params,
+                                        Scalar* force_divr,
+                                        Scalar* pair_eng,
+                                        bool energy_shift)
+        {
+        // look up the table entries on either side of each r
+        Scalar r[width];
+        Scalar value_f[width];
+        Scalar V0[width];
+        Scalar V1[width];
+        Scalar F0[width];
+        Scalar F1[width];
+        bool evaluated[width];
+        for (unsigned int l = 0; l < width; l++)
+            {
+            const param_type& param = params[param_idx[l]];
+            const unsigned int table_width = param.V_table.size();
+
+            r[l] = fast::sqrt(rsq[l]);
+            evaluated[l] = rsq[l] < rcutsq[l] && r[l] >= param.rmin;
+            const Scalar rcut = fast::sqrt(rcutsq[l]);
+            const Scalar delta_r = (rcut - param.rmin) / static_cast<Scalar>(table_width);
+            value_f[l] = evaluated[l] ? (r[l] - param.rmin) / delta_r : Scalar(0.0);
+
+            const unsigned int value_i = static_cast<unsigned int>(slow::floor(value_f[l]));
+            const bool has_next = value_i + 1 < table_width;
+            V0[l] = param.V_table[value_i];
+            F0[l] = param.F_table[value_i];
+            V1[l] = has_next ? param.V_table[value_i + 1] : Scalar(0.0);
+            F1[l] = has_next ? param.F_table[value_i + 1] : Scalar(0.0);
+            }
+
+        // interpolate
+        for (unsigned int l = 0; l < width; l++)
+            {
+            const Scalar f = value_f[l] - slow::floor(value_f[l]);
+            force_divr[l] = (F0[l] + f * (F1[l] - F0[l])) / r[l];
+            pair_eng[l] = V0[l] + f * (V1[l] - V0[l]);
+            }
+
+        for (unsigned int l = 0; l < width; l++)
+            {
+            const bool has_force = evaluated[l] & (rsq[l] > Scalar(0.0));
+            force_divr[l] = has_force ? force_divr[l] : Scalar(0.0);
+            pair_eng[l] = evaluated[l] ? pair_eng[l] : Scalar(0.0);
+            }
+        }
+#endif
+
     DEVICE Scalar evalPressureLRCIntegral()
         {
         return 0;
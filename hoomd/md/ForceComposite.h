@@ -4,6 +4,8 @@
 #include "MolecularForceCompute.h"
 #include "NeighborList.h"
 
+#include "hoomd/ForEachRange.h"
+
 /*! \file ForceComposite.h
     \brief Implementation of a rigid body force compute
 
@@ -3,6 +3,7 @@
 
 #include "hoomd/BondedGroupData.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 
 #include <memory>
 
@@ -95,6 +96,11 @@ class PYBIND11_EXPORT HarmonicAngleForceCompute : public ForceCompute
 
     std::shared_ptr<AngleData> m_angle_data; //!< Angle data to use in computing angles
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
     };
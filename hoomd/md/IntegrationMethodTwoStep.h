@@ -10,6 +10,9 @@
 #ifndef __INTEGRATION_METHOD_TWO_STEP_H__
 #define __INTEGRATION_METHOD_TWO_STEP_H__
 
+#include "hoomd/DeterministicReduce.h"
+#include "hoomd/ForEachRange.h"
+
 #ifdef ENABLE_MPI
 //! Forward declaration
 class Communicator;
@@ -180,6 +183,20 @@ class PYBIND11_EXPORT IntegrationMethodTwoStep : public Autotuned
     bool m_aniso;    //!< True if anisotropic integration is requested
 
     Scalar m_deltaT; //!< The time step
+
+    //! Sum the values returned by f(first, last) over contiguous ranges of [0, \a n)
+    /*! Like detail::forEachRange(), but \a f returns the partial sum over its range. The ranges
+        and the order in which the partial sums are added come from detail::deterministicReduce()
+        and depend only on \a n, so the result does not depend on the number of threads.
+    */
+    template<class Func> Scalar sumOverRanges(unsigned int n, const Func& f)
+        {
+        return hoomd::detail::deterministicReduce(*m_exec_conf,
+                                                  n,
+                                                  Scalar(0.0),
+                                                  f,
+                                                  [](Scalar x, Scalar y) { return x + y; });
+        }
     };
 
     } // end namespace md
@@ -1507,41 +1507,62 @@ void NeighborList::filterNlist()
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
 
-    // for each particle's neighbor list
-    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
-        {
-        size_t myHead = h_head_list.data[idx];
-        unsigned int n_neigh = h_n_neigh.data[idx];
-        unsigned int n_ex = h_n_ex_idx.data[idx];
-        unsigned int new_n_neigh = 0;
-
-        // loop over the list, regenerating it as we go
-        for (unsigned int cur_neigh_idx = 0; cur_neigh_idx < n_neigh; cur_neigh_idx++)
+    // filter the neighbor lists of particles [first, last)
+    auto filter_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int idx = first; idx < last; idx++)
             {
-            unsigned int cur_neigh = h_nlist.data[myHead + cur_neigh_idx];
+            size_t myHead = h_head_list.data[idx];
+            unsigned int n_neigh = h_n_neigh.data[idx];
+            unsigned int n_ex = h_n_ex_idx.data[idx];
+            unsigned int new_n_neigh = 0;
 
-            // test if excluded
-            bool excluded = false;
-            for (unsigned int cur_ex_idx = 0; cur_ex_idx < n_ex; cur_ex_idx++)
+            // loop over the list, regenerating it as we go
+            for (unsigned int cur_neigh_idx = 0; cur_neigh_idx < n_neigh; cur_neigh_idx++)
                 {
-                unsigned int cur_ex = h_ex_list_idx.data[m_ex_list_indexer(idx, cur_ex_idx)];
-                if (cur_ex == cur_neigh)
+                unsigned int cur_neigh = h_nlist.data[myHead + cur_neigh_idx];
+
+                // test if excluded
+                bool excluded = false;
+                for (unsigned int cur_ex_idx = 0; cur_ex_idx < n_ex; cur_ex_idx++)
                     {
-                    excluded = true;
-                    break;
+                    unsigned int cur_ex = h_ex_list_idx.data[m_ex_list_indexer(idx, cur_ex_idx)];
+                    if (cur_ex == cur_neigh)
+                        {
+                        excluded = true;
+                        break;
+                        }
                     }
-                }
 
-            // add it back to the list if it is not excluded
-            if (!excluded)
-                {
-                h_nlist.data[myHead + new_n_neigh] = cur_neigh;
-                new_n_neigh++;
+                // add it back to the list if it is not excluded
+                if (!excluded)
+                    {
+                    h_nlist.data[myHead + new_n_neigh] = cur_neigh;
+                    new_n_neigh++;
+                    }
                 }
+
+            // update the number of neighbors
+            h_n_neigh.data[idx] = new_n_neigh;
             }
+    };
 
-        // update the number of neighbors
-        h_n_neigh.data[idx] = new_n_neigh;
+    // each particle's neighbor list is filtered independently
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+                                  [&](const tbb::blocked_range<unsigned int>& r)
+                                  { filter_range(r.begin(), r.end()); });
+            });
+        }
+    else
+#endif
+        {
+        filter_range(0, m_pdata->getN());
         }
     }
 
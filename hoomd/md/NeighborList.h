@@ -9,6 +9,7 @@
 #include "hoomd/MeshDefinition.h"
 #include "hoomd/PythonLocalDataAccess.h"
 
+#include <algorithm>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 #include <memory>
 #include <set>
@@ -31,6 +32,12 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 namespace hoomd
     {
 namespace md
@@ -548,6 +555,54 @@ class PYBIND11_EXPORT NeighborList : public Compute
     //! Amortized resizing of the neighborlist
     void resizeNlist(size_t size);
 
+    //! Build the neighbor list over ranges of local particles, using threads when available
+    /*! \param build Callable build(first, last, conditions) that fills the neighbor list of the
+                     particles [first, last) and records overflows by type in \a conditions
+
+        Each particle writes only to its own segment of m_nlist starting at m_head_list, so ranges
+        of particles are independent. When the execution configuration has more than one thread,
+        the ranges are built in parallel with per-thread overflow conditions that are merged into
+        m_conditions with max(). The resulting m_nlist, m_n_neigh, and m_conditions are identical
+        to the serial build.
+    */
+    template<class Func> void buildNlistRanges(const Func& build)
+        {
+        ArrayHandle<unsigned int> h_conditions(m_conditions,
+                                               access_location::host,
+                                               access_mode::readwrite);
+        const unsigned int N = m_pdata->getN();
+
+#ifdef ENABLE_TBB
+        if (m_exec_conf->getNumThreads() > 1)
+            {
+            const unsigned int n_types = m_pdata->getNTypes();
+            tbb::enumerable_thread_specific<std::vector<unsigned int>> thread_conditions(n_types,
+                                                                                       0u);
+
+            m_exec_conf->getTaskArena()->execute(
+                [&]
+                {
+                    tbb::parallel_for(
+                        tbb::blocked_range<unsigned int>(0, N),
+                        [&](const tbb::blocked_range<unsigned int>& r)
+                        { build(r.begin(), r.end(), thread_conditions.local().data()); });
+                });
+
+            for (const auto& conditions : thread_conditions)
+                {
+                for (unsigned int cur_type = 0; cur_type < n_types; ++cur_type)
+                    {
+                    h_conditions.data[cur_type]
+                        = std::max(h_conditions.data[cur_type], conditions[cur_type]);
+                    }
+                }
+            return;
+            }
+#endif
+
+        build(0, N, h_conditions.data);
+        }
+
 #ifdef ENABLE_MPI
     CommFlags getRequestedCommFlags(uint64_t timestep)
         {
@@ -0,0 +1,580 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+/*! \file NeighborListCluster.cc
+    \brief Defines NeighborListCluster
+*/
+
+#include "NeighborListCluster.h"
+#include "hoomd/SystemDefinition.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/Communicator.h"
+#endif
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#endif
+
+#include <algorithm>
+
+using namespace std;
+
+namespace hoomd
+    {
+namespace md
+    {
+namespace detail
+    {
+//! Spread the lower 10 bits of \a v so that there are two zero bits between each bit
+static uint32_t expandBits(uint32_t v)
+    {
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+    }
+
+//! Map a fractional coordinate to one of the 1024 bins of the Morton grid
+static uint32_t mortonBin(Scalar f)
+    {
+    f = std::min(std::max(f, Scalar(0.0)), Scalar(1.0));
+    return std::min((uint32_t)(f * Scalar(1024.0)), uint32_t(1023));
+    }
+    } // end namespace detail
+
+const unsigned int NeighborListCluster::cluster_size;
+const unsigned int NeighborListCluster::empty_lane;
+
+NeighborListCluster::NeighborListCluster(std::shared_ptr<SystemDefinition> sysdef, Scalar r_buff)
+    : NeighborList(sysdef, r_buff), m_box_changed(true), m_n_local_clusters(0), m_n_clusters(0),
+      m_n_images(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListCluster" << endl;
+
+    m_pdata->getBoxChangeSignal()
+        .connect<NeighborListCluster, &NeighborListCluster::slotBoxChanged>(this);
+    }
+
+NeighborListCluster::~NeighborListCluster()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListCluster" << endl;
+    m_pdata->getBoxChangeSignal()
+        .disconnect<NeighborListCluster, &NeighborListCluster::slotBoxChanged>(this);
+    }
+
+void NeighborListCluster::buildNlist(uint64_t timestep)
+    {
+    if (m_box_changed)
+        {
+        updateImageVectors();
+        m_box_changed = false;
+        }
+
+    buildClusters();
+    buildClusterPairs();
+    buildParticleNlist();
+    }
+
+/*!
+ * Computes the lattice translations of the periodic images to query. See
+ * NeighborListTree::updateImageVectors().
+ */
+void NeighborListCluster::updateImageVectors()
+    {
+    const BoxDim& box = m_pdata->getBox();
+    uchar3 periodic = box.getPeriodic();
+    unsigned char sys3d = (this->m_sysdef->getNDimensions() == 3);
+
+    // each periodic dimension increases the number of images by one power of 3
+    unsigned int n_dim_periodic = (unsigned int)(periodic.x + periodic.y + sys3d * periodic.z);
+    m_n_images = 1;
+    for (unsigned int dim = 0; dim < n_dim_periodic; ++dim)
+        {
+        m_n_images *= 3;
+        }
+
+    if (m_n_images > m_image_list.size())
+        {
+        m_image_list.resize(m_n_images);
+        }
+
+    vec3<Scalar> latt_a = vec3<Scalar>(box.getLatticeVector(0));
+    vec3<Scalar> latt_b = vec3<Scalar>(box.getLatticeVector(1));
+    vec3<Scalar> latt_c = vec3<Scalar>(box.getLatticeVector(2));
+
+    // the zero translation is always the first image
+    m_image_list[0] = vec3<Scalar>(0.0, 0.0, 0.0);
+
+    unsigned int n_images = 1;
+    for (int i = -1; i <= 1 && n_images < m_n_images; ++i)
+        {
+        for (int j = -1; j <= 1 && n_images < m_n_images; ++j)
+            {
+            for (int k = -1; k <= 1 && n_images < m_n_images; ++k)
+                {
+                if (!(i == 0 && j == 0 && k == 0))
+                    {
+                    // skip any periodic images if we don't have periodicity
+                    if (i != 0 && !periodic.x)
+                        continue;
+                    if (j != 0 && !periodic.y)
+                        continue;
+                    if (k != 0 && (!sys3d || !periodic.z))
+                        continue;
+
+                    m_image_list[n_images]
+                        = Scalar(i) * latt_a + Scalar(j) * latt_b + Scalar(k) * latt_c;
+                    ++n_images;
+                    }
+                }
+            }
+        }
+    }
+
+/*!
+ * Local and ghost particles are sorted separately by the Morton code of their position in a 1024^3
+ * grid that spans the box and the ghost layer, with the particle index breaking ties. Runs of
+ * cluster_size consecutive particles form the clusters, the last cluster of each kind is padded
+ * with empty lanes.
+ */
+void NeighborListCluster::buildClusters()
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::read);
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_ghosts = m_pdata->getNGhosts();
+    const BoxDim& box = m_pdata->getBox();
+
+    Scalar ghost_layer_width(0.0);
+#ifdef ENABLE_MPI
+    if (m_sysdef->isDomainDecomposed())
+        ghost_layer_width = m_comm->getGhostLayerMaxWidth();
+#endif
+
+    Scalar3 ghost_width = make_scalar3(0.0, 0.0, 0.0);
+    if (!box.getPeriodic().x)
+        ghost_width.x = ghost_layer_width;
+    if (!box.getPeriodic().y)
+        ghost_width.y = ghost_layer_width;
+    if (this->m_sysdef->getNDimensions() == 3 && !box.getPeriodic().z)
+        ghost_width.z = ghost_layer_width;
+
+    // sort the particles along the Morton curve
+    m_sort_keys.resize(N + n_ghosts);
+    for (unsigned int i = 0; i < N + n_ghosts; ++i)
+        {
+        Scalar4 postype = h_postype.data[i];
+        Scalar3 f = box.makeFraction(make_scalar3(postype.x, postype.y, postype.z), ghost_width);
+        uint32_t code = (detail::expandBits(detail::mortonBin(f.x)) << 2)
+                        | (detail::expandBits(detail::mortonBin(f.y)) << 1)
+                        | detail::expandBits(detail::mortonBin(f.z));
+        m_sort_keys[i] = (uint64_t(code) << 32) | i;
+        }
+
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_sort(m_sort_keys.begin(), m_sort_keys.begin() + N);
+                tbb::parallel_sort(m_sort_keys.begin() + N, m_sort_keys.end());
+            });
+        }
+    else
+#endif
+        {
+        std::sort(m_sort_keys.begin(), m_sort_keys.begin() + N);
+        std::sort(m_sort_keys.begin() + N, m_sort_keys.end());
+        }
+
+    // group consecutive particles into clusters
+    m_n_local_clusters = (N + cluster_size - 1) / cluster_size;
+    m_n_clusters = m_n_local_clusters + (n_ghosts + cluster_size - 1) / cluster_size;
+
+    m_cluster_particles.assign(size_t(m_n_clusters) * cluster_size, empty_lane);
+    m_particle_lane.resize(N);
+    for (unsigned int k = 0; k < N; ++k)
+        {
+        unsigned int i = (unsigned int)(m_sort_keys[k] & 0xffffffff);
+        m_cluster_particles[k] = i;
+        m_particle_lane[i] = k;
+        }
+    for (unsigned int k = 0; k < n_ghosts; ++k)
+        {
+        unsigned int i = (unsigned int)(m_sort_keys[N + k] & 0xffffffff);
+        m_cluster_particles[size_t(m_n_local_clusters) * cluster_size + k] = i;
+        }
+
+    // bound each cluster and build the tree
+    m_cluster_aabbs.resize(m_n_clusters);
+    for (unsigned int c = 0; c < m_n_clusters; ++c)
+        {
+        const unsigned int* lanes = &m_cluster_particles[size_t(c) * cluster_size];
+        vec3<Scalar> lower(h_postype.data[lanes[0]]);
+        vec3<Scalar> upper = lower;
+        for (unsigned int l = 1; l < cluster_size && lanes[l] != empty_lane; ++l)
+            {
+            vec3<Scalar> pos(h_postype.data[lanes[l]]);
+            lower.x = std::min(lower.x, pos.x);
+            lower.y = std::min(lower.y, pos.y);
+            lower.z = std::min(lower.z, pos.z);
+            upper.x = std::max(upper.x, pos.x);
+            upper.y = std::max(upper.y, pos.y);
+            upper.z = std::max(upper.z, pos.z);
+            }
+
+        m_cluster_aabbs[c] = hoomd::detail::AABB(lower, upper);
+        m_cluster_aabbs[c].tag = c;
+        }
+
+    // the tree build reorders the AABBs it is given
+    m_tree_aabbs = m_cluster_aabbs;
+    if (m_n_clusters > 0)
+        m_aabb_tree.buildTree(m_tree_aabbs.data(), m_n_clusters);
+    }
+
+/*!
+ * Each local cluster queries the tree with its AABB grown by the largest r_list at every periodic
+ * image. The candidate j clusters are sorted and made unique (a cluster may be found through more
+ * than one image), then the interaction mask is computed from the minimum image distance of every
+ * pair of lanes. The clusters are processed in chunks that each fill their own list, and the chunk
+ * lists are concatenated in order, so the result does not depend on the number of threads.
+ */
+void NeighborListCluster::buildClusterPairs()
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(),
+                                     access_location::host,
+                                     access_mode::read);
+    ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_r_listsq(m_r_listsq, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_ex_idx(m_n_ex_idx, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ex_list_idx(m_ex_list_idx,
+                                            access_location::host,
+                                            access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+    const Scalar r_list = getMaxRCut() + m_r_buff;
+
+    unsigned int n_chunks = 1;
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        n_chunks = 4 * m_exec_conf->getNumThreads();
+#endif
+    n_chunks = std::max(std::min(n_chunks, m_n_local_clusters), 1u);
+
+    m_chunk_pairs.resize(n_chunks);
+    m_cluster_pair_head.resize(size_t(m_n_local_clusters) + 1);
+    m_cluster_pair_half_begin.resize(m_n_local_clusters);
+
+    // find the cluster pairs of the clusters in chunk c
+    auto build_chunk = [&](unsigned int c)
+    {
+        const unsigned int first
+            = (unsigned int)((uint64_t(m_n_local_clusters) * c) / n_chunks);
+        const unsigned int last
+            = (unsigned int)((uint64_t(m_n_local_clusters) * (c + 1)) / n_chunks);
+
+        std::vector<ClusterPair>& pairs = m_chunk_pairs[c];
+        pairs.clear();
+        std::vector<unsigned int> candidates;
+
+        for (unsigned int ci = first; ci < last; ++ci)
+            {
+            m_cluster_pair_head[ci] = pairs.size();
+
+            // find the clusters whose AABB is within r_list
+            candidates.clear();
+            const hoomd::detail::AABB& aabb_i = m_cluster_aabbs[ci];
+            vec3<Scalar> r_list_vec(r_list, r_list, r_list);
+            for (unsigned int cur_image = 0; cur_image < m_n_images; ++cur_image)
+                {
+                hoomd::detail::AABB aabb(aabb_i.getLower() - r_list_vec,
+                                         aabb_i.getUpper() + r_list_vec);
+                aabb.translate(m_image_list[cur_image]);
+
+                // traverse the wide BVH of the tree
+                hoomd::detail::AABBTreeTraversal traversal(m_aabb_tree, aabb);
+                for (unsigned int cur_node_idx = traversal.next();
+                     cur_node_idx != hoomd::detail::INVALID_NODE;
+                     cur_node_idx = traversal.next())
+                    {
+                    for (unsigned int cur_p = 0;
+                         cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx);
+                         ++cur_p)
+                        {
+                        unsigned int cj = m_aabb_tree.getNodeParticleTag(cur_node_idx, cur_p);
+                        if (aabb.overlaps(m_cluster_aabbs[cj]))
+                            candidates.push_back(cj);
+                        }
+                    }
+                }
+
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            // compute the interaction masks
+            const unsigned int* lanes_i = &m_cluster_particles[size_t(ci) * cluster_size];
+            bool half_begin_set = false;
+            for (unsigned int cj : candidates)
+                {
+                if (!half_begin_set && cj >= ci)
+                    {
+                    m_cluster_pair_half_begin[ci] = pairs.size();
+                    half_begin_set = true;
+                    }
+
+                const unsigned int* lanes_j = &m_cluster_particles[size_t(cj) * cluster_size];
+                uint64_t mask = 0;
+                for (unsigned int li = 0; li < cluster_size; ++li)
+                    {
+                    const unsigned int i = lanes_i[li];
+                    if (i == empty_lane)
+                        continue;
+
+                    const Scalar4 postype_i = h_postype.data[i];
+                    const Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
+                    const unsigned int type_i = __scalar_as_int(postype_i.w);
+                    const unsigned int body_i = h_body.data[i];
+                    const unsigned int n_ex_i = h_n_ex_idx.data[i];
+
+                    for (unsigned int lj = 0; lj < cluster_size; ++lj)
+                        {
+                        const unsigned int j = lanes_j[lj];
+                        if (j == empty_lane || j == i)
+                            continue;
+
+                        const Scalar4 postype_j = h_postype.data[j];
+                        const unsigned int type_j = __scalar_as_int(postype_j.w);
+                        const unsigned int typpair_idx = m_typpair_idx(type_i, type_j);
+                        if (h_r_cut.data[typpair_idx] <= Scalar(0.0))
+                            continue;
+
+                        if (m_filter_body && body_i != NO_BODY && body_i == h_body.data[j])
+                            continue;
+
+                        Scalar3 dx = pos_i - make_scalar3(postype_j.x, postype_j.y, postype_j.z);
+                        dx = box.minImage(dx);
+                        if (dot(dx, dx) > h_r_listsq.data[typpair_idx])
+                            continue;
+
+                        bool excluded = false;
+                        for (unsigned int cur_ex_idx = 0; cur_ex_idx < n_ex_i; ++cur_ex_idx)
+                            {
+                            if (h_ex_list_idx.data[m_ex_list_indexer(i, cur_ex_idx)] == j)
+                                {
+                                excluded = true;
+                                break;
+                                }
+                            }
+                        if (excluded)
+                            continue;
+
+                        mask |= uint64_t(1) << (li * cluster_size + lj);
+                        }
+                    }
+
+                if (mask != 0)
+                    {
+                    ClusterPair pair;
+                    pair.mask = mask;
+                    pair.cluster = cj;
+                    pairs.push_back(pair);
+                    }
+                }
+
+            if (!half_begin_set)
+                m_cluster_pair_half_begin[ci] = pairs.size();
+            }
+    };
+
+#ifdef ENABLE_TBB
+    if (n_chunks > 1)
+        {
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_chunks, 1),
+                                  [&](const tbb::blocked_range<unsigned int>& r)
+                                  {
+                                      for (unsigned int c = r.begin(); c != r.end(); ++c)
+                                          build_chunk(c);
+                                  });
+            });
+        }
+    else
+#endif
+        {
+        for (unsigned int c = 0; c < n_chunks; ++c)
+            build_chunk(c);
+        }
+
+    // concatenate the chunk lists in order
+    size_t n_pairs = 0;
+    for (unsigned int c = 0; c < n_chunks; ++c)
+        {
+        const unsigned int first
+            = (unsigned int)((uint64_t(m_n_local_clusters) * c) / n_chunks);
+        const unsigned int last
+            = (unsigned int)((uint64_t(m_n_local_clusters) * (c + 1)) / n_chunks);
+        for (unsigned int ci = first; ci < last; ++ci)
+            {
+            m_cluster_pair_head[ci] += n_pairs;
+            m_cluster_pair_half_begin[ci] += n_pairs;
+            }
+        n_pairs += m_chunk_pairs[c].size();
+        }
+    m_cluster_pair_head[m_n_local_clusters] = n_pairs;
+
+    m_cluster_pairs.resize(n_pairs);
+    for (unsigned int c = 0; c < n_chunks; ++c)
+        {
+        const unsigned int first
+            = (unsigned int)((uint64_t(m_n_local_clusters) * c) / n_chunks);
+        if (!m_chunk_pairs[c].empty())
+            {
+            std::copy(m_chunk_pairs[c].begin(),
+                      m_chunk_pairs[c].end(),
+                      m_cluster_pairs.begin() + m_cluster_pair_head[first]);
+            }
+        }
+    }
+
+/*!
+ * Each particle reads the row of the interaction masks that belongs to its lane. With half storage
+ * a pair is listed under the particle with the smaller index, as in the other neighbor lists.
+ */
+void NeighborListCluster::buildParticleNlist()
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::read);
+    ArrayHandle<size_t> h_head_list(m_head_list, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
+
+    const uint64_t row_mask = (uint64_t(1) << cluster_size) - 1;
+
+    buildNlistRanges(
+        [&](unsigned int first, unsigned int last, unsigned int* conditions)
+        {
+        for (unsigned int i = first; i < last; ++i)
+            {
+            const unsigned int type_i = __scalar_as_int(h_postype.data[i].w);
+            const unsigned int Nmax_i = h_Nmax.data[type_i];
+            const size_t nlist_head_i = h_head_list.data[i];
+
+            const unsigned int ci = m_particle_lane[i] / cluster_size;
+            const unsigned int li = m_particle_lane[i] % cluster_size;
+
+            unsigned int n_neigh_i = 0;
+            for (size_t p = m_cluster_pair_head[ci]; p < m_cluster_pair_head[ci + 1]; ++p)
+                {
+                const uint64_t row = (m_cluster_pairs[p].mask >> (li * cluster_size)) & row_mask;
+                if (row == 0)
+                    continue;
+
+                const unsigned int* lanes_j
+                    = &m_cluster_particles[size_t(m_cluster_pairs[p].cluster) * cluster_size];
+                for (unsigned int lj = 0; lj < cluster_size; ++lj)
+                    {
+                    if (!(row & (uint64_t(1) << lj)))
+                        continue;
+
+                    const unsigned int j = lanes_j[lj];
+                    if (m_storage_mode == full || i < j)
+                        {
+                        if (n_neigh_i < Nmax_i)
+                            h_nlist.data[nlist_head_i + n_neigh_i] = j;
+                        else
+                            conditions[type_i] = max(conditions[type_i], n_neigh_i + 1);
+
+                        ++n_neigh_i;
+                        }
+                    }
+                }
+
+            h_n_neigh.data[i] = n_neigh_i;
+            }
+        });
+    }
+
+/*!
+ * Empty lanes repeat the coordinates of the first lane of the cluster.
+ */
+void NeighborListCluster::updateClusterPositions()
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::read);
+
+    m_cluster_pos.resize(size_t(m_n_clusters) * 3 * cluster_size);
+    m_cluster_type.resize(size_t(m_n_clusters) * cluster_size);
+
+    auto update_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int c = first; c < last; ++c)
+            {
+            const unsigned int* lanes = &m_cluster_particles[size_t(c) * cluster_size];
+            Scalar* x = &m_cluster_pos[size_t(c) * 3 * cluster_size];
+            Scalar* y = x + cluster_size;
+            Scalar* z = y + cluster_size;
+            unsigned int* type = &m_cluster_type[size_t(c) * cluster_size];
+
+            for (unsigned int l = 0; l < cluster_size; ++l)
+                {
+                const unsigned int idx = lanes[l] != empty_lane ? lanes[l] : lanes[0];
+                const Scalar4 postype = h_postype.data[idx];
+                x[l] = postype.x;
+                y[l] = postype.y;
+                z[l] = postype.z;
+                type[l] = __scalar_as_int(postype.w);
+                }
+            }
+    };
+
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_n_clusters),
+                                  [&](const tbb::blocked_range<unsigned int>& r)
+                                  { update_range(r.begin(), r.end()); });
+            });
+        }
+    else
+#endif
+        {
+        update_range(0, m_n_clusters);
+        }
+    }
+
+namespace detail
+    {
+void export_NeighborListCluster(pybind11::module& m)
+    {
+    pybind11::class_<NeighborListCluster, NeighborList, std::shared_ptr<NeighborListCluster>>(
+        m,
+        "NeighborListCluster")
+        .def(pybind11::init<std::shared_ptr<SystemDefinition>, Scalar>())
+        .def("getNumClusters", &NeighborListCluster::getNumClusters)
+        .def("getNumClusterPairs",
+             [](const NeighborListCluster& nlist) { return nlist.getClusterPairs().size(); });
+    }
+
+    } // end namespace detail
+    } // end namespace md
+    } // end namespace hoomd
@@ -0,0 +1,182 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+#include "NeighborList.h"
+#include "hoomd/AABBTree.h"
+#include <vector>
+
+/*! \file NeighborListCluster.h
+    \brief Declares the NeighborListCluster class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+#ifndef __NEIGHBORLISTCLUSTER_H__
+#define __NEIGHBORLISTCLUSTER_H__
+
+namespace hoomd
+    {
+namespace md
+    {
+//! Cluster pair neighbor list for SIMD force evaluation on the CPU
+/*!
+ * NeighborListCluster sorts the particles along a Morton curve and groups consecutive particles
+ * into clusters of cluster_size particles. Local and ghost particles are grouped separately, so the
+ * first getNumLocalClusters() clusters hold only local particles. A BVH tree of the cluster AABBs
+ * finds all pairs of clusters within the largest r_list, including periodic images.
+ *
+ * Each cluster pair stores an interaction mask with one bit per pair of particles: bit
+ * (li * cluster_size + lj) is set when lane li of the i cluster and lane lj of the j cluster are
+ * within r_list of each other and the pair is not excluded (self, r_cut <= 0, same body or
+ * topological exclusions). Every i cluster lists all of its j clusters in increasing order.
+ * getClusterPairHalfBegin() points to the first j cluster not smaller than the i cluster. Half list
+ * consumers start there and keep only the upper triangle of the mask when the j cluster is the i
+ * cluster.
+ *
+ * Consumers that understand the cluster pair list (PotentialPair) refresh the structure-of-arrays
+ * cluster coordinates with updateClusterPositions() and stream the j cluster coordinates
+ * contiguously. The per particle neighbor list is also filled from the masks, so
+ * NeighborListCluster works with every force compute. Topological exclusions are applied to the
+ * masks, so filterNlist() has nothing left to do.
+ *
+ * \ingroup computes
+ */
+class PYBIND11_EXPORT NeighborListCluster : public NeighborList
+    {
+    public:
+    //! Number of particles in a cluster
+#if defined(__AVX512F__)
+    static const unsigned int cluster_size = 8;
+#else
+    static const unsigned int cluster_size = 4;
+#endif
+
+    //! Particle index stored in cluster lanes that hold no particle
+    static const unsigned int empty_lane = 0xffffffff;
+
+    //! Pair of clusters in the cluster pair list
+    struct ClusterPair
+        {
+        uint64_t mask;        //!< Bit (li * cluster_size + lj) is set when the lanes interact
+        unsigned int cluster; //!< Index of the j cluster
+        };
+
+    //! Constructs the compute
+    NeighborListCluster(std::shared_ptr<SystemDefinition> sysdef, Scalar r_buff);
+
+    //! Destructor
+    virtual ~NeighborListCluster();
+
+    //! Get the number of clusters of local particles
+    unsigned int getNumLocalClusters() const
+        {
+        return m_n_local_clusters;
+        }
+
+    //! Get the total number of clusters (local and ghost)
+    unsigned int getNumClusters() const
+        {
+        return m_n_clusters;
+        }
+
+    //! Get the particle index of each cluster lane (empty_lane for padding)
+    const std::vector<unsigned int>& getClusterParticles() const
+        {
+        return m_cluster_particles;
+        }
+
+    //! Get the index of the first cluster pair of each local cluster
+    const std::vector<size_t>& getClusterPairHead() const
+        {
+        return m_cluster_pair_head;
+        }
+
+    //! Get the index of the first cluster pair with a j cluster not smaller than the i cluster
+    const std::vector<size_t>& getClusterPairHalfBegin() const
+        {
+        return m_cluster_pair_half_begin;
+        }
+
+    //! Get the cluster pair list
+    const std::vector<ClusterPair>& getClusterPairs() const
+        {
+        return m_cluster_pairs;
+        }
+
+    //! Copy the current particle positions and types into the cluster coordinates
+    void updateClusterPositions();
+
+    //! Get the x, y, and z coordinates of the cluster lanes
+    /*! Cluster c stores its x coordinates at [3 * c * cluster_size, (3 * c + 1) * cluster_size),
+        followed by the y and z coordinates.
+    */
+    const std::vector<Scalar>& getClusterPositions() const
+        {
+        return m_cluster_pos;
+        }
+
+    //! Get the type of each cluster lane
+    const std::vector<unsigned int>& getClusterTypes() const
+        {
+        return m_cluster_type;
+        }
+
+    protected:
+    //! Builds the neighbor list
+    virtual void buildNlist(uint64_t timestep);
+
+    //! Exclusions are already applied to the interaction masks
+    virtual void filterNlist() { }
+
+    private:
+    //! Notification of a box size change
+    void slotBoxChanged()
+        {
+        m_box_changed = true;
+        }
+
+    bool m_box_changed; //!< Flag if box size has changed
+
+    unsigned int m_n_local_clusters; //!< Number of clusters of local particles
+    unsigned int m_n_clusters;       //!< Number of local and ghost clusters
+
+    // we use stl vectors here because the cluster data is only used on the CPU
+    std::vector<uint64_t> m_sort_keys;                //!< Morton code and index of each particle
+    std::vector<unsigned int> m_cluster_particles;    //!< Particle index of each cluster lane
+    std::vector<unsigned int> m_particle_lane;        //!< Cluster lane of each local particle
+    std::vector<hoomd::detail::AABB> m_cluster_aabbs; //!< Bounding box of each cluster
+    std::vector<hoomd::detail::AABB> m_tree_aabbs;    //!< Scratch copy of the AABBs for the tree
+    hoomd::detail::AABBTree m_aabb_tree;              //!< BVH tree of the cluster AABBs
+
+    std::vector<size_t> m_cluster_pair_head;             //!< First cluster pair of each cluster
+    std::vector<size_t> m_cluster_pair_half_begin;       //!< First cluster pair of the half list
+    std::vector<ClusterPair> m_cluster_pairs;            //!< Flat cluster pair list
+    std::vector<std::vector<ClusterPair>> m_chunk_pairs; //!< Cluster pairs found by each chunk
+
+    std::vector<Scalar> m_cluster_pos;        //!< Structure-of-arrays cluster coordinates
+    std::vector<unsigned int> m_cluster_type; //!< Type of each cluster lane
+
+    std::vector<vec3<Scalar>> m_image_list; //!< List of translation vectors
+    unsigned int m_n_images;                //!< The number of image vectors to check
+
+    //! Computes the image vectors to query for
+    void updateImageVectors();
+
+    //! Sorts the particles and groups them into clusters
+    void buildClusters();
+
+    //! Finds the interacting cluster pairs and their masks
+    void buildClusterPairs();
+
+    //! Fills the per particle neighbor list from the cluster pair list
+    void buildParticleNlist();
+    };
+
+    } // end namespace md
+    } // end namespace hoomd
+
+#endif // __NEIGHBORLISTCLUSTER_H__
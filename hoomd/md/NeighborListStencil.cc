@@ -36,6 +36,7 @@ NeighborListStencil::NeighborListStencil(std::shared_ptr<SystemDefinition> sysde
     m_cl->setComputeTypeBody(true);
     m_cl->setFlagIndex();
     m_cl->setComputeAdjList(false);
+    m_cl->setCompactLayout(true);
     }
 
 NeighborListStencil::~NeighborListStencil()
@@ -127,6 +128,9 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
     ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(),
                                           access_location::host,
                                           access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start(m_cl->getCellStartArray(),
+                                           access_location::host,
+                                           access_mode::read);
     ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(),
                                      access_location::host,
                                      access_mode::read);
@@ -142,164 +146,164 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
     // access the neighbor list data
     ArrayHandle<size_t> h_head_list(m_head_list, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_conditions(m_conditions,
-                                           access_location::host,
-                                           access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
     // access indexers
     Index3D ci = m_cl->getCellIndexer();
-    Index2D cli = m_cl->getCellListIndexer();
-
-    // for each local particle
-    unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    // build the list for each local particle
+    buildNlistRanges(
+        [&](unsigned int first, unsigned int last, unsigned int* conditions)
         {
-        unsigned int cur_n_neigh = 0;
-
-        const Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
-        const unsigned int body_i = h_body.data[i];
-
-        const unsigned int Nmax_i = h_Nmax.data[type_i];
-        const size_t head_idx_i = h_head_list.data[i];
-
-        // find the bin each particle belongs in
-        Scalar3 f = box.makeFraction(my_pos, ghost_width);
-        int ib = (unsigned int)(f.x * dim.x);
-        int jb = (unsigned int)(f.y * dim.y);
-        int kb = (unsigned int)(f.z * dim.z);
-
-        // need to handle the case where the particle is exactly at the box hi
-        if (ib == (int)dim.x && periodic.x)
-            ib = 0;
-        if (jb == (int)dim.y && periodic.y)
-            jb = 0;
-        if (kb == (int)dim.z && periodic.z)
-            kb = 0;
-
-        // loop through all neighboring bins
-        unsigned int n_stencil = h_n_stencil.data[type_i];
-        for (unsigned int cur_stencil = 0; cur_stencil < n_stencil; ++cur_stencil)
+        for (unsigned int i = first; i < last; i++)
             {
-            // compute the stenciled cell cartesian coordinates
-            Scalar4 stencil = h_stencil.data[stencil_idx(cur_stencil, type_i)];
-            int sib = ib + __scalar_as_int(stencil.x);
-            int sjb = jb + __scalar_as_int(stencil.y);
-            int skb = kb + __scalar_as_int(stencil.z);
-            Scalar cell_dist2 = stencil.w;
-            // wrap through the boundary
-            if (periodic.x)
+            unsigned int cur_n_neigh = 0;
+
+            const Scalar3 my_pos
+                = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
+            const unsigned int body_i = h_body.data[i];
+
+            const unsigned int Nmax_i = h_Nmax.data[type_i];
+            const size_t head_idx_i = h_head_list.data[i];
+
+            // find the bin each particle belongs in
+            Scalar3 f = box.makeFraction(my_pos, ghost_width);
+            int ib = (unsigned int)(f.x * dim.x);
+            int jb = (unsigned int)(f.y * dim.y);
+            int kb = (unsigned int)(f.z * dim.z);
+
+            // need to handle the case where the particle is exactly at the box hi
+            if (ib == (int)dim.x && periodic.x)
+                ib = 0;
+            if (jb == (int)dim.y && periodic.y)
+                jb = 0;
+            if (kb == (int)dim.z && periodic.z)
+                kb = 0;
+
+            // loop through all neighboring bins
+            unsigned int n_stencil = h_n_stencil.data[type_i];
+            for (unsigned int cur_stencil = 0; cur_stencil < n_stencil; ++cur_stencil)
                 {
-                if (sib >= (int)dim.x)
-                    sib -= dim.x;
-                else if (sib < 0)
-                    sib += dim.x;
+                // compute the stenciled cell cartesian coordinates
+                Scalar4 stencil = h_stencil.data[stencil_idx(cur_stencil, type_i)];
+                int sib = ib + __scalar_as_int(stencil.x);
+                int sjb = jb + __scalar_as_int(stencil.y);
+                int skb = kb + __scalar_as_int(stencil.z);
+                Scalar cell_dist2 = stencil.w;
+                // wrap through the boundary
+                if (periodic.x)
+                    {
+                    if (sib >= (int)dim.x)
+                        sib -= dim.x;
+                    else if (sib < 0)
+                        sib += dim.x;
 
-                // wrapping and the stencil construction should ensure this is in bounds
-                assert(sib >= 0 && sib < (int)dim.x);
-                }
-            else if (sib < 0 || sib >= (int)dim.x)
-                {
-                // in aperiodic systems the stencil could maybe extend out of the grid
-                continue;
-                }
+                    // wrapping and the stencil construction should ensure this is in bounds
+                    assert(sib >= 0 && sib < (int)dim.x);
+                    }
+                else if (sib < 0 || sib >= (int)dim.x)
+                    {
+                    // in aperiodic systems the stencil could maybe extend out of the grid
+                    continue;
+                    }
 
-            if (periodic.y)
-                {
-                if (sjb >= (int)dim.y)
-                    sjb -= dim.y;
-                else if (sjb < 0)
-                    sjb += dim.y;
+                if (periodic.y)
+                    {
+                    if (sjb >= (int)dim.y)
+                        sjb -= dim.y;
+                    else if (sjb < 0)
+                        sjb += dim.y;
 
-                assert(sjb >= 0 && sjb < (int)dim.y);
-                }
-            else if (sjb < 0 || sjb >= (int)dim.y)
-                {
-                continue;
-                }
+                    assert(sjb >= 0 && sjb < (int)dim.y);
+                    }
+                else if (sjb < 0 || sjb >= (int)dim.y)
+                    {
+                    continue;
+                    }
 
-            if (periodic.z)
-                {
-                if (skb >= (int)dim.z)
-                    skb -= dim.z;
-                else if (skb < 0)
-                    skb += dim.z;
+                if (periodic.z)
+                    {
+                    if (skb >= (int)dim.z)
+                        skb -= dim.z;
+                    else if (skb < 0)
+                        skb += dim.z;
 
-                assert(skb >= 0 && skb < (int)dim.z);
-                }
-            else if (skb < 0 || skb >= (int)dim.z)
-                {
-                continue;
-                }
+                    assert(skb >= 0 && skb < (int)dim.z);
+                    }
+                else if (skb < 0 || skb >= (int)dim.z)
+                    {
+                    continue;
+                    }
 
-            unsigned int neigh_cell = ci(sib, sjb, skb);
+                unsigned int neigh_cell = ci(sib, sjb, skb);
 
-            // check against all the particles in that neighboring bin to see if it is a neighbor
-            unsigned int size = h_cell_size.data[neigh_cell];
-            for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
-                {
-                // read in the particle type (diameter and body as well while we've got the Scalar4
-                // in)
-                const uint2& neigh_type_body = h_cell_type_body.data[cli(cur_offset, neigh_cell)];
-                const unsigned int type_j = neigh_type_body.x;
-                const unsigned int body_j = neigh_type_body.y;
-
-                // skip any particles belonging to the same body if requested
-                if (m_filter_body && body_i != NO_BODY && body_i == body_j)
-                    continue;
+                // check against all the particles in that neighboring bin to see if it is a
+                // neighbor
+                unsigned int size = h_cell_size.data[neigh_cell];
+                unsigned int start = h_cell_start.data[neigh_cell];
+                for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                    {
+                    // read in the particle type (diameter and body as well while we've got the
+                    // Scalar4 in)
+                    const uint2& neigh_type_body = h_cell_type_body.data[start + cur_offset];
+                    const unsigned int type_j = neigh_type_body.x;
+                    const unsigned int body_j = neigh_type_body.y;
 
-                // read cutoff and skip if pair is inactive
-                Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i, type_j)];
-                if (r_cut <= Scalar(0.0))
-                    continue;
+                    // skip any particles belonging to the same body if requested
+                    if (m_filter_body && body_i != NO_BODY && body_i == body_j)
+                        continue;
 
-                // compute the rlist based on the particle type we're interacting with
-                Scalar r_list = r_cut + m_r_buff;
-                Scalar r_listsq = r_list * r_list;
+                    // read cutoff and skip if pair is inactive
+                    Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i, type_j)];
+                    if (r_cut <= Scalar(0.0))
+                        continue;
 
-                // compare the check distance to the minimum cell distance, and pass without
-                // distance check if unnecessary
-                if (cell_dist2 > r_listsq)
-                    continue;
+                    // compute the rlist based on the particle type we're interacting with
+                    Scalar r_list = r_cut + m_r_buff;
+                    Scalar r_listsq = r_list * r_list;
 
-                // only load in the particle position and id if distance check is satisfied
-                const Scalar4& neigh_xyzf = h_cell_xyzf.data[cli(cur_offset, neigh_cell)];
-                unsigned int cur_neigh = __scalar_as_int(neigh_xyzf.w);
+                    // compare the check distance to the minimum cell distance, and pass without
+                    // distance check if unnecessary
+                    if (cell_dist2 > r_listsq)
+                        continue;
 
-                // a particle cannot neighbor itself
-                if (i == (int)cur_neigh)
-                    continue;
+                    // only load in the particle position and id if distance check is satisfied
+                    const Scalar4& neigh_xyzf = h_cell_xyzf.data[start + cur_offset];
+                    unsigned int cur_neigh = __scalar_as_int(neigh_xyzf.w);
 
-                Scalar3 neigh_pos = make_scalar3(neigh_xyzf.x, neigh_xyzf.y, neigh_xyzf.z);
-                Scalar3 dx = my_pos - neigh_pos;
-                dx = box.minImage(dx);
+                    // a particle cannot neighbor itself
+                    if (i == cur_neigh)
+                        continue;
 
-                Scalar dr_sq = dot(dx, dx);
+                    Scalar3 neigh_pos = make_scalar3(neigh_xyzf.x, neigh_xyzf.y, neigh_xyzf.z);
+                    Scalar3 dx = my_pos - neigh_pos;
+                    dx = box.minImage(dx);
 
-                if (dr_sq <= r_listsq)
-                    {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    Scalar dr_sq = dot(dx, dx);
+
+                    if (dr_sq <= r_listsq)
                         {
-                        // local neighbor
-                        if (cur_n_neigh < Nmax_i)
+                        if (m_storage_mode == full || i < cur_neigh)
                             {
-                            h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
+                            // local neighbor
+                            if (cur_n_neigh < Nmax_i)
+                                {
+                                h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
+                                }
+                            else
+                                conditions[type_i] = max(conditions[type_i], cur_n_neigh + 1);
+
+                            ++cur_n_neigh;
                             }
-                        else
-                            h_conditions.data[type_i]
-                                = max(h_conditions.data[type_i], cur_n_neigh + 1);
-
-                        ++cur_n_neigh;
                         }
                     }
                 }
-            }
 
-        h_n_neigh.data[i] = cur_n_neigh;
-        }
+            h_n_neigh.data[i] = cur_n_neigh;
+            }
+        });
     }
 
 namespace detail
@@ -20,7 +20,7 @@ namespace md
     {
 NeighborListTree::NeighborListTree(std::shared_ptr<SystemDefinition> sysdef, Scalar r_buff)
     : NeighborList(sysdef, r_buff), m_box_changed(true), m_max_num_changed(true),
-      m_remap_particles(true), m_types_allocated(false), m_n_images(0)
+      m_remap_particles(true), m_rebuild_trees(true), m_types_allocated(false), m_n_images(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing NeighborListTree" << endl;
 
@@ -85,6 +85,7 @@ void NeighborListTree::setupTree()
         {
         mapParticlesByType();
         m_remap_particles = false;
+        m_rebuild_trees = true;
         }
 
     if (m_box_changed)
@@ -195,6 +196,13 @@ void NeighborListTree::updateImageVectors()
 /*!
  * \note AABBTree implements its own build routine, so this is a wrapper to call this for multiple
  * tree types.
+ *
+ * When the particles have not been remapped since the last build, each tree keeps its topology and
+ * is refit to the new particle positions in O(N) time. A tree is only rebuilt when it holds a
+ * different number of particles or when particles have moved far enough from their original
+ * neighbors that the refit tree is too slow to traverse (see AABBTree::refit()). A refit tree finds
+ * the same neighbors as a rebuilt one, but may list them in a different order, so the pair forces
+ * summed over the list match those of a rebuilt tree only to within round off.
  */
 void NeighborListTree::buildTree()
     {
@@ -259,18 +267,21 @@ void NeighborListTree::buildTree()
     // call the tree build routine, one tree per type
     for (unsigned int i = 0; i < m_pdata->getNTypes(); ++i)
         {
-        if (m_num_per_type[i] > 0)
+        if (m_num_per_type[i] > 0
+            && (m_rebuild_trees
+                || !m_aabb_trees[i].refit(&(h_aabbs.data[0]) + m_type_head[i],
+                                          m_num_per_type[i])))
             {
             m_aabb_trees[i].buildTree(&(h_aabbs.data[0]) + m_type_head[i], m_num_per_type[i]);
             }
         }
+    m_rebuild_trees = false;
     }
 
 /*!
- * Each AABBTree is traversed in a stackless fashion. One traversal is performed (per particle)-(per
- * tree)-(per image). The stackless traversal is a variation on left descent, where each node knows
- * how far ahead to advance in the list of nodes if there is no intersection between the current
- * node AABB and the query AABB. Otherwise, the search advances by one to the next node in the list.
+ * One traversal is performed (per particle)-(per tree)-(per image). Each traversal walks the wide
+ * BVH of the AABBTree with hoomd::detail::AABBTreeTraversal, which tests the query AABB against all
+ * children of a wide node with one SIMD overlap check and returns the overlapping leaf nodes.
  */
 void NeighborListTree::traverseTree()
     {
@@ -287,109 +298,100 @@ void NeighborListTree::traverseTree()
     // neighborlist data
     ArrayHandle<size_t> h_head_list(m_head_list, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_conditions(m_conditions,
-                                           access_location::host,
-                                           access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
     // Loop over all particles
-    for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+    buildNlistRanges(
+        [&](unsigned int first, unsigned int last, unsigned int* conditions)
         {
-        // read in the current position and orientation
-        const Scalar4 postype_i = h_postype.data[i];
-        const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
-        const unsigned int type_i = __scalar_as_int(postype_i.w);
-        const unsigned int body_i = h_body.data[i];
-
-        const unsigned int Nmax_i = h_Nmax.data[type_i];
-        const size_t nlist_head_i = h_head_list.data[i];
-
-        unsigned int n_neigh_i = 0;
-        for (unsigned int cur_pair_type = 0; cur_pair_type < m_pdata->getNTypes();
-             ++cur_pair_type) // loop on pair types
+        for (unsigned int i = first; i < last; ++i)
             {
-            // pass on empty types
-            if (!m_num_per_type[cur_pair_type])
-                continue;
-
-            // Check if this tree type should be excluded by r_cut(i,j) <= 0.0
-            Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i, cur_pair_type)];
-            if (r_cut <= Scalar(0.0))
-                continue;
+            // read in the current position and orientation
+            const Scalar4 postype_i = h_postype.data[i];
+            const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+            const unsigned int type_i = __scalar_as_int(postype_i.w);
+            const unsigned int body_i = h_body.data[i];
+
+            const unsigned int Nmax_i = h_Nmax.data[type_i];
+            const size_t nlist_head_i = h_head_list.data[i];
+
+            unsigned int n_neigh_i = 0;
+            for (unsigned int cur_pair_type = 0; cur_pair_type < m_pdata->getNTypes();
+                 ++cur_pair_type) // loop on pair types
+                {
+                // pass on empty types
+                if (!m_num_per_type[cur_pair_type])
+                    continue;
 
-            // Determine the minimum r_cut_i (with buffer) for this particle
-            Scalar r_cut_i = r_cut + m_r_buff;
-            Scalar r_cutsq_i = r_cut_i * r_cut_i;
-            Scalar r_list_i = r_cut_i;
+                // Check if this tree type should be excluded by r_cut(i,j) <= 0.0
+                Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i, cur_pair_type)];
+                if (r_cut <= Scalar(0.0))
+                    continue;
 
-            hoomd::detail::AABBTree* cur_aabb_tree = &m_aabb_trees[cur_pair_type];
+                // Determine the minimum r_cut_i (with buffer) for this particle
+                Scalar r_cut_i = r_cut + m_r_buff;
+                Scalar r_cutsq_i = r_cut_i * r_cut_i;
+                Scalar r_list_i = r_cut_i;
 
-            for (unsigned int cur_image = 0; cur_image < m_n_images;
-                 ++cur_image) // for each image vector
-                {
-                // make an AABB for the image of this particle
-                vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-                hoomd::detail::AABB aabb = hoomd::detail::AABB(pos_i_image, r_list_i);
+                hoomd::detail::AABBTree* cur_aabb_tree = &m_aabb_trees[cur_pair_type];
 
-                // stackless traversal of the tree
-                for (unsigned int cur_node_idx = 0; cur_node_idx < cur_aabb_tree->getNumNodes();
-                     ++cur_node_idx)
+                for (unsigned int cur_image = 0; cur_image < m_n_images;
+                     ++cur_image) // for each image vector
                     {
-                    if (aabb.overlaps(cur_aabb_tree->getNodeAABB(cur_node_idx)))
+                    // make an AABB for the image of this particle
+                    vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+                    hoomd::detail::AABB aabb = hoomd::detail::AABB(pos_i_image, r_list_i);
+
+                    // traverse the wide BVH of the tree
+                    hoomd::detail::AABBTreeTraversal traversal(*cur_aabb_tree, aabb);
+                    for (unsigned int cur_node_idx = traversal.next();
+                         cur_node_idx != hoomd::detail::INVALID_NODE;
+                         cur_node_idx = traversal.next())
                         {
-                        if (cur_aabb_tree->isNodeLeaf(cur_node_idx))
+                        for (unsigned int cur_p = 0;
+                             cur_p < cur_aabb_tree->getNodeNumParticles(cur_node_idx);
+                             ++cur_p)
                             {
-                            for (unsigned int cur_p = 0;
-                                 cur_p < cur_aabb_tree->getNodeNumParticles(cur_node_idx);
-                                 ++cur_p)
-                                {
-                                // neighbor j
-                                unsigned int j
-                                    = cur_aabb_tree->getNodeParticleTag(cur_node_idx, cur_p);
+                            // neighbor j
+                            unsigned int j = cur_aabb_tree->getNodeParticleTag(cur_node_idx, cur_p);
 
-                                // skip self-interaction always
-                                bool excluded = (i == j);
+                            // skip self-interaction always
+                            bool excluded = (i == j);
 
-                                if (m_filter_body && body_i != NO_BODY)
-                                    excluded = excluded | (body_i == h_body.data[j]);
+                            if (m_filter_body && body_i != NO_BODY)
+                                excluded = excluded | (body_i == h_body.data[j]);
 
-                                if (!excluded)
+                            if (!excluded)
+                                {
+                                // compute distance
+                                Scalar4 postype_j = h_postype.data[j];
+                                Scalar3 drij
+                                    = make_scalar3(postype_j.x, postype_j.y, postype_j.z)
+                                      - vec_to_scalar3(pos_i_image);
+                                Scalar dr_sq = dot(drij, drij);
+
+                                if (dr_sq <= r_cutsq_i)
                                     {
-                                    // compute distance
-                                    Scalar4 postype_j = h_postype.data[j];
-                                    Scalar3 drij
-                                        = make_scalar3(postype_j.x, postype_j.y, postype_j.z)
-                                          - vec_to_scalar3(pos_i_image);
-                                    Scalar dr_sq = dot(drij, drij);
-
-                                    if (dr_sq <= r_cutsq_i)
+                                    if (m_storage_mode == full || i < j)
                                         {
-                                        if (m_storage_mode == full || i < j)
-                                            {
-                                            if (n_neigh_i < Nmax_i)
-                                                h_nlist.data[nlist_head_i + n_neigh_i] = j;
-                                            else
-                                                h_conditions.data[type_i]
-                                                    = max(h_conditions.data[type_i], n_neigh_i + 1);
-
-                                            ++n_neigh_i;
-                                            }
+                                        if (n_neigh_i < Nmax_i)
+                                            h_nlist.data[nlist_head_i + n_neigh_i] = j;
+                                        else
+                                            conditions[type_i]
+                                                = max(conditions[type_i], n_neigh_i + 1);
+
+                                        ++n_neigh_i;
                                         }
                                     }
                                 }
                             }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += cur_aabb_tree->getNodeSkip(cur_node_idx);
-                        }
-                    } // end stackless search
-                } // end loop over images
-            } // end loop over pair types
-        h_n_neigh.data[i] = n_neigh_i;
-        } // end loop over particles
+                        } // end tree traversal
+                    } // end loop over images
+                } // end loop over pair types
+            h_n_neigh.data[i] = n_neigh_i;
+            } // end loop over particles
+        });
     }
 
 namespace detail
@@ -75,6 +75,7 @@ class PYBIND11_EXPORT NeighborListTree : public NeighborList
     bool m_box_changed;     //!< Flag if box size has changed
     bool m_max_num_changed; //!< Flag if the particle arrays need to be resized
     bool m_remap_particles; //!< Flag if the particles need to remapped (triggered by sort)
+    bool m_rebuild_trees;   //!< Flag if the trees need to be rebuilt instead of refit
 
     /// set to true when the type data has been allocated
     bool m_types_allocated;
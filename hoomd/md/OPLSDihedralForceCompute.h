@@ -3,6 +3,7 @@
 
 #include "hoomd/BondedGroupData.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 
 #include <memory>
 #include <vector>
@@ -93,6 +94,11 @@ class PYBIND11_EXPORT OPLSDihedralForceCompute : public ForceCompute
     //!< Dihedral data to use in computing dihedrals
     std::shared_ptr<DihedralData> m_dihedral_data;
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
     };
@@ -142,6 +142,13 @@ PPPMForceCompute::~PPPMForceCompute()
         {
         kiss_fft_free(m_kiss_fft);
         kiss_fft_free(m_kiss_ifft);
+#ifdef ENABLE_TBB
+        for (unsigned int d = 0; d < 3; ++d)
+            {
+            kiss_fft_free(m_kiss_fft_1d[d]);
+            kiss_fft_free(m_kiss_ifft_1d[d]);
+            }
+#endif
         kiss_fft_cleanup();
         }
 #ifdef ENABLE_MPI
@@ -544,6 +551,21 @@ void PPPMForceCompute::initializeFFT()
         m_kiss_fft = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
         m_kiss_ifft = kiss_fftnd_alloc(dims, 3, 1, NULL, NULL);
 
+#ifdef ENABLE_TBB
+        // one dimensional plans for the threaded transform, see localFFT()
+        for (unsigned int d = 0; d < 3; ++d)
+            {
+            if (m_kiss_fft_1d[d])
+                kiss_fft_free(m_kiss_fft_1d[d]);
+            if (m_kiss_ifft_1d[d])
+                kiss_fft_free(m_kiss_ifft_1d[d]);
+
+            m_kiss_fft_1d[d] = kiss_fft_alloc(dims[d], 0, NULL, NULL);
+            m_kiss_ifft_1d[d] = kiss_fft_alloc(dims[d], 1, NULL, NULL);
+            }
+        m_fft_scratch.resize(size_t(dims[0]) * dims[1] * dims[2]);
+#endif
+
         m_kiss_fft_initialized = true;
         }
 
@@ -780,150 +802,205 @@ void PPPMForceCompute::assignParticles()
                                    access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                            access_location::host,
+                                            access_mode::read);
 
     ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff, access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
 
-    // set mesh to zero
-    memset(h_mesh.data, 0, sizeof(kiss_fft_cpx) * m_mesh.getNumElements());
-
     Scalar V_cell = box.getVolume() / (Scalar)(m_mesh_points.x * m_mesh_points.y * m_mesh_points.z);
 
-    // loop over group
-    unsigned int group_size = m_group->getNumMembers();
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int idx = m_group->getMemberIndex(group_idx);
-
-        Scalar4 postype = h_postype.data[idx];
-        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-
-        // ignore if NaN
-        if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+    // spread the charges of group members [first, last) onto mesh
+    auto assign_range = [&](unsigned int first, unsigned int last, kiss_fft_cpx* mesh)
+    {
+        for (unsigned int group_idx = first; group_idx < last; group_idx++)
             {
-            continue;
-            }
-
-        Scalar qi = h_charge.data[idx];
+            unsigned int idx = h_index_array.data[group_idx];
 
-        // compute coordinates in units of the mesh size
-        Scalar3 f = box.makeFraction(pos);
-        Scalar3 reduced_pos = make_scalar3(f.x * (Scalar)m_mesh_points.x,
-                                           f.y * (Scalar)m_mesh_points.y,
-                                           f.z * (Scalar)m_mesh_points.z);
+            Scalar4 postype = h_postype.data[idx];
+            Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
 
-        reduced_pos.x += (Scalar)m_n_ghost_cells.x;
-        reduced_pos.y += (Scalar)m_n_ghost_cells.y;
-        reduced_pos.z += (Scalar)m_n_ghost_cells.z;
+            // ignore if NaN
+            if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+                {
+                continue;
+                }
 
-        Scalar shift, shiftone;
+            Scalar qi = h_charge.data[idx];
 
-        if (m_order % 2)
-            {
-            shift = 0.5;
-            shiftone = 0.0;
-            }
-        else
-            {
-            shift = 0.0;
-            shiftone = 0.5;
-            }
+            // compute coordinates in units of the mesh size
+            Scalar3 f = box.makeFraction(pos);
+            Scalar3 reduced_pos = make_scalar3(f.x * (Scalar)m_mesh_points.x,
+                                               f.y * (Scalar)m_mesh_points.y,
+                                               f.z * (Scalar)m_mesh_points.z);
 
-        // find cell of the mesh the particle is in
-        int ix = int(reduced_pos.x + shift);
-        int iy = int(reduced_pos.y + shift);
-        int iz = int(reduced_pos.z + shift);
-
-        Scalar dx = shiftone + (Scalar)ix - reduced_pos.x;
-        Scalar dy = shiftone + (Scalar)iy - reduced_pos.y;
-        Scalar dz = shiftone + (Scalar)iz - reduced_pos.z;
-
-        // handle particles on the boundary
-        if (ix == (int)m_grid_dim.x && !m_n_ghost_cells.x)
-            ix = 0;
-        if (iy == (int)m_grid_dim.y && !m_n_ghost_cells.y)
-            iy = 0;
-        if (iz == (int)m_grid_dim.z && !m_n_ghost_cells.z)
-            iz = 0;
-
-        if (ix < 0 || ix >= (int)m_grid_dim.x || iy < 0 || iy >= (int)m_grid_dim.y || iz < 0
-            || iz >= (int)m_grid_dim.z)
-            {
-            // ignore, error will be thrown elsewhere (in CellList)
-            continue;
-            }
-
-        int mult_fact = 2 * m_order + 1;
-        Scalar Wx, Wy, Wz;
+            reduced_pos.x += (Scalar)m_n_ghost_cells.x;
+            reduced_pos.y += (Scalar)m_n_ghost_cells.y;
+            reduced_pos.z += (Scalar)m_n_ghost_cells.z;
 
-        int nlower = -(m_order - 1) / 2;
-        int nupper = m_order / 2;
+            Scalar shift, shiftone;
 
-        for (int i = nlower; i <= nupper; ++i)
-            {
-            Wx = Scalar(0.0);
-            for (int iorder = m_order - 1; iorder >= 0; iorder--)
+            if (m_order % 2)
                 {
-                Wx = h_rho_coeff.data[i - nlower + iorder * mult_fact] + Wx * dx;
+                shift = 0.5;
+                shiftone = 0.0;
+                }
+            else
+                {
+                shift = 0.0;
+                shiftone = 0.5;
                 }
 
-            int neighi = (int)ix + i;
-
-            if (!m_n_ghost_cells.x)
+            // find cell of the mesh the particle is in
+            int ix = int(reduced_pos.x + shift);
+            int iy = int(reduced_pos.y + shift);
+            int iz = int(reduced_pos.z + shift);
+
+            Scalar dx = shiftone + (Scalar)ix - reduced_pos.x;
+            Scalar dy = shiftone + (Scalar)iy - reduced_pos.y;
+            Scalar dz = shiftone + (Scalar)iz - reduced_pos.z;
+
+            // handle particles on the boundary
+            if (ix == (int)m_grid_dim.x && !m_n_ghost_cells.x)
+                ix = 0;
+            if (iy == (int)m_grid_dim.y && !m_n_ghost_cells.y)
+                iy = 0;
+            if (iz == (int)m_grid_dim.z && !m_n_ghost_cells.z)
+                iz = 0;
+
+            if (ix < 0 || ix >= (int)m_grid_dim.x || iy < 0 || iy >= (int)m_grid_dim.y || iz < 0
+                || iz >= (int)m_grid_dim.z)
                 {
-                if (neighi >= (int)m_grid_dim.x)
-                    neighi -= m_grid_dim.x;
-                else if (neighi < 0)
-                    neighi += m_grid_dim.x;
+                // ignore, error will be thrown elsewhere (in CellList)
+                continue;
                 }
 
-            for (int j = nlower; j <= nupper; ++j)
+            int mult_fact = 2 * m_order + 1;
+            Scalar Wx, Wy, Wz;
+
+            int nlower = -(m_order - 1) / 2;
+            int nupper = m_order / 2;
+
+            for (int i = nlower; i <= nupper; ++i)
                 {
-                Wy = Scalar(0.0);
+                Wx = Scalar(0.0);
                 for (int iorder = m_order - 1; iorder >= 0; iorder--)
                     {
-                    Wy = h_rho_coeff.data[j - nlower + iorder * mult_fact] + Wy * dy;
+                    Wx = h_rho_coeff.data[i - nlower + iorder * mult_fact] + Wx * dx;
                     }
 
-                int neighj = (int)iy + j;
+                int neighi = (int)ix + i;
 
-                if (!m_n_ghost_cells.y)
+                if (!m_n_ghost_cells.x)
                     {
-                    if (neighj >= (int)m_grid_dim.y)
-                        neighj -= m_grid_dim.y;
-                    else if (neighj < 0)
-                        neighj += m_grid_dim.y;
+                    if (neighi >= (int)m_grid_dim.x)
+                        neighi -= m_grid_dim.x;
+                    else if (neighi < 0)
+                        neighi += m_grid_dim.x;
                     }
 
-                for (int k = nlower; k <= nupper; ++k)
+                for (int j = nlower; j <= nupper; ++j)
                     {
-                    Wz = Scalar(0.0);
+                    Wy = Scalar(0.0);
                     for (int iorder = m_order - 1; iorder >= 0; iorder--)
                         {
-                        Wz = h_rho_coeff.data[k - nlower + iorder * mult_fact] + Wz * dz;
+                        Wy = h_rho_coeff.data[j - nlower + iorder * mult_fact] + Wy * dy;
                         }
 
-                    int neighk = (int)iz + k;
-                    if (!m_n_ghost_cells.z)
+                    int neighj = (int)iy + j;
+
+                    if (!m_n_ghost_cells.y)
                         {
-                        if (neighk >= (int)m_grid_dim.z)
-                            neighk -= m_grid_dim.z;
-                        else if (neighk < 0)
-                            neighk += m_grid_dim.z;
+                        if (neighj >= (int)m_grid_dim.y)
+                            neighj -= m_grid_dim.y;
+                        else if (neighj < 0)
+                            neighj += m_grid_dim.y;
                         }
 
-                    Scalar W = Wx * Wy * Wz;
+                    for (int k = nlower; k <= nupper; ++k)
+                        {
+                        Wz = Scalar(0.0);
+                        for (int iorder = m_order - 1; iorder >= 0; iorder--)
+                            {
+                            Wz = h_rho_coeff.data[k - nlower + iorder * mult_fact] + Wz * dz;
+                            }
+
+                        int neighk = (int)iz + k;
+                        if (!m_n_ghost_cells.z)
+                            {
+                            if (neighk >= (int)m_grid_dim.z)
+                                neighk -= m_grid_dim.z;
+                            else if (neighk < 0)
+                                neighk += m_grid_dim.z;
+                            }
+
+                        Scalar W = Wx * Wy * Wz;
 
-                    // store in row major order
-                    unsigned int neigh_idx
-                        = neighi + m_grid_dim.x * (neighj + m_grid_dim.y * neighk);
+                        // store in row major order
+                        unsigned int neigh_idx
+                            = neighi + m_grid_dim.x * (neighj + m_grid_dim.y * neighk);
 
-                    h_mesh.data[neigh_idx].r += float(qi * W / V_cell);
+                        mesh[neigh_idx].r += float(qi * W / V_cell);
+                        }
                     }
                 }
             }
-        } // end loop over particles
+    };
+
+    unsigned int group_size = m_group->getNumMembers();
+
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        // each chunk of group members spreads its charges onto a private copy of the mesh, then
+        // the copies are summed in chunk order
+        const unsigned int n_chunks = m_exec_conf->getNumThreads();
+        const size_t n_elements = m_mesh.getNumElements();
+        if (m_mesh_scratch.size() < n_chunks * n_elements)
+            m_mesh_scratch.resize(n_chunks * n_elements);
+
+        auto chunk_begin = [&](unsigned int c)
+        { return hoomd::detail::ForceScatterBuffers::getChunkBegin(c, n_chunks, group_size); };
+
+        auto assign_chunks = [&](const tbb::blocked_range<unsigned int>& r)
+        {
+            for (unsigned int c = r.begin(); c != r.end(); ++c)
+                {
+                kiss_fft_cpx* mesh = m_mesh_scratch.data() + c * n_elements;
+                memset(mesh, 0, sizeof(kiss_fft_cpx) * n_elements);
+                assign_range(chunk_begin(c), chunk_begin(c + 1), mesh);
+                }
+        };
+
+        auto sum_chunks = [&](const tbb::blocked_range<size_t>& r)
+        {
+            for (size_t cell = r.begin(); cell != r.end(); ++cell)
+                {
+                kiss_fft_scalar rho(0.0);
+                for (unsigned int c = 0; c < n_chunks; ++c)
+                    rho += m_mesh_scratch[c * n_elements + cell].r;
+                h_mesh.data[cell].r = rho;
+                h_mesh.data[cell].i = 0;
+                }
+        };
+
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_chunks, 1), assign_chunks);
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, n_elements), sum_chunks);
+            });
+        }
+    else
+#endif
+        {
+        // set mesh to zero
+        memset(h_mesh.data, 0, sizeof(kiss_fft_cpx) * m_mesh.getNumElements());
+
+        assign_range(0, group_size, h_mesh.data);
+        }
     }
 
 void PPPMForceCompute::updateMeshes()
@@ -936,7 +1013,12 @@ void PPPMForceCompute::updateMeshes()
                                                  access_location::host,
                                                  access_mode::overwrite);
 
-        kiss_fftnd(m_kiss_fft, h_mesh.data, h_fourier_mesh.data);
+#ifdef ENABLE_TBB
+        if (m_exec_conf->getNumThreads() > 1)
+            localFFT(m_kiss_fft_1d, h_mesh.data, h_fourier_mesh.data);
+        else
+#endif
+            kiss_fftnd(m_kiss_fft, h_mesh.data, h_fourier_mesh.data);
         }
 
 #ifdef ENABLE_MPI
@@ -980,23 +1062,28 @@ void PPPMForceCompute::updateMeshes()
         unsigned int NNN = m_global_dim.x * m_global_dim.y * m_global_dim.z;
 
         // multiply with influence function and I*k
-        for (unsigned int k = 0; k < m_n_inner_cells; ++k)
-            {
-            kiss_fft_cpx f = h_fourier_mesh.data[k];
+        auto influence_range = [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int k = first; k < last; ++k)
+                {
+                kiss_fft_cpx f = h_fourier_mesh.data[k];
 
-            Scalar scaled_inf_f = h_inf_f.data[k] / ((Scalar)NNN);
+                Scalar scaled_inf_f = h_inf_f.data[k] / ((Scalar)NNN);
 
-            Scalar3 kvec = h_k.data[k];
+                Scalar3 kvec = h_k.data[k];
 
-            h_fourier_mesh_G_x.data[k].r = float(f.i * kvec.x * scaled_inf_f);
-            h_fourier_mesh_G_x.data[k].i = float(-f.r * kvec.x * scaled_inf_f);
+                h_fourier_mesh_G_x.data[k].r = float(f.i * kvec.x * scaled_inf_f);
+                h_fourier_mesh_G_x.data[k].i = float(-f.r * kvec.x * scaled_inf_f);
 
-            h_fourier_mesh_G_y.data[k].r = float(f.i * kvec.y * scaled_inf_f);
-            h_fourier_mesh_G_y.data[k].i = float(-f.r * kvec.y * scaled_inf_f);
+                h_fourier_mesh_G_y.data[k].r = float(f.i * kvec.y * scaled_inf_f);
+                h_fourier_mesh_G_y.data[k].i = float(-f.r * kvec.y * scaled_inf_f);
 
-            h_fourier_mesh_G_z.data[k].r = float(f.i * kvec.z * scaled_inf_f);
-            h_fourier_mesh_G_z.data[k].i = float(-f.r * kvec.z * scaled_inf_f);
-            }
+                h_fourier_mesh_G_z.data[k].r = float(f.i * kvec.z * scaled_inf_f);
+                h_fourier_mesh_G_z.data[k].i = float(-f.r * kvec.z * scaled_inf_f);
+                }
+        };
+
+        hoomd::detail::forEachRange(*m_exec_conf, m_n_inner_cells, influence_range);
         }
 
     if (m_kiss_fft_initialized)
@@ -1020,9 +1107,20 @@ void PPPMForceCompute::updateMeshes()
         ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z,
                                                        access_location::host,
                                                        access_mode::overwrite);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
+#ifdef ENABLE_TBB
+        if (m_exec_conf->getNumThreads() > 1)
+            {
+            localFFT(m_kiss_ifft_1d, h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data);
+            localFFT(m_kiss_ifft_1d, h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data);
+            localFFT(m_kiss_ifft_1d, h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
+            }
+        else
+#endif
+            {
+            kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data);
+            kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data);
+            kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
+            }
         }
 
 #ifdef ENABLE_MPI
@@ -1079,6 +1177,58 @@ void PPPMForceCompute::updateMeshes()
 #endif
     }
 
+#ifdef ENABLE_TBB
+/*! \param plans One dimensional plans for the z, y, and x dimensions (forward or inverse)
+    \param fin Input mesh
+    \param fout Output mesh (must not alias \a fin)
+
+    Performs the same sequence of one dimensional transforms as kiss_fftnd(), one dimension at a
+    time, but transforms the independent columns of each stage in parallel. The result is identical
+    to that of kiss_fftnd().
+*/
+void PPPMForceCompute::localFFT(const kiss_fft_cfg* plans,
+                                const kiss_fft_cpx* fin,
+                                kiss_fft_cpx* fout)
+    {
+    const int dims[3] = {int(m_mesh_points.z), int(m_mesh_points.y), int(m_mesh_points.x)};
+    const int dimprod = dims[0] * dims[1] * dims[2];
+
+    // with an odd number of dimensions, the stages go fin -> fout -> scratch -> fout
+    const kiss_fft_cpx* bufin = fin;
+    kiss_fft_cpx* bufout = fout;
+    kiss_fft_cpx* scratch = m_fft_scratch.data();
+
+    m_exec_conf->getTaskArena()->execute(
+        [&]
+        {
+            for (unsigned int d = 0; d < 3; ++d)
+                {
+                const int curdim = dims[d];
+                const int stride = dimprod / curdim;
+
+                tbb::parallel_for(
+                    tbb::blocked_range<int>(0, stride),
+                    [&](const tbb::blocked_range<int>& r)
+                    {
+                        for (int i = r.begin(); i != r.end(); ++i)
+                            kiss_fft_stride(plans[d], bufin + i, bufout + i * curdim, stride);
+                    });
+
+                if (bufout == scratch)
+                    {
+                    bufin = scratch;
+                    bufout = fout;
+                    }
+                else
+                    {
+                    bufin = fout;
+                    bufout = scratch;
+                    }
+                }
+        });
+    }
+#endif
+
 void PPPMForceCompute::interpolateForces()
     {
     // access particle data
@@ -1086,6 +1236,9 @@ void PPPMForceCompute::interpolateForces()
                                    access_location::host,
                                    access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                            access_location::host,
+                                            access_mode::read);
 
     // access inverse Fourier transform mesh
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x,
@@ -1108,147 +1261,151 @@ void PPPMForceCompute::interpolateForces()
 
     const BoxDim& box = m_pdata->getBox();
 
-    // loop over group
-    unsigned int group_size = m_group->getNumMembers();
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int idx = m_group->getMemberIndex(group_idx);
-        Scalar4 postype = h_postype.data[idx];
-
-        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-
-        // ignore if NaN
-        if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+    // interpolate the force on group members [first, last), each writes only its own force
+    auto interpolate_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int group_idx = first; group_idx < last; group_idx++)
             {
-            continue;
-            }
-
-        Scalar qi = h_charge.data[idx];
+            unsigned int idx = h_index_array.data[group_idx];
+            Scalar4 postype = h_postype.data[idx];
 
-        // compute coordinates in units of the mesh size
-        Scalar3 f = box.makeFraction(pos);
-        Scalar3 reduced_pos = make_scalar3(f.x * (Scalar)m_mesh_points.x,
-                                           f.y * (Scalar)m_mesh_points.y,
-                                           f.z * (Scalar)m_mesh_points.z);
-        reduced_pos.x += (Scalar)m_n_ghost_cells.x;
-        reduced_pos.y += (Scalar)m_n_ghost_cells.y;
-        reduced_pos.z += (Scalar)m_n_ghost_cells.z;
+            Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
 
-        Scalar shift, shiftone;
-
-        if (m_order % 2)
-            {
-            shift = 0.5;
-            shiftone = 0.0;
-            }
-        else
-            {
-            shift = 0.0;
-            shiftone = 0.5;
-            }
-
-        // find cell of the force mesh the particle is in
-        int ix = int(reduced_pos.x + shift);
-        int iy = int(reduced_pos.y + shift);
-        int iz = int(reduced_pos.z + shift);
-
-        Scalar dx = shiftone + (Scalar)ix - reduced_pos.x;
-        Scalar dy = shiftone + (Scalar)iy - reduced_pos.y;
-        Scalar dz = shiftone + (Scalar)iz - reduced_pos.z;
-
-        // handle particles on the boundary
-        if (ix == (int)m_grid_dim.x && !m_n_ghost_cells.x)
-            ix = 0;
-        if (iy == (int)m_grid_dim.y && !m_n_ghost_cells.y)
-            iy = 0;
-        if (iz == (int)m_grid_dim.z && !m_n_ghost_cells.z)
-            iz = 0;
-
-        if (ix < 0 || ix >= (int)m_grid_dim.x || iy < 0 || iy >= (int)m_grid_dim.y || iz < 0
-            || iz >= (int)m_grid_dim.z)
-            {
-            // ignore, error will be thrown elsewhere (in CellList)
-            continue;
-            }
+            // ignore if NaN
+            if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+                {
+                continue;
+                }
 
-        Scalar3 force = make_scalar3(0.0, 0.0, 0.0);
+            Scalar qi = h_charge.data[idx];
 
-        int mult_fact = 2 * m_order + 1;
-        Scalar Wx, Wy, Wz;
+            // compute coordinates in units of the mesh size
+            Scalar3 f = box.makeFraction(pos);
+            Scalar3 reduced_pos = make_scalar3(f.x * (Scalar)m_mesh_points.x,
+                                               f.y * (Scalar)m_mesh_points.y,
+                                               f.z * (Scalar)m_mesh_points.z);
+            reduced_pos.x += (Scalar)m_n_ghost_cells.x;
+            reduced_pos.y += (Scalar)m_n_ghost_cells.y;
+            reduced_pos.z += (Scalar)m_n_ghost_cells.z;
 
-        int nlower = -(m_order - 1) / 2;
-        int nupper = m_order / 2;
+            Scalar shift, shiftone;
 
-        for (int i = nlower; i <= nupper; ++i)
-            {
-            Wx = Scalar(0.0);
-            for (int iorder = m_order - 1; iorder >= 0; iorder--)
+            if (m_order % 2)
                 {
-                Wx = h_rho_coeff.data[i - nlower + iorder * mult_fact] + Wx * dx;
+                shift = 0.5;
+                shiftone = 0.0;
+                }
+            else
+                {
+                shift = 0.0;
+                shiftone = 0.5;
                 }
 
-            int neighi = (int)ix + i;
-
-            if (!m_n_ghost_cells.x)
+            // find cell of the force mesh the particle is in
+            int ix = int(reduced_pos.x + shift);
+            int iy = int(reduced_pos.y + shift);
+            int iz = int(reduced_pos.z + shift);
+
+            Scalar dx = shiftone + (Scalar)ix - reduced_pos.x;
+            Scalar dy = shiftone + (Scalar)iy - reduced_pos.y;
+            Scalar dz = shiftone + (Scalar)iz - reduced_pos.z;
+
+            // handle particles on the boundary
+            if (ix == (int)m_grid_dim.x && !m_n_ghost_cells.x)
+                ix = 0;
+            if (iy == (int)m_grid_dim.y && !m_n_ghost_cells.y)
+                iy = 0;
+            if (iz == (int)m_grid_dim.z && !m_n_ghost_cells.z)
+                iz = 0;
+
+            if (ix < 0 || ix >= (int)m_grid_dim.x || iy < 0 || iy >= (int)m_grid_dim.y || iz < 0
+                || iz >= (int)m_grid_dim.z)
                 {
-                if (neighi >= (int)m_grid_dim.x)
-                    neighi -= m_grid_dim.x;
-                else if (neighi < 0)
-                    neighi += m_grid_dim.x;
+                // ignore, error will be thrown elsewhere (in CellList)
+                continue;
                 }
 
-            for (int j = nlower; j <= nupper; ++j)
+            Scalar3 force = make_scalar3(0.0, 0.0, 0.0);
+
+            int mult_fact = 2 * m_order + 1;
+            Scalar Wx, Wy, Wz;
+
+            int nlower = -(m_order - 1) / 2;
+            int nupper = m_order / 2;
+
+            for (int i = nlower; i <= nupper; ++i)
                 {
-                Wy = Scalar(0.0);
+                Wx = Scalar(0.0);
                 for (int iorder = m_order - 1; iorder >= 0; iorder--)
                     {
-                    Wy = h_rho_coeff.data[j - nlower + iorder * mult_fact] + Wy * dy;
+                    Wx = h_rho_coeff.data[i - nlower + iorder * mult_fact] + Wx * dx;
                     }
 
-                int neighj = (int)iy + j;
+                int neighi = (int)ix + i;
 
-                if (!m_n_ghost_cells.y)
+                if (!m_n_ghost_cells.x)
                     {
-                    if (neighj >= (int)m_grid_dim.y)
-                        neighj -= m_grid_dim.y;
-                    else if (neighj < 0)
-                        neighj += m_grid_dim.y;
+                    if (neighi >= (int)m_grid_dim.x)
+                        neighi -= m_grid_dim.x;
+                    else if (neighi < 0)
+                        neighi += m_grid_dim.x;
                     }
 
-                for (int k = nlower; k <= nupper; ++k)
+                for (int j = nlower; j <= nupper; ++j)
                     {
-                    Wz = Scalar(0.0);
+                    Wy = Scalar(0.0);
                     for (int iorder = m_order - 1; iorder >= 0; iorder--)
                         {
-                        Wz = h_rho_coeff.data[k - nlower + iorder * mult_fact] + Wz * dz;
+                        Wy = h_rho_coeff.data[j - nlower + iorder * mult_fact] + Wy * dy;
                         }
 
-                    int neighk = (int)iz + k;
-                    if (!m_n_ghost_cells.z)
+                    int neighj = (int)iy + j;
+
+                    if (!m_n_ghost_cells.y)
                         {
-                        if (neighk >= (int)m_grid_dim.z)
-                            neighk -= m_grid_dim.z;
-                        else if (neighk < 0)
-                            neighk += m_grid_dim.z;
+                        if (neighj >= (int)m_grid_dim.y)
+                            neighj -= m_grid_dim.y;
+                        else if (neighj < 0)
+                            neighj += m_grid_dim.y;
                         }
 
-                    unsigned int neigh_idx
-                        = neighi + m_grid_dim.x * (neighj + m_grid_dim.y * neighk);
+                    for (int k = nlower; k <= nupper; ++k)
+                        {
+                        Wz = Scalar(0.0);
+                        for (int iorder = m_order - 1; iorder >= 0; iorder--)
+                            {
+                            Wz = h_rho_coeff.data[k - nlower + iorder * mult_fact] + Wz * dz;
+                            }
+
+                        int neighk = (int)iz + k;
+                        if (!m_n_ghost_cells.z)
+                            {
+                            if (neighk >= (int)m_grid_dim.z)
+                                neighk -= m_grid_dim.z;
+                            else if (neighk < 0)
+                                neighk += m_grid_dim.z;
+                            }
 
-                    kiss_fft_cpx E_x = h_inv_fourier_mesh_x.data[neigh_idx];
-                    kiss_fft_cpx E_y = h_inv_fourier_mesh_y.data[neigh_idx];
-                    kiss_fft_cpx E_z = h_inv_fourier_mesh_z.data[neigh_idx];
+                        unsigned int neigh_idx
+                            = neighi + m_grid_dim.x * (neighj + m_grid_dim.y * neighk);
 
-                    Scalar W = Wx * Wy * Wz;
-                    force.x += qi * W * E_x.r;
-                    force.y += qi * W * E_y.r;
-                    force.z += qi * W * E_z.r;
+                        kiss_fft_cpx E_x = h_inv_fourier_mesh_x.data[neigh_idx];
+                        kiss_fft_cpx E_y = h_inv_fourier_mesh_y.data[neigh_idx];
+                        kiss_fft_cpx E_z = h_inv_fourier_mesh_z.data[neigh_idx];
+
+                        Scalar W = Wx * Wy * Wz;
+                        force.x += qi * W * E_x.r;
+                        force.y += qi * W * E_y.r;
+                        force.z += qi * W * E_z.r;
+                        }
                     }
                 }
+
+            h_force.data[idx] = make_scalar4(force.x, force.y, force.z, 0.0);
             }
+    };
 
-        h_force.data[idx] = make_scalar4(force.x, force.y, force.z, 0.0);
-        } // end of loop over particles
+    hoomd::detail::forEachRange(*m_exec_conf, m_group->getNumMembers(), interpolate_range);
     }
 
 Scalar PPPMForceCompute::computePE()
@@ -5,6 +5,7 @@
 #define __PPPM_FORCE_COMPUTE_H__
 
 #include "NeighborList.h"
+#include "hoomd/ForEachRange.h"
 #include "hoomd/ForceCompute.h"
 #include "hoomd/ParticleGroup.h"
 
@@ -18,6 +19,13 @@
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 #include <memory>
 
+#ifdef ENABLE_TBB
+#include "hoomd/ForceScatterBuffers.h"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+#endif
+
 namespace hoomd
     {
 namespace md
@@ -229,6 +237,16 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
 
     bool m_dfft_initialized; //! True if host dfft has been initialized
 
+#ifdef ENABLE_TBB
+    kiss_fft_cfg m_kiss_fft_1d[3] = {NULL, NULL, NULL};  //!< 1D FFT plans (z, y, x) for localFFT()
+    kiss_fft_cfg m_kiss_ifft_1d[3] = {NULL, NULL, NULL}; //!< 1D inverse FFT plans for localFFT()
+    std::vector<kiss_fft_cpx> m_fft_scratch;  //!< Intermediate mesh for localFFT()
+    std::vector<kiss_fft_cpx> m_mesh_scratch; //!< Per-chunk charge meshes for threaded assignment
+
+    //! Threaded local 3D FFT, equivalent to kiss_fftnd()
+    void localFFT(const kiss_fft_cfg* plans, const kiss_fft_cpx* fin, kiss_fft_cpx* fout);
+#endif
+
     //! Compute virial on mesh
     void computeVirialMesh();
 
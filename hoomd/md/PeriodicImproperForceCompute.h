@@ -4,6 +4,7 @@
 #include "PeriodicImproper.h"
 #include "hoomd/BondedGroupData.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 
 #include <memory>
 
@@ -60,6 +61,11 @@ class PYBIND11_EXPORT PeriodicImproperForceCompute : public ForceCompute
 
     std::shared_ptr<ImproperData> m_improper_data; //!< Improper data to use in computing impropers
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
     };
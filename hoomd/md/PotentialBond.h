@@ -2,6 +2,7 @@
 // Part of HOOMD-blue, released under the BSD 3-Clause License.
 
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 #include "hoomd/GPUArray.h"
 #include "hoomd/MeshDefinition.h"
 #include <memory>
@@ -64,6 +65,11 @@ template<class evaluator, class Bonds> class PotentialBond : public ForceCompute
     GPUArray<param_type> m_params;      //!< Bond parameters per type
     std::shared_ptr<Bonds> m_bond_data; //!< Bond data to use in computing bonds
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
     };
@@ -197,10 +203,6 @@ void PotentialBond<evaluator, Bonds>::computeForces(uint64_t timestep)
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor];
 
-    Scalar bond_virial[6];
-    for (unsigned int i = 0; i < 6; i++)
-        bond_virial[i] = Scalar(0.0);
-
     ArrayHandle<typename Bonds::members_t> h_bonds(m_bond_data->getMembersArray(),
                                                    access_location::host,
                                                    access_mode::read);
@@ -208,109 +210,152 @@ void PotentialBond<evaluator, Bonds>::computeForces(uint64_t timestep)
                                      access_location::host,
                                      access_mode::read);
 
-    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+    const unsigned int N = m_pdata->getN();
+    unsigned int max_local = N + m_pdata->getNGhosts();
 
-    // for each of the bonds
-    const unsigned int size = (unsigned int)m_bond_data->getN();
+    // compute the forces of bonds [first, last) and accumulate them in force and virial
+    auto compute_range = [&](unsigned int first,
+                             unsigned int last,
+                             Scalar4* force,
+                             Scalar* virial,
+                             size_t virial_pitch)
+    {
+        Scalar bond_virial[6];
+        for (unsigned int i = 0; i < 6; i++)
+            bond_virial[i] = Scalar(0.0);
 
-    for (unsigned int i = 0; i < size; i++)
-        {
-        // lookup the tag of each of the particles participating in the bond
-        const typename Bonds::members_t& bond = h_bonds.data[i];
-        assert(bond.tag[0] < m_pdata->getMaximumTag() + 1);
-        assert(bond.tag[1] < m_pdata->getMaximumTag() + 1);
-
-        // transform a and b into indices into the particle data arrays
-        // (MEM TRANSFER: 4 integers)
-        unsigned int idx_a = h_rtag.data[bond.tag[0]];
-        unsigned int idx_b = h_rtag.data[bond.tag[1]];
-
-        // throw an error if this bond is incomplete
-        if (idx_a >= max_local || idx_b >= max_local)
+        for (unsigned int i = first; i < last; i++)
             {
-            std::ostringstream stream;
-            stream << "Error: bond " << bond.tag[0] << " " << bond.tag[1] << " is incomplete.";
-            throw std::runtime_error(stream.str());
-            }
+            // lookup the tag of each of the particles participating in the bond
+            const typename Bonds::members_t& bond = h_bonds.data[i];
+            assert(bond.tag[0] < m_pdata->getMaximumTag() + 1);
+            assert(bond.tag[1] < m_pdata->getMaximumTag() + 1);
+
+            // transform a and b into indices into the particle data arrays
+            // (MEM TRANSFER: 4 integers)
+            unsigned int idx_a = h_rtag.data[bond.tag[0]];
+            unsigned int idx_b = h_rtag.data[bond.tag[1]];
+
+            // throw an error if this bond is incomplete
+            if (idx_a >= max_local || idx_b >= max_local)
+                {
+                std::ostringstream stream;
+                stream << "Error: bond " << bond.tag[0] << " " << bond.tag[1] << " is incomplete.";
+                throw std::runtime_error(stream.str());
+                }
 
-        // calculate d\vec{r}
-        // (MEM TRANSFER: 6 Scalars / FLOPS: 3)
-        Scalar3 posa = make_scalar3(h_pos.data[idx_a].x, h_pos.data[idx_a].y, h_pos.data[idx_a].z);
-        Scalar3 posb = make_scalar3(h_pos.data[idx_b].x, h_pos.data[idx_b].y, h_pos.data[idx_b].z);
+            // calculate d\vec{r}
+            // (MEM TRANSFER: 6 Scalars / FLOPS: 3)
+            Scalar3 posa
+                = make_scalar3(h_pos.data[idx_a].x, h_pos.data[idx_a].y, h_pos.data[idx_a].z);
+            Scalar3 posb
+                = make_scalar3(h_pos.data[idx_b].x, h_pos.data[idx_b].y, h_pos.data[idx_b].z);
 
-        Scalar3 dx = posb - posa;
+            Scalar3 dx = posb - posa;
 
-        // access charge (if needed)
-        Scalar charge_a = Scalar(0.0);
-        Scalar charge_b = Scalar(0.0);
-        if (evaluator::needsCharge())
-            {
-            charge_a = h_charge.data[idx_a];
-            charge_b = h_charge.data[idx_b];
-            }
-
-        // if the vector crosses the box, pull it back
-        dx = box.minImage(dx);
+            // access charge (if needed)
+            Scalar charge_a = Scalar(0.0);
+            Scalar charge_b = Scalar(0.0);
+            if (evaluator::needsCharge())
+                {
+                charge_a = h_charge.data[idx_a];
+                charge_b = h_charge.data[idx_b];
+                }
 
-        // calculate r_ab squared
-        Scalar rsq = dot(dx, dx);
+            // if the vector crosses the box, pull it back
+            dx = box.minImage(dx);
 
-        // compute the force and potential energy
-        Scalar force_divr = Scalar(0.0);
-        Scalar bond_eng = Scalar(0.0);
-        evaluator eval(rsq, h_params.data[h_typeval.data[i].type]);
-        if (evaluator::needsCharge())
-            eval.setCharge(charge_a, charge_b);
+            // calculate r_ab squared
+            Scalar rsq = dot(dx, dx);
 
-        bool evaluated = eval.evalForceAndEnergy(force_divr, bond_eng);
+            // compute the force and potential energy
+            Scalar force_divr = Scalar(0.0);
+            Scalar bond_eng = Scalar(0.0);
+            evaluator eval(rsq, h_params.data[h_typeval.data[i].type]);
+            if (evaluator::needsCharge())
+                eval.setCharge(charge_a, charge_b);
 
-        // Bond energy must be halved
-        bond_eng *= Scalar(0.5);
+            bool evaluated = eval.evalForceAndEnergy(force_divr, bond_eng);
 
-        if (evaluated)
-            {
-            // calculate virial
-            if (compute_virial)
-                {
-                Scalar force_div2r = Scalar(1.0 / 2.0) * force_divr;
-                bond_virial[0] = dx.x * dx.x * force_div2r; // xx
-                bond_virial[1] = dx.x * dx.y * force_div2r; // xy
-                bond_virial[2] = dx.x * dx.z * force_div2r; // xz
-                bond_virial[3] = dx.y * dx.y * force_div2r; // yy
-                bond_virial[4] = dx.y * dx.z * force_div2r; // yz
-                bond_virial[5] = dx.z * dx.z * force_div2r; // zz
-                }
+            // Bond energy must be halved
+            bond_eng *= Scalar(0.5);
 
-            // add the force to the particles (only for non-ghost particles)
-            if (idx_b < m_pdata->getN())
+            if (evaluated)
                 {
-                h_force.data[idx_b].x += force_divr * dx.x;
-                h_force.data[idx_b].y += force_divr * dx.y;
-                h_force.data[idx_b].z += force_divr * dx.z;
-                h_force.data[idx_b].w += bond_eng;
+                // calculate virial
                 if (compute_virial)
-                    for (unsigned int i = 0; i < 6; i++)
-                        h_virial.data[i * m_virial_pitch + idx_b] += bond_virial[i];
+                    {
+                    Scalar force_div2r = Scalar(1.0 / 2.0) * force_divr;
+                    bond_virial[0] = dx.x * dx.x * force_div2r; // xx
+                    bond_virial[1] = dx.x * dx.y * force_div2r; // xy
+                    bond_virial[2] = dx.x * dx.z * force_div2r; // xz
+                    bond_virial[3] = dx.y * dx.y * force_div2r; // yy
+                    bond_virial[4] = dx.y * dx.z * force_div2r; // yz
+                    bond_virial[5] = dx.z * dx.z * force_div2r; // zz
+                    }
+
+                // add the force to the particles (only for non-ghost particles)
+                if (idx_b < N)
+                    {
+                    force[idx_b].x += force_divr * dx.x;
+                    force[idx_b].y += force_divr * dx.y;
+                    force[idx_b].z += force_divr * dx.z;
+                    force[idx_b].w += bond_eng;
+                    if (compute_virial)
+                        for (unsigned int i = 0; i < 6; i++)
+                            virial[i * virial_pitch + idx_b] += bond_virial[i];
+                    }
+
+                if (idx_a < N)
+                    {
+                    force[idx_a].x -= force_divr * dx.x;
+                    force[idx_a].y -= force_divr * dx.y;
+                    force[idx_a].z -= force_divr * dx.z;
+                    force[idx_a].w += bond_eng;
+                    if (compute_virial)
+                        for (unsigned int i = 0; i < 6; i++)
+                            virial[i * virial_pitch + idx_a] += bond_virial[i];
+                    }
                 }
-
-            if (idx_a < m_pdata->getN())
+            else
                 {
-                h_force.data[idx_a].x -= force_divr * dx.x;
-                h_force.data[idx_a].y -= force_divr * dx.y;
-                h_force.data[idx_a].z -= force_divr * dx.z;
-                h_force.data[idx_a].w += bond_eng;
-                if (compute_virial)
-                    for (unsigned int i = 0; i < 6; i++)
-                        h_virial.data[i * m_virial_pitch + idx_a] += bond_virial[i];
+                this->m_exec_conf->msg->error()
+                    << "bond." << evaluator::getName() << ": bond out of bounds" << std::endl
+                    << std::endl;
+                throw std::runtime_error("Error in bond calculation");
                 }
             }
-        else
+    };
+
+    // for each of the bonds
+    const unsigned int size = (unsigned int)m_bond_data->getN();
+
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        // bonds share particles: accumulate each chunk of bonds in its own buffer and sum the
+        // buffers in a fixed order
+        m_exec_conf->getTaskArena()->execute(
+            [&]
             {
-            this->m_exec_conf->msg->error()
-                << "bond." << evaluator::getName() << ": bond out of bounds" << std::endl
-                << std::endl;
-            throw std::runtime_error("Error in bond calculation");
-            }
+                m_scatter_buffers.resize(m_exec_conf->getNumThreads(), N, false, compute_virial);
+                m_scatter_buffers.parallelForChunks(
+                    size,
+                    [&](unsigned int c, unsigned int first, unsigned int last)
+                    {
+                        compute_range(first,
+                                      last,
+                                      m_scatter_buffers.getForce(c),
+                                      m_scatter_buffers.getVirial(c),
+                                      m_scatter_buffers.getVirialPitch());
+                    });
+                m_scatter_buffers.reduce(h_force.data, nullptr, h_virial.data, m_virial_pitch);
+            });
+        }
+    else
+#endif
+        {
+        compute_range(0, size, h_force.data, h_virial.data, m_virial_pitch);
         }
     }
 
@@ -9,9 +9,12 @@
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <stdexcept>
+#include <type_traits>
 
 #include "NeighborList.h"
+#include "NeighborListCluster.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 #include "hoomd/GlobalArray.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
@@ -26,6 +29,11 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*! \file PotentialPair.h
     \brief Defines the template class for standard pair potentials
     \details The heart of the code that computes pair potentials is in this file.
@@ -40,6 +48,37 @@ namespace hoomd
     {
 namespace md
     {
+namespace detail
+    {
+//! Number of neighbors that PotentialPair evaluates together with evalForceAndEnergyBatch
+/*! One batch fills a vector register of the widest instruction set enabled at compile time (e.g.
+    with -march=native). Two lane SSE2 or NEON batches are slower than the per pair code path in
+    benchmarks, so builds without AVX use a width of 1, which disables batch evaluation.
+*/
+#if defined(__AVX512F__)
+const unsigned int pair_batch_width = 64 / sizeof(Scalar);
+#elif defined(__AVX__)
+const unsigned int pair_batch_width = 32 / sizeof(Scalar);
+#else
+const unsigned int pair_batch_width = 1;
+#endif
+
+//! Detect evaluators that provide evalForceAndEnergyBatch for batches of \a width > 1 pairs
+template<class evaluator, unsigned int width, class = void>
+struct has_batch_evaluation : std::false_type
+    {
+    };
+
+template<class evaluator, unsigned int width>
+struct has_batch_evaluation<
+    evaluator,
+    width,
+    std::void_t<std::enable_if_t<(width > 1)>,
+                decltype(&evaluator::template evalForceAndEnergyBatch<width>)>> : std::true_type
+    {
+    };
+    } // end namespace detail
+
 //! Template class for computing pair potentials
 /*! <b>Overview:</b>
     PotentialPair computes standard pair potentials (and forces) between all particle pairs in the
@@ -80,6 +119,15 @@ namespace md
    values are stored in GlobalArray for easy access on the GPU by a derived class. The type of the
    parameters is defined by \a param_type in the potential evaluator class passed in. See the
    appropriate documentation for the evaluator for the definition of each element of the parameters.
+
+    Evaluators that do not need charges may also provide a static member function template
+   evalForceAndEnergyBatch<width>() that evaluates \a width pairs with branch free loops. The CPU
+   code then gathers the neighbors of a particle into structure-of-arrays batches of
+   detail::pair_batch_width pairs and applies the minimum image convention, evaluates the potential,
+   and sums the force on particle i in loops over the batch that the compiler vectorizes. With a
+   NeighborListCluster, computeForcesCluster() instead evaluates all pairs between two clusters of
+   particles in one batch, reading the cluster coordinates contiguously. XPLOR switching always
+   uses the per pair evaluator.
 */
 template<class evaluator> class PotentialPair : public ForceCompute
     {
@@ -242,6 +290,11 @@ template<class evaluator> class PotentialPair : public ForceCompute
     /// Keep track of number of each type of particle
     std::vector<unsigned int> m_num_particles_by_type;
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation with half neighbor lists
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
 #ifdef ENABLE_MPI
     /// The system's communicator.
     std::shared_ptr<Communicator> m_comm;
@@ -250,6 +303,9 @@ template<class evaluator> class PotentialPair : public ForceCompute
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
 
+    //! Compute the forces with the cluster pair list of a NeighborListCluster
+    void computeForcesCluster(NeighborListCluster& nlist);
+
     //! Compute the long-range corrections to energy and pressure to account for truncating the pair
     //! potentials
     virtual void computeTailCorrection()
@@ -589,6 +645,20 @@ template<class evaluator> void PotentialPair<evaluator>::computeForces(uint64_t
     // start by updating the neighborlist
     m_nlist->compute(timestep);
 
+    // evaluate whole clusters against each other when the neighbor list provides cluster pairs
+    const unsigned int cluster_pair_size
+        = NeighborListCluster::cluster_size * NeighborListCluster::cluster_size;
+    if constexpr (detail::has_batch_evaluation<evaluator, cluster_pair_size>::value)
+        {
+        auto cluster_nlist = std::dynamic_pointer_cast<NeighborListCluster>(m_nlist);
+        if (cluster_nlist && m_shift_mode != xplor)
+            {
+            computeForcesCluster(*cluster_nlist);
+            computeTailCorrection();
+            return;
+            }
+        }
+
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
@@ -619,178 +689,715 @@ template<class evaluator> void PotentialPair<evaluator>::computeForces(uint64_t
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor];
 
+    // box parameters for the batched minimum image convention
+    const Scalar3 L = box.getL();
+    const Scalar3 L_inv = make_scalar3(Scalar(1.0) / L.x, Scalar(1.0) / L.y, Scalar(1.0) / L.z);
+    const uchar3 periodic = box.getPeriodic();
+    const Scalar3 periodic_mask = make_scalar3(periodic.x ? Scalar(1.0) : Scalar(0.0),
+                                               periodic.y ? Scalar(1.0) : Scalar(0.0),
+                                               periodic.z ? Scalar(1.0) : Scalar(0.0));
+    const Scalar xy = box.getTiltFactorXY();
+    const Scalar xz = box.getTiltFactorXZ();
+    const Scalar yz = box.getTiltFactorYZ();
+
     // need to start from a zero force, energy and virial
     memset((void*)h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
     memset((void*)h_virial.data, 0, sizeof(Scalar) * m_virial.getNumElements());
 
-    // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
-        {
-        // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+    // compute the forces on particles [first, last) and accumulate them in force and virial
+    auto compute_range = [&](unsigned int first,
+                             unsigned int last,
+                             Scalar4* force,
+                             Scalar* virial,
+                             size_t virial_pitch)
+    {
+        // for each particle
+        for (unsigned int i = first; i < last; i++)
+            {
+            // access the particle's position and type (MEM TRANSFER: 4 scalars)
+            Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
 
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
+            // sanity check
+            assert(typei < m_pdata->getNTypes());
 
-        // access charge (if needed)
-        Scalar qi = Scalar(0.0);
-        if (evaluator::needsCharge())
-            qi = h_charge.data[i];
+            // access charge (if needed)
+            Scalar qi = Scalar(0.0);
+            if (evaluator::needsCharge())
+                qi = h_charge.data[i];
+
+            // initialize current particle force, potential energy, and virial to 0
+            Scalar3 fi = make_scalar3(0, 0, 0);
+            Scalar pei = 0.0;
+            Scalar virialxxi = 0.0;
+            Scalar virialxyi = 0.0;
+            Scalar virialxzi = 0.0;
+            Scalar virialyyi = 0.0;
+            Scalar virialyzi = 0.0;
+            Scalar virialzzi = 0.0;
+
+            // loop over all of the neighbors of this particle
+            const size_t myHead = h_head_list.data[i];
+            const unsigned int size = (unsigned int)h_n_neigh.data[i];
+            unsigned int k = 0;
+
+            if constexpr (detail::has_batch_evaluation<evaluator, detail::pair_batch_width>::value)
+                {
+                if (m_shift_mode != xplor)
+                    {
+                    const unsigned int width = detail::pair_batch_width;
+                    const bool energy_shift = m_shift_mode == shift;
+
+                    // structure-of-arrays batch of neighbors
+                    unsigned int j_batch[width];
+                    unsigned int param_idx_batch[width];
+                    Scalar dx_batch[width];
+                    Scalar dy_batch[width];
+                    Scalar dz_batch[width];
+                    Scalar rsq_batch[width];
+                    Scalar rcutsq_batch[width];
+                    Scalar force_divr_batch[width];
+                    Scalar pair_eng_batch[width];
+
+                    // per lane sums of the force, energy and virial of particle i
+                    Scalar fx_lane[width] = {};
+                    Scalar fy_lane[width] = {};
+                    Scalar fz_lane[width] = {};
+                    Scalar pe_lane[width] = {};
+                    Scalar virial_lane[6][width] = {};
+
+                    for (; k < size; k += width)
+                        {
+                        const unsigned int n_lanes = std::min(width, size - k);
+
+                        // gather the neighbors into the batch
+                        for (unsigned int l = 0; l < n_lanes; l++)
+                            {
+                            unsigned int j = h_nlist.data[myHead + k + l];
+                            assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+                            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+                            assert(typej < m_pdata->getNTypes());
+                            unsigned int typpair_idx = m_typpair_idx(typei, typej);
+
+                            j_batch[l] = j;
+                            param_idx_batch[l] = typpair_idx;
+                            dx_batch[l] = h_pos.data[j].x;
+                            dy_batch[l] = h_pos.data[j].y;
+                            dz_batch[l] = h_pos.data[j].z;
+                            rcutsq_batch[l] = h_rcutsq.data[typpair_idx];
+                            }
+
+                        // pad the last batch with pairs beyond the cutoff
+                        for (unsigned int l = n_lanes; l < width; l++)
+                            {
+                            param_idx_batch[l] = param_idx_batch[0];
+                            dx_batch[l] = pi.x;
+                            dy_batch[l] = pi.y;
+                            dz_batch[l] = pi.z;
+                            rcutsq_batch[l] = Scalar(0.0);
+                            }
+
+                        // apply the minimum image convention
+#pragma GCC unroll 1
+                        for (unsigned int l = 0; l < width; l++)
+                            {
+                            Scalar dx = pi.x - dx_batch[l];
+                            Scalar dy = pi.y - dy_batch[l];
+                            Scalar dz = pi.z - dz_batch[l];
+
+                            Scalar img = periodic_mask.z * slow::rint(dz * L_inv.z);
+                            dz -= L.z * img;
+                            dy -= L.z * yz * img;
+                            dx -= L.z * xz * img;
+
+                            img = periodic_mask.y * slow::rint(dy * L_inv.y);
+                            dy -= L.y * img;
+                            dx -= L.y * xy * img;
+
+                            img = periodic_mask.x * slow::rint(dx * L_inv.x);
+                            dx -= L.x * img;
+
+                            dx_batch[l] = dx;
+                            dy_batch[l] = dy;
+                            dz_batch[l] = dz;
+                            rsq_batch[l] = dx * dx + dy * dy + dz * dz;
+                            }
+
+                        evaluator::template evalForceAndEnergyBatch<width>(rsq_batch,
+                                                                           rcutsq_batch,
+                                                                           param_idx_batch,
+                                                                           m_params.data(),
+                                                                           force_divr_batch,
+                                                                           pair_eng_batch,
+                                                                           energy_shift);
+
+                        // add the force, potential energy and virial to the particle i
+#pragma GCC unroll 1
+                        for (unsigned int l = 0; l < width; l++)
+                            {
+                            Scalar force_divr = force_divr_batch[l];
+                            Scalar force_div2r = force_divr * Scalar(0.5);
+                            fx_lane[l] += dx_batch[l] * force_divr;
+                            fy_lane[l] += dy_batch[l] * force_divr;
+                            fz_lane[l] += dz_batch[l] * force_divr;
+                            pe_lane[l] += pair_eng_batch[l] * Scalar(0.5);
+                            virial_lane[0][l] += force_div2r * dx_batch[l] * dx_batch[l];
+                            virial_lane[1][l] += force_div2r * dx_batch[l] * dy_batch[l];
+                            virial_lane[2][l] += force_div2r * dx_batch[l] * dz_batch[l];
+                            virial_lane[3][l] += force_div2r * dy_batch[l] * dy_batch[l];
+                            virial_lane[4][l] += force_div2r * dy_batch[l] * dz_batch[l];
+                            virial_lane[5][l] += force_div2r * dz_batch[l] * dz_batch[l];
+                            }
+
+                        // add the force to particle j if we are using the third law, only add
+                        // force to local particles
+                        if (third_law)
+                            {
+                            for (unsigned int l = 0; l < n_lanes; l++)
+                                {
+                                unsigned int mem_idx = j_batch[l];
+                                if (rsq_batch[l] >= rcutsq_batch[l] || mem_idx >= m_pdata->getN())
+                                    continue;
+
+                                Scalar force_divr = force_divr_batch[l];
+                                Scalar force_div2r = force_divr * Scalar(0.5);
+                                force[mem_idx].x -= dx_batch[l] * force_divr;
+                                force[mem_idx].y -= dy_batch[l] * force_divr;
+                                force[mem_idx].z -= dz_batch[l] * force_divr;
+                                force[mem_idx].w += pair_eng_batch[l] * Scalar(0.5);
+                                if (compute_virial)
+                                    {
+                                    virial[0 * virial_pitch + mem_idx]
+                                        += force_div2r * dx_batch[l] * dx_batch[l];
+                                    virial[1 * virial_pitch + mem_idx]
+                                        += force_div2r * dx_batch[l] * dy_batch[l];
+                                    virial[2 * virial_pitch + mem_idx]
+                                        += force_div2r * dx_batch[l] * dz_batch[l];
+                                    virial[3 * virial_pitch + mem_idx]
+                                        += force_div2r * dy_batch[l] * dy_batch[l];
+                                    virial[4 * virial_pitch + mem_idx]
+                                        += force_div2r * dy_batch[l] * dz_batch[l];
+                                    virial[5 * virial_pitch + mem_idx]
+                                        += force_div2r * dz_batch[l] * dz_batch[l];
+                                    }
+                                }
+                            }
+                        }
 
-        // initialize current particle force, potential energy, and virial to 0
-        Scalar3 fi = make_scalar3(0, 0, 0);
-        Scalar pei = 0.0;
-        Scalar virialxxi = 0.0;
-        Scalar virialxyi = 0.0;
-        Scalar virialxzi = 0.0;
-        Scalar virialyyi = 0.0;
-        Scalar virialyzi = 0.0;
-        Scalar virialzzi = 0.0;
-
-        // loop over all of the neighbors of this particle
-        const size_t myHead = h_head_list.data[i];
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-        for (unsigned int k = 0; k < size; k++)
-            {
-            // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[myHead + k];
-            assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+                    // sum the lanes in a fixed order
+                    for (unsigned int l = 0; l < width; l++)
+                        {
+                        fi.x += fx_lane[l];
+                        fi.y += fy_lane[l];
+                        fi.z += fz_lane[l];
+                        pei += pe_lane[l];
+                        virialxxi += virial_lane[0][l];
+                        virialxyi += virial_lane[1][l];
+                        virialxzi += virial_lane[2][l];
+                        virialyyi += virial_lane[3][l];
+                        virialyzi += virial_lane[4][l];
+                        virialzzi += virial_lane[5][l];
+                        }
+                    }
+                }
 
-            // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-            Scalar3 dx = pi - pj;
+            for (; k < size; k++)
+                {
+                // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                unsigned int j = h_nlist.data[myHead + k];
+                assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+                // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+                Scalar3 dx = pi - pj;
+
+                // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
+                unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+                assert(typej < m_pdata->getNTypes());
+
+                // access charge (if needed)
+                Scalar qj = Scalar(0.0);
+                if (evaluator::needsCharge())
+                    qj = h_charge.data[j];
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
+
+                // calculate r_ij squared (FLOPS: 5)
+                Scalar rsq = dot(dx, dx);
+
+                // get parameters for this type pair
+                unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                const param_type& param = m_params[typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                Scalar ronsq = Scalar(0.0);
+                if (m_shift_mode == xplor)
+                    ronsq = h_ronsq.data[typpair_idx];
 
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
-            assert(typej < m_pdata->getNTypes());
+                // design specifies that energies are shifted if
+                // 1) shift mode is set to shift
+                // or 2) shift mode is explor and ron > rcut
+                bool energy_shift = false;
+                if (m_shift_mode == shift)
+                    energy_shift = true;
+                else if (m_shift_mode == xplor)
+                    {
+                    if (ronsq > rcutsq)
+                        energy_shift = true;
+                    }
 
-            // access charge (if needed)
-            Scalar qj = Scalar(0.0);
-            if (evaluator::needsCharge())
-                qj = h_charge.data[j];
+                // compute the force and potential energy
+                Scalar force_divr = Scalar(0.0);
+                Scalar pair_eng = Scalar(0.0);
+                evaluator eval(rsq, rcutsq, param);
+                if (evaluator::needsCharge())
+                    eval.setCharge(qi, qj);
 
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
+                bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
 
-            // calculate r_ij squared (FLOPS: 5)
-            Scalar rsq = dot(dx, dx);
+                if (evaluated)
+                    {
+                    // modify the potential for xplor shifting
+                    if (m_shift_mode == xplor)
+                        {
+                        if (rsq >= ronsq && rsq < rcutsq)
+                            {
+                            // Implement XPLOR smoothing (FLOPS: 16)
+                            Scalar old_pair_eng = pair_eng;
+                            Scalar old_force_divr = force_divr;
+
+                            // calculate 1.0 / (xplor denominator)
+                            Scalar xplor_denom_inv
+                                = Scalar(1.0)
+                                  / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+
+                            Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
+                            Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq
+                                       * (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq)
+                                       * xplor_denom_inv;
+                            Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq
+                                                * xplor_denom_inv;
+
+                            // make modifications to the old pair energy and force
+                            pair_eng = old_pair_eng * s;
+                            // note: I'm not sure why the minus sign needs to be there: my notes
+                            // have a + But this is verified correct via plotting
+                            force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+                            }
+                        }
 
-            // get parameters for this type pair
-            unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            const param_type& param = m_params[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
-            Scalar ronsq = Scalar(0.0);
-            if (m_shift_mode == xplor)
-                ronsq = h_ronsq.data[typpair_idx];
+                    Scalar force_div2r = force_divr * Scalar(0.5);
+                    // add the force, potential energy and virial to the particle i
+                    // (FLOPS: 8)
+                    fi += dx * force_divr;
+                    pei += pair_eng * Scalar(0.5);
+                    if (compute_virial)
+                        {
+                        virialxxi += force_div2r * dx.x * dx.x;
+                        virialxyi += force_div2r * dx.x * dx.y;
+                        virialxzi += force_div2r * dx.x * dx.z;
+                        virialyyi += force_div2r * dx.y * dx.y;
+                        virialyzi += force_div2r * dx.y * dx.z;
+                        virialzzi += force_div2r * dx.z * dx.z;
+                        }
 
-            // design specifies that energies are shifted if
-            // 1) shift mode is set to shift
-            // or 2) shift mode is explor and ron > rcut
-            bool energy_shift = false;
-            if (m_shift_mode == shift)
-                energy_shift = true;
-            else if (m_shift_mode == xplor)
+                    // add the force to particle j if we are using the third law (MEM TRANSFER: 10
+                    // scalars / FLOPS: 8) only add force to local particles
+                    if (third_law && j < m_pdata->getN())
+                        {
+                        unsigned int mem_idx = j;
+                        force[mem_idx].x -= dx.x * force_divr;
+                        force[mem_idx].y -= dx.y * force_divr;
+                        force[mem_idx].z -= dx.z * force_divr;
+                        force[mem_idx].w += pair_eng * Scalar(0.5);
+                        if (compute_virial)
+                            {
+                            virial[0 * virial_pitch + mem_idx] += force_div2r * dx.x * dx.x;
+                            virial[1 * virial_pitch + mem_idx] += force_div2r * dx.x * dx.y;
+                            virial[2 * virial_pitch + mem_idx] += force_div2r * dx.x * dx.z;
+                            virial[3 * virial_pitch + mem_idx] += force_div2r * dx.y * dx.y;
+                            virial[4 * virial_pitch + mem_idx] += force_div2r * dx.y * dx.z;
+                            virial[5 * virial_pitch + mem_idx] += force_div2r * dx.z * dx.z;
+                            }
+                        }
+                    }
+                }
+
+            // finally, increment the force, potential energy and virial for particle i
+            unsigned int mem_idx = i;
+            force[mem_idx].x += fi.x;
+            force[mem_idx].y += fi.y;
+            force[mem_idx].z += fi.z;
+            force[mem_idx].w += pei;
+            if (compute_virial)
                 {
-                if (ronsq > rcutsq)
-                    energy_shift = true;
+                virial[0 * virial_pitch + mem_idx] += virialxxi;
+                virial[1 * virial_pitch + mem_idx] += virialxyi;
+                virial[2 * virial_pitch + mem_idx] += virialxzi;
+                virial[3 * virial_pitch + mem_idx] += virialyyi;
+                virial[4 * virial_pitch + mem_idx] += virialyzi;
+                virial[5 * virial_pitch + mem_idx] += virialzzi;
                 }
+            }
+    };
 
-            // compute the force and potential energy
-            Scalar force_divr = Scalar(0.0);
-            Scalar pair_eng = Scalar(0.0);
-            evaluator eval(rsq, rcutsq, param);
-            if (evaluator::needsCharge())
-                eval.setCharge(qi, qj);
+#ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        const unsigned int N = m_pdata->getN();
+        m_exec_conf->getTaskArena()->execute(
+            [&]
+            {
+                if (third_law)
+                    {
+                    // forces are also applied to j: accumulate each chunk of particles in its own
+                    // buffer and sum the buffers in a fixed order
+                    m_scatter_buffers.resize(m_exec_conf->getNumThreads(),
+                                             N,
+                                             false,
+                                             compute_virial);
+                    m_scatter_buffers.parallelForChunks(
+                        N,
+                        [&](unsigned int c, unsigned int first, unsigned int last)
+                        {
+                            compute_range(first,
+                                          last,
+                                          m_scatter_buffers.getForce(c),
+                                          m_scatter_buffers.getVirial(c),
+                                          m_scatter_buffers.getVirialPitch());
+                        });
+                    m_scatter_buffers.reduce(h_force.data, nullptr, h_virial.data, m_virial_pitch);
+                    }
+                else
+                    {
+                    // with a full neighbor list, each thread writes only to the particles it owns
+                    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+                                      [&](const tbb::blocked_range<unsigned int>& r)
+                                      {
+                                          compute_range(r.begin(),
+                                                        r.end(),
+                                                        h_force.data,
+                                                        h_virial.data,
+                                                        m_virial_pitch);
+                                      });
+                    }
+            });
+        }
+    else
+#endif
+        {
+        compute_range(0, m_pdata->getN(), h_force.data, h_virial.data, m_virial_pitch);
+        }
 
-            bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+    computeTailCorrection();
+    }
 
-            if (evaluated)
+/*! \param nlist Cluster pair neighbor list (already computed for this step)
+
+    Each local i cluster loops over its j clusters. The cluster_size * cluster_size pairs of lanes
+    of the two clusters form one batch for evalForceAndEnergyBatch(). Pairs that are not in the
+    interaction mask get rcutsq = 0 so that the evaluator returns zero for them. With half storage,
+    each pair of particles appears once: the j clusters start at the i cluster itself, where only
+    the upper triangle of the mask is used, and the force on the j cluster is applied with Newton's
+    third law.
+*/
+template<class evaluator>
+void PotentialPair<evaluator>::computeForcesCluster(NeighborListCluster& nlist)
+    {
+    const unsigned int width = NeighborListCluster::cluster_size;
+    if constexpr (detail::has_batch_evaluation<evaluator, width * width>::value)
+        {
+        bool third_law = nlist.getStorageMode() == NeighborList::half;
+
+        // refresh the structure-of-arrays coordinates of the clusters
+        nlist.updateClusterPositions();
+        const std::vector<unsigned int>& cluster_particles = nlist.getClusterParticles();
+        const std::vector<size_t>& pair_head = nlist.getClusterPairHead();
+        const std::vector<size_t>& pair_half_begin = nlist.getClusterPairHalfBegin();
+        const std::vector<NeighborListCluster::ClusterPair>& pairs = nlist.getClusterPairs();
+        const std::vector<Scalar>& cluster_pos = nlist.getClusterPositions();
+        const std::vector<unsigned int>& cluster_type = nlist.getClusterTypes();
+
+        // force arrays
+        ArrayHandle<Scalar4> h_force(m_force, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_virial(m_virial, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
+
+        PDataFlags flags = this->m_pdata->getFlags();
+        bool compute_virial = flags[pdata_flag::pressure_tensor];
+        const bool energy_shift = m_shift_mode == shift;
+        const unsigned int N = m_pdata->getN();
+
+        // box parameters for the batched minimum image convention
+        const BoxDim box = m_pdata->getGlobalBox();
+        const Scalar3 L = box.getL();
+        const Scalar3 L_inv
+            = make_scalar3(Scalar(1.0) / L.x, Scalar(1.0) / L.y, Scalar(1.0) / L.z);
+        const uchar3 periodic = box.getPeriodic();
+        const Scalar3 periodic_mask = make_scalar3(periodic.x ? Scalar(1.0) : Scalar(0.0),
+                                                   periodic.y ? Scalar(1.0) : Scalar(0.0),
+                                                   periodic.z ? Scalar(1.0) : Scalar(0.0));
+        const Scalar xy = box.getTiltFactorXY();
+        const Scalar xz = box.getTiltFactorXZ();
+        const Scalar yz = box.getTiltFactorYZ();
+
+        // interaction mask bits of one lane of the i cluster
+        const uint64_t row_mask = (uint64_t(1) << width) - 1;
+
+        // mask bits with lj > li, used when the i cluster interacts with itself in a half list
+        uint64_t upper_triangle = 0;
+        for (unsigned int li = 0; li < width; li++)
+            for (unsigned int lj = li + 1; lj < width; lj++)
+                upper_triangle |= uint64_t(1) << (li * width + lj);
+
+        // need to start from a zero force, energy and virial
+        memset((void*)h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
+        memset((void*)h_virial.data, 0, sizeof(Scalar) * m_virial.getNumElements());
+
+        // compute the forces on the clusters [first, last) and accumulate them in force and virial
+        auto compute_range = [&](unsigned int first,
+                                 unsigned int last,
+                                 Scalar4* force,
+                                 Scalar* virial,
+                                 size_t virial_pitch)
+        {
+            for (unsigned int ci = first; ci < last; ci++)
                 {
-                // modify the potential for xplor shifting
-                if (m_shift_mode == xplor)
+                const unsigned int* lanes_i = &cluster_particles[size_t(ci) * width];
+                const Scalar* xi = &cluster_pos[size_t(ci) * 3 * width];
+                const Scalar* yi = xi + width;
+                const Scalar* zi = yi + width;
+                const unsigned int* typei = &cluster_type[size_t(ci) * width];
+
+                // per lane pair sums of the force, energy and virial of the i cluster
+                Scalar fx_i[width * width] = {};
+                Scalar fy_i[width * width] = {};
+                Scalar fz_i[width * width] = {};
+                Scalar pe_i[width * width] = {};
+                Scalar virial_i[6][width * width] = {};
+
+                // structure-of-arrays batch of all pairs between the i and j clusters
+                const unsigned int n_pairs = width * width;
+                unsigned int param_idx_batch[n_pairs];
+                Scalar dx_batch[n_pairs];
+                Scalar dy_batch[n_pairs];
+                Scalar dz_batch[n_pairs];
+                Scalar rsq_batch[n_pairs];
+                Scalar rcutsq_batch[n_pairs];
+                Scalar force_divr_batch[n_pairs];
+                Scalar pair_eng_batch[n_pairs];
+
+                const size_t pair_begin = third_law ? pair_half_begin[ci] : pair_head[ci];
+                for (size_t p = pair_begin; p < pair_head[ci + 1]; p++)
                     {
-                    if (rsq >= ronsq && rsq < rcutsq)
+                    const unsigned int cj = pairs[p].cluster;
+                    uint64_t mask = pairs[p].mask;
+                    if (third_law && cj == ci)
+                        mask &= upper_triangle;
+                    if (mask == 0)
+                        continue;
+
+                    const unsigned int* lanes_j = &cluster_particles[size_t(cj) * width];
+                    const Scalar* xj = &cluster_pos[size_t(cj) * 3 * width];
+                    const Scalar* yj = xj + width;
+                    const Scalar* zj = yj + width;
+                    const unsigned int* typej = &cluster_type[size_t(cj) * width];
+
+                    for (unsigned int li = 0; li < width; li++)
                         {
-                        // Implement XPLOR smoothing (FLOPS: 16)
-                        Scalar old_pair_eng = pair_eng;
-                        Scalar old_force_divr = force_divr;
+                        for (unsigned int lj = 0; lj < width; lj++)
+                            {
+                            const unsigned int lane = li * width + lj;
+                            unsigned int typpair_idx = m_typpair_idx(typei[li], typej[lj]);
+                            param_idx_batch[lane] = typpair_idx;
+                            rcutsq_batch[lane] = ((mask >> lane) & 1) ? h_rcutsq.data[typpair_idx]
+                                                                      : Scalar(0.0);
+                            dx_batch[lane] = xi[li] - xj[lj];
+                            dy_batch[lane] = yi[li] - yj[lj];
+                            dz_batch[lane] = zi[li] - zj[lj];
+                            }
+                        }
 
-                        // calculate 1.0 / (xplor denominator)
-                        Scalar xplor_denom_inv
-                            = Scalar(1.0)
-                              / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+                    // apply the minimum image convention
+#pragma GCC unroll 1
+                    for (unsigned int lane = 0; lane < n_pairs; lane++)
+                        {
+                        Scalar dx = dx_batch[lane];
+                        Scalar dy = dy_batch[lane];
+                        Scalar dz = dz_batch[lane];
+
+                        Scalar img = periodic_mask.z * slow::rint(dz * L_inv.z);
+                        dz -= L.z * img;
+                        dy -= L.z * yz * img;
+                        dx -= L.z * xz * img;
+
+                        img = periodic_mask.y * slow::rint(dy * L_inv.y);
+                        dy -= L.y * img;
+                        dx -= L.y * xy * img;
+
+                        img = periodic_mask.x * slow::rint(dx * L_inv.x);
+                        dx -= L.x * img;
+
+                        dx_batch[lane] = dx;
+                        dy_batch[lane] = dy;
+                        dz_batch[lane] = dz;
+                        rsq_batch[lane] = dx * dx + dy * dy + dz * dz;
+                        }
 
-                        Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
-                        Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq
-                                   * (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq)
-                                   * xplor_denom_inv;
-                        Scalar ds_dr_divr
-                            = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
+                    evaluator::template evalForceAndEnergyBatch<n_pairs>(rsq_batch,
+                                                                         rcutsq_batch,
+                                                                         param_idx_batch,
+                                                                         m_params.data(),
+                                                                         force_divr_batch,
+                                                                         pair_eng_batch,
+                                                                         energy_shift);
+
+                    // add the force, potential energy and virial to the i cluster
+#pragma GCC unroll 1
+                    for (unsigned int lane = 0; lane < n_pairs; lane++)
+                        {
+                        Scalar force_divr = force_divr_batch[lane];
+                        Scalar force_div2r = force_divr * Scalar(0.5);
+                        fx_i[lane] += dx_batch[lane] * force_divr;
+                        fy_i[lane] += dy_batch[lane] * force_divr;
+                        fz_i[lane] += dz_batch[lane] * force_divr;
+                        pe_i[lane] += pair_eng_batch[lane] * Scalar(0.5);
+                        virial_i[0][lane] += force_div2r * dx_batch[lane] * dx_batch[lane];
+                        virial_i[1][lane] += force_div2r * dx_batch[lane] * dy_batch[lane];
+                        virial_i[2][lane] += force_div2r * dx_batch[lane] * dz_batch[lane];
+                        virial_i[3][lane] += force_div2r * dy_batch[lane] * dy_batch[lane];
+                        virial_i[4][lane] += force_div2r * dy_batch[lane] * dz_batch[lane];
+                        virial_i[5][lane] += force_div2r * dz_batch[lane] * dz_batch[lane];
+                        }
 
-                        // make modifications to the old pair energy and force
-                        pair_eng = old_pair_eng * s;
-                        // note: I'm not sure why the minus sign needs to be there: my notes have a
-                        // + But this is verified correct via plotting
-                        force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+                    // add the force to the particles of the j cluster if we are using the third
+                    // law, only add force to local particles
+                    if (third_law)
+                        {
+                        for (unsigned int lj = 0; lj < width; lj++)
+                            {
+                            unsigned int mem_idx = lanes_j[lj];
+                            if (mem_idx == NeighborListCluster::empty_lane || mem_idx >= N)
+                                continue;
+
+                            Scalar4 fj = make_scalar4(0, 0, 0, 0);
+                            Scalar virial_j[6] = {};
+                            for (unsigned int li = 0; li < width; li++)
+                                {
+                                const unsigned int lane = li * width + lj;
+                                Scalar force_divr = force_divr_batch[lane];
+                                Scalar force_div2r = force_divr * Scalar(0.5);
+                                fj.x -= dx_batch[lane] * force_divr;
+                                fj.y -= dy_batch[lane] * force_divr;
+                                fj.z -= dz_batch[lane] * force_divr;
+                                fj.w += pair_eng_batch[lane] * Scalar(0.5);
+                                virial_j[0] += force_div2r * dx_batch[lane] * dx_batch[lane];
+                                virial_j[1] += force_div2r * dx_batch[lane] * dy_batch[lane];
+                                virial_j[2] += force_div2r * dx_batch[lane] * dz_batch[lane];
+                                virial_j[3] += force_div2r * dy_batch[lane] * dy_batch[lane];
+                                virial_j[4] += force_div2r * dy_batch[lane] * dz_batch[lane];
+                                virial_j[5] += force_div2r * dz_batch[lane] * dz_batch[lane];
+                                }
+
+                            force[mem_idx].x += fj.x;
+                            force[mem_idx].y += fj.y;
+                            force[mem_idx].z += fj.z;
+                            force[mem_idx].w += fj.w;
+                            if (compute_virial)
+                                {
+                                for (unsigned int k = 0; k < 6; k++)
+                                    virial[k * virial_pitch + mem_idx] += virial_j[k];
+                                }
+                            }
                         }
                     }
 
-                Scalar force_div2r = force_divr * Scalar(0.5);
-                // add the force, potential energy and virial to the particle i
-                // (FLOPS: 8)
-                fi += dx * force_divr;
-                pei += pair_eng * Scalar(0.5);
-                if (compute_virial)
+                // finally, sum the lanes in a fixed order and increment the force, potential energy
+                // and virial of the particles in the i cluster
+                for (unsigned int li = 0; li < width; li++)
                     {
-                    virialxxi += force_div2r * dx.x * dx.x;
-                    virialxyi += force_div2r * dx.x * dx.y;
-                    virialxzi += force_div2r * dx.x * dx.z;
-                    virialyyi += force_div2r * dx.y * dx.y;
-                    virialyzi += force_div2r * dx.y * dx.z;
-                    virialzzi += force_div2r * dx.z * dx.z;
-                    }
+                    unsigned int mem_idx = lanes_i[li];
+                    if (mem_idx == NeighborListCluster::empty_lane)
+                        continue;
 
-                // add the force to particle j if we are using the third law (MEM TRANSFER: 10
-                // scalars / FLOPS: 8) only add force to local particles
-                if (third_law && j < m_pdata->getN())
-                    {
-                    unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x * force_divr;
-                    h_force.data[mem_idx].y -= dx.y * force_divr;
-                    h_force.data[mem_idx].z -= dx.z * force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                    Scalar4 fi = make_scalar4(0, 0, 0, 0);
+                    Scalar virial_sum[6] = {};
+                    for (unsigned int lj = 0; lj < width; lj++)
+                        {
+                        fi.x += fx_i[li * width + lj];
+                        fi.y += fy_i[li * width + lj];
+                        fi.z += fz_i[li * width + lj];
+                        fi.w += pe_i[li * width + lj];
+                        for (unsigned int k = 0; k < 6; k++)
+                            virial_sum[k] += virial_i[k][li * width + lj];
+                        }
+
+                    force[mem_idx].x += fi.x;
+                    force[mem_idx].y += fi.y;
+                    force[mem_idx].z += fi.z;
+                    force[mem_idx].w += fi.w;
                     if (compute_virial)
                         {
-                        h_virial.data[0 * m_virial_pitch + mem_idx] += force_div2r * dx.x * dx.x;
-                        h_virial.data[1 * m_virial_pitch + mem_idx] += force_div2r * dx.x * dx.y;
-                        h_virial.data[2 * m_virial_pitch + mem_idx] += force_div2r * dx.x * dx.z;
-                        h_virial.data[3 * m_virial_pitch + mem_idx] += force_div2r * dx.y * dx.y;
-                        h_virial.data[4 * m_virial_pitch + mem_idx] += force_div2r * dx.y * dx.z;
-                        h_virial.data[5 * m_virial_pitch + mem_idx] += force_div2r * dx.z * dx.z;
+                        for (unsigned int k = 0; k < 6; k++)
+                            virial[k * virial_pitch + mem_idx] += virial_sum[k];
                         }
                     }
                 }
-            }
+        };
 
-        // finally, increment the force, potential energy and virial for particle i
-        unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
-        if (compute_virial)
+        const unsigned int n_clusters = nlist.getNumLocalClusters();
+#ifdef ENABLE_TBB
+        if (m_exec_conf->getNumThreads() > 1)
             {
-            h_virial.data[0 * m_virial_pitch + mem_idx] += virialxxi;
-            h_virial.data[1 * m_virial_pitch + mem_idx] += virialxyi;
-            h_virial.data[2 * m_virial_pitch + mem_idx] += virialxzi;
-            h_virial.data[3 * m_virial_pitch + mem_idx] += virialyyi;
-            h_virial.data[4 * m_virial_pitch + mem_idx] += virialyzi;
-            h_virial.data[5 * m_virial_pitch + mem_idx] += virialzzi;
+            m_exec_conf->getTaskArena()->execute(
+                [&]
+                {
+                    if (third_law)
+                        {
+                        // forces are also applied to j: accumulate each chunk of clusters in its
+                        // own buffer and sum the buffers in a fixed order
+                        m_scatter_buffers.resize(m_exec_conf->getNumThreads(),
+                                                 N,
+                                                 false,
+                                                 compute_virial);
+                        m_scatter_buffers.parallelForChunks(
+                            n_clusters,
+                            [&](unsigned int c, unsigned int first, unsigned int last)
+                            {
+                                compute_range(first,
+                                              last,
+                                              m_scatter_buffers.getForce(c),
+                                              m_scatter_buffers.getVirial(c),
+                                              m_scatter_buffers.getVirialPitch());
+                            });
+                        m_scatter_buffers.reduce(h_force.data,
+                                                 nullptr,
+                                                 h_virial.data,
+                                                 m_virial_pitch);
+                        }
+                    else
+                        {
+                        // with a full neighbor list, each thread writes only to the clusters it
+                        // owns
+                        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_clusters),
+                                          [&](const tbb::blocked_range<unsigned int>& r)
+                                          {
+                                              compute_range(r.begin(),
+                                                            r.end(),
+                                                            h_force.data,
+                                                            h_virial.data,
+                                                            m_virial_pitch);
+                                          });
+                        }
+                });
+            }
+        else
+#endif
+            {
+            compute_range(0, n_clusters, h_force.data, h_virial.data, m_virial_pitch);
             }
         }
-
-    computeTailCorrection();
     }
 
 #ifdef ENABLE_MPI
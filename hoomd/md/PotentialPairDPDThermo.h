@@ -5,6 +5,8 @@
 #define __POTENTIAL_PAIR_DPDTHERMO_H__
 
 #include "PotentialPair.h"
+#include "hoomd/RNGIdentifiers.h"
+#include "hoomd/RandomNumbers.h"
 #include "hoomd/Variant.h"
 
 /*! \file PotentialPairDPDThermo.h
@@ -142,6 +144,17 @@ template<class evaluator> void PotentialPairDPDThermo<evaluator>::computeForces(
     memset((void*)h_virial.data, 0, sizeof(Scalar) * this->m_virial.getNumElements());
 
     uint16_t seed = this->m_sysdef->getSeed();
+    const hoomd::Seed rng_seed(hoomd::RNGIdentifier::EvaluatorPairDPDThermo, timestep, seed);
+    hoomd::RandomGeneratorBatch<1> rng_batch;
+
+    // Special Potential Pair DPD Requirements
+    const Scalar currentTemp = m_T->operator()(timestep);
+
+    // design specifies that energies are shifted if
+    // 1) shift mode is set to shift
+    bool energy_shift = false;
+    if (this->m_shift_mode == this->shift)
+        energy_shift = true;
 
     // for each particle
     for (int i = 0; i < (int)this->m_pdata->getN(); i++)
@@ -163,6 +176,91 @@ template<class evaluator> void PotentialPairDPDThermo<evaluator>::computeForces(
         for (unsigned int l = 0; l < 6; l++)
             viriali[l] = 0.0;
 
+        // neighbors within the cutoff are evaluated in batches, so that the random numbers of
+        // rng_batch_width pairs are generated together
+        unsigned int batch_j[hoomd::rng_batch_width];
+        Scalar3 batch_dx[hoomd::rng_batch_width];
+        Scalar batch_rsq[hoomd::rng_batch_width];
+        Scalar batch_rdotv[hoomd::rng_batch_width];
+        unsigned int batch_typpair_idx[hoomd::rng_batch_width];
+        unsigned int batch_size = 0;
+
+        auto evaluate_batch = [&]()
+        {
+            unsigned int tagi = h_tag.data[i];
+            rng_batch.generate(
+                rng_seed,
+                batch_size,
+                [&](unsigned int b)
+                {
+                    unsigned int tagj = h_tag.data[batch_j[b]];
+                    return hoomd::Counter(std::min(tagi, tagj), std::max(tagi, tagj));
+                },
+                1);
+
+            for (unsigned int b = 0; b < batch_size; b++)
+                {
+                unsigned int j = batch_j[b];
+                Scalar3 dx = batch_dx[b];
+                const param_type& param = this->m_params[batch_typpair_idx[b]];
+                Scalar rcutsq = h_rcutsq.data[batch_typpair_idx[b]];
+
+                // compute the force and potential energy
+                Scalar force_divr = Scalar(0.0);
+                Scalar force_divr_cons = Scalar(0.0);
+                Scalar pair_eng = Scalar(0.0);
+                evaluator eval(batch_rsq[b], rcutsq, param);
+
+                // Special Potential Pair DPD Requirements
+                eval.setDeltaT(this->m_deltaT);
+                eval.setRDotV(batch_rdotv[b]);
+                eval.setT(currentTemp);
+
+                // the random number comes from the stream of the global tags
+                hoomd::BatchedRandomGenerator rng = rng_batch.getGenerator(b);
+                eval.setAlpha(hoomd::UniformDistribution<Scalar>(-1, 1)(rng));
+
+                bool evaluated = eval.evalForceEnergyThermo(force_divr,
+                                                            force_divr_cons,
+                                                            pair_eng,
+                                                            energy_shift);
+
+                if (evaluated)
+                    {
+                    // compute the virial (FLOPS: 2)
+                    Scalar pair_virial[6];
+                    pair_virial[0] = Scalar(0.5) * dx.x * dx.x * force_divr_cons;
+                    pair_virial[1] = Scalar(0.5) * dx.x * dx.y * force_divr_cons;
+                    pair_virial[2] = Scalar(0.5) * dx.x * dx.z * force_divr_cons;
+                    pair_virial[3] = Scalar(0.5) * dx.y * dx.y * force_divr_cons;
+                    pair_virial[4] = Scalar(0.5) * dx.y * dx.z * force_divr_cons;
+                    pair_virial[5] = Scalar(0.5) * dx.z * dx.z * force_divr_cons;
+
+                    // add the force, potential energy and virial to the particle i
+                    // (FLOPS: 8)
+                    fi += dx * force_divr;
+                    pei += pair_eng * Scalar(0.5);
+                    for (unsigned int l = 0; l < 6; l++)
+                        viriali[l] += pair_virial[l];
+
+                    // add the force to particle j if we are using the third law (MEM TRANSFER: 10
+                    // scalars / FLOPS: 8)
+                    if (third_law)
+                        {
+                        unsigned int mem_idx = j;
+                        h_force.data[mem_idx].x -= dx.x * force_divr;
+                        h_force.data[mem_idx].y -= dx.y * force_divr;
+                        h_force.data[mem_idx].z -= dx.z * force_divr;
+                        h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                        for (unsigned int l = 0; l < 6; l++)
+                            h_virial.data[l * this->m_virial_pitch + mem_idx] += pair_virial[l];
+                        }
+                    }
+                }
+
+            batch_size = 0;
+        };
+
         // loop over all of the neighbors of this particle
         const unsigned int size = (unsigned int)h_n_neigh.data[i];
         for (unsigned int k = 0; k < size; k++)
@@ -175,10 +273,6 @@ template<class evaluator> void PotentialPairDPDThermo<evaluator>::computeForces(
             Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
             Scalar3 dx = pi - pj;
 
-            // calculate dv_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 vj = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
-            Scalar3 dv = vi - vj;
-
             // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
             unsigned int typej = __scalar_as_int(h_pos.data[j].w);
             assert(typej < this->m_pdata->getNTypes());
@@ -189,73 +283,30 @@ template<class evaluator> void PotentialPairDPDThermo<evaluator>::computeForces(
             // calculate r_ij squared (FLOPS: 5)
             Scalar rsq = dot(dx, dx);
 
-            // calculate the drag term r \dot v
-            Scalar rdotv = dot(dx, dv);
-
-            // get parameters for this type pair
+            // pairs beyond the cutoff have no force and draw no random numbers
             unsigned int typpair_idx = this->m_typpair_idx(typei, typej);
-            const param_type& param = this->m_params[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
-
-            // design specifies that energies are shifted if
-            // 1) shift mode is set to shift
-            bool energy_shift = false;
-            if (this->m_shift_mode == this->shift)
-                energy_shift = true;
-
-            // compute the force and potential energy
-            Scalar force_divr = Scalar(0.0);
-            Scalar force_divr_cons = Scalar(0.0);
-            Scalar pair_eng = Scalar(0.0);
-            evaluator eval(rsq, rcutsq, param);
-
-            // Special Potential Pair DPD Requirements
-            const Scalar currentTemp = m_T->operator()(timestep);
+            if (rsq >= h_rcutsq.data[typpair_idx])
+                continue;
 
-            // set seed using global tags
-            unsigned int tagi = h_tag.data[i];
-            unsigned int tagj = h_tag.data[j];
-            eval.set_seed_ij_timestep(seed, tagi, tagj, timestep);
-            eval.setDeltaT(this->m_deltaT);
-            eval.setRDotV(rdotv);
-            eval.setT(currentTemp);
-
-            bool evaluated
-                = eval.evalForceEnergyThermo(force_divr, force_divr_cons, pair_eng, energy_shift);
+            // calculate dv_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
+            Scalar3 vj = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
+            Scalar3 dv = vi - vj;
 
-            if (evaluated)
-                {
-                // compute the virial (FLOPS: 2)
-                Scalar pair_virial[6];
-                pair_virial[0] = Scalar(0.5) * dx.x * dx.x * force_divr_cons;
-                pair_virial[1] = Scalar(0.5) * dx.x * dx.y * force_divr_cons;
-                pair_virial[2] = Scalar(0.5) * dx.x * dx.z * force_divr_cons;
-                pair_virial[3] = Scalar(0.5) * dx.y * dx.y * force_divr_cons;
-                pair_virial[4] = Scalar(0.5) * dx.y * dx.z * force_divr_cons;
-                pair_virial[5] = Scalar(0.5) * dx.z * dx.z * force_divr_cons;
-
-                // add the force, potential energy and virial to the particle i
-                // (FLOPS: 8)
-                fi += dx * force_divr;
-                pei += pair_eng * Scalar(0.5);
-                for (unsigned int l = 0; l < 6; l++)
-                    viriali[l] += pair_virial[l];
-
-                // add the force to particle j if we are using the third law (MEM TRANSFER: 10
-                // scalars / FLOPS: 8)
-                if (third_law)
-                    {
-                    unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x * force_divr;
-                    h_force.data[mem_idx].y -= dx.y * force_divr;
-                    h_force.data[mem_idx].z -= dx.z * force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
-                    for (unsigned int l = 0; l < 6; l++)
-                        h_virial.data[l * this->m_virial_pitch + mem_idx] += pair_virial[l];
-                    }
-                }
+            // calculate the drag term r \dot v
+            batch_rdotv[batch_size] = dot(dx, dv);
+            batch_j[batch_size] = j;
+            batch_dx[batch_size] = dx;
+            batch_rsq[batch_size] = rsq;
+            batch_typpair_idx[batch_size] = typpair_idx;
+            batch_size++;
+
+            if (batch_size == hoomd::rng_batch_width)
+                evaluate_batch();
             }
 
+        if (batch_size > 0)
+            evaluate_batch();
+
         // finally, increment the force, potential energy and virial for particle i
         unsigned int mem_idx = i;
         h_force.data[mem_idx].x += fi.x;
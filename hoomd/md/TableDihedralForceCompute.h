@@ -3,6 +3,7 @@
 
 #include "hoomd/BondedGroupData.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/ForceScatterBuffers.h"
 #include "hoomd/GPUArray.h"
 #include "hoomd/Index1D.h"
 
@@ -97,6 +98,11 @@ class PYBIND11_EXPORT TableDihedralForceCompute : public ForceCompute
     GPUArray<Scalar2> m_tables;                    //!< Stored V and F tables
     Index2D m_table_value;                         //!< Index table helper
 
+#ifdef ENABLE_TBB
+    /// Per-chunk accumulation buffers for threaded evaluation
+    hoomd::detail::ForceScatterBuffers m_scatter_buffers;
+#endif
+
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
     };
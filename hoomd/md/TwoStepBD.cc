@@ -79,6 +79,9 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
     ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(),
                                    access_location::host,
                                    access_mode::read);
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                            access_location::host,
+                                            access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
 
@@ -87,165 +90,182 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
     // perform the first half step
     // r(t+deltaT) = r(t) + (Fc(t) + Fr)*deltaT/gamma
     // v(t+deltaT) = random distribution consistent with T
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        unsigned int ptag = h_tag.data[j];
-
-        // Initialize the RNG
-        RandomGenerator rng(hoomd::Seed(RNGIdentifier::TwoStepBD, timestep, seed),
-                            hoomd::Counter(ptag));
-
-        // compute the random force
-        UniformDistribution<Scalar> uniform(Scalar(-1), Scalar(1));
-        Scalar rx = uniform(rng);
-        Scalar ry = uniform(rng);
-        Scalar rz = uniform(rng);
-
-        Scalar gamma;
-        unsigned int type = __scalar_as_int(h_pos.data[j].w);
-        gamma = h_gamma.data[type];
-
-        // compute the bd force (the extra factor of 3 is because <rx^2> is 1/3 in the uniform -1,1
-        // distribution it is not the dimensionality of the system
-        Scalar coeff = fast::sqrt(Scalar(3.0) * Scalar(2.0) * gamma * currentTemp / m_deltaT);
-        if (m_noiseless_t)
-            coeff = Scalar(0.0);
-        Scalar Fr_x = rx * coeff;
-        Scalar Fr_y = ry * coeff;
-        Scalar Fr_z = rz * coeff;
-
-        if (D < 3)
-            Fr_z = Scalar(0.0);
-
-        // update position
-        h_pos.data[j].x += (h_net_force.data[j].x + Fr_x) * m_deltaT / gamma;
-        h_pos.data[j].y += (h_net_force.data[j].y + Fr_y) * m_deltaT / gamma;
-        h_pos.data[j].z += (h_net_force.data[j].z + Fr_z) * m_deltaT / gamma;
-
-        // particles may have been moved slightly outside the box by the above steps, wrap them back
-        // into place
-        box.wrap(h_pos.data[j], h_image.data[j]);
-
-        if (m_noiseless_t)
-            {
-            h_vel.data[j].x = h_net_force.data[j].x / gamma;
-            h_vel.data[j].y = h_net_force.data[j].y / gamma;
-            if (D > 2)
-                h_vel.data[j].z = h_net_force.data[j].z / gamma;
-            else
-                h_vel.data[j].z = 0;
-            }
-        else
-            {
-            // draw a new random velocity for particle j
-            Scalar mass = h_vel.data[j].w;
-            Scalar sigma = fast::sqrt(currentTemp / mass);
-            NormalDistribution<Scalar> normal(sigma);
-            h_vel.data[j].x = normal(rng);
-            h_vel.data[j].y = normal(rng);
-            if (D > 2)
-                h_vel.data[j].z = normal(rng);
-            else
-                h_vel.data[j].z = 0;
-            }
+    auto bd_range = [&](unsigned int first, unsigned int last)
+    {
+        // generate the random numbers for rng_batch_width particles at a time
+        const hoomd::Seed rng_seed(RNGIdentifier::TwoStepBD, timestep, seed);
+        RandomGeneratorBatch<12> rng_batch;
+        auto rng_counter = [&](unsigned int group_idx)
+        { return hoomd::Counter(h_tag.data[h_index_array.data[group_idx]]); };
 
-        // rotational random force and orientation quaternion updates
-        if (m_aniso)
+        for (unsigned int group_idx = first; group_idx < last; group_idx++)
             {
-            unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
-            Scalar3 gamma_r = h_gamma_r.data[type_r];
-            if (gamma_r.x > 0 || gamma_r.y > 0 || gamma_r.z > 0)
-                {
-                vec3<Scalar> p_vec;
-                quat<Scalar> q(h_orientation.data[j]);
-                vec3<Scalar> t(h_torque.data[j]);
-                vec3<Scalar> I(h_inertia.data[j]);
-
-                bool x_zero, y_zero, z_zero;
-                x_zero = (I.x == 0);
-                y_zero = (I.y == 0);
-                z_zero = (I.z == 0);
-
-                Scalar3 sigma_r
-                    = make_scalar3(fast::sqrt(Scalar(2.0) * gamma_r.x * currentTemp / m_deltaT),
-                                   fast::sqrt(Scalar(2.0) * gamma_r.y * currentTemp / m_deltaT),
-                                   fast::sqrt(Scalar(2.0) * gamma_r.z * currentTemp / m_deltaT));
-                if (m_noiseless_r)
-                    sigma_r = make_scalar3(0, 0, 0);
-
-                // original Gaussian random torque
-                // Gaussian random distribution is preferred in terms of preserving the exact math
-                vec3<Scalar> bf_torque;
-                bf_torque.x = NormalDistribution<Scalar>(sigma_r.x)(rng);
-                bf_torque.y = NormalDistribution<Scalar>(sigma_r.y)(rng);
-                bf_torque.z = NormalDistribution<Scalar>(sigma_r.z)(rng);
-
-                if (x_zero)
-                    {
-                    bf_torque.x = 0;
-                    t.x = 0;
-                    }
-                if (y_zero)
-                    {
-                    bf_torque.y = 0;
-                    t.y = 0;
-                    }
-                if (z_zero)
-                    {
-                    bf_torque.z = 0;
-                    t.z = 0;
-                    }
-
-                // use the damping by gamma_r and rotate back to lab frame
-                // Notes For the Future: take special care when have anisotropic gamma_r
-                // if aniso gamma_r, first rotate the torque into particle frame and divide the
-                // different gamma_r and then rotate the "angular velocity" back to lab frame and
-                // integrate
-                bf_torque = rotate(q, bf_torque);
-                if (D < 3)
-                    {
-                    bf_torque.x = 0;
-                    bf_torque.y = 0;
-                    t.x = 0;
-                    t.y = 0;
-                    }
+            unsigned int j = h_index_array.data[group_idx];
 
-                // do the integration for quaternion
-                q += Scalar(0.5) * m_deltaT * ((t + bf_torque) / vec3<Scalar>(gamma_r)) * q;
-                q = q * (Scalar(1.0) / slow::sqrt(norm2(q)));
-                h_orientation.data[j] = quat_to_scalar4(q);
-
-                if (m_noiseless_r)
-                    {
-                    p_vec.x = t.x / gamma_r.x;
-                    p_vec.y = t.y / gamma_r.y;
-                    p_vec.z = t.z / gamma_r.z;
-                    }
+            // Initialize the RNG
+            unsigned int batch_idx = (group_idx - first) % rng_batch_width;
+            if (batch_idx == 0)
+                {
+                rng_batch.generate(rng_seed,
+                                   std::min(rng_batch_width, last - group_idx),
+                                   [&](unsigned int k) { return rng_counter(group_idx + k); },
+                                   m_aniso ? 12 : 6);
+                }
+            BatchedRandomGenerator rng = rng_batch.getGenerator(batch_idx);
+
+            // compute the random force
+            UniformDistribution<Scalar> uniform(Scalar(-1), Scalar(1));
+            Scalar rx = uniform(rng);
+            Scalar ry = uniform(rng);
+            Scalar rz = uniform(rng);
+
+            Scalar gamma;
+            unsigned int type = __scalar_as_int(h_pos.data[j].w);
+            gamma = h_gamma.data[type];
+
+            // compute the bd force (the extra factor of 3 is because <rx^2> is 1/3 in the uniform
+            // -1,1 distribution it is not the dimensionality of the system
+            Scalar coeff = fast::sqrt(Scalar(3.0) * Scalar(2.0) * gamma * currentTemp / m_deltaT);
+            if (m_noiseless_t)
+                coeff = Scalar(0.0);
+            Scalar Fr_x = rx * coeff;
+            Scalar Fr_y = ry * coeff;
+            Scalar Fr_z = rz * coeff;
+
+            if (D < 3)
+                Fr_z = Scalar(0.0);
+
+            // update position
+            h_pos.data[j].x += (h_net_force.data[j].x + Fr_x) * m_deltaT / gamma;
+            h_pos.data[j].y += (h_net_force.data[j].y + Fr_y) * m_deltaT / gamma;
+            h_pos.data[j].z += (h_net_force.data[j].z + Fr_z) * m_deltaT / gamma;
+
+            // particles may have been moved slightly outside the box by the above steps, wrap them
+            // back into place
+            box.wrap(h_pos.data[j], h_image.data[j]);
+
+            if (m_noiseless_t)
+                {
+                h_vel.data[j].x = h_net_force.data[j].x / gamma;
+                h_vel.data[j].y = h_net_force.data[j].y / gamma;
+                if (D > 2)
+                    h_vel.data[j].z = h_net_force.data[j].z / gamma;
+                else
+                    h_vel.data[j].z = 0;
+                }
+            else
+                {
+                // draw a new random velocity for particle j
+                Scalar mass = h_vel.data[j].w;
+                Scalar sigma = fast::sqrt(currentTemp / mass);
+                NormalDistribution<Scalar> normal(sigma);
+                h_vel.data[j].x = normal(rng);
+                h_vel.data[j].y = normal(rng);
+                if (D > 2)
+                    h_vel.data[j].z = normal(rng);
                 else
+                    h_vel.data[j].z = 0;
+                }
+
+            // rotational random force and orientation quaternion updates
+            if (m_aniso)
+                {
+                unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
+                Scalar3 gamma_r = h_gamma_r.data[type_r];
+                if (gamma_r.x > 0 || gamma_r.y > 0 || gamma_r.z > 0)
                     {
-                    // draw a new random ang_mom for particle j in body frame
-                    p_vec.x = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.x))(rng);
-                    p_vec.y = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.y))(rng);
-                    p_vec.z = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.z))(rng);
+                    vec3<Scalar> p_vec;
+                    quat<Scalar> q(h_orientation.data[j]);
+                    vec3<Scalar> t(h_torque.data[j]);
+                    vec3<Scalar> I(h_inertia.data[j]);
+
+                    bool x_zero, y_zero, z_zero;
+                    x_zero = (I.x == 0);
+                    y_zero = (I.y == 0);
+                    z_zero = (I.z == 0);
+
+                    Scalar3 sigma_r = make_scalar3(
+                        fast::sqrt(Scalar(2.0) * gamma_r.x * currentTemp / m_deltaT),
+                        fast::sqrt(Scalar(2.0) * gamma_r.y * currentTemp / m_deltaT),
+                        fast::sqrt(Scalar(2.0) * gamma_r.z * currentTemp / m_deltaT));
+                    if (m_noiseless_r)
+                        sigma_r = make_scalar3(0, 0, 0);
+
+                    // original Gaussian random torque
+                    // Gaussian random distribution is preferred in terms of preserving the exact
+                    // math
+                    vec3<Scalar> bf_torque;
+                    bf_torque.x = NormalDistribution<Scalar>(sigma_r.x)(rng);
+                    bf_torque.y = NormalDistribution<Scalar>(sigma_r.y)(rng);
+                    bf_torque.z = NormalDistribution<Scalar>(sigma_r.z)(rng);
+
+                    if (x_zero)
+                        {
+                        bf_torque.x = 0;
+                        t.x = 0;
+                        }
+                    if (y_zero)
+                        {
+                        bf_torque.y = 0;
+                        t.y = 0;
+                        }
+                    if (z_zero)
+                        {
+                        bf_torque.z = 0;
+                        t.z = 0;
+                        }
+
+                    // use the damping by gamma_r and rotate back to lab frame
+                    // Notes For the Future: take special care when have anisotropic gamma_r
+                    // if aniso gamma_r, first rotate the torque into particle frame and divide the
+                    // different gamma_r and then rotate the "angular velocity" back to lab frame
+                    // and integrate
+                    bf_torque = rotate(q, bf_torque);
+                    if (D < 3)
+                        {
+                        bf_torque.x = 0;
+                        bf_torque.y = 0;
+                        t.x = 0;
+                        t.y = 0;
+                        }
+
+                    // do the integration for quaternion
+                    q += Scalar(0.5) * m_deltaT * ((t + bf_torque) / vec3<Scalar>(gamma_r)) * q;
+                    q = q * (Scalar(1.0) / slow::sqrt(norm2(q)));
+                    h_orientation.data[j] = quat_to_scalar4(q);
+
+                    if (m_noiseless_r)
+                        {
+                        p_vec.x = t.x / gamma_r.x;
+                        p_vec.y = t.y / gamma_r.y;
+                        p_vec.z = t.z / gamma_r.z;
+                        }
+                    else
+                        {
+                        // draw a new random ang_mom for particle j in body frame
+                        p_vec.x = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.x))(rng);
+                        p_vec.y = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.y))(rng);
+                        p_vec.z = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.z))(rng);
+                        }
+
+                    if (x_zero)
+                        p_vec.x = 0;
+                    if (y_zero)
+                        p_vec.y = 0;
+                    if (z_zero)
+                        p_vec.z = 0;
+
+                    // !! Note this isn't well-behaving in 2D,
+                    // !! because may have effective non-zero ang_mom in x,y
+
+                    // store ang_mom quaternion
+                    quat<Scalar> p = Scalar(2.0) * q * p_vec;
+                    h_angmom.data[j] = quat_to_scalar4(p);
                     }
-
-                if (x_zero)
-                    p_vec.x = 0;
-                if (y_zero)
-                    p_vec.y = 0;
-                if (z_zero)
-                    p_vec.z = 0;
-
-                // !! Note this isn't well-behaving in 2D,
-                // !! because may have effective non-zero ang_mom in x,y
-
-                // store ang_mom quaternion
-                quat<Scalar> p = Scalar(2.0) * q * p_vec;
-                h_angmom.data[j] = quat_to_scalar4(p);
                 }
             }
-        }
+    };
+    hoomd::detail::forEachRange(*m_exec_conf, group_size, bd_range);
     }
 
 /*! @param timestep Current time step
@@ -276,18 +276,22 @@ void TwoStepConstantPressure::integrateStepOne(uint64_t timestep)
 
         unsigned int nparticles = m_pdata->getN();
 
-        for (unsigned int i = 0; i < nparticles; i++)
-            {
-            Scalar3 r = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        auto rescale_range = [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int i = first; i < last; i++)
+                {
+                Scalar3 r = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
 
-            r.x = m_mat_exp_r[0] * r.x + m_mat_exp_r[1] * r.y + m_mat_exp_r[2] * r.z;
-            r.y = m_mat_exp_r[3] * r.y + m_mat_exp_r[4] * r.z;
-            r.z = m_mat_exp_r[5] * r.z;
+                r.x = m_mat_exp_r[0] * r.x + m_mat_exp_r[1] * r.y + m_mat_exp_r[2] * r.z;
+                r.y = m_mat_exp_r[3] * r.y + m_mat_exp_r[4] * r.z;
+                r.z = m_mat_exp_r[5] * r.z;
 
-            h_pos.data[i].x = r.x;
-            h_pos.data[i].y = r.y;
-            h_pos.data[i].z = r.z;
-            }
+                h_pos.data[i].x = r.x;
+                h_pos.data[i].y = r.y;
+                h_pos.data[i].z = r.z;
+                }
+        };
+        hoomd::detail::forEachRange(*m_exec_conf, nparticles, rescale_range);
         }
 
         {
@@ -300,48 +304,56 @@ void TwoStepConstantPressure::integrateStepOne(uint64_t timestep)
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(),
                                    access_location::host,
                                    access_mode::readwrite);
+        ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                                access_location::host,
+                                                access_mode::read);
 
         // precompute loop invariant quantity
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
-            Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
-            Scalar3 accel = h_accel.data[j];
-            Scalar3 r = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-
-            // advance velocity
-            v += m_deltaT / Scalar(2.0) * accel;
-
-            // apply barostat by multiplying with matrix exponential
-            v.x = m_mat_exp_v[0] * v.x + m_mat_exp_v[1] * v.y + m_mat_exp_v[2] * v.z;
-            v.y = m_mat_exp_v[3] * v.y + m_mat_exp_v[4] * v.z;
-            v.z = m_mat_exp_v[5] * v.z;
-
-            // apply thermostat update of velocity
-            v *= rescaleFactors[0];
-
-            if (!m_rescale_all)
+        auto translate_range = [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int group_idx = first; group_idx < last; group_idx++)
                 {
-                r.x = m_mat_exp_r[0] * r.x + m_mat_exp_r[1] * r.y + m_mat_exp_r[2] * r.z;
-                r.y = m_mat_exp_r[3] * r.y + m_mat_exp_r[4] * r.z;
-                r.z = m_mat_exp_r[5] * r.z;
+                unsigned int j = h_index_array.data[group_idx];
+
+                Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
+                Scalar3 accel = h_accel.data[j];
+                Scalar3 r = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+
+                // advance velocity
+                v += m_deltaT / Scalar(2.0) * accel;
+
+                // apply barostat by multiplying with matrix exponential
+                v.x = m_mat_exp_v[0] * v.x + m_mat_exp_v[1] * v.y + m_mat_exp_v[2] * v.z;
+                v.y = m_mat_exp_v[3] * v.y + m_mat_exp_v[4] * v.z;
+                v.z = m_mat_exp_v[5] * v.z;
+
+                // apply thermostat update of velocity
+                v *= rescaleFactors[0];
+
+                if (!m_rescale_all)
+                    {
+                    r.x = m_mat_exp_r[0] * r.x + m_mat_exp_r[1] * r.y + m_mat_exp_r[2] * r.z;
+                    r.y = m_mat_exp_r[3] * r.y + m_mat_exp_r[4] * r.z;
+                    r.z = m_mat_exp_r[5] * r.z;
+                    }
+
+                r.x += m_mat_exp_r_int[0] * v.x + m_mat_exp_r_int[1] * v.y
+                       + m_mat_exp_r_int[2] * v.z;
+                r.y += m_mat_exp_r_int[3] * v.y + m_mat_exp_r_int[4] * v.z;
+                r.z += m_mat_exp_r_int[5] * v.z;
+
+                // store velocity
+                h_vel.data[j].x = v.x;
+                h_vel.data[j].y = v.y;
+                h_vel.data[j].z = v.z;
+
+                // store position
+                h_pos.data[j].x = r.x;
+                h_pos.data[j].y = r.y;
+                h_pos.data[j].z = r.z;
                 }
-
-            r.x += m_mat_exp_r_int[0] * v.x + m_mat_exp_r_int[1] * v.y + m_mat_exp_r_int[2] * v.z;
-            r.y += m_mat_exp_r_int[3] * v.y + m_mat_exp_r_int[4] * v.z;
-            r.z += m_mat_exp_r_int[5] * v.z;
-
-            // store velocity
-            h_vel.data[j].x = v.x;
-            h_vel.data[j].y = v.y;
-            h_vel.data[j].z = v.z;
-
-            // store position
-            h_pos.data[j].x = r.x;
-            h_pos.data[j].y = r.y;
-            h_pos.data[j].z = r.z;
-            }
+        };
+        hoomd::detail::forEachRange(*m_exec_conf, group_size, translate_range);
         } // end of GPUArray scope
 
     // Get new local box
@@ -356,8 +368,12 @@ void TwoStepConstantPressure::integrateStepOne(uint64_t timestep)
                                   access_mode::readwrite);
 
         // Wrap particles
-        for (unsigned int j = 0; j < m_pdata->getN(); j++)
-            box.wrap(h_pos.data[j], h_image.data[j]);
+        auto wrap_range = [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int j = first; j < last; j++)
+                box.wrap(h_pos.data[j], h_image.data[j]);
+        };
+        hoomd::detail::forEachRange(*m_exec_conf, m_pdata->getN(), wrap_range);
         }
 
     // Integration of angular degrees of freedom using symplectic and
@@ -376,111 +392,118 @@ void TwoStepConstantPressure::integrateStepOne(uint64_t timestep)
         ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(),
                                        access_location::host,
                                        access_mode::read);
+        ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                                access_location::host,
+                                                access_mode::read);
 
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-
-            quat<Scalar> q(h_orientation.data[j]);
-            quat<Scalar> p(h_angmom.data[j]);
-            vec3<Scalar> t(h_net_torque.data[j]);
-            vec3<Scalar> I(h_inertia.data[j]);
-
-            // rotate torque into principal frame
-            t = rotate(conj(q), t);
-
-            // check for zero moment of inertia
-            bool x_zero, y_zero, z_zero;
-            x_zero = (I.x == 0);
-            y_zero = (I.y == 0);
-            z_zero = (I.z == 0);
-
-            // ignore torque component along an axis for which the moment of inertia zero
-            if (x_zero)
-                t.x = 0;
-            if (y_zero)
-                t.y = 0;
-            if (z_zero)
-                t.z = 0;
-
-            // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
-            p += m_deltaT * q * t;
-
-            // apply thermostat
-            p = p * rescaleFactors[1];
-
-            quat<Scalar> p1, p2, p3; // permutated quaternions
-            quat<Scalar> q1, q2, q3;
-            Scalar phi1, cphi1, sphi1;
-            Scalar phi2, cphi2, sphi2;
-            Scalar phi3, cphi3, sphi3;
-
-            if (!z_zero)
+        auto rotate_range = [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int group_idx = first; group_idx < last; group_idx++)
                 {
-                p3 = quat<Scalar>(-p.v.z, vec3<Scalar>(p.v.y, -p.v.x, p.s));
-                q3 = quat<Scalar>(-q.v.z, vec3<Scalar>(q.v.y, -q.v.x, q.s));
-                phi3 = Scalar(1. / 4.) / I.z * dot(p, q3);
-                cphi3 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi3);
-                sphi3 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi3);
-
-                p = cphi3 * p + sphi3 * p3;
-                q = cphi3 * q + sphi3 * q3;
-                }
+                unsigned int j = h_index_array.data[group_idx];
 
-            if (!y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y, vec3<Scalar>(-p.v.z, p.s, p.v.x));
-                q2 = quat<Scalar>(-q.v.y, vec3<Scalar>(-q.v.z, q.s, q.v.x));
-                phi2 = Scalar(1. / 4.) / I.y * dot(p, q2);
-                cphi2 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi2);
-                sphi2 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi2);
-
-                p = cphi2 * p + sphi2 * p2;
-                q = cphi2 * q + sphi2 * q2;
-                }
+                quat<Scalar> q(h_orientation.data[j]);
+                quat<Scalar> p(h_angmom.data[j]);
+                vec3<Scalar> t(h_net_torque.data[j]);
+                vec3<Scalar> I(h_inertia.data[j]);
 
-            if (!x_zero)
-                {
-                p1 = quat<Scalar>(-p.v.x, vec3<Scalar>(p.s, p.v.z, -p.v.y));
-                q1 = quat<Scalar>(-q.v.x, vec3<Scalar>(q.s, q.v.z, -q.v.y));
-                phi1 = Scalar(1. / 4.) / I.x * dot(p, q1);
-                cphi1 = slow::cos(m_deltaT * phi1);
-                sphi1 = slow::sin(m_deltaT * phi1);
-
-                p = cphi1 * p + sphi1 * p1;
-                q = cphi1 * q + sphi1 * q1;
-                }
+                // rotate torque into principal frame
+                t = rotate(conj(q), t);
 
-            if (!y_zero)
-                {
-                p2 = quat<Scalar>(-p.v.y, vec3<Scalar>(-p.v.z, p.s, p.v.x));
-                q2 = quat<Scalar>(-q.v.y, vec3<Scalar>(-q.v.z, q.s, q.v.x));
-                phi2 = Scalar(1. / 4.) / I.y * dot(p, q2);
-                cphi2 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi2);
-                sphi2 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi2);
-
-                p = cphi2 * p + sphi2 * p2;
-                q = cphi2 * q + sphi2 * q2;
-                }
+                // check for zero moment of inertia
+                bool x_zero, y_zero, z_zero;
+                x_zero = (I.x == 0);
+                y_zero = (I.y == 0);
+                z_zero = (I.z == 0);
 
-            if (!z_zero)
-                {
-                p3 = quat<Scalar>(-p.v.z, vec3<Scalar>(p.v.y, -p.v.x, p.s));
-                q3 = quat<Scalar>(-q.v.z, vec3<Scalar>(q.v.y, -q.v.x, q.s));
-                phi3 = Scalar(1. / 4.) / I.z * dot(p, q3);
-                cphi3 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi3);
-                sphi3 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi3);
-
-                p = cphi3 * p + sphi3 * p3;
-                q = cphi3 * q + sphi3 * q3;
-                }
+                // ignore torque component along an axis for which the moment of inertia zero
+                if (x_zero)
+                    t.x = 0;
+                if (y_zero)
+                    t.y = 0;
+                if (z_zero)
+                    t.z = 0;
+
+                // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
+                p += m_deltaT * q * t;
 
-            // renormalize (improves stability)
-            q = q * (Scalar(1.0) / slow::sqrt(norm2(q)));
+                // apply thermostat
+                p = p * rescaleFactors[1];
 
-            h_orientation.data[j] = quat_to_scalar4(q);
-            h_angmom.data[j] = quat_to_scalar4(p);
-            }
+                quat<Scalar> p1, p2, p3; // permutated quaternions
+                quat<Scalar> q1, q2, q3;
+                Scalar phi1, cphi1, sphi1;
+                Scalar phi2, cphi2, sphi2;
+                Scalar phi3, cphi3, sphi3;
+
+                if (!z_zero)
+                    {
+                    p3 = quat<Scalar>(-p.v.z, vec3<Scalar>(p.v.y, -p.v.x, p.s));
+                    q3 = quat<Scalar>(-q.v.z, vec3<Scalar>(q.v.y, -q.v.x, q.s));
+                    phi3 = Scalar(1. / 4.) / I.z * dot(p, q3);
+                    cphi3 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi3);
+                    sphi3 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi3);
+
+                    p = cphi3 * p + sphi3 * p3;
+                    q = cphi3 * q + sphi3 * q3;
+                    }
+
+                if (!y_zero)
+                    {
+                    p2 = quat<Scalar>(-p.v.y, vec3<Scalar>(-p.v.z, p.s, p.v.x));
+                    q2 = quat<Scalar>(-q.v.y, vec3<Scalar>(-q.v.z, q.s, q.v.x));
+                    phi2 = Scalar(1. / 4.) / I.y * dot(p, q2);
+                    cphi2 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi2);
+                    sphi2 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi2);
+
+                    p = cphi2 * p + sphi2 * p2;
+                    q = cphi2 * q + sphi2 * q2;
+                    }
+
+                if (!x_zero)
+                    {
+                    p1 = quat<Scalar>(-p.v.x, vec3<Scalar>(p.s, p.v.z, -p.v.y));
+                    q1 = quat<Scalar>(-q.v.x, vec3<Scalar>(q.s, q.v.z, -q.v.y));
+                    phi1 = Scalar(1. / 4.) / I.x * dot(p, q1);
+                    cphi1 = slow::cos(m_deltaT * phi1);
+                    sphi1 = slow::sin(m_deltaT * phi1);
+
+                    p = cphi1 * p + sphi1 * p1;
+                    q = cphi1 * q + sphi1 * q1;
+                    }
+
+                if (!y_zero)
+                    {
+                    p2 = quat<Scalar>(-p.v.y, vec3<Scalar>(-p.v.z, p.s, p.v.x));
+                    q2 = quat<Scalar>(-q.v.y, vec3<Scalar>(-q.v.z, q.s, q.v.x));
+                    phi2 = Scalar(1. / 4.) / I.y * dot(p, q2);
+                    cphi2 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi2);
+                    sphi2 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi2);
+
+                    p = cphi2 * p + sphi2 * p2;
+                    q = cphi2 * q + sphi2 * q2;
+                    }
+
+                if (!z_zero)
+                    {
+                    p3 = quat<Scalar>(-p.v.z, vec3<Scalar>(p.v.y, -p.v.x, p.s));
+                    q3 = quat<Scalar>(-q.v.z, vec3<Scalar>(q.v.y, -q.v.x, q.s));
+                    phi3 = Scalar(1. / 4.) / I.z * dot(p, q3);
+                    cphi3 = slow::cos(Scalar(1. / 2.) * m_deltaT * phi3);
+                    sphi3 = slow::sin(Scalar(1. / 2.) * m_deltaT * phi3);
+
+                    p = cphi3 * p + sphi3 * p3;
+                    q = cphi3 * q + sphi3 * q3;
+                    }
+
+                // renormalize (improves stability)
+                q = q * (Scalar(1.0) / slow::sqrt(norm2(q)));
+
+                h_orientation.data[j] = quat_to_scalar4(q);
+                h_angmom.data[j] = quat_to_scalar4(p);
+                }
+        };
+        hoomd::detail::forEachRange(*m_exec_conf, group_size, rotate_range);
         }
 
     // propagate thermostat variables forward
@@ -605,40 +628,48 @@ void TwoStepConstantPressure::integrateStepTwo(uint64_t timestep)
                                      access_location::host,
                                      access_mode::readwrite);
         ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(),
+                                                access_location::host,
+                                                access_mode::read);
 
         // perform second half step of NPT integration
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
+        auto translate_range = [&](unsigned int first, unsigned int last)
+        {
+            for (unsigned int group_idx = first; group_idx < last; group_idx++)
+                {
+                unsigned int j = h_index_array.data[group_idx];
 
-            // first, calculate acceleration from the net force
-            Scalar m = h_vel.data[j].w;
-            Scalar minv = Scalar(1.0) / m;
-            h_accel.data[j].x = h_net_force.data[j].x * minv;
-            h_accel.data[j].y = h_net_force.data[j].y * minv;
-            h_accel.data[j].z = h_net_force.data[j].z * minv;
+                // first, calculate acceleration from the net force
+                Scalar m = h_vel.data[j].w;
+                Scalar minv = Scalar(1.0) / m;
+                h_accel.data[j].x = h_net_force.data[j].x * minv;
+                h_accel.data[j].y = h_net_force.data[j].y * minv;
+                h_accel.data[j].z = h_net_force.data[j].z * minv;
 
-            Scalar3 accel = make_scalar3(h_accel.data[j].x, h_accel.data[j].y, h_accel.data[j].z);
+                Scalar3 accel
+                    = make_scalar3(h_accel.data[j].x, h_accel.data[j].y, h_accel.data[j].z);
 
-            // update velocity by multiplication with upper triangular matrix
-            Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
+                // update velocity by multiplication with upper triangular matrix
+                Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
 
-            // apply thermostat
-            v = v * rescaleFactors[0];
+                // apply thermostat
+                v = v * rescaleFactors[0];
 
-            // apply barostat by multiplying with matrix exponential
-            v.x = m_mat_exp_v[0] * v.x + m_mat_exp_v[1] * v.y + m_mat_exp_v[2] * v.z;
-            v.y = m_mat_exp_v[3] * v.y + m_mat_exp_v[4] * v.z;
-            v.z = m_mat_exp_v[5] * v.z;
+                // apply barostat by multiplying with matrix exponential
+                v.x = m_mat_exp_v[0] * v.x + m_mat_exp_v[1] * v.y + m_mat_exp_v[2] * v.z;
+                v.y = m_mat_exp_v[3] * v.y + m_mat_exp_v[4] * v.z;
+                v.z = m_mat_exp_v[5] * v.z;
 
-            // advance velocity
-            v += m_deltaT / Scalar(2.0) * accel;
+                // advance velocity
+                v += m_deltaT / Scalar(2.0) * accel;
 
-            // store velocity
-            h_vel.data[j].x = v.x;
-            h_vel.data[j].y = v.y;
-            h_vel.data[j].z = v.z;
-            }
+                // store velocity
+                h_vel.data[j].x = v.x;
+                h_vel.data[j].y = v.y;
+                h_vel.data[j].z = v.z;
+                }
+        };
+        hoomd::detail::forEachRange(*m_exec_conf, group_size, translate_range);
 
         if (m_aniso)
             {
@@ -659,40 +690,44 @@ void TwoStepConstantPressure::integrateStepTwo(uint64_t timestep)
             // precompute loop invariant quantity
 
             // apply rotational (NO_SQUISH) equations of motion
-            for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-                {
-                unsigned int j = m_group->getMemberIndex(group_idx);
-
-                quat<Scalar> q(h_orientation.data[j]);
-                quat<Scalar> p(h_angmom.data[j]);
-                vec3<Scalar> t(h_net_torque.data[j]);
-                vec3<Scalar> I(h_inertia.data[j]);
-
-                // rotate torque into principal frame
-                t = rotate(conj(q), t);
-
-                // check for zero moment of inertia
-                bool x_zero, y_zero, z_zero;
-                x_zero = (I.x == 0);
-                y_zero = (I.y == 0);
-                z_zero = (I.z == 0);
-
-                // ignore torque component along an axis for which the moment of inertia zero
-                if (x_zero)
-                    t.x = 0;
-                if (y_zero)
-                    t.y = 0;
-                if (z_zero)
-                    t.z = 0;
-
-                // thermostat angular degrees of freedom
-                p = p * rescaleFactors[1];
-
-                // advance p(t+deltaT/2)->p(t+deltaT)
-                p += m_deltaT * q * t;
-
-                h_angmom.data[j] = quat_to_scalar4(p);
-                }
+            auto rotate_range = [&](unsigned int first, unsigned int last)
+            {
+                for (unsigned int group_idx = first; group_idx < last; group_idx++)
+                    {
+                    unsigned int j = h_index_array.data[group_idx];
+
+                    quat<Scalar> q(h_orientation.data[j]);
+                    quat<Scalar> p(h_angmom.data[j]);
+                    vec3<Scalar> t(h_net_torque.data[j]);
+                    vec3<Scalar> I(h_inertia.data[j]);
+
+                    // rotate torque into principal frame
+                    t = rotate(conj(q), t);
+
+                    // check for zero moment of inertia
+                    bool x_zero, y_zero, z_zero;
+                    x_zero = (I.x == 0);
+                    y_zero = (I.y == 0);
+                    z_zero = (I.z == 0);
+
+                    // ignore torque component along an axis for which the moment of inertia zero
+                    if (x_zero)
+                        t.x = 0;
+                    if (y_zero)
+                        t.y = 0;
+                    if (z_zero)
+                        t.z = 0;
+
+                    // thermostat angular degrees of freedom
+                    p = p * rescaleFactors[1];
+
+                    // advance p(t+deltaT/2)->p(t+deltaT)
+                    p += m_deltaT * q * t;
+
+                    h_angmom.data[j] = quat_to_scalar4(p);
+                    }
+            };
+            hoomd::detail::forEachRange(*m_exec_conf, group_size, rotate_range);
             }
         } // end GPUArray scope
 
@@ -34,6 +34,7 @@ void export_BondTablePotential(pybind11::module& m);
 void export_CustomForceCompute(pybind11::module& m);
 void export_NeighborList(pybind11::module& m);
 void export_NeighborListBinned(pybind11::module& m);
+void export_NeighborListCluster(pybind11::module& m);
 void export_NeighborListStencil(pybind11::module& m);
 void export_NeighborListTree(pybind11::module& m);
 void export_MolecularForceCompute(pybind11::module& m);
@@ -409,6 +410,7 @@ PYBIND11_MODULE(_md, m)
     export_CustomForceCompute(m);
     export_NeighborList(m);
     export_NeighborListBinned(m);
+    export_NeighborListCluster(m);
     export_NeighborListStencil(m);
     export_NeighborListTree(m);
     export_MolecularForceCompute(m);
@@ -10,7 +10,7 @@ import json
 import random
 import collections
 from pathlib import Path
-from hoomd.md.nlist import Cell, Stencil, Tree
+from hoomd.md.nlist import Cell, _Cluster, Stencil, Tree
 from hoomd.conftest import (logging_check, pickling_check,
                             autotuned_kernel_parameter_check)
 
@@ -191,6 +191,38 @@ def test_cell_properties(simulation_factory, lattice_snapshot_factory):
     assert nlist.allocated_particles_per_cell >= 1
 
 
+def test_cluster_forces(simulation_factory, lattice_snapshot_factory):
+    snap = lattice_snapshot_factory(particle_types=['A', 'B'], n=8, r=0.2)
+    if snap.communicator.rank == 0:
+        snap.particles.typeid[::3] = 1
+
+    forces = {}
+    for nlist_cls in (Cell, _Cluster):
+        sim = simulation_factory(snap)
+        if isinstance(sim.device, hoomd.device.GPU):
+            pytest.skip("Cluster is not implemented on the GPU.")
+
+        nlist = nlist_cls(buffer=0.4)
+        lj = hoomd.md.pair.LJ(nlist, default_r_cut=2.5, mode='shift')
+        lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+        lj.params[('A', 'B')] = dict(epsilon=1.5, sigma=0.9)
+        lj.params[('B', 'B')] = dict(epsilon=0.5, sigma=1.1)
+        integrator = hoomd.md.Integrator(0.005, forces=[lj])
+        sim.operations.integrator = integrator
+        sim.run(0)
+
+        forces[nlist_cls] = (lj.forces, lj.energy)
+        if nlist_cls is _Cluster:
+            assert nlist.num_cluster_pairs > 0
+
+    if forces[Cell][0] is not None:
+        np.testing.assert_allclose(forces[_Cluster][0],
+                                   forces[Cell][0],
+                                   rtol=1e-5,
+                                   atol=1e-8)
+    np.testing.assert_allclose(forces[_Cluster][1], forces[Cell][1], rtol=1e-5)
+
+
 def test_logging():
     base_loggables = {
         'shortest_rebuild': {
@@ -217,6 +249,15 @@ def test_logging():
             },
         })
 
+    logging_check(
+        hoomd.md.nlist._Cluster, ('md', 'nlist'), {
+            **base_loggables,
+            'num_cluster_pairs': {
+                'category': LoggerCategories.scalar,
+                'default': False
+            },
+        })
+
 
 _path = Path(__file__).parent / "true_pair_list.json"
 TRUE_PAIR_LIST = set([frozenset(pair) for pair in json.load(_path.open())])
@@ -769,6 +769,52 @@ def test_run(simulation_factory, lattice_snapshot_factory, valid_params):
     autotuned_kernel_parameter_check(instance=pot, activate=lambda: sim.run(1))
 
 
+@pytest.mark.skipif(not hoomd.version.tbb_enabled,
+                    reason="HOOMD was compiled without TBB support")
+def test_threaded_forces(device, simulation_factory, lattice_snapshot_factory,
+                         valid_params):
+    """Test that threaded CPU evaluation matches serial evaluation."""
+    if isinstance(device, hoomd.device.GPU):
+        pytest.skip("Threaded evaluation applies only to the CPU")
+
+    pair_keys = valid_params.pair_potential_params.keys()
+    particle_types = list(set(itertools.chain.from_iterable(pair_keys)))
+    snap = lattice_snapshot_factory(particle_types=particle_types,
+                                    n=7,
+                                    a=1.2,
+                                    r=0.05)
+    _update_snap(valid_params.pair_potential, snap)
+    if snap.communicator.rank == 0:
+        snap.particles.typeid[:] = (np.arange(snap.particles.N)
+                                    % len(snap.particles.types))
+
+    num_cpu_threads = device.num_cpu_threads
+    forces = []
+    energies = []
+    try:
+        for num_threads in (1, 4):
+            device.num_cpu_threads = num_threads
+            pot = valid_params.pair_potential(**valid_params.extra_args,
+                                              nlist=md.nlist.Cell(buffer=0.4),
+                                              default_r_cut=2.5)
+            pot.params = valid_params.pair_potential_params
+            sim = simulation_factory(snap)
+            sim.operations.integrator = hoomd.md.Integrator(dt=0.005,
+                                                            forces=[pot])
+            sim.run(0)
+            forces.append(pot.forces)
+            energies.append(pot.energies)
+    finally:
+        device.num_cpu_threads = num_cpu_threads
+
+    if forces[0] is not None:
+        np.testing.assert_allclose(forces[0], forces[1], rtol=1e-6, atol=1e-8)
+        np.testing.assert_allclose(energies[0],
+                                   energies[1],
+                                   rtol=1e-6,
+                                   atol=1e-8)
+
+
 def set_distance(simulation, distance):
     snap = simulation.state.get_snapshot()
     if snap.communicator.rank == 0:
@@ -0,0 +1,188 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/AnisoPotentialPair.h"
+#include "hoomd/md/EvaluatorPairGB.h"
+#include "hoomd/md/NeighborListTree.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_aniso_pair_threads.cc
+    \brief Checks the threaded CPU anisotropic pair potentials against the serial code path
+    \ingroup unit_tests
+*/
+
+//! Per particle forces, energies, torques and virials of an anisotropic pair potential
+struct aniso_result
+    {
+    std::vector<Scalar4> force;
+    std::vector<Scalar4> torque;
+    std::vector<Scalar> virial;
+    };
+
+//! Compute the Gay-Berne potential on a jittered lattice of rotated particles
+/*! \param storage_mode Neighbor list storage mode, which selects the threaded code path
+    \param num_threads Number of CPU threads
+
+    The 8000 particles span many chunks of the threaded code path and every particle has neighbors
+    in other chunks, so with a half neighbor list neighboring chunks write to the same particles.
+*/
+aniso_result run_gay_berne(NeighborList::storageMode storage_mode, unsigned int num_threads)
+    {
+    const unsigned int n_side = 20;
+    const unsigned int N = n_side * n_side * n_side;
+    const Scalar a = Scalar(1.4);
+    const Scalar L = a * Scalar(n_side);
+    const Scalar lo = (a - L) / Scalar(2.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(num_threads);
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(),
+                                           access_location::host,
+                                           access_mode::readwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int ix = i % n_side;
+            unsigned int iy = (i / n_side) % n_side;
+            unsigned int iz = i / (n_side * n_side);
+            Scalar jitter_x = Scalar((i * 7919) % 101) / Scalar(101.0) - Scalar(0.5);
+            Scalar jitter_y = Scalar((i * 104729) % 103) / Scalar(103.0) - Scalar(0.5);
+            Scalar jitter_z = Scalar((i * 1299709) % 107) / Scalar(107.0) - Scalar(0.5);
+            h_pos.data[i].x = lo + a * (Scalar(ix) + Scalar(0.2) * jitter_x);
+            h_pos.data[i].y = lo + a * (Scalar(iy) + Scalar(0.2) * jitter_y);
+            h_pos.data[i].z = lo + a * (Scalar(iz) + Scalar(0.2) * jitter_z);
+            h_pos.data[i].w = __int_as_scalar(0);
+
+            // rotate each particle by a different angle about a different axis
+            vec3<Scalar> axis(jitter_x + Scalar(0.6), jitter_y, jitter_z);
+            axis = axis / sqrt(dot(axis, axis));
+            Scalar angle = Scalar(0.37) * Scalar(i % 17);
+            h_orientation.data[i] = quat_to_scalar4(quat<Scalar>::fromAxisAngle(axis, angle));
+            }
+        }
+
+    std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(0.3)));
+    nlist->setStorageMode(storage_mode);
+    std::shared_ptr<AnisoPotentialPair<EvaluatorPairGB>> potential(
+        new AnisoPotentialPair<EvaluatorPairGB>(sysdef, nlist));
+    EvaluatorPairGB::param_type param;
+    param.epsilon = Scalar(1.0);
+    param.lperp = Scalar(0.3);
+    param.lpar = Scalar(0.6);
+    potential->setParams(0, 0, param);
+    potential->setRcut(0, 0, Scalar(3.0));
+    potential->setShiftMode(AnisoPotentialPair<EvaluatorPairGB>::shift);
+    potential->compute(0);
+
+    aniso_result result;
+    ArrayHandle<Scalar4> h_force(potential->getForceArray(),
+                                 access_location::host,
+                                 access_mode::read);
+    ArrayHandle<Scalar4> h_torque(potential->getTorqueArray(),
+                                  access_location::host,
+                                  access_mode::read);
+    ArrayHandle<Scalar> h_virial(potential->getVirialArray(),
+                                 access_location::host,
+                                 access_mode::read);
+    const size_t pitch = potential->getVirialArray().getPitch();
+    result.force.assign(h_force.data, h_force.data + N);
+    result.torque.assign(h_torque.data, h_torque.data + N);
+    for (unsigned int k = 0; k < 6; k++)
+        result.virial.insert(result.virial.end(),
+                             h_virial.data + k * pitch,
+                             h_virial.data + k * pitch + N);
+    return result;
+    }
+
+//! Check that a threaded value matches the serial value to within round off
+void check_threaded_value(Scalar threaded, Scalar serial)
+    {
+    UP_ASSERT(std::abs(threaded - serial) <= tol_small * std::max(Scalar(1.0), std::abs(serial)));
+    }
+
+//! Compare the threaded code path with 2, 3 and 8 threads to the serial code path
+/*! With a half neighbor list, the threaded sums are associated by chunk, so they match the serial
+    sums to within round off and are bitwise reproducible for a given number of threads.
+*/
+void gay_berne_thread_test(NeighborList::storageMode storage_mode)
+    {
+    aniso_result serial = run_gay_berne(storage_mode, 1);
+    const unsigned int N = (unsigned int)serial.force.size();
+
+    // the test system must give nonzero forces, energies and torques
+    Scalar max_force = 0;
+    Scalar max_energy = 0;
+    Scalar max_torque = 0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        const Scalar4& f = serial.force[i];
+        const Scalar4& t = serial.torque[i];
+        max_force = std::max(max_force, std::abs(f.x) + std::abs(f.y) + std::abs(f.z));
+        max_energy = std::max(max_energy, std::abs(f.w));
+        max_torque = std::max(max_torque, std::abs(t.x) + std::abs(t.y) + std::abs(t.z));
+        }
+    UP_ASSERT(max_force > Scalar(1e-3));
+    UP_ASSERT(max_energy > Scalar(1e-3));
+    UP_ASSERT(max_torque > Scalar(1e-3));
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        aniso_result threaded = run_gay_berne(storage_mode, num_threads);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            check_threaded_value(threaded.force[i].x, serial.force[i].x);
+            check_threaded_value(threaded.force[i].y, serial.force[i].y);
+            check_threaded_value(threaded.force[i].z, serial.force[i].z);
+            check_threaded_value(threaded.force[i].w, serial.force[i].w);
+            check_threaded_value(threaded.torque[i].x, serial.torque[i].x);
+            check_threaded_value(threaded.torque[i].y, serial.torque[i].y);
+            check_threaded_value(threaded.torque[i].z, serial.torque[i].z);
+            }
+        for (unsigned int i = 0; i < 6 * N; i++)
+            check_threaded_value(threaded.virial[i], serial.virial[i]);
+
+        aniso_result repeat = run_gay_berne(storage_mode, num_threads);
+        UP_ASSERT(memcmp(threaded.force.data(), repeat.force.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(memcmp(threaded.torque.data(), repeat.torque.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(memcmp(threaded.virial.data(), repeat.virial.data(), sizeof(Scalar) * 6 * N)
+                  == 0);
+        }
+    }
+
+#ifdef ENABLE_TBB
+//! Half neighbor list: forces and torques are scattered to j through per chunk buffers
+UP_TEST(gay_berne_half_threads)
+    {
+    gay_berne_thread_test(NeighborList::half);
+    }
+
+//! Full neighbor list: each thread writes only to the particles it owns
+UP_TEST(gay_berne_full_threads)
+    {
+    gay_berne_thread_test(NeighborList::full);
+    }
+#endif
@@ -0,0 +1,365 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/md/CosineSqAngleForceCompute.h"
+#include "hoomd/md/EvaluatorBondHarmonic.h"
+#include "hoomd/md/EvaluatorSpecialPairLJ.h"
+#include "hoomd/md/HarmonicAngleForceCompute.h"
+#include "hoomd/md/HarmonicDihedralForceCompute.h"
+#include "hoomd/md/HarmonicImproperForceCompute.h"
+#include "hoomd/md/OPLSDihedralForceCompute.h"
+#include "hoomd/md/PeriodicImproperForceCompute.h"
+#include "hoomd/md/PotentialBond.h"
+#include "hoomd/md/PotentialSpecialPair.h"
+#include "hoomd/md/TableAngleForceCompute.h"
+#include "hoomd/md/TableDihedralForceCompute.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_bonded_force_threads.cc
+    \brief Checks the threaded CPU bonded force computes against the serial code path
+    \ingroup unit_tests
+*/
+
+//! Function that creates a bonded force compute for a system
+typedef std::function<std::shared_ptr<ForceCompute>(std::shared_ptr<SystemDefinition>)>
+    force_creator;
+
+//! Number of chains in the test system
+const unsigned int n_chains = 1000;
+
+//! Number of particles in each chain
+const unsigned int chain_length = 40;
+
+//! Per particle forces and virials of a force compute
+struct force_result
+    {
+    std::vector<Scalar4> force;
+    std::vector<Scalar> virial;
+    };
+
+//! Build a system of helical chains with bonds, angles, dihedrals, impropers and special pairs
+/*! Each chain of chain_length particles has a group of every kind on every run of consecutive
+    particles, so a group type holds tens of thousands of groups and spans many chunks of the
+    threaded code paths. Chunk boundaries fall inside chains, where neighboring chunks write to the
+    same particles.
+*/
+std::shared_ptr<SystemDefinition> build_chains(unsigned int num_threads)
+    {
+    const unsigned int n_side = 10;
+    const Scalar spacing = Scalar(6.0);
+    const Scalar L = spacing * Scalar(n_side);
+    const unsigned int N = n_chains * chain_length;
+
+    std::shared_ptr<SnapshotSystemData<Scalar>> snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = std::make_shared<BoxDim>(L);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(N);
+
+    for (unsigned int c = 0; c < n_chains; c++)
+        {
+        vec3<Scalar> origin(spacing * Scalar(c % n_side) - L / Scalar(2.0) + Scalar(3.0),
+                            spacing * Scalar((c / n_side) % n_side) - L / Scalar(2.0)
+                                + Scalar(3.0),
+                            spacing * Scalar(c / (n_side * n_side)) - L / Scalar(2.0)
+                                + Scalar(0.3));
+        for (unsigned int k = 0; k < chain_length; k++)
+            {
+            unsigned int tag = c * chain_length + k;
+            Scalar jitter = Scalar((tag * 7919) % 101) / Scalar(101.0) - Scalar(0.5);
+            Scalar phi = Scalar(0.9) * Scalar(k) + Scalar(0.3) * jitter;
+            snap->particle_data.pos[tag]
+                = origin
+                  + vec3<Scalar>(Scalar(1.1) * cos(phi),
+                                 Scalar(1.1) * sin(phi),
+                                 Scalar(0.13) * Scalar(k) + Scalar(0.05) * jitter);
+            }
+        }
+
+    snap->bond_data.type_mapping.push_back("A");
+    snap->angle_data.type_mapping.push_back("A");
+    snap->dihedral_data.type_mapping.push_back("A");
+    snap->improper_data.type_mapping.push_back("A");
+    snap->pair_data.type_mapping.push_back("A");
+
+    snap->bond_data.resize(n_chains * (chain_length - 1));
+    snap->pair_data.resize(n_chains * (chain_length - 3));
+    snap->angle_data.resize(n_chains * (chain_length - 2));
+    snap->dihedral_data.resize(n_chains * (chain_length - 3));
+    snap->improper_data.resize(n_chains * (chain_length - 3));
+    for (unsigned int c = 0; c < n_chains; c++)
+        {
+        unsigned int first = c * chain_length;
+        for (unsigned int k = 0; k < chain_length - 1; k++)
+            {
+            unsigned int g = c * (chain_length - 1) + k;
+            snap->bond_data.groups[g].tag[0] = first + k;
+            snap->bond_data.groups[g].tag[1] = first + k + 1;
+            }
+        for (unsigned int k = 0; k < chain_length - 2; k++)
+            {
+            unsigned int g = c * (chain_length - 2) + k;
+            for (unsigned int m = 0; m < 3; m++)
+                snap->angle_data.groups[g].tag[m] = first + k + m;
+            }
+        for (unsigned int k = 0; k < chain_length - 3; k++)
+            {
+            unsigned int g = c * (chain_length - 3) + k;
+            snap->pair_data.groups[g].tag[0] = first + k;
+            snap->pair_data.groups[g].tag[1] = first + k + 3;
+            for (unsigned int m = 0; m < 4; m++)
+                {
+                snap->dihedral_data.groups[g].tag[m] = first + k + m;
+                snap->improper_data.groups[g].tag[m] = first + k + m;
+                }
+            }
+        }
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(num_threads);
+    return std::shared_ptr<SystemDefinition>(new SystemDefinition(snap, exec_conf));
+    }
+
+//! Compute the forces of the compute made by \a creator with \a num_threads CPU threads
+force_result run_force(force_creator creator, unsigned int num_threads)
+    {
+    std::shared_ptr<SystemDefinition> sysdef = build_chains(num_threads);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<ForceCompute> fc = creator(sysdef);
+    fc->compute(0);
+
+    const unsigned int N = pdata->getN();
+    force_result result;
+    ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+    const size_t pitch = fc->getVirialArray().getPitch();
+    result.force.assign(h_force.data, h_force.data + N);
+    for (unsigned int k = 0; k < 6; k++)
+        result.virial.insert(result.virial.end(),
+                             h_virial.data + k * pitch,
+                             h_virial.data + k * pitch + N);
+    return result;
+    }
+
+//! Check that a threaded value matches the serial value to within round off
+void check_threaded_value(Scalar threaded, Scalar serial)
+    {
+    UP_ASSERT(std::abs(threaded - serial) <= tol_small * std::max(Scalar(1.0), std::abs(serial)));
+    }
+
+//! Compare the threaded code path with 2, 3 and 8 threads to the serial code path
+/*! The threaded sums are associated by chunk, so they match the serial sums to within round off
+    and are bitwise reproducible for a given number of threads.
+*/
+void bonded_thread_test(force_creator creator)
+    {
+    force_result serial = run_force(creator, 1);
+
+    // the test system must give nonzero forces
+    Scalar max_force = 0;
+    for (const Scalar4& f : serial.force)
+        max_force = std::max(max_force, std::abs(f.x) + std::abs(f.y) + std::abs(f.z));
+    UP_ASSERT(max_force > Scalar(1e-3));
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        force_result threaded = run_force(creator, num_threads);
+        const unsigned int N = (unsigned int)serial.force.size();
+        for (unsigned int i = 0; i < N; i++)
+            {
+            check_threaded_value(threaded.force[i].x, serial.force[i].x);
+            check_threaded_value(threaded.force[i].y, serial.force[i].y);
+            check_threaded_value(threaded.force[i].z, serial.force[i].z);
+            check_threaded_value(threaded.force[i].w, serial.force[i].w);
+            }
+        for (unsigned int i = 0; i < 6 * N; i++)
+            check_threaded_value(threaded.virial[i], serial.virial[i]);
+
+        force_result repeat = run_force(creator, num_threads);
+        UP_ASSERT(memcmp(threaded.force.data(), repeat.force.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(memcmp(threaded.virial.data(), repeat.virial.data(), sizeof(Scalar) * 6 * N)
+                  == 0);
+        }
+    }
+
+//! Make a table of V(theta) = K (theta - theta_0)^2 and T = -dV/dtheta on [theta_min, theta_max]
+void make_table(unsigned int width,
+                Scalar theta_min,
+                Scalar theta_max,
+                std::vector<Scalar>& V,
+                std::vector<Scalar>& T)
+    {
+    const Scalar K = Scalar(5.0);
+    const Scalar theta_0 = Scalar(1.8);
+    V.resize(width);
+    T.resize(width);
+    for (unsigned int i = 0; i < width; i++)
+        {
+        Scalar theta = theta_min + (theta_max - theta_min) * Scalar(i) / Scalar(width - 1);
+        V[i] = K * (theta - theta_0) * (theta - theta_0);
+        T[i] = -Scalar(2.0) * K * (theta - theta_0);
+        }
+    }
+
+//! PeriodicImproperForceCompute with direct access to the parameters
+class PeriodicImproperTest : public PeriodicImproperForceCompute
+    {
+    public:
+    PeriodicImproperTest(std::shared_ptr<SystemDefinition> sysdef)
+        : PeriodicImproperForceCompute(sysdef)
+        {
+        ArrayHandle<periodic_improper_params> h_params(m_params,
+                                                       access_location::host,
+                                                       access_mode::readwrite);
+        h_params.data[0].k = Scalar(2.0);
+        h_params.data[0].d = Scalar(1.0);
+        h_params.data[0].n = 2;
+        h_params.data[0].chi_0 = Scalar(0.4);
+        }
+    };
+
+#ifdef ENABLE_TBB
+//! PotentialBond
+UP_TEST(PotentialBondHarmonic_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<PotentialBond<EvaluatorBondHarmonic, BondData>>(sysdef);
+            fc->setParams(0, harmonic_params(Scalar(300.0), Scalar(0.9)));
+            return fc;
+        });
+    }
+
+//! PotentialSpecialPair
+UP_TEST(PotentialSpecialPairLJ_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<PotentialSpecialPair<EvaluatorSpecialPairLJ>>(sysdef);
+            special_lj_params params;
+            params.sigma_6 = Scalar(1.0);
+            params.epsilon_x_4 = Scalar(4.0);
+            params.r_cutsq = Scalar(9.0);
+            fc->setParams(0, params);
+            return fc;
+        });
+    }
+
+//! HarmonicAngleForceCompute
+UP_TEST(HarmonicAngleForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<HarmonicAngleForceCompute>(sysdef);
+            fc->setParams(0, Scalar(10.0), Scalar(1.8));
+            return fc;
+        });
+    }
+
+//! CosineSqAngleForceCompute
+UP_TEST(CosineSqAngleForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<CosineSqAngleForceCompute>(sysdef);
+            fc->setParams(0, Scalar(10.0), Scalar(1.8));
+            return fc;
+        });
+    }
+
+//! TableAngleForceCompute
+UP_TEST(TableAngleForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            const unsigned int width = 100;
+            auto fc = std::make_shared<TableAngleForceCompute>(sysdef, width);
+            std::vector<Scalar> V, T;
+            make_table(width, Scalar(0.0), Scalar(M_PI), V, T);
+            fc->setTable(0, V, T);
+            return fc;
+        });
+    }
+
+//! HarmonicDihedralForceCompute
+UP_TEST(HarmonicDihedralForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<HarmonicDihedralForceCompute>(sysdef);
+            fc->setParams(0, Scalar(5.0), Scalar(1.0), 3, Scalar(0.3));
+            return fc;
+        });
+    }
+
+//! TableDihedralForceCompute
+UP_TEST(TableDihedralForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            const unsigned int width = 100;
+            auto fc = std::make_shared<TableDihedralForceCompute>(sysdef, width);
+            std::vector<Scalar> V, T;
+            make_table(width, Scalar(-M_PI), Scalar(M_PI), V, T);
+            fc->setTable(0, V, T);
+            return fc;
+        });
+    }
+
+//! OPLSDihedralForceCompute
+UP_TEST(OPLSDihedralForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<OPLSDihedralForceCompute>(sysdef);
+            fc->setParams(0, Scalar(1.5), Scalar(-0.5), Scalar(0.8), Scalar(0.2));
+            return fc;
+        });
+    }
+
+//! HarmonicImproperForceCompute
+UP_TEST(HarmonicImproperForceCompute_threads)
+    {
+    bonded_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef)
+        {
+            auto fc = std::make_shared<HarmonicImproperForceCompute>(sysdef);
+            fc->setParams(0, Scalar(8.0), Scalar(0.5));
+            return fc;
+        });
+    }
+
+//! PeriodicImproperForceCompute
+UP_TEST(PeriodicImproperForceCompute_threads)
+    {
+    bonded_thread_test([](std::shared_ptr<SystemDefinition> sysdef)
+                       { return std::make_shared<PeriodicImproperTest>(sysdef); });
+    }
+#endif
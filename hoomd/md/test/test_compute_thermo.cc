@@ -0,0 +1,166 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "hoomd/DeterministicReduce.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+#include "hoomd/md/ComputeThermo.h"
+#include "hoomd/md/ComputeThermoHMA.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_compute_thermo.cc
+    \brief Checks that the thermodynamic quantities do not depend on the number of threads
+    \ingroup unit_tests
+*/
+
+//! Thread counts compared against the serial result
+const unsigned int thread_counts[] = {1, 2, 8};
+
+//! Sum a badly conditioned sequence of \a n values with deterministicReduce
+double reduce_sum(unsigned int n, unsigned int num_threads)
+    {
+    ExecutionConfiguration exec_conf(ExecutionConfiguration::CPU);
+#ifdef ENABLE_TBB
+    exec_conf.setNumThreads(num_threads);
+#endif
+
+    // values of very different magnitude, so any change in the order of the sum shows up
+    auto value = [](unsigned int i) { return std::pow(10.0, double(i % 17) - 8.0) * sin(i); };
+    return hoomd::detail::deterministicReduce(
+        exec_conf,
+        n,
+        0.0,
+        [&](unsigned int first, unsigned int last)
+        {
+            double sum = 0.0;
+            for (unsigned int i = first; i < last; i++)
+                sum += value(i);
+            return sum;
+        },
+        [](double a, double b) { return a + b; });
+    }
+
+//! deterministicReduce gives bitwise identical sums with any number of threads
+UP_TEST(deterministic_reduce_threads)
+    {
+    for (unsigned int n : {0u, 1u, 1023u, 1024u, 1025u, 4096u, 100003u})
+        {
+        double serial = reduce_sum(n, 1);
+        for (unsigned int num_threads : thread_counts)
+            {
+            double threaded = reduce_sum(n, num_threads);
+            UP_ASSERT(memcmp(&serial, &threaded, sizeof(double)) == 0);
+            }
+        }
+    UP_ASSERT_EQUAL(reduce_sum(0, 1), 0.0);
+    }
+
+//! Compute the thermodynamic quantities of a fixed random state with \a num_threads threads
+std::vector<Scalar> thermo_quantities(unsigned int num_threads)
+    {
+    // enough particles that the reduction is split into many blocks
+    const unsigned int N = 20000;
+    const Scalar L = Scalar(40.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+#endif
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(),
+                                         access_location::host,
+                                         access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial(pdata->getNetVirial(),
+                                         access_location::host,
+                                         access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom(pdata->getAngularMomentumArray(),
+                                      access_location::host,
+                                      access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia(pdata->getMomentsOfInertiaArray(),
+                                       access_location::host,
+                                       access_mode::overwrite);
+        const size_t virial_pitch = pdata->getNetVirial().getPitch();
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_pos.data[i].x = L * (Scalar((i * 7919) % N) / Scalar(N) - Scalar(0.5));
+            h_pos.data[i].y = L * (Scalar((i * 104729) % N) / Scalar(N) - Scalar(0.5));
+            h_pos.data[i].z = L * (Scalar((i * 1299709) % N) / Scalar(N) - Scalar(0.5));
+            h_vel.data[i] = make_scalar4(sin(Scalar(i)),
+                                         cos(Scalar(3 * i)),
+                                         sin(Scalar(7 * i)),
+                                         Scalar(1.0) + Scalar(i % 3));
+            h_net_force.data[i] = make_scalar4(cos(Scalar(i)),
+                                               sin(Scalar(5 * i)),
+                                               cos(Scalar(11 * i)),
+                                               Scalar(1e3) * sin(Scalar(13 * i)));
+            for (unsigned int j = 0; j < 6; j++)
+                h_net_virial.data[j * virial_pitch + i] = sin(Scalar((j + 1) * i));
+            h_angmom.data[i] = make_scalar4(0, sin(Scalar(2 * i)), cos(Scalar(2 * i)), Scalar(0.5));
+            h_inertia.data[i] = make_scalar3(1, 2, 0);
+            }
+        }
+
+    PDataFlags flags;
+    flags[pdata_flag::pressure_tensor] = 1;
+    flags[pdata_flag::rotational_kinetic_energy] = 1;
+    pdata->setFlags(flags);
+
+    std::shared_ptr<ParticleGroup> group(
+        new ParticleGroup(sysdef, std::make_shared<ParticleFilterAll>()));
+    std::shared_ptr<ComputeThermo> thermo(new ComputeThermo(sysdef, group));
+    thermo->compute(0);
+    std::shared_ptr<ComputeThermoHMA> thermo_hma(
+        new ComputeThermoHMA(sysdef, group, Scalar(1.0), Scalar(0.5)));
+    thermo_hma->compute(0);
+
+    PressureTensor P = thermo->getPressureTensor();
+    return {thermo->getTranslationalKineticEnergy(),
+            thermo->getRotationalKineticEnergy(),
+            thermo->getPotentialEnergy(),
+            thermo->getPressure(),
+            P.xx,
+            P.xy,
+            P.xz,
+            P.yy,
+            P.yz,
+            P.zz,
+            thermo_hma->getPotentialEnergyHMA(),
+            thermo_hma->getPressureHMA()};
+    }
+
+//! ComputeThermo and ComputeThermoHMA give bitwise identical results with any number of threads
+UP_TEST(compute_thermo_threads)
+    {
+    std::vector<Scalar> serial = thermo_quantities(1);
+    for (unsigned int num_threads : thread_counts)
+        {
+        std::vector<Scalar> threaded = thermo_quantities(num_threads);
+        UP_ASSERT_EQUAL(serial.size(), threaded.size());
+        UP_ASSERT(memcmp(serial.data(), threaded.data(), sizeof(Scalar) * serial.size()) == 0);
+        }
+    }
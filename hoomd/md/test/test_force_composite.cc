@@ -0,0 +1,195 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "hoomd/md/ForceComposite.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_force_composite.cc
+    \brief Checks that ForceComposite updates the constituent particles the same way with any
+    number of threads
+    \ingroup unit_tests
+*/
+
+//! ForceComposite that can remove a particle from its molecule
+class MyForceComposite : public ForceComposite
+    {
+    public:
+    MyForceComposite(std::shared_ptr<SystemDefinition> sysdef) : ForceComposite(sysdef) { }
+
+    //! Detach the particle with tag \a tag from its body
+    void removeFromMolecule(unsigned int tag)
+        {
+            {
+            ArrayHandle<unsigned int> h_molecule_tag(m_molecule_tag,
+                                                     access_location::host,
+                                                     access_mode::readwrite);
+            h_molecule_tag.data[tag] = NO_MOLECULE;
+            }
+        // rebuild the molecule table
+        m_pdata->notifyParticleSort();
+        }
+    };
+
+//! Positions, orientations, and images of all particles after an update
+struct composite_result
+    {
+    std::vector<Scalar4> pos;
+    std::vector<Scalar4> orientation;
+    std::vector<int3> image;
+    };
+
+//! Create rigid bodies, move and rotate the central particles, and update the constituents
+/*! \param num_threads Number of CPU threads
+    \param missing_constituent If true, detach one constituent from its body before the update
+*/
+composite_result update_bodies(unsigned int num_threads, bool missing_constituent = false)
+    {
+    // enough bodies that they are split over many threads
+    const unsigned int n_bodies = 5000;
+    const Scalar L = Scalar(40.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+#endif
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(n_bodies, BoxDim(L), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        const Scalar n = Scalar(n_bodies);
+        for (unsigned int i = 0; i < n_bodies; i++)
+            {
+            h_pos.data[i].x = L * (Scalar((i * 7919) % n_bodies) / n - Scalar(0.5));
+            h_pos.data[i].y = L * (Scalar((i * 104729) % n_bodies) / n - Scalar(0.5));
+            h_pos.data[i].z = L * (Scalar((i * 1299709) % n_bodies) / n - Scalar(0.5));
+            }
+        }
+
+    // bodies of type 0 with three constituents of type 1
+    std::shared_ptr<MyForceComposite> rigid(new MyForceComposite(sysdef));
+    std::vector<unsigned int> types = {1, 1, 1};
+    std::vector<Scalar3> positions = {make_scalar3(1.0, 0.0, 0.0),
+                                      make_scalar3(-0.5, 0.8, 0.0),
+                                      make_scalar3(-0.5, -0.8, 0.3)};
+    std::vector<Scalar4> orientations = {make_scalar4(1.0, 0.0, 0.0, 0.0),
+                                         make_scalar4(0.0, 1.0, 0.0, 0.0),
+                                         make_scalar4(sqrt(0.5), 0.0, 0.0, sqrt(0.5))};
+    rigid->setParam(0, types, positions, orientations);
+    rigid->createRigidBodies(std::unordered_map<unsigned int, std::vector<Scalar>>());
+    const unsigned int N = pdata->getN();
+    UP_ASSERT_EQUAL(N, 4 * n_bodies);
+
+        {
+        // move and rotate the central particles, some across the box boundary
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(),
+                                           access_location::host,
+                                           access_mode::readwrite);
+        ArrayHandle<unsigned int> h_body(pdata->getBodies(),
+                                         access_location::host,
+                                         access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            if (h_body.data[i] != h_tag.data[i])
+                continue;
+
+            Scalar phi = Scalar(0.1) * Scalar(i % 31);
+            vec3<Scalar> axis(sin(Scalar(i)), cos(Scalar(i)), Scalar(0.5));
+            quat<Scalar> q = quat<Scalar>::fromAxisAngle(axis / sqrt(dot(axis, axis)), phi);
+            h_orientation.data[i] = quat_to_scalar4(q);
+            h_pos.data[i].x += Scalar(0.3) * sin(Scalar(3 * i));
+            h_pos.data[i].y += Scalar(0.3) * cos(Scalar(5 * i));
+            h_pos.data[i].z += Scalar(0.3) * sin(Scalar(7 * i));
+            }
+        }
+
+    if (missing_constituent)
+        rigid->removeFromMolecule(n_bodies + 3 * (n_bodies / 2) + 1);
+
+    rigid->updateCompositeParticles(1);
+
+    composite_result result;
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(),
+                                       access_location::host,
+                                       access_mode::read);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+    result.pos.assign(h_pos.data, h_pos.data + N);
+    result.orientation.assign(h_orientation.data, h_orientation.data + N);
+    result.image.assign(h_image.data, h_image.data + N);
+    return result;
+    }
+
+//! The constituents are placed on the rotated body frame
+UP_TEST(force_composite_update)
+    {
+    const unsigned int n_bodies = 5000;
+    composite_result result = update_bodies(1);
+
+    // the constituents of a body are all at the same distance from the updated central particle
+    const Scalar L = Scalar(40.0);
+    BoxDim box(L);
+    for (unsigned int i = 0; i < n_bodies; i++)
+        {
+        vec3<Scalar> center(result.pos[i]);
+        Scalar expected[] = {Scalar(1.0), sqrt(Scalar(0.89)), sqrt(Scalar(0.98))};
+        for (unsigned int j = 0; j < 3; j++)
+            {
+            vec3<Scalar> pos(result.pos[n_bodies + 3 * i + j]);
+            Scalar3 dr = box.minImage(vec_to_scalar3(pos - center));
+            MY_CHECK_CLOSE(sqrt(dot(dr, dr)), expected[j], tol_small);
+            }
+        }
+    }
+
+#ifdef ENABLE_TBB
+//! The threaded update gives bitwise identical positions and orientations
+UP_TEST(force_composite_threads)
+    {
+    composite_result serial = update_bodies(1);
+    const size_t N = serial.pos.size();
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        composite_result threaded = update_bodies(num_threads);
+        UP_ASSERT(memcmp(serial.pos.data(), threaded.pos.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(
+            memcmp(serial.orientation.data(), threaded.orientation.data(), sizeof(Scalar4) * N)
+            == 0);
+        UP_ASSERT(memcmp(serial.image.data(), threaded.image.data(), sizeof(int3) * N) == 0);
+        }
+    }
+#endif
+
+//! A body with a missing constituent is an error, also when it is detected in a worker thread
+UP_TEST(force_composite_missing_constituent)
+    {
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&] { update_bodies(1, true); });
+#ifdef ENABLE_TBB
+    for (unsigned int num_threads : {2, 8})
+        UP_ASSERT_EXCEPTION(std::runtime_error, [&] { update_bodies(num_threads, true); });
+#endif
+    }
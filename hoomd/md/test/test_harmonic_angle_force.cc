@@ -448,6 +448,18 @@ UP_TEST(HarmonicAngleForceCompute_basic)
     angle_force_basic_tests(af_creator, exec_conf);
     }
 
+#ifdef ENABLE_TBB
+//! test case for threaded angle forces on the CPU
+UP_TEST(HarmonicAngleForceCompute_threaded)
+    {
+    angleforce_creator af_creator = bind(base_class_af_creator, _1);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(4);
+    angle_force_basic_tests(af_creator, exec_conf);
+    }
+#endif
+
 #ifdef ENABLE_HIP
 //! test case for angle forces on the GPU
 UP_TEST(HarmonicAngleForceComputeGPU_basic)
@@ -475,6 +475,18 @@ UP_TEST(PotentialBondHarmonic_basic)
                                new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! test case for threaded bond forces on the CPU
+UP_TEST(PotentialBondHarmonic_threaded)
+    {
+    bondforce_creator bf_creator = bind(base_class_bf_creator, _1);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(4);
+    bond_force_basic_tests(bf_creator, exec_conf);
+    }
+#endif
+
 #ifdef ENABLE_HIP
 //! test case for bond forces on the GPU
 UP_TEST(PotentialBondHarmonicGPU_basic)
@@ -638,6 +638,19 @@ UP_TEST(HarmonicDihedralForceCompute_basic)
                                    new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! test case for threaded dihedral forces on the CPU
+UP_TEST(HarmonicDihedralForceCompute_threaded)
+    {
+    dihedralforce_creator tf_creator = bind(base_class_tf_creator, _1);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(4);
+    dihedral_force_basic_tests(tf_creator, exec_conf);
+    dihedral_force_phase_shift(tf_creator, exec_conf);
+    }
+#endif
+
 #ifdef ENABLE_HIP
 //! test case for dihedral forces on the GPU
 UP_TEST(HarmonicDihedralForceComputeGPU_basic)
@@ -0,0 +1,168 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/TwoStepBD.h"
+#include "hoomd/md/TwoStepConstantVolume.h"
+#include "hoomd/md/TwoStepLangevin.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_integration_method_threads.cc
+    \brief Checks that the CPU integration methods give the same result with any number of threads
+    \ingroup unit_tests
+*/
+
+//! Function that creates an integration method for a system and group
+typedef std::function<std::shared_ptr<IntegrationMethodTwoStep>(std::shared_ptr<SystemDefinition>,
+                                                                std::shared_ptr<ParticleGroup>)>
+    method_creator;
+
+//! State of the particles at the end of a run
+struct integration_result
+    {
+    std::vector<Scalar4> pos;
+    std::vector<Scalar4> vel;
+    std::vector<int3> image;
+    Scalar reservoir_energy;
+    };
+
+//! Integrate a system of harmonically bound particles with \a num_threads CPU threads
+integration_result run_method(method_creator creator, unsigned int num_threads)
+    {
+    // enough particles that the ranges are split into many pieces
+    const unsigned int N = 6000;
+    const Scalar L = Scalar(25.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(num_threads);
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_pos.data[i].x = L * (Scalar((i * 7919) % N) / Scalar(N) - Scalar(0.5));
+            h_pos.data[i].y = L * (Scalar((i * 104729) % N) / Scalar(N) - Scalar(0.5));
+            h_pos.data[i].z = L * (Scalar((i * 1299709) % N) / Scalar(N) - Scalar(0.5));
+            h_vel.data[i].x = Scalar(i % 13) * Scalar(0.1) - Scalar(0.6);
+            h_vel.data[i].y = Scalar(i % 7) * Scalar(0.2) - Scalar(0.6);
+            h_vel.data[i].z = Scalar(i % 5) * Scalar(0.3) - Scalar(0.6);
+            }
+        }
+
+    // integrate every other particle
+    std::vector<unsigned int> member_tags;
+    for (unsigned int i = 0; i < N; i += 2)
+        member_tags.push_back(i);
+    std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef, member_tags));
+
+    std::shared_ptr<IntegrationMethodTwoStep> method = creator(sysdef, group);
+    method->setDeltaT(Scalar(0.005));
+
+    for (uint64_t timestep = 0; timestep < 10; timestep++)
+        {
+        method->integrateStepOne(timestep);
+
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                       access_location::host,
+                                       access_mode::read);
+            ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(),
+                                             access_location::host,
+                                             access_mode::overwrite);
+            for (unsigned int i = 0; i < N; i++)
+                h_net_force.data[i]
+                    = make_scalar4(-h_pos.data[i].x, -h_pos.data[i].y, -h_pos.data[i].z, 0);
+            }
+
+        method->integrateStepTwo(timestep);
+        }
+
+    integration_result result;
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+    result.pos.assign(h_pos.data, h_pos.data + N);
+    result.vel.assign(h_vel.data, h_vel.data + N);
+    result.image.assign(h_image.data, h_image.data + N);
+    result.reservoir_energy = Scalar(0.0);
+    if (auto langevin = std::dynamic_pointer_cast<TwoStepLangevin>(method))
+        result.reservoir_energy = langevin->getReservoirEnergy();
+    return result;
+    }
+
+//! Check that a method gives bitwise identical results with 1 and several threads
+void integration_method_thread_test(method_creator creator)
+    {
+    integration_result serial = run_method(creator, 1);
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        integration_result threaded = run_method(creator, num_threads);
+        const unsigned int N = (unsigned int)serial.pos.size();
+        UP_ASSERT(memcmp(serial.pos.data(), threaded.pos.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(memcmp(serial.vel.data(), threaded.vel.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(memcmp(serial.image.data(), threaded.image.data(), sizeof(int3) * N) == 0);
+        UP_ASSERT_EQUAL(serial.reservoir_energy, threaded.reservoir_energy);
+        }
+    }
+
+#ifdef ENABLE_TBB
+//! TwoStepLangevin, including the reservoir energy sum
+UP_TEST(TwoStepLangevin_threads)
+    {
+    integration_method_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleGroup> group)
+        {
+            auto method
+                = std::make_shared<TwoStepLangevin>(sysdef,
+                                                    group,
+                                                    std::make_shared<VariantConstant>(1.5));
+            method->setTallyReservoirEnergy(true);
+            return method;
+        });
+    }
+
+//! TwoStepBD
+UP_TEST(TwoStepBD_threads)
+    {
+    integration_method_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleGroup> group)
+        {
+            return std::make_shared<TwoStepBD>(sysdef,
+                                               group,
+                                               std::make_shared<VariantConstant>(1.5),
+                                               false,
+                                               false);
+        });
+    }
+
+//! TwoStepConstantVolume without a thermostat
+UP_TEST(TwoStepConstantVolume_threads)
+    {
+    integration_method_thread_test(
+        [](std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleGroup> group)
+        { return std::make_shared<TwoStepConstantVolume>(sysdef, group, nullptr); });
+    }
+#endif
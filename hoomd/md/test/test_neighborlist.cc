@@ -12,6 +12,7 @@
 #include "hoomd/Initializers.h"
 #include "hoomd/md/NeighborList.h"
 #include "hoomd/md/NeighborListBinned.h"
+#include "hoomd/md/NeighborListCluster.h"
 #include "hoomd/md/NeighborListStencil.h"
 #include "hoomd/md/NeighborListTree.h"
 
@@ -1146,6 +1147,78 @@ void neighborlist_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_c
         }
     }
 
+#ifdef ENABLE_TBB
+//! Test that a threaded neighbor list build produces the same list as a serial build
+template<class NL> void neighborlist_threaded_test()
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr<SnapshotSystemData<Scalar>> snap = init.getSnapshot();
+
+    std::vector<std::shared_ptr<NeighborList>> nlists;
+    std::vector<std::shared_ptr<SystemDefinition>> sysdefs;
+    for (unsigned int num_threads : {1, 4})
+        {
+        std::shared_ptr<ExecutionConfiguration> exec_conf(
+            new ExecutionConfiguration(ExecutionConfiguration::CPU));
+        exec_conf->setNumThreads(num_threads);
+
+        std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+        std::shared_ptr<NeighborList> nlist(new NL(sysdef, Scalar(0.4)));
+        auto r_cut
+            = std::make_shared<GlobalArray<Scalar>>(nlist->getTypePairIndexer().getNumElements(),
+                                                    exec_conf);
+            {
+            ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+            h_r_cut.data[0] = 3.0;
+            }
+        nlist->addRCutMatrix(r_cut);
+
+        // exclusions exercise the threaded filter pass
+        for (unsigned int i = 0; i < sysdef->getParticleData()->getN() - 2; i++)
+            {
+            nlist->addExclusion(i, i + 1);
+            nlist->addExclusion(i, i + 2);
+            }
+
+        nlist->compute(0);
+        sysdefs.push_back(sysdef);
+        nlists.push_back(nlist);
+        }
+
+    ArrayHandle<unsigned int> h_n_neigh1(nlists[0]->getNNeighArray(),
+                                         access_location::host,
+                                         access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlists[0]->getNListArray(),
+                                       access_location::host,
+                                       access_mode::read);
+    ArrayHandle<size_t> h_head_list1(nlists[0]->getHeadList(),
+                                     access_location::host,
+                                     access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlists[1]->getNNeighArray(),
+                                         access_location::host,
+                                         access_mode::read);
+    ArrayHandle<unsigned int> h_nlist2(nlists[1]->getNListArray(),
+                                       access_location::host,
+                                       access_mode::read);
+    ArrayHandle<size_t> h_head_list2(nlists[1]->getHeadList(),
+                                     access_location::host,
+                                     access_mode::read);
+
+    // the layout and the order of neighbors must be identical
+    for (unsigned int i = 0; i < sysdefs[0]->getParticleData()->getN(); i++)
+        {
+        CHECK_EQUAL_UINT(h_head_list2.data[i], h_head_list1.data[i]);
+        CHECK_EQUAL_UINT(h_n_neigh2.data[i], h_n_neigh1.data[i]);
+        for (unsigned int j = 0; j < h_n_neigh1.data[i]; ++j)
+            {
+            CHECK_EQUAL_UINT(h_nlist2.data[h_head_list2.data[i] + j],
+                             h_nlist1.data[h_head_list1.data[i] + j]);
+            }
+        }
+    }
+#endif
+
 //! Test that a NeighborList can successfully exclude a ridiculously large number of particles
 template<class NL>
 void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1564,6 +1637,13 @@ UP_TEST(NeighborListBinned_2d)
     neighborlist_2d_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(
         new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+#ifdef ENABLE_TBB
+//! threaded build test case for binned class
+UP_TEST(NeighborListBinned_threaded)
+    {
+    neighborlist_threaded_test<NeighborListBinned>();
+    }
+#endif
 
 ////////////////////
 // STENCIL CPU
@@ -1624,6 +1704,13 @@ UP_TEST(NeighborListStencil_comparison)
         std::shared_ptr<ExecutionConfiguration>(
             new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+#ifdef ENABLE_TBB
+//! threaded build test case for stencil class
+UP_TEST(NeighborListStencil_threaded)
+    {
+    neighborlist_threaded_test<NeighborListStencil>();
+    }
+#endif
 
 ///////////////
 // TREE CPU
@@ -1683,6 +1770,79 @@ UP_TEST(NeighborListTree_comparison)
         std::shared_ptr<ExecutionConfiguration>(
             new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+#ifdef ENABLE_TBB
+//! threaded build test case for tree class
+UP_TEST(NeighborListTree_threaded)
+    {
+    neighborlist_threaded_test<NeighborListTree>();
+    }
+#endif
+
+///////////////
+// CLUSTER CPU
+///////////////
+//! basic test case for cluster class
+UP_TEST(NeighborListCluster_basic)
+    {
+    neighborlist_basic_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! exclusion test case for cluster class
+UP_TEST(NeighborListCluster_exclusion)
+    {
+    neighborlist_exclusion_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! large exclusion test case for cluster class
+UP_TEST(NeighborListCluster_large_ex)
+    {
+    neighborlist_large_ex_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! body filter test case for cluster class
+UP_TEST(NeighborListCluster_body_filter)
+    {
+    neighborlist_body_filter_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! particle asymmetry test case for cluster class
+UP_TEST(NeighborListCluster_particle_asymm)
+    {
+    neighborlist_particle_asymm_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! cutoff exclusion test case for cluster class
+UP_TEST(NeighborListCluster_cutoff_exclude)
+    {
+    neighborlist_cutoff_exclude_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! type test case for cluster class
+UP_TEST(NeighborListCluster_type)
+    {
+    neighborlist_type_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! 2d tests for cluster class
+UP_TEST(NeighborListCluster_2d)
+    {
+    neighborlist_2d_tests<NeighborListCluster>(std::shared_ptr<ExecutionConfiguration>(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! comparison test case for cluster class
+UP_TEST(NeighborListCluster_comparison)
+    {
+    neighborlist_comparison_test<NeighborListBinned, NeighborListCluster>(
+        std::shared_ptr<ExecutionConfiguration>(
+            new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#ifdef ENABLE_TBB
+//! threaded build test case for cluster class
+UP_TEST(NeighborListCluster_threaded)
+    {
+    neighborlist_threaded_test<NeighborListCluster>();
+    }
+#endif
 
 #ifdef ENABLE_HIP
 ///////////////
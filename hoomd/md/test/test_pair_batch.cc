@@ -0,0 +1,265 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/EvaluatorPairExpandedLJ.h"
+#include "hoomd/md/EvaluatorPairGauss.h"
+#include "hoomd/md/EvaluatorPairLJ.h"
+#include "hoomd/md/EvaluatorPairMorse.h"
+#include "hoomd/md/EvaluatorPairTable.h"
+#include "hoomd/md/NeighborListCluster.h"
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/PotentialPair.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_pair_batch.cc
+    \brief Checks that evalForceAndEnergyBatch() matches the per pair evaluator
+    \ingroup unit_tests
+*/
+
+//! Check that a batch result matches the per pair result
+void check_batch_value(Scalar batch, Scalar scalar)
+    {
+    UP_ASSERT(std::abs(batch - scalar) <= tol_small * std::max(Scalar(1.0), std::abs(scalar)));
+    }
+
+//! Compare evalForceAndEnergyBatch<width>() to evalForceAndEnergy() pair by pair
+/*! \param params Parameters of the type pairs
+    \param r_cut Cutoff radius
+
+    The pairs sweep r from inside the core to beyond r_cut and cycle through the parameters. Every
+    fifth pair has rcutsq = 0, like the masked lanes of a cluster pair batch.
+*/
+template<class evaluator, unsigned int width>
+void batch_evaluator_test(const std::vector<typename evaluator::param_type>& params, Scalar r_cut)
+    {
+    const unsigned int n_batches = 32;
+    const unsigned int n = width * n_batches;
+
+    std::vector<Scalar> rsq(n);
+    std::vector<Scalar> rcutsq(n);
+    std::vector<unsigned int> param_idx(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+        Scalar r = Scalar(0.6) + Scalar(0.7) * r_cut * Scalar(i) / Scalar(n);
+        rsq[i] = r * r;
+        rcutsq[i] = (i % 5 == 4) ? Scalar(0.0) : r_cut * r_cut;
+        param_idx[i] = (i / 3) % params.size();
+        }
+
+    for (bool energy_shift : {false, true})
+        {
+        std::vector<Scalar> force_divr(n);
+        std::vector<Scalar> pair_eng(n);
+        for (unsigned int b = 0; b < n_batches; b++)
+            {
+            evaluator::template evalForceAndEnergyBatch<width>(&rsq[b * width],
+                                                               &rcutsq[b * width],
+                                                               &param_idx[b * width],
+                                                               params.data(),
+                                                               &force_divr[b * width],
+                                                               &pair_eng[b * width],
+                                                               energy_shift);
+            }
+
+        for (unsigned int i = 0; i < n; i++)
+            {
+            Scalar scalar_force_divr = Scalar(0.0);
+            Scalar scalar_pair_eng = Scalar(0.0);
+            evaluator eval(rsq[i], rcutsq[i], params[param_idx[i]]);
+            eval.evalForceAndEnergy(scalar_force_divr, scalar_pair_eng, energy_shift);
+
+            check_batch_value(force_divr[i], scalar_force_divr);
+            check_batch_value(pair_eng[i], scalar_pair_eng);
+            }
+        }
+    }
+
+//! Per particle forces, energies and virials of a pair potential
+struct pair_result
+    {
+    std::vector<Scalar3> force;
+    std::vector<Scalar> energy;
+    std::vector<Scalar> virial;
+    };
+
+//! Compute a pair potential on a jittered lattice of two particle types
+/*! \param params Parameters of the type pairs (0,0), (0,1) and (1,1)
+    \param r_cut Cutoff radius
+    \param use_batch Use the shift mode, which takes the batch path, or the xplor mode with
+           r_on > r_cut, which gives the same potential with the per pair evaluator
+*/
+template<class evaluator, class nlist_type>
+pair_result run_pair_potential(const std::vector<typename evaluator::param_type>& params,
+                               Scalar r_cut,
+                               bool use_batch)
+    {
+    const unsigned int n_side = 12;
+    const unsigned int N = n_side * n_side * n_side;
+    const Scalar a = Scalar(1.1);
+    const Scalar L = a * Scalar(n_side);
+    const Scalar lo = (a - L) / Scalar(2.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int ix = i % n_side;
+            unsigned int iy = (i / n_side) % n_side;
+            unsigned int iz = i / (n_side * n_side);
+            Scalar jitter_x = Scalar((i * 7919) % 101) / Scalar(101.0) - Scalar(0.5);
+            Scalar jitter_y = Scalar((i * 104729) % 103) / Scalar(103.0) - Scalar(0.5);
+            Scalar jitter_z = Scalar((i * 1299709) % 107) / Scalar(107.0) - Scalar(0.5);
+            h_pos.data[i].x = lo + a * (Scalar(ix) + Scalar(0.2) * jitter_x);
+            h_pos.data[i].y = lo + a * (Scalar(iy) + Scalar(0.2) * jitter_y);
+            h_pos.data[i].z = lo + a * (Scalar(iz) + Scalar(0.2) * jitter_z);
+            h_pos.data[i].w = __int_as_scalar(i % 3 == 0 ? 1 : 0);
+            }
+        }
+
+    std::shared_ptr<NeighborList> nlist(new nlist_type(sysdef, Scalar(0.3)));
+    std::shared_ptr<PotentialPair<evaluator>> pair(new PotentialPair<evaluator>(sysdef, nlist));
+    pair->setParams(0, 0, params[0]);
+    pair->setParams(0, 1, params[1]);
+    pair->setParams(1, 1, params[2]);
+    for (unsigned int typ1 = 0; typ1 < 2; typ1++)
+        {
+        for (unsigned int typ2 = typ1; typ2 < 2; typ2++)
+            {
+            pair->setRcut(typ1, typ2, r_cut);
+            pair->setRon(typ1, typ2, Scalar(2.0) * r_cut);
+            }
+        }
+    pair->setShiftMode(use_batch ? PotentialPair<evaluator>::shift
+                                 : PotentialPair<evaluator>::xplor);
+    pair->compute(0);
+
+    pair_result result;
+    ArrayHandle<Scalar4> h_force(pair->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(pair->getVirialArray(), access_location::host, access_mode::read);
+    const size_t pitch = pair->getVirialArray().getPitch();
+    for (unsigned int i = 0; i < N; i++)
+        {
+        result.force.push_back(
+            make_scalar3(h_force.data[i].x, h_force.data[i].y, h_force.data[i].z));
+        result.energy.push_back(h_force.data[i].w);
+        for (unsigned int k = 0; k < 6; k++)
+            result.virial.push_back(h_virial.data[k * pitch + i]);
+        }
+    return result;
+    }
+
+//! Compare the forces, energies and virials of the batch path and the per pair path
+template<class evaluator, class nlist_type>
+void batch_potential_test(const std::vector<typename evaluator::param_type>& params, Scalar r_cut)
+    {
+    pair_result batch = run_pair_potential<evaluator, nlist_type>(params, r_cut, true);
+    pair_result scalar = run_pair_potential<evaluator, nlist_type>(params, r_cut, false);
+
+    for (unsigned int i = 0; i < batch.energy.size(); i++)
+        {
+        check_batch_value(batch.force[i].x, scalar.force[i].x);
+        check_batch_value(batch.force[i].y, scalar.force[i].y);
+        check_batch_value(batch.force[i].z, scalar.force[i].z);
+        check_batch_value(batch.energy[i], scalar.energy[i]);
+        }
+    for (unsigned int i = 0; i < batch.virial.size(); i++)
+        check_batch_value(batch.virial[i], scalar.virial[i]);
+    }
+
+//! Run the evaluator and potential comparisons for one evaluator
+template<class evaluator>
+void batch_test(const std::vector<typename evaluator::param_type>& params, Scalar r_cut)
+    {
+    batch_evaluator_test<evaluator, 4>(params, r_cut);
+    batch_evaluator_test<evaluator, 16>(params, r_cut);
+    batch_potential_test<evaluator, NeighborListTree>(params, r_cut);
+    batch_potential_test<evaluator, NeighborListCluster>(params, r_cut);
+    }
+
+//! EvaluatorPairLJ, including a type pair with epsilon = 0
+UP_TEST(lj_batch)
+    {
+    batch_test<EvaluatorPairLJ>({EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)),
+                                 EvaluatorPairLJ::param_type(Scalar(0.9), Scalar(1.5)),
+                                 EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(0.0))},
+                                Scalar(2.5));
+    }
+
+//! EvaluatorPairExpandedLJ
+UP_TEST(expanded_lj_batch)
+    {
+    typedef EvaluatorPairExpandedLJ::param_type param_type;
+    batch_test<EvaluatorPairExpandedLJ>({param_type(Scalar(1.0), Scalar(1.0), Scalar(0.0)),
+                                         param_type(Scalar(0.8), Scalar(1.5), Scalar(0.2)),
+                                         param_type(Scalar(0.9), Scalar(0.5), Scalar(-0.1))},
+                                        Scalar(2.5));
+    }
+
+//! EvaluatorPairGauss
+UP_TEST(gauss_batch)
+    {
+    typedef EvaluatorPairGauss::param_type param_type;
+    batch_test<EvaluatorPairGauss>({param_type(Scalar(1.0), Scalar(0.5)),
+                                    param_type(Scalar(2.0), Scalar(0.75)),
+                                    param_type(Scalar(-0.5), Scalar(1.0))},
+                                   Scalar(3.0));
+    }
+
+//! EvaluatorPairMorse
+UP_TEST(morse_batch)
+    {
+    typedef EvaluatorPairMorse::param_type param_type;
+    batch_test<EvaluatorPairMorse>({param_type(Scalar(1.0), Scalar(3.0), Scalar(1.0)),
+                                    param_type(Scalar(2.0), Scalar(2.0), Scalar(1.1)),
+                                    param_type(Scalar(0.5), Scalar(4.0), Scalar(0.9))},
+                                   Scalar(2.5));
+    }
+
+//! Make a table of V(r) = epsilon * (2 - r)^2 for r in [r_min, r_cut)
+EvaluatorPairTable::param_type make_table(Scalar epsilon, Scalar r_min, Scalar r_cut)
+    {
+    const unsigned int width = 200;
+    EvaluatorPairTable::param_type param;
+    param.rmin = r_min;
+    param.V_table = ManagedArray<Scalar>(width, false);
+    param.F_table = ManagedArray<Scalar>(width, false);
+    for (unsigned int i = 0; i < width; i++)
+        {
+        Scalar r = r_min + (r_cut - r_min) * Scalar(i) / Scalar(width);
+        param.V_table[i] = epsilon * (Scalar(2.0) - r) * (Scalar(2.0) - r);
+        param.F_table[i] = Scalar(2.0) * epsilon * (Scalar(2.0) - r);
+        }
+    return param;
+    }
+
+//! EvaluatorPairTable, including pairs below r_min
+UP_TEST(table_batch)
+    {
+    const Scalar r_cut = Scalar(2.5);
+    batch_test<EvaluatorPairTable>({make_table(Scalar(1.0), Scalar(0.8), r_cut),
+                                    make_table(Scalar(2.0), Scalar(0.7), r_cut),
+                                    make_table(Scalar(0.5), Scalar(0.9), r_cut)},
+                                   r_cut);
+    }
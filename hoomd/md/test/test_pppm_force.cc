@@ -259,6 +259,28 @@ UP_TEST(PPPMForceCompute_triclinic)
             new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifdef ENABLE_TBB
+//! test case for threaded particle test on CPU
+UP_TEST(PPPMForceCompute_threaded)
+    {
+    pppmforce_creator pppm_creator = bind(base_class_pppm_creator, _1, _2, _3);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(4);
+    pppm_force_particle_test(pppm_creator, exec_conf);
+    }
+
+//! test case for threaded particle test on CPU with a triclinic box
+UP_TEST(PPPMForceCompute_triclinic_threaded)
+    {
+    pppmforce_creator pppm_creator = bind(base_class_pppm_creator, _1, _2, _3);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(4);
+    pppm_force_particle_test_triclinic(pppm_creator, exec_conf);
+    }
+#endif
+
 #ifdef ENABLE_HIP
 //! test case for bond forces on the GPU
 UP_TEST(PPPMForceComputeGPU_basic)
@@ -0,0 +1,192 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/EvaluatorRevCross.h"
+#include "hoomd/md/EvaluatorSquareDensity.h"
+#include "hoomd/md/EvaluatorTersoff.h"
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/PotentialTersoff.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_tersoff_threads.cc
+    \brief Checks the threaded CPU three-body potentials against the serial code path
+    \ingroup unit_tests
+*/
+
+//! Per particle forces, energies and virials of a three-body potential
+struct three_body_result
+    {
+    std::vector<Scalar4> force;
+    std::vector<Scalar> virial;
+    };
+
+//! Compute a three-body potential on a jittered cubic lattice with \a num_threads CPU threads
+/*! \param param Parameters of the single type pair
+    \param r_cut Cutoff radius
+    \param num_threads Number of CPU threads
+
+    The 8000 particles span many chunks of the threaded code path and every particle has neighbors
+    in other chunks, so neighboring chunks write to the same particles.
+*/
+template<class evaluator>
+three_body_result run_three_body(const typename evaluator::param_type& param,
+                                 Scalar r_cut,
+                                 unsigned int num_threads)
+    {
+    const unsigned int n_side = 20;
+    const unsigned int N = n_side * n_side * n_side;
+    const Scalar a = Scalar(1.1);
+    const Scalar L = a * Scalar(n_side);
+    const Scalar lo = (a - L) / Scalar(2.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(num_threads);
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int ix = i % n_side;
+            unsigned int iy = (i / n_side) % n_side;
+            unsigned int iz = i / (n_side * n_side);
+            Scalar jitter_x = Scalar((i * 7919) % 101) / Scalar(101.0) - Scalar(0.5);
+            Scalar jitter_y = Scalar((i * 104729) % 103) / Scalar(103.0) - Scalar(0.5);
+            Scalar jitter_z = Scalar((i * 1299709) % 107) / Scalar(107.0) - Scalar(0.5);
+            h_pos.data[i].x = lo + a * (Scalar(ix) + Scalar(0.2) * jitter_x);
+            h_pos.data[i].y = lo + a * (Scalar(iy) + Scalar(0.2) * jitter_y);
+            h_pos.data[i].z = lo + a * (Scalar(iz) + Scalar(0.2) * jitter_z);
+            h_pos.data[i].w = __int_as_scalar(0);
+            }
+        }
+
+    std::shared_ptr<NeighborList> nlist(new NeighborListTree(sysdef, Scalar(0.3)));
+    nlist->setStorageMode(NeighborList::full);
+    std::shared_ptr<PotentialTersoff<evaluator>> potential(
+        new PotentialTersoff<evaluator>(sysdef, nlist));
+    potential->setParams(0, 0, param);
+    potential->setRcut(0, 0, r_cut);
+    potential->compute(0);
+
+    three_body_result result;
+    ArrayHandle<Scalar4> h_force(potential->getForceArray(),
+                                 access_location::host,
+                                 access_mode::read);
+    ArrayHandle<Scalar> h_virial(potential->getVirialArray(),
+                                 access_location::host,
+                                 access_mode::read);
+    const size_t pitch = potential->getVirialArray().getPitch();
+    result.force.assign(h_force.data, h_force.data + N);
+    for (unsigned int k = 0; k < 6; k++)
+        result.virial.insert(result.virial.end(),
+                             h_virial.data + k * pitch,
+                             h_virial.data + k * pitch + N);
+    return result;
+    }
+
+//! Check that a threaded value matches the serial value to within round off
+void check_threaded_value(Scalar threaded, Scalar serial)
+    {
+    UP_ASSERT(std::abs(threaded - serial) <= tol_small * std::max(Scalar(1.0), std::abs(serial)));
+    }
+
+//! Compare the threaded code path with 2, 3 and 8 threads to the serial code path
+/*! The threaded sums are associated by chunk, so they match the serial sums to within round off
+    and are bitwise reproducible for a given number of threads.
+*/
+template<class evaluator>
+void three_body_thread_test(const typename evaluator::param_type& param, Scalar r_cut)
+    {
+    three_body_result serial = run_three_body<evaluator>(param, r_cut, 1);
+    const unsigned int N = (unsigned int)serial.force.size();
+
+    // the test system must give nonzero forces and energies
+    Scalar max_force = 0;
+    Scalar max_energy = 0;
+    for (const Scalar4& f : serial.force)
+        {
+        max_force = std::max(max_force, std::abs(f.x) + std::abs(f.y) + std::abs(f.z));
+        max_energy = std::max(max_energy, std::abs(f.w));
+        }
+    UP_ASSERT(max_force > Scalar(1e-3));
+    UP_ASSERT(max_energy > Scalar(1e-3));
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        three_body_result threaded = run_three_body<evaluator>(param, r_cut, num_threads);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            check_threaded_value(threaded.force[i].x, serial.force[i].x);
+            check_threaded_value(threaded.force[i].y, serial.force[i].y);
+            check_threaded_value(threaded.force[i].z, serial.force[i].z);
+            check_threaded_value(threaded.force[i].w, serial.force[i].w);
+            }
+        for (unsigned int i = 0; i < 6 * N; i++)
+            check_threaded_value(threaded.virial[i], serial.virial[i]);
+
+        three_body_result repeat = run_three_body<evaluator>(param, r_cut, num_threads);
+        UP_ASSERT(memcmp(threaded.force.data(), repeat.force.data(), sizeof(Scalar4) * N) == 0);
+        UP_ASSERT(memcmp(threaded.virial.data(), repeat.virial.data(), sizeof(Scalar) * 6 * N)
+                  == 0);
+        }
+    }
+
+#ifdef ENABLE_TBB
+//! EvaluatorTersoff
+UP_TEST(tersoff_threads)
+    {
+    // the parameters as param_type(dict) stores them: alpha negated, gamma^n, lambda3^3, c^2, d^2
+    EvaluatorTersoff::param_type param;
+    param.cutoff_thickness = Scalar(0.3);
+    param.coeffs = make_scalar2(Scalar(5.0), Scalar(2.0));
+    param.exp_consts = make_scalar2(Scalar(2.0), Scalar(1.0));
+    param.dimer_r = Scalar(1.1);
+    param.tersoff_n = Scalar(2.0);
+    param.gamman = Scalar(0.25);
+    param.lambda_cube = Scalar(0.125);
+    param.ang_consts = make_scalar3(Scalar(1.0), Scalar(4.0), Scalar(0.5));
+    param.alpha = Scalar(-3.0);
+    three_body_thread_test<EvaluatorTersoff>(param, Scalar(1.6));
+    }
+
+//! EvaluatorSquareDensity
+UP_TEST(square_density_threads)
+    {
+    EvaluatorSquareDensity::param_type param;
+    param.A = Scalar(5.0);
+    param.B = Scalar(2.0);
+    three_body_thread_test<EvaluatorSquareDensity>(param, Scalar(1.6));
+    }
+
+//! EvaluatorRevCross
+UP_TEST(revcross_threads)
+    {
+    EvaluatorRevCross::param_type param;
+    param.sigma = Scalar(1.0);
+    param.n = Scalar(12.0);
+    param.epsilon = Scalar(1.0);
+    param.lambda3 = Scalar(2.0);
+    three_body_thread_test<EvaluatorRevCross>(param, Scalar(1.6));
+    }
+#endif
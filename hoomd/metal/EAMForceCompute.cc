@@ -294,6 +294,17 @@ void EAMForceCompute::interpolation(int num_all,
  */
 void EAMForceCompute::computeForces(uint64_t timestep)
     {
+#ifdef ENABLE_TBB
+    // the threaded passes need a full neighbor list, check every step because the number of
+    // threads may change after construction
+    if (m_exec_conf->getNumThreads() > 1 && m_nlist->getStorageMode() == md::NeighborList::half)
+        {
+        m_exec_conf->msg->notice(2)
+            << "EAM: using a full neighbor list for the threaded CPU force computation" << endl;
+        m_nlist->setStorageMode(md::NeighborList::full);
+        }
+#endif
+
     // start by updating the neighborlist
     m_nlist->compute(timestep);
 
@@ -327,13 +338,6 @@ void EAMForceCompute::computeForces(uint64_t timestep)
     ArrayHandle<Scalar4> h_rphi(m_rphi, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_drphi(m_drphi, access_location::host, access_mode::read);
 
-    // index and remainder
-    Scalar position;           // look up position, scalar
-    unsigned int int_position; // look up index for position, integer
-    unsigned int idxs;         // look up index in F, rho, rphi array, considering shift, integer
-    Scalar remainder;          // look up remainder in array, integer
-    Scalar4 v, dv;             // value, d(value)
-
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
@@ -364,192 +368,247 @@ void EAMForceCompute::computeForces(uint64_t timestep)
     atomEmbeddingFunction.resize(m_pdata->getN());
     unsigned int ntypes = m_pdata->getNTypes();
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        // access the particle's position and type
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        const size_t head_i = h_head_list.data[i];
-
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
-
-        // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-
-        for (unsigned int j = 0; j < size; j++)
+    // accumulate the electron density P of particles [first, last)
+    auto density_range = [&](unsigned int first, unsigned int last)
+    {
+        // index and remainder
+        Scalar position;           // look up position, scalar
+        unsigned int int_position; // look up index for position, integer
+        unsigned int idxs;         // look up index in F, rho, rphi array, considering shift
+        Scalar remainder;          // look up remainder in array, integer
+        Scalar4 v;                 // value
+
+        for (unsigned int i = first; i < last; i++)
             {
-            // access the index of this neighbor
-            unsigned int k = h_nlist.data[head_i + j];
-            // sanity check
-            assert(k < m_pdata->getN());
-
-            // calculate dr
-            Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
-            Scalar3 dx = pi - pk;
+            // access the particle's position and type
+            Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            const size_t head_i = h_head_list.data[i];
 
-            // access the type of the neighbor particle
-            unsigned int typej = __scalar_as_int(h_pos.data[k].w);
             // sanity check
-            assert(typej < m_pdata->getNTypes());
+            assert(typei < m_pdata->getNTypes());
 
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
+            // loop over all of the neighbors of this particle
+            const unsigned int size = (unsigned int)h_n_neigh.data[i];
 
-            // start computing the force
-            // calculate r squared
-            Scalar rsq = dot(dx, dx);
-            ;
-            // only compute the force if the particles are closer than the cut-off
-            if (rsq < r_cut_sq)
+            for (unsigned int j = 0; j < size; j++)
                 {
-                // calculate position r for rho(r)
-                position = sqrt(rsq) * rdr;
-                int_position = (unsigned int)position;
-                int_position = min(int_position, nr - 1);
-                remainder = position - int_position;
-                // calculate P = sum{rho}
-                idxs = int_position + nr * (typej * ntypes + typei);
-                v = h_rho.data[idxs];
-                atomElectronDensity[i] += v.w + v.z * remainder + v.y * remainder * remainder
-                                          + v.x * remainder * remainder * remainder;
-                // if third_law, pair it
-                if (third_law)
+                // access the index of this neighbor
+                unsigned int k = h_nlist.data[head_i + j];
+                // sanity check
+                assert(k < m_pdata->getN());
+
+                // calculate dr
+                Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
+                Scalar3 dx = pi - pk;
+
+                // access the type of the neighbor particle
+                unsigned int typej = __scalar_as_int(h_pos.data[k].w);
+                // sanity check
+                assert(typej < m_pdata->getNTypes());
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
+
+                // start computing the force
+                // calculate r squared
+                Scalar rsq = dot(dx, dx);
+                ;
+                // only compute the force if the particles are closer than the cut-off
+                if (rsq < r_cut_sq)
                     {
-                    idxs = int_position + nr * (typei * ntypes + typej);
+                    // calculate position r for rho(r)
+                    position = sqrt(rsq) * rdr;
+                    int_position = (unsigned int)position;
+                    int_position = min(int_position, nr - 1);
+                    remainder = position - int_position;
+                    // calculate P = sum{rho}
+                    idxs = int_position + nr * (typej * ntypes + typei);
                     v = h_rho.data[idxs];
-                    atomElectronDensity[k] += v.w + v.z * remainder + v.y * remainder * remainder
+                    atomElectronDensity[i] += v.w + v.z * remainder + v.y * remainder * remainder
                                               + v.x * remainder * remainder * remainder;
+                    // if third_law, pair it
+                    if (third_law)
+                        {
+                        idxs = int_position + nr * (typei * ntypes + typej);
+                        v = h_rho.data[idxs];
+                        atomElectronDensity[k] += v.w + v.z * remainder
+                                                  + v.y * remainder * remainder
+                                                  + v.x * remainder * remainder * remainder;
+                        }
                     }
                 }
             }
-        }
+    };
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        // calculate position rho for F(rho)
-        position = atomElectronDensity[i] * rdrho;
-        int_position = (unsigned int)position;
-        int_position = min(int_position, nrho - 1);
-        remainder = position - int_position;
-
-        idxs = int_position + typei * nrho;
-        v = h_F.data[idxs];
-        dv = h_dF.data[idxs];
-        // compute dF / dP
-        atomDerivativeEmbeddingFunction[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
-        // compute embedded energy F(P), sum up each particle
-        h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
-                             + v.x * remainder * remainder * remainder;
-        }
-
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        // access the particle's position and type
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        const size_t head_i = h_head_list.data[i];
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
-
-        // initialize current particle force, potential energy, and virial to 0
-        Scalar fxi = 0.0;
-        Scalar fyi = 0.0;
-        Scalar fzi = 0.0;
-        Scalar pei = 0.0;
-        Scalar viriali[6];
-        for (int k = 0; k < 6; k++)
-            viriali[k] = 0.0;
-
-        // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-        for (unsigned int j = 0; j < size; j++)
+    // evaluate the embedding function F(P) and dF/dP of particles [first, last)
+    auto embedding_range = [&](unsigned int first, unsigned int last)
+    {
+        // index and remainder
+        Scalar position;           // look up position, scalar
+        unsigned int int_position; // look up index for position, integer
+        unsigned int idxs;         // look up index in F, rho, rphi array, considering shift
+        Scalar remainder;          // look up remainder in array, integer
+        Scalar4 v, dv;             // value, d(value)
+
+        for (unsigned int i = first; i < last; i++)
             {
-            // access the index of this neighbor
-            unsigned int k = h_nlist.data[head_i + j];
-            // sanity check
-            assert(k < m_pdata->getN());
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            // calculate position rho for F(rho)
+            position = atomElectronDensity[i] * rdrho;
+            int_position = (unsigned int)position;
+            int_position = min(int_position, nrho - 1);
+            remainder = position - int_position;
 
-            // calculate \Delta r
-            Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
-            Scalar3 dx = pi - pk;
+            idxs = int_position + typei * nrho;
+            v = h_F.data[idxs];
+            dv = h_dF.data[idxs];
+            // compute dF / dP
+            atomDerivativeEmbeddingFunction[i]
+                = dv.z + dv.y * remainder + dv.x * remainder * remainder;
+            // compute embedded energy F(P), sum up each particle
+            h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
+                                 + v.x * remainder * remainder * remainder;
+            }
+    };
 
-            // access the type of the neighbor particle
-            unsigned int typej = __scalar_as_int(h_pos.data[k].w);
+    // compute the pair and embedding forces on particles [first, last)
+    auto force_range = [&](unsigned int first, unsigned int last)
+    {
+        // index and remainder
+        Scalar position;           // look up position, scalar
+        unsigned int int_position; // look up index for position, integer
+        unsigned int idxs;         // look up index in F, rho, rphi array, considering shift
+        Scalar remainder;          // look up remainder in array, integer
+        Scalar4 v, dv;             // value, d(value)
+
+        for (unsigned int i = first; i < last; i++)
+            {
+            // access the particle's position and type
+            Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            const size_t head_i = h_head_list.data[i];
             // sanity check
-            assert(typej < m_pdata->getNTypes());
-
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // start computing the force
-            // calculate r squared
-            Scalar rsq = dot(dx, dx);
-
-            // calculate position r for phi(r)
-            if (rsq >= r_cut_sq)
-                continue;
-            Scalar r = sqrt(rsq);
-            Scalar inverseR = 1.0 / r;
-            position = r * rdr;
-            int_position = (unsigned int)position;
-            int_position = min(int_position, nr - 1);
-            remainder = position - int_position;
-            // calculate the shift position for type ij
-            int shift = (typei >= typej)
-                            ? (int)(0.5 * (2 * ntypes - typej - 1) * typej + typei) * nr
-                            : (int)(0.5 * (2 * ntypes - typei - 1) * typei + typej) * nr;
-
-            idxs = int_position + shift;
-            v = h_rphi.data[idxs];
-            dv = h_drphi.data[idxs];
-            // pair_eng = phi
-            Scalar pair_eng = (v.w + v.z * remainder + v.y * remainder * remainder
-                               + v.x * remainder * remainder * remainder)
-                              * inverseR;
-            // derivativePhi = (phi + r * dphi/dr - phi) * 1/r = dphi / dr
-            Scalar derivativePhi
-                = (dv.z + dv.y * remainder + dv.x * remainder * remainder - pair_eng) * inverseR;
-            // derivativeRhoI = drho / dr of i
-            idxs = int_position + typei * ntypes * nr + typej * nr;
-            dv = h_drho.data[idxs];
-            Scalar derivativeRhoI = dv.z + dv.y * remainder + dv.x * remainder * remainder;
-            // derivativeRhoJ = drho / dr of j
-            idxs = int_position + typej * ntypes * nr + typei * nr;
-            dv = h_drho.data[idxs];
-            Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
-            // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
-            Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ
-                                       + atomDerivativeEmbeddingFunction[k] * derivativeRhoI
-                                       + derivativePhi;
-            // compute forces
-            Scalar pairForce = -fullDerivativePhi * inverseR;
-            viriali[0] += dx.x * dx.x * pairForce;
-            viriali[1] += dx.x * dx.y * pairForce;
-            viriali[2] += dx.x * dx.z * pairForce;
-            viriali[3] += dx.y * dx.y * pairForce;
-            viriali[4] += dx.y * dx.z * pairForce;
-            viriali[5] += dx.z * dx.z * pairForce;
-            fxi += dx.x * pairForce;
-            fyi += dx.y * pairForce;
-            fzi += dx.z * pairForce;
-            pei += pair_eng * 0.5;
-
-            if (third_law)
+            assert(typei < m_pdata->getNTypes());
+
+            // initialize current particle force, potential energy, and virial to 0
+            Scalar fxi = 0.0;
+            Scalar fyi = 0.0;
+            Scalar fzi = 0.0;
+            Scalar pei = 0.0;
+            Scalar viriali[6];
+            for (int k = 0; k < 6; k++)
+                viriali[k] = 0.0;
+
+            // loop over all of the neighbors of this particle
+            const unsigned int size = (unsigned int)h_n_neigh.data[i];
+            for (unsigned int j = 0; j < size; j++)
                 {
-                h_force.data[k].x -= dx.x * pairForce;
-                h_force.data[k].y -= dx.y * pairForce;
-                h_force.data[k].z -= dx.z * pairForce;
-                h_force.data[k].w += pair_eng * 0.5;
+                // access the index of this neighbor
+                unsigned int k = h_nlist.data[head_i + j];
+                // sanity check
+                assert(k < m_pdata->getN());
+
+                // calculate \Delta r
+                Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
+                Scalar3 dx = pi - pk;
+
+                // access the type of the neighbor particle
+                unsigned int typej = __scalar_as_int(h_pos.data[k].w);
+                // sanity check
+                assert(typej < m_pdata->getNTypes());
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
+
+                // start computing the force
+                // calculate r squared
+                Scalar rsq = dot(dx, dx);
+
+                // calculate position r for phi(r)
+                if (rsq >= r_cut_sq)
+                    continue;
+                Scalar r = sqrt(rsq);
+                Scalar inverseR = 1.0 / r;
+                position = r * rdr;
+                int_position = (unsigned int)position;
+                int_position = min(int_position, nr - 1);
+                remainder = position - int_position;
+                // calculate the shift position for type ij
+                int shift = (typei >= typej)
+                                ? (int)(0.5 * (2 * ntypes - typej - 1) * typej + typei) * nr
+                                : (int)(0.5 * (2 * ntypes - typei - 1) * typei + typej) * nr;
+
+                idxs = int_position + shift;
+                v = h_rphi.data[idxs];
+                dv = h_drphi.data[idxs];
+                // pair_eng = phi
+                Scalar pair_eng = (v.w + v.z * remainder + v.y * remainder * remainder
+                                   + v.x * remainder * remainder * remainder)
+                                  * inverseR;
+                // derivativePhi = (phi + r * dphi/dr - phi) * 1/r = dphi / dr
+                Scalar derivativePhi
+                    = (dv.z + dv.y * remainder + dv.x * remainder * remainder - pair_eng)
+                      * inverseR;
+                // derivativeRhoI = drho / dr of i
+                idxs = int_position + typei * ntypes * nr + typej * nr;
+                dv = h_drho.data[idxs];
+                Scalar derivativeRhoI = dv.z + dv.y * remainder + dv.x * remainder * remainder;
+                // derivativeRhoJ = drho / dr of j
+                idxs = int_position + typej * ntypes * nr + typei * nr;
+                dv = h_drho.data[idxs];
+                Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
+                // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
+                Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ
+                                           + atomDerivativeEmbeddingFunction[k] * derivativeRhoI
+                                           + derivativePhi;
+                // compute forces
+                Scalar pairForce = -fullDerivativePhi * inverseR;
+                viriali[0] += dx.x * dx.x * pairForce;
+                viriali[1] += dx.x * dx.y * pairForce;
+                viriali[2] += dx.x * dx.z * pairForce;
+                viriali[3] += dx.y * dx.y * pairForce;
+                viriali[4] += dx.y * dx.z * pairForce;
+                viriali[5] += dx.z * dx.z * pairForce;
+                fxi += dx.x * pairForce;
+                fyi += dx.y * pairForce;
+                fzi += dx.z * pairForce;
+                pei += pair_eng * 0.5;
+
+                if (third_law)
+                    {
+                    h_force.data[k].x -= dx.x * pairForce;
+                    h_force.data[k].y -= dx.y * pairForce;
+                    h_force.data[k].z -= dx.z * pairForce;
+                    h_force.data[k].w += pair_eng * 0.5;
+                    }
                 }
+            h_force.data[i].x += fxi;
+            h_force.data[i].y += fyi;
+            h_force.data[i].z += fzi;
+            h_force.data[i].w += pei;
+            // a full neighbor list visits every pair twice, split the pair virial between i and j
+            const Scalar virial_factor = third_law ? Scalar(1.0) : Scalar(0.5);
+            for (int k = 0; k < 6; k++)
+                h_virial.data[k * virial_pitch + i] += virial_factor * viriali[k];
             }
-        h_force.data[i].x += fxi;
-        h_force.data[i].y += fyi;
-        h_force.data[i].z += fzi;
-        h_force.data[i].w += pei;
-        for (int k = 0; k < 6; k++)
-            h_virial.data[k * virial_pitch + i] += viriali[k];
+    };
+
+    const unsigned int N = m_pdata->getN();
+
+    if (third_law)
+        {
+        // a half neighbor list scatters to the neighbors, so the passes run serially
+        density_range(0, N);
+        embedding_range(0, N);
+        force_range(0, N);
+        }
+    else
+        {
+        // with a full neighbor list, each pass writes only to the particles in its own range
+        hoomd::detail::forEachRange(*m_exec_conf, N, density_range);
+        hoomd::detail::forEachRange(*m_exec_conf, N, embedding_range);
+        hoomd::detail::forEachRange(*m_exec_conf, N, force_range);
         }
     }
 
@@ -1,6 +1,7 @@
 // Copyright (c) 2009-2024 The Regents of the University of Michigan.
 // Part of HOOMD-blue, released under the BSD 3-Clause License.
 
+#include "hoomd/ForEachRange.h"
 #include "hoomd/ForceCompute.h"
 #include "hoomd/md/NeighborList.h"
 
@@ -43,6 +44,13 @@ namespace metal
  h_dF.data[100].z, h_dF.data[100].y, h_dF.data[100].x, are for interpolating derivative embedded
  function.
 
+ \b Threading
+ With a full neighbor list, the density, embedding, and force passes each run in parallel over
+ particles. Every pass writes only to the particles it owns, so the result does not depend on the
+ number of threads. The threaded passes cover only full neighbor lists: whenever more than one CPU
+ thread is in use, computeForces() switches a half neighbor list to full storage. With one thread, a
+ half neighbor list runs the serial passes.
+
  \ingroup computes
  */
 class EAMForceCompute : public ForceCompute
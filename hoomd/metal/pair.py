@@ -41,6 +41,11 @@ class eam(force._force):
     .. attention::
         EAM is **NOT** supported in MPI parallel simulations.
 
+    Note:
+        With more than one CPU thread, :py:class:`eam` switches *nlist* to full
+        storage the next time it computes forces. Only the full neighbor list
+        computation runs in parallel.
+
     Example::
 
         nl = nlist.cell()
@@ -85,6 +90,8 @@ class eam(force._force):
 
         #Load neighbor list to compute.
         self.cpp_force.set_neighbor_list(self.nlist.cpp_nlist)
+        # the GPU implementation needs a full neighbor list, the CPU compute
+        # requests one itself whenever it runs with more than one thread
         if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
             self.nlist.cpp_nlist.setStorageMode(
                 _md.NeighborList.storageMode.full)
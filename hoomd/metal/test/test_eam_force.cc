@@ -0,0 +1,198 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "hoomd/metal/EAMForceCompute.h"
+#include "hoomd/md/NeighborListTree.h"
+
+using namespace std;
+using namespace hoomd;
+using namespace hoomd::md;
+using namespace hoomd::metal;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_eam_force.cc
+    \brief Checks that the CPU EAM force gives the same result with any number of threads
+    \ingroup unit_tests
+*/
+
+//! Name of the potential file written by the tests
+const char* eam_filename = "test_eam_force.eam.alloy";
+
+//! Write a smooth single element EAM/Alloy potential file
+void write_eam_file()
+    {
+    const unsigned int nrho = 500, nr = 500;
+    const double drho = 0.01, dr = 0.01, r_cut = 4.5;
+
+    FILE* fp = fopen(eam_filename, "w");
+    UP_ASSERT(fp != NULL);
+    fprintf(fp, "test\ntest\ntest\n");
+    fprintf(fp, "1 Cu\n%u %g %u %g %g\n29 63.5 3.6 fcc\n", nrho, drho, nr, dr, r_cut);
+    // embedding function F(rho)
+    for (unsigned int i = 0; i < nrho; i++)
+        fprintf(fp, "%.10e\n", -sqrt(i * drho));
+    // electron density rho(r)
+    for (unsigned int i = 0; i < nr; i++)
+        fprintf(fp, "%.10e\n", exp(-1.5 * i * dr));
+    // pair potential r * phi(r)
+    for (unsigned int i = 0; i < nr; i++)
+        fprintf(fp, "%.10e\n", 10.0 * i * dr * exp(-2.0 * i * dr));
+    fclose(fp);
+    }
+
+//! Forces, energies, and virials computed by EAMForceCompute
+struct eam_result
+    {
+    std::vector<Scalar4> force;
+    std::vector<Scalar> virial;
+    };
+
+//! Build a jittered cubic lattice of \a N particles with a single type named Cu
+std::shared_ptr<SystemDefinition> make_system(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                              unsigned int N)
+    {
+    const unsigned int n = (unsigned int)ceil(cbrt((double)N));
+    const Scalar a = Scalar(2.25);
+    const Scalar L = a * n;
+
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setTypeName(0, "Cu");
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                               access_location::host,
+                               access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int ix = i % n, iy = (i / n) % n, iz = i / (n * n);
+        h_pos.data[i].x = -L / 2 + (ix + Scalar(0.5)) * a + Scalar(0.3) * sin(Scalar(i));
+        h_pos.data[i].y = -L / 2 + (iy + Scalar(0.5)) * a + Scalar(0.3) * sin(Scalar(3 * i));
+        h_pos.data[i].z = -L / 2 + (iz + Scalar(0.5)) * a + Scalar(0.3) * sin(Scalar(7 * i));
+        }
+    return sysdef;
+    }
+
+//! Compute the EAM forces once with \a num_threads threads and the given storage mode
+eam_result run_eam(unsigned int num_threads, NeighborList::storageMode mode)
+    {
+    const unsigned int N = 4000;
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(num_threads);
+    std::shared_ptr<SystemDefinition> sysdef = make_system(exec_conf, N);
+
+    std::shared_ptr<EAMForceCompute> eam(new EAMForceCompute(sysdef, (char*)eam_filename, 0));
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(0.3)));
+    nlist->setStorageMode(mode);
+    std::shared_ptr<GlobalArray<Scalar>> r_cut(new GlobalArray<Scalar>(1, exec_conf));
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = eam->get_r_cut();
+        }
+    nlist->addRCutMatrix(r_cut);
+    nlist->notifyRCutMatrixChange();
+    eam->set_neighbor_list(nlist);
+
+    eam->compute(0);
+
+    // with more than one thread, the compute must have switched to a full neighbor list
+    if (num_threads > 1)
+        UP_ASSERT(nlist->getStorageMode() == NeighborList::full);
+    else
+        UP_ASSERT(nlist->getStorageMode() == mode);
+
+    eam_result result;
+    ArrayHandle<Scalar4> h_force(eam->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(eam->getVirialArray(), access_location::host, access_mode::read);
+    const size_t pitch = eam->getVirialArray().getPitch();
+    result.force.assign(h_force.data, h_force.data + N);
+    for (unsigned int j = 0; j < 6; j++)
+        result.virial.insert(result.virial.end(),
+                             h_virial.data + j * pitch,
+                             h_virial.data + j * pitch + N);
+    return result;
+    }
+
+//! Check that two values agree within a relative tolerance, or an absolute one near zero
+void check_close(Scalar a, Scalar b)
+    {
+    if (std::abs(a) < tol_small)
+        MY_CHECK_SMALL(a - b, tol_small);
+    else
+        MY_CHECK_CLOSE(a, b, tol);
+    }
+
+//! Check that two results agree within the tolerance
+/*! A half neighbor list assigns the whole pair virial to one of the particles, so only the total
+    virial is compared.
+*/
+void check_close(const eam_result& a, const eam_result& b)
+    {
+    const size_t N = a.force.size();
+    UP_ASSERT_EQUAL(N, b.force.size());
+    for (unsigned int i = 0; i < N; i++)
+        {
+        check_close(a.force[i].x, b.force[i].x);
+        check_close(a.force[i].y, b.force[i].y);
+        check_close(a.force[i].z, b.force[i].z);
+        check_close(a.force[i].w, b.force[i].w);
+        }
+    for (unsigned int j = 0; j < 6; j++)
+        {
+        Scalar virial_a = 0, virial_b = 0;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            virial_a += a.virial[j * N + i];
+            virial_b += b.virial[j * N + i];
+            }
+        check_close(virial_a, virial_b);
+        }
+    }
+
+//! The serial half and full neighbor list paths agree
+UP_TEST(eam_force_half_full)
+    {
+    write_eam_file();
+    eam_result half = run_eam(1, NeighborList::half);
+    eam_result full = run_eam(1, NeighborList::full);
+    check_close(half, full);
+    remove(eam_filename);
+    }
+
+#ifdef ENABLE_TBB
+//! The threaded passes give bitwise identical results to the serial full neighbor list path
+UP_TEST(eam_force_threads)
+    {
+    write_eam_file();
+    eam_result serial = run_eam(1, NeighborList::full);
+    const size_t N = serial.force.size();
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        // a half neighbor list is switched to a full one when more than one thread is in use
+        for (NeighborList::storageMode mode : {NeighborList::full, NeighborList::half})
+            {
+            eam_result threaded = run_eam(num_threads, mode);
+            UP_ASSERT(memcmp(serial.force.data(), threaded.force.data(), sizeof(Scalar4) * N)
+                      == 0);
+            UP_ASSERT(
+                memcmp(serial.virial.data(), threaded.virial.data(), sizeof(Scalar) * 6 * N)
+                == 0);
+            }
+        }
+    remove(eam_filename);
+    }
+#endif
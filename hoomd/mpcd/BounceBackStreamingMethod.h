@@ -16,6 +16,8 @@
 #include "StreamingMethod.h"
 #include <pybind11/pybind11.h>
 
+#include <atomic>
+
 namespace hoomd
     {
 namespace mpcd
@@ -123,40 +125,62 @@ void BounceBackStreamingMethod<Geometry, Force>::stream(uint64_t timestep)
 
     // default construct a force if one is not set
     const Force force = (m_force) ? *m_force : Force();
+    const Geometry& geom = *m_geom;
+    const Scalar dt = m_mpcd_dt;
 
-    for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
+    // optionally bin the particles for the next streaming step, when the cell list will need them
+    const bool bin = m_bin_during_stream;
+    mpcd::detail::CellBinner binner;
+    if (bin)
         {
-        const Scalar4 postype = h_pos.data[cur_p];
-        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-        const unsigned int type = __scalar_as_int(postype.w);
-
-        const Scalar4 vel_cell = h_vel.data[cur_p];
-        Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
-        // estimate next velocity based on current acceleration
-        vel += Scalar(0.5) * m_mpcd_dt * force.evaluate(pos) / mass;
-
-        // propagate the particle to its new position ballistically
-        Scalar dt_remain = m_mpcd_dt;
-        bool collide = true;
-        do
-            {
-            pos += dt_remain * vel;
-            collide = m_geom->detectCollision(pos, vel, dt_remain);
-            } while (dt_remain > 0 && collide);
-        // finalize velocity update
-        vel += Scalar(0.5) * m_mpcd_dt * force.evaluate(pos) / mass;
-
-        // wrap and update the position
-        int3 image = make_int3(0, 0, 0);
-        box.wrap(pos, image);
-
-        h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
-        h_vel.data[cur_p]
-            = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+        binner = m_cl->getCellBinner(m_next_timestep);
         }
 
+    auto stream_range = [&](unsigned int first, unsigned int last)
+        {
+        for (unsigned int cur_p = first; cur_p < last; ++cur_p)
+            {
+            const Scalar4 postype = h_pos.data[cur_p];
+            Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+            const unsigned int type = __scalar_as_int(postype.w);
+
+            const Scalar4 vel_cell = h_vel.data[cur_p];
+            Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
+            // estimate next velocity based on current acceleration
+            vel += Scalar(0.5) * dt * force.evaluate(pos) / mass;
+
+            // propagate the particle to its new position ballistically
+            Scalar dt_remain = dt;
+            bool collide = true;
+            do
+                {
+                pos += dt_remain * vel;
+                collide = geom.detectCollision(pos, vel, dt_remain);
+                } while (dt_remain > 0 && collide);
+            // finalize velocity update
+            vel += Scalar(0.5) * dt * force.evaluate(pos) / mass;
+
+            // wrap and update the position
+            int3 image = make_int3(0, 0, 0);
+            box.wrap(pos, image);
+
+            const unsigned int cell = (bin) ? binner(pos) : mpcd::detail::NO_CELL;
+            h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
+            h_vel.data[cur_p] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(cell));
+            }
+        };
+    hoomd::detail::forEachRange(*m_exec_conf, m_mpcd_pdata->getN(), stream_range);
+
     // particles have moved, so the cell cache is no longer valid
     m_mpcd_pdata->invalidateCellCache();
+    if (bin)
+        {
+        m_mpcd_pdata->setPrebinnedCellCache(m_next_timestep);
+        }
+    else
+        {
+        m_mpcd_pdata->invalidatePrebinnedCellCache();
+        }
     }
 
 /*!
@@ -173,17 +197,24 @@ bool BounceBackStreamingMethod<Geometry, Force>::checkParticles()
                                     access_location::host,
                                     access_mode::read);
 
-    bool out_of_bounds = false;
-    for (unsigned int idx = 0; idx < m_mpcd_pdata->getN(); ++idx)
+    // each range stops at its first particle outside the geometry
+    const Geometry& geom = *m_geom;
+    std::atomic<bool> out_of_bounds_any(false);
+    auto check_range = [&](unsigned int first, unsigned int last)
         {
-        const Scalar4 postype = h_pos.data[idx];
-        const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-        if (m_geom->isOutside(pos))
+        for (unsigned int idx = first; idx < last && !out_of_bounds_any.load(); ++idx)
             {
-            out_of_bounds = true;
-            break;
+            const Scalar4 postype = h_pos.data[idx];
+            const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+            if (geom.isOutside(pos))
+                {
+                out_of_bounds_any.store(true);
+                break;
+                }
             }
-        }
+        };
+    hoomd::detail::forEachRange(*m_exec_conf, m_mpcd_pdata->getN(), check_range);
+    bool out_of_bounds = out_of_bounds_any.load();
 
 #ifdef ENABLE_MPI
     if (m_exec_conf->getNRanks() > 1)
@@ -105,6 +105,7 @@ void BounceBackStreamingMethodGPU<Geometry, Force>::stream(uint64_t timestep)
 
     // particles have moved, so the cell cache is no longer valid
     this->m_mpcd_pdata->invalidateCellCache();
+    this->m_mpcd_pdata->invalidatePrebinnedCellCache();
     }
 
 namespace detail
@@ -35,6 +35,9 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef, Scalar cell_s
     m_max_grid_shift = 0.5 * m_cell_size;
     m_origin_idx = make_int3(0, 0, 0);
 
+    m_use_prebinned = false;
+    m_prebin_grid_shift = make_scalar3(0.0, 0.0, 0.0);
+
     resetConditions();
 
 #ifdef ENABLE_MPI
@@ -87,6 +90,12 @@ void mpcd::CellList::compute(uint64_t timestep)
         // ensure grid is shifted
         drawGridShift(timestep);
 
+        // reuse the cells of the MPCD particles if they were binned for this step while streaming
+        m_use_prebinned = m_mpcd_pdata->checkPrebinnedCellCache(timestep)
+                          && m_grid_shift.x == m_prebin_grid_shift.x
+                          && m_grid_shift.y == m_prebin_grid_shift.y
+                          && m_grid_shift.z == m_prebin_grid_shift.z;
+
 #ifdef ENABLE_MPI
         // exchange embedded particles if necessary
         if (m_sysdef->isDomainDecomposed() && needsEmbedMigrate(timestep))
@@ -120,6 +129,7 @@ void mpcd::CellList::compute(uint64_t timestep)
                 resetConditions();
                 }
             } while (overflowed);
+        m_use_prebinned = false;
 
         // we are finished building, explicitly mark everything (rather than using shouldCompute)
         m_first_compute = false;
@@ -316,6 +326,9 @@ void mpcd::CellList::computeDimensions()
     // dimensions are now current
     m_needs_compute_dim = false;
     notifySizeChange();
+
+    // cells binned for a future step used the old dimensions
+    m_mpcd_pdata->invalidatePrebinnedCellCache();
     }
 
 #ifdef ENABLE_MPI
@@ -528,9 +541,6 @@ bool mpcd::CellList::isCommunicating(mpcd::detail::face dir)
  */
 void mpcd::CellList::buildCellList()
     {
-    const BoxDim& box = m_pdata->getBox();
-    const uchar3 periodic = box.getPeriodic();
-
     ArrayHandle<unsigned int> h_cell_list(m_cell_list,
                                           access_location::host,
                                           access_mode::overwrite);
@@ -567,84 +577,47 @@ void mpcd::CellList::buildCellList()
         N_tot += m_embed_group->getNumMembers();
         }
 
-    // total effective number of cells in the global box, optionally padded by
-    // extra cells in MPI simulations
-    uint3 n_global_cells = m_global_cell_dim;
-#ifdef ENABLE_MPI
-    if (isCommunicating(mpcd::detail::face::east))
-        n_global_cells.x += 2 * m_num_extra;
-    if (isCommunicating(mpcd::detail::face::north))
-        n_global_cells.y += 2 * m_num_extra;
-    if (isCommunicating(mpcd::detail::face::up))
-        n_global_cells.z += 2 * m_num_extra;
-#endif // ENABLE_MPI
-
-    const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
+    // the MPCD particles may already have been binned while streaming
+    const unsigned int N_prebinned = (m_use_prebinned) ? m_mpcd_pdata->getN() : 0;
+    const mpcd::detail::CellBinner binner = makeCellBinner(m_grid_shift);
 
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
         {
-        Scalar4 postype_i;
-        if (cur_p < N_mpcd)
-            {
-            postype_i = h_pos.data[cur_p];
-            }
-        else
+        unsigned int bin_idx = mpcd::detail::NO_CELL;
+        if (cur_p < N_prebinned)
             {
-            postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+            bin_idx = __scalar_as_int(h_vel.data[cur_p].w);
             }
-        Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
-        if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
+        // particles that could not be binned in advance are binned from their position
+        if (bin_idx == mpcd::detail::NO_CELL)
             {
-            conditions.y = cur_p + 1;
-            continue;
-            }
-
-        // bin particle assuming orthorhombic box (already validated)
-        const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
-        int3 global_bin = make_int3((int)std::floor(delta.x / m_cell_size),
-                                    (int)std::floor(delta.y / m_cell_size),
-                                    (int)std::floor(delta.z / m_cell_size));
-
-        // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
-        // this is done using periodic from the "local" box, since this will be periodic
-        // only when there is one rank along the dimension
-        if (periodic.x)
-            {
-            if (global_bin.x == (int)n_global_cells.x)
-                global_bin.x = 0;
-            else if (global_bin.x == -1)
-                global_bin.x = n_global_cells.x - 1;
-            }
-        if (periodic.y)
-            {
-            if (global_bin.y == (int)n_global_cells.y)
-                global_bin.y = 0;
-            else if (global_bin.y == -1)
-                global_bin.y = n_global_cells.y - 1;
-            }
-        if (periodic.z)
-            {
-            if (global_bin.z == (int)n_global_cells.z)
-                global_bin.z = 0;
-            else if (global_bin.z == -1)
-                global_bin.z = n_global_cells.z - 1;
-            }
+            Scalar4 postype_i;
+            if (cur_p < N_mpcd)
+                {
+                postype_i = h_pos.data[cur_p];
+                }
+            else
+                {
+                postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+                }
+            Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
-        // compute the local cell
-        int3 bin = make_int3(global_bin.x - m_origin_idx.x,
-                             global_bin.y - m_origin_idx.y,
-                             global_bin.z - m_origin_idx.z);
+            if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
+                {
+                conditions.y = cur_p + 1;
+                continue;
+                }
 
-        // validate and make sure no particles blew out of the box
-        if ((bin.x < 0 || bin.x >= (int)m_cell_dim.x) || (bin.y < 0 || bin.y >= (int)m_cell_dim.y)
-            || (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
-            {
-            conditions.z = cur_p + 1;
-            continue;
+            // validate and make sure no particles blew out of the box
+            bin_idx = binner(pos_i);
+            if (bin_idx == mpcd::detail::NO_CELL)
+                {
+                conditions.z = cur_p + 1;
+                continue;
+                }
             }
 
-        unsigned int bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
         unsigned int offset = h_cell_np.data[bin_idx];
         if (offset < m_cell_np_max)
             {
@@ -873,22 +846,81 @@ void mpcd::CellList::drawGridShift(uint64_t timestep)
     {
     if (m_enable_grid_shift)
         {
-        uint16_t seed = m_sysdef->getSeed();
-
-        // PRNG using seed and timestep as seeds
-        hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::MPCDCellList, timestep, seed),
-                                   hoomd::Counter());
-
-        // draw shift variables from uniform distribution
-        hoomd::UniformDistribution<Scalar> uniform(-m_max_grid_shift, m_max_grid_shift);
-        Scalar3 shift;
-        shift.x = uniform(rng);
-        shift.y = uniform(rng);
-        shift.z = (m_sysdef->getNDimensions() == 3) ? uniform(rng) : Scalar(0.0);
-        setGridShift(shift);
+        setGridShift(computeGridShift(timestep));
         }
     }
 
+/*!
+ * \param timestep Timestep to compute shifting for
+ * \returns The grid shift drawGridShift() sets for \a timestep
+ *
+ * The grid shift is not modified. If grid shifting is disabled, the current grid shift is returned.
+ */
+Scalar3 mpcd::CellList::computeGridShift(uint64_t timestep) const
+    {
+    if (!m_enable_grid_shift)
+        return m_grid_shift;
+
+    uint16_t seed = m_sysdef->getSeed();
+
+    // PRNG using seed and timestep as seeds
+    hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::MPCDCellList, timestep, seed),
+                               hoomd::Counter());
+
+    // draw shift variables from uniform distribution
+    hoomd::UniformDistribution<Scalar> uniform(-m_max_grid_shift, m_max_grid_shift);
+    Scalar3 shift;
+    shift.x = uniform(rng);
+    shift.y = uniform(rng);
+    shift.z = (m_sysdef->getNDimensions() == 3) ? uniform(rng) : Scalar(0.0);
+    return shift;
+    }
+
+/*!
+ * \param timestep Timestep the cell list will next be built at
+ * \returns A binner using the current cell dimensions and the grid shift for \a timestep
+ *
+ * Cells computed with the binner can be cached in the velocity of the MPCD particles and marked
+ * with mpcd::ParticleData::setPrebinnedCellCache(). The next time the cell list is built, it
+ * reuses them instead of binning the MPCD particles again as long as it is built at \a timestep
+ * and neither the particles nor the cell dimensions have changed in between.
+ */
+mpcd::detail::CellBinner mpcd::CellList::getCellBinner(uint64_t timestep)
+    {
+    m_prebin_grid_shift = computeGridShift(timestep);
+    return makeCellBinner(m_prebin_grid_shift);
+    }
+
+/*!
+ * \param grid_shift Amount to shift positions before binning
+ * \returns A binner using the current cell dimensions
+ */
+mpcd::detail::CellBinner mpcd::CellList::makeCellBinner(const Scalar3& grid_shift)
+    {
+    mpcd::detail::CellBinner binner;
+    binner.global_lo = m_pdata->getGlobalBox().getLo();
+    binner.grid_shift = grid_shift;
+    binner.cell_size = m_cell_size;
+    binner.periodic = m_pdata->getBox().getPeriodic();
+
+    // total effective number of cells in the global box, optionally padded by
+    // extra cells in MPI simulations
+    binner.n_global_cells = m_global_cell_dim;
+#ifdef ENABLE_MPI
+    if (isCommunicating(mpcd::detail::face::east))
+        binner.n_global_cells.x += 2 * m_num_extra;
+    if (isCommunicating(mpcd::detail::face::north))
+        binner.n_global_cells.y += 2 * m_num_extra;
+    if (isCommunicating(mpcd::detail::face::up))
+        binner.n_global_cells.z += 2 * m_num_extra;
+#endif // ENABLE_MPI
+
+    binner.origin_idx = m_origin_idx;
+    binner.cell_dim = m_cell_dim;
+    binner.cell_indexer = m_cell_indexer;
+    return binner;
+    }
+
 void mpcd::CellList::getCellStatistics() const
     {
     unsigned int min_np(0xffffffff), max_np(0);
@@ -29,6 +29,81 @@ namespace hoomd
     {
 namespace mpcd
     {
+namespace detail
+    {
+//! Assigns positions to the local cells of an mpcd::CellList
+/*!
+ * The binner holds a copy of the cell geometry and grid shift so that particles can be binned
+ * outside of the cell list, e.g., while they are being streamed.
+ */
+struct CellBinner
+    {
+    //! Get the local cell containing a position
+    /*!
+     * \param pos Position to bin
+     * \returns Index of the local cell, or mpcd::detail::NO_CELL if \a pos is NaN or lies outside
+     *          the local cells
+     */
+    unsigned int operator()(const Scalar3& pos) const
+        {
+        if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+            return mpcd::detail::NO_CELL;
+
+        // bin particle assuming orthorhombic box (already validated)
+        const Scalar3 delta = (pos - grid_shift) - global_lo;
+        int3 global_bin = make_int3((int)std::floor(delta.x / cell_size),
+                                    (int)std::floor(delta.y / cell_size),
+                                    (int)std::floor(delta.z / cell_size));
+
+        // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
+        // this is done using periodic from the "local" box, since this will be periodic
+        // only when there is one rank along the dimension
+        if (periodic.x)
+            {
+            if (global_bin.x == (int)n_global_cells.x)
+                global_bin.x = 0;
+            else if (global_bin.x == -1)
+                global_bin.x = n_global_cells.x - 1;
+            }
+        if (periodic.y)
+            {
+            if (global_bin.y == (int)n_global_cells.y)
+                global_bin.y = 0;
+            else if (global_bin.y == -1)
+                global_bin.y = n_global_cells.y - 1;
+            }
+        if (periodic.z)
+            {
+            if (global_bin.z == (int)n_global_cells.z)
+                global_bin.z = 0;
+            else if (global_bin.z == -1)
+                global_bin.z = n_global_cells.z - 1;
+            }
+
+        // compute the local cell
+        int3 bin = make_int3(global_bin.x - origin_idx.x,
+                             global_bin.y - origin_idx.y,
+                             global_bin.z - origin_idx.z);
+
+        // validate and make sure no particles blew out of the box
+        if ((bin.x < 0 || bin.x >= (int)cell_dim.x) || (bin.y < 0 || bin.y >= (int)cell_dim.y)
+            || (bin.z < 0 || bin.z >= (int)cell_dim.z))
+            return mpcd::detail::NO_CELL;
+
+        return cell_indexer(bin.x, bin.y, bin.z);
+        }
+
+    Scalar3 global_lo;    //!< Lower corner of the global box
+    Scalar3 grid_shift;   //!< Amount to shift positions before binning
+    Scalar cell_size;     //!< MPCD cell width
+    uchar3 periodic;      //!< Periodicity of the local box
+    uint3 n_global_cells; //!< Number of cells in the global box, including communication padding
+    int3 origin_idx;      //!< Origin as a global index
+    uint3 cell_dim;       //!< Number of local cells in each direction
+    Index3D cell_indexer; //!< Indexer from 3D into cell list 1D
+    };
+    } // end namespace detail
+
 //! Computes the MPCD cell list on the CPU
 class PYBIND11_EXPORT CellList : public Compute
     {
@@ -220,6 +295,9 @@ class PYBIND11_EXPORT CellList : public Compute
     //! Generates the random grid shift vector
     void drawGridShift(uint64_t timestep);
 
+    //! Get a binner for the cells the list will have at a timestep
+    mpcd::detail::CellBinner getCellBinner(uint64_t timestep);
+
     //! Calculate current cell occupancy statistics
     virtual void getCellStatistics() const;
 
@@ -295,9 +373,18 @@ class PYBIND11_EXPORT CellList : public Compute
     //! Reset the conditions array
     void resetConditions();
 
+    bool m_use_prebinned;        //!< True if the MPCD particles were binned while streaming
+    Scalar3 m_prebin_grid_shift; //!< Grid shift the MPCD particles were binned with
+
     //! Builds the cell list and handles cell list memory
     virtual void buildCellList();
 
+    //! Compute the grid shift vector for a timestep
+    Scalar3 computeGridShift(uint64_t timestep) const;
+
+    //! Make a binner for the current cells
+    mpcd::detail::CellBinner makeCellBinner(const Scalar3& grid_shift);
+
     //! Callback to sort cell list when particle data is sorted
     virtual void sort(uint64_t timestep,
                       const GPUArray<unsigned int>& order,
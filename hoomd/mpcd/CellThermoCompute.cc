@@ -9,6 +9,8 @@
 #include "CellThermoCompute.h"
 #include "ReductionOperators.h"
 
+#include "hoomd/DeterministicReduce.h"
+
 namespace hoomd
     {
 /*!
@@ -216,6 +218,28 @@ struct CellPropertySum
     const unsigned int* embed_idx; //!< Embedded particle indexes
     const unsigned int N_mpcd;     //!< Number of MPCD particles
     };
+
+//! Partial sum of the cell properties used to compute the net properties
+struct CellThermoSum
+    {
+    double3 momentum = make_double3(0, 0, 0); //!< Net momentum
+    double energy = 0.0;                      //!< Net kinetic energy
+    double temp = 0.0;                        //!< Sum of the cell temperatures
+    unsigned int n_temp_cells = 0;            //!< Number of cells with a temperature
+
+    //! Add two partial sums
+    CellThermoSum operator+(const CellThermoSum& other) const
+        {
+        CellThermoSum sum;
+        sum.momentum = make_double3(momentum.x + other.momentum.x,
+                                    momentum.y + other.momentum.y,
+                                    momentum.z + other.momentum.z);
+        sum.energy = energy + other.energy;
+        sum.temp = temp + other.temp;
+        sum.n_temp_cells = n_temp_cells + other.n_temp_cells;
+        return sum;
+        }
+    };
     } // end namespace detail
     } // end namespace mpcd
 
@@ -272,20 +296,25 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
 
     // Loop over all outer cells and compute total momentum, mass, energy
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int idx = 0; idx < m_vel_comm->getNCells(); ++idx)
-        {
-        const unsigned int cur_cell = h_cells.data[idx];
-
-        // compute the cell properties
-        double4 momentum;
-        double ke(0.0);
-        unsigned int np(0);
-        summer.compute(momentum, ke, np, cur_cell, need_energy);
-
-        h_cell_vel.data[cur_cell] = make_double4(momentum.x, momentum.y, momentum.z, momentum.w);
-        if (need_energy)
-            h_cell_energy.data[cur_cell] = make_double3(ke, 0.0, __int_as_double(np));
-        }
+    auto outer_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int idx = first; idx < last; ++idx)
+            {
+            const unsigned int cur_cell = h_cells.data[idx];
+
+            // compute the cell properties
+            double4 momentum;
+            double ke(0.0);
+            unsigned int np(0);
+            summer.compute(momentum, ke, np, cur_cell, need_energy);
+
+            h_cell_vel.data[cur_cell]
+                = make_double4(momentum.x, momentum.y, momentum.z, momentum.w);
+            if (need_energy)
+                h_cell_energy.data[cur_cell] = make_double3(ke, 0.0, __int_as_double(np));
+            }
+    };
+    hoomd::detail::forEachRange(*m_exec_conf, m_vel_comm->getNCells(), outer_range);
     }
 
 void mpcd::CellThermoCompute::finishOuterCellProperties()
@@ -300,41 +329,45 @@ void mpcd::CellThermoCompute::finishOuterCellProperties()
 
     // Loop over all outer cells and normalize the summed quantities
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int idx = 0; idx < m_vel_comm->getNCells(); ++idx)
-        {
-        const unsigned int cur_cell = h_cells.data[idx];
+    auto normalize_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int idx = first; idx < last; ++idx)
+            {
+            const unsigned int cur_cell = h_cells.data[idx];
 
-        // average cell properties if the cell has mass
-        const double4 cell_vel = h_cell_vel.data[cur_cell];
-        double3 vel_cm = make_double3(cell_vel.x, cell_vel.y, cell_vel.z);
-        const double mass = cell_vel.w;
+            // average cell properties if the cell has mass
+            const double4 cell_vel = h_cell_vel.data[cur_cell];
+            double3 vel_cm = make_double3(cell_vel.x, cell_vel.y, cell_vel.z);
+            const double mass = cell_vel.w;
 
-        if (mass > 0.)
-            {
-            // average velocity is only defined when there is some mass in the cell
-            vel_cm.x /= mass;
-            vel_cm.y /= mass;
-            vel_cm.z /= mass;
-            }
-        h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
+            if (mass > 0.)
+                {
+                // average velocity is only defined when there is some mass in the cell
+                vel_cm.x /= mass;
+                vel_cm.y /= mass;
+                vel_cm.z /= mass;
+                }
+            h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
 
-        if (need_energy)
-            {
-            const double3 cell_energy = h_cell_energy.data[cur_cell];
-            const double ke = cell_energy.x;
-            double temp(0.0);
-            const unsigned int np = __double_as_int(cell_energy.z);
-            // temperature is only defined for 2 or more particles
-            if (np > 1)
+            if (need_energy)
                 {
-                const double ke_cm
-                    = 0.5 * mass
-                      * (vel_cm.x * vel_cm.x + vel_cm.y * vel_cm.y + vel_cm.z * vel_cm.z);
-                temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np - 1));
+                const double3 cell_energy = h_cell_energy.data[cur_cell];
+                const double ke = cell_energy.x;
+                double temp(0.0);
+                const unsigned int np = __double_as_int(cell_energy.z);
+                // temperature is only defined for 2 or more particles
+                if (np > 1)
+                    {
+                    const double ke_cm
+                        = 0.5 * mass
+                          * (vel_cm.x * vel_cm.x + vel_cm.y * vel_cm.y + vel_cm.z * vel_cm.z);
+                    temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np - 1));
+                    }
+                h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
                 }
-            h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
             }
-        }
+    };
+    hoomd::detail::forEachRange(*m_exec_conf, m_vel_comm->getNCells(), normalize_range);
     }
 #endif // ENABLE_MPI
 
@@ -408,46 +441,49 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
         }
 
     // iterate over all of the inner cells and compute average velocity, energy, temperature
+    // each cell gathers its own particles, so the cells can be computed independently
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int k = lo.z; k < hi.z; ++k)
-        {
-        for (unsigned int j = lo.y; j < hi.y; ++j)
+    const uint3 n_inner = make_uint3(hi.x - lo.x, hi.y - lo.y, hi.z - lo.z);
+    auto inner_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int idx = first; idx < last; ++idx)
             {
-            for (unsigned int i = lo.x; i < hi.x; ++i)
+            const unsigned int i = lo.x + idx % n_inner.x;
+            const unsigned int j = lo.y + (idx / n_inner.x) % n_inner.y;
+            const unsigned int k = lo.z + idx / (n_inner.x * n_inner.y);
+            const unsigned int cur_cell = ci(i, j, k);
+
+            // compute the cell properties
+            double4 momentum;
+            double ke(0.0);
+            unsigned int np(0);
+            summer.compute(momentum, ke, np, cur_cell, need_energy);
+
+            const double mass = momentum.w;
+            double3 vel_cm = make_double3(0.0, 0.0, 0.0);
+            if (mass > 0.)
                 {
-                const unsigned int cur_cell = ci(i, j, k);
-
-                // compute the cell properties
-                double4 momentum;
-                double ke(0.0);
-                unsigned int np(0);
-                summer.compute(momentum, ke, np, cur_cell, need_energy);
-
-                const double mass = momentum.w;
-                double3 vel_cm = make_double3(0.0, 0.0, 0.0);
-                if (mass > 0.)
-                    {
-                    vel_cm.x = momentum.x / mass;
-                    vel_cm.y = momentum.y / mass;
-                    vel_cm.z = momentum.z / mass;
-                    }
+                vel_cm.x = momentum.x / mass;
+                vel_cm.y = momentum.y / mass;
+                vel_cm.z = momentum.z / mass;
+                }
 
-                h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
-                if (need_energy)
+            h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
+            if (need_energy)
+                {
+                double temp(0.0);
+                if (np > 1)
                     {
-                    double temp(0.0);
-                    if (np > 1)
-                        {
-                        const double ke_cm
-                            = 0.5 * mass
-                              * (vel_cm.x * vel_cm.x + vel_cm.y * vel_cm.y + vel_cm.z * vel_cm.z);
-                        temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np - 1));
-                        }
-                    h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
+                    const double ke_cm
+                        = 0.5 * mass
+                          * (vel_cm.x * vel_cm.x + vel_cm.y * vel_cm.y + vel_cm.z * vel_cm.z);
+                    temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np - 1));
                     }
-                } // i
-            } // j
-        } // k
+                h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
+                }
+            }
+    };
+    hoomd::detail::forEachRange(*m_exec_conf, n_inner.x * n_inner.y * n_inner.z, inner_range);
     }
 
 void mpcd::CellThermoCompute::computeNetProperties()
@@ -473,49 +509,58 @@ void mpcd::CellThermoCompute::computeNetProperties()
 
         const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
 
-        double3 net_momentum = make_double3(0, 0, 0);
-        double energy(0.0), temp(0.0);
-        for (unsigned int k = 0; k < upper.z; ++k)
-            {
-            for (unsigned int j = 0; j < upper.y; ++j)
+        // sum the cell properties over blocks of cells, then add the block sums pairwise so that
+        // the result does not depend on the number of threads
+        auto sum_range = [&](unsigned int first, unsigned int last)
+        {
+            mpcd::detail::CellThermoSum sum;
+            for (unsigned int cell = first; cell < last; ++cell)
                 {
-                for (unsigned int i = 0; i < upper.x; ++i)
-                    {
-                    const unsigned int idx = ci(i, j, k);
+                const unsigned int i = cell % upper.x;
+                const unsigned int j = (cell / upper.x) % upper.y;
+                const unsigned int k = cell / (upper.x * upper.y);
+                const unsigned int idx = ci(i, j, k);
+
+                const double4 cell_vel_mass = h_cell_vel.data[idx];
+                const double3 cell_vel
+                    = make_double3(cell_vel_mass.x, cell_vel_mass.y, cell_vel_mass.z);
+                const double cell_mass = cell_vel_mass.w;
 
-                    const double4 cell_vel_mass = h_cell_vel.data[idx];
-                    const double3 cell_vel
-                        = make_double3(cell_vel_mass.x, cell_vel_mass.y, cell_vel_mass.z);
-                    const double cell_mass = cell_vel_mass.w;
+                sum.momentum.x += cell_mass * cell_vel.x;
+                sum.momentum.y += cell_mass * cell_vel.y;
+                sum.momentum.z += cell_mass * cell_vel.z;
 
-                    net_momentum.x += cell_mass * cell_vel.x;
-                    net_momentum.y += cell_mass * cell_vel.y;
-                    net_momentum.z += cell_mass * cell_vel.z;
+                if (need_energy)
+                    {
+                    const double3 cell_energy = h_cell_energy.data[idx];
+                    sum.energy += cell_energy.x;
 
-                    if (need_energy)
+                    if (__double_as_int(cell_energy.z) > 1)
                         {
-                        const double3 cell_energy = h_cell_energy.data[idx];
-                        energy += cell_energy.x;
-
-                        if (__double_as_int(cell_energy.z) > 1)
-                            {
-                            temp += cell_energy.y;
-                            ++n_temp_cells;
-                            }
+                        sum.temp += cell_energy.y;
+                        ++sum.n_temp_cells;
                         }
                     }
                 }
-            }
+            return sum;
+        };
+        const mpcd::detail::CellThermoSum net
+            = hoomd::detail::deterministicReduce(*m_exec_conf,
+                                                 upper.x * upper.y * upper.z,
+                                                 mpcd::detail::CellThermoSum(),
+                                                 sum_range,
+                                                 mpcd::ops::Sum());
+        n_temp_cells = net.n_temp_cells;
 
         ArrayHandle<double> h_net_properties(m_net_properties,
                                              access_location::host,
                                              access_mode::overwrite);
-        h_net_properties.data[mpcd::detail::thermo_index::momentum_x] = net_momentum.x;
-        h_net_properties.data[mpcd::detail::thermo_index::momentum_y] = net_momentum.y;
-        h_net_properties.data[mpcd::detail::thermo_index::momentum_z] = net_momentum.z;
+        h_net_properties.data[mpcd::detail::thermo_index::momentum_x] = net.momentum.x;
+        h_net_properties.data[mpcd::detail::thermo_index::momentum_y] = net.momentum.y;
+        h_net_properties.data[mpcd::detail::thermo_index::momentum_z] = net.momentum.z;
 
-        h_net_properties.data[mpcd::detail::thermo_index::energy] = energy;
-        h_net_properties.data[mpcd::detail::thermo_index::temperature] = temp;
+        h_net_properties.data[mpcd::detail::thermo_index::energy] = net.energy;
+        h_net_properties.data[mpcd::detail::thermo_index::temperature] = net.temp;
         }
 
 #ifdef ENABLE_MPI
@@ -20,6 +20,7 @@
 #endif // ENABLE_MPI
 
 #include "hoomd/Compute.h"
+#include "hoomd/ForEachRange.h"
 #include "hoomd/SystemDefinition.h"
 #include "hoomd/extern/nano-signal-slot/nano_signal_slot.hpp"
 #include <pybind11/pybind11.h>
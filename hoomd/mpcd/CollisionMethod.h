@@ -16,6 +16,7 @@
 #include "CellList.h"
 
 #include "hoomd/Autotuned.h"
+#include "hoomd/ForEachRange.h"
 #include "hoomd/ParticleGroup.h"
 #include "hoomd/SystemDefinition.h"
 #include <pybind11/pybind11.h>
@@ -45,7 +45,7 @@ mpcd::ParticleData::ParticleData(unsigned int N,
                                  std::shared_ptr<ExecutionConfiguration> exec_conf,
                                  std::shared_ptr<DomainDecomposition> decomposition)
     : m_N(0), m_N_virtual(0), m_N_global(0), m_N_max(0), m_exec_conf(exec_conf), m_mass(1.0),
-      m_valid_cell_cache(false)
+      m_valid_cell_cache(false), m_prebinned_cell_cache(false), m_prebinned_timestep(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD ParticleData" << endl;
 
@@ -75,7 +75,7 @@ mpcd::ParticleData::ParticleData(const mpcd::ParticleDataSnapshot& snapshot,
                                  std::shared_ptr<const ExecutionConfiguration> exec_conf,
                                  std::shared_ptr<DomainDecomposition> decomposition)
     : m_N(0), m_N_virtual(0), m_N_global(0), m_N_max(0), m_exec_conf(exec_conf), m_mass(1.0),
-      m_valid_cell_cache(false)
+      m_valid_cell_cache(false), m_prebinned_cell_cache(false), m_prebinned_timestep(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD ParticleData" << endl;
 
@@ -314,6 +314,9 @@ void mpcd::ParticleData::initializeFromSnapshot(const mpcd::ParticleDataSnapshot
 
     setNGlobal(nglobal);
 
+    // particles have been replaced, so any cells binned for a future step are stale
+    invalidatePrebinnedCellCache();
+
     // TODO: any particle data signaling to subscribers
     }
 
@@ -1057,6 +1060,7 @@ void mpcd::ParticleData::addParticles(const GPUVector<mpcd::detail::pdata_elemen
     // cache is invalid because particles migrated, sort signal is tripped because adding particles
     // is like reordering
     invalidateCellCache();
+    invalidatePrebinnedCellCache();
     notifySort(timestep);
     }
 
@@ -1244,6 +1248,7 @@ void mpcd::ParticleData::addParticlesGPU(const GPUVector<mpcd::detail::pdata_ele
     // cache is invalid because particles migrated, sort signal is tripped because adding particles
     // is like reordering
     invalidateCellCache();
+    invalidatePrebinnedCellCache();
     notifySort(timestep);
     }
 #endif // ENABLE_HIP
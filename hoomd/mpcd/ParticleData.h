@@ -271,6 +271,33 @@ class PYBIND11_EXPORT ParticleData : public Autotuned
         return m_valid_cell_cache;
         }
 
+    //! Mark the cell value cached in the velocity of the MPCD particles as binned for a future step
+    /*!
+     * \param timestep Timestep the cell list will be built at
+     *
+     * A streaming method may bin the MPCD particles while it moves them. The cached cells are only
+     * used by the cell list if nothing has invalidated them before it is built at \a timestep.
+     */
+    void setPrebinnedCellCache(uint64_t timestep)
+        {
+        m_prebinned_cell_cache = true;
+        m_prebinned_timestep = timestep;
+        }
+    //! Mark the cell value cached for a future step as invalid
+    void invalidatePrebinnedCellCache()
+        {
+        m_prebinned_cell_cache = false;
+        }
+    //! Check if the MPCD particles have been binned for a timestep
+    /*!
+     * \param timestep Timestep the cell list is being built at
+     * \returns True if the cell value cached in the velocity was computed for \a timestep
+     */
+    bool checkPrebinnedCellCache(uint64_t timestep) const
+        {
+        return m_prebinned_cell_cache && m_prebinned_timestep == timestep;
+        }
+
     //! Signature for particle sort signal
     typedef Nano::Signal<
         void(uint64_t timestep, const GPUArray<unsigned int>&, const GPUArray<unsigned int>&)>
@@ -438,6 +465,8 @@ class PYBIND11_EXPORT ParticleData : public Autotuned
 #endif                                            // ENABLE_MPI
 
     bool m_valid_cell_cache;               //!< Flag for validity of cell cache
+    bool m_prebinned_cell_cache;           //!< Flag for validity of cell cache for a future step
+    uint64_t m_prebinned_timestep;         //!< Timestep the cell cache was binned for
     SortSignal m_sort_signal;              //!< Signal triggered when particles are sorted
     Nano::Signal<void()> m_virtual_signal; //!< Signal for number of virtual particles changing
 
@@ -71,53 +71,53 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(uint64_t timestep)
 
     uint16_t seed = m_sysdef->getSeed();
 
-    for (unsigned int k = 0; k < ci.getD(); ++k)
-        {
-        for (unsigned int j = 0; j < ci.getH(); ++j)
+    // each cell draws from its own random number stream, so the cells are independent
+    auto draw_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int idx = first; idx < last; ++idx)
             {
-            for (unsigned int i = 0; i < ci.getW(); ++i)
+            const unsigned int i = idx % ci.getW();
+            const unsigned int j = (idx / ci.getW()) % ci.getH();
+            const unsigned int k = idx / (ci.getW() * ci.getH());
+            const int3 global_cell = m_cl->getGlobalCell(make_int3(i, j, k));
+            const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
+
+            // Initialize the PRNG using the current cell index, timestep, and seed for the hash
+            hoomd::RandomGenerator rng(
+                hoomd::Seed(hoomd::RNGIdentifier::SRDCollisionMethod, timestep, seed),
+                hoomd::Counter(global_idx));
+
+            // draw rotation vector off the surface of the sphere
+            double3 rotvec;
+            hoomd::SpherePointGenerator<double> sphgen;
+            sphgen(rng, rotvec);
+            h_rotvec.data[idx] = rotvec;
+
+            if (use_thermostat)
                 {
-                const int3 global_cell = m_cl->getGlobalCell(make_int3(i, j, k));
-                const unsigned int global_idx
-                    = global_ci(global_cell.x, global_cell.y, global_cell.z);
-                const unsigned int idx = ci(i, j, k);
-
-                // Initialize the PRNG using the current cell index, timestep, and seed for the hash
-                hoomd::RandomGenerator rng(
-                    hoomd::Seed(hoomd::RNGIdentifier::SRDCollisionMethod, timestep, seed),
-                    hoomd::Counter(global_idx));
-
-                // draw rotation vector off the surface of the sphere
-                double3 rotvec;
-                hoomd::SpherePointGenerator<double> sphgen;
-                sphgen(rng, rotvec);
-                h_rotvec.data[idx] = rotvec;
-
-                if (use_thermostat)
+                const double3 cell_energy = h_cell_energy->data[idx];
+                const unsigned int np = __double_as_int(cell_energy.z);
+                double factor = 1.0;
+                if (np > 1)
                     {
-                    const double3 cell_energy = h_cell_energy->data[idx];
-                    const unsigned int np = __double_as_int(cell_energy.z);
-                    double factor = 1.0;
-                    if (np > 1)
-                        {
-                        // the total number of degrees of freedom in the cell divided by 2
-                        const double alpha = m_sysdef->getNDimensions() * (np - 1) / (double)2.;
-
-                        // draw a random kinetic energy for the cell at the set temperature
-                        hoomd::GammaDistribution<double> gamma_gen(alpha, T_set);
-                        const double rand_ke = gamma_gen(rng);
-
-                        // generate the scale factor from the current temperature
-                        // (don't use the kinetic energy of this cell, since this
-                        // is total not relative to COM)
-                        const double cur_ke = alpha * cell_energy.y;
-                        factor = (cur_ke > 0.) ? fast::sqrt(rand_ke / cur_ke) : 1.;
-                        }
-                    h_factors->data[idx] = factor;
+                    // the total number of degrees of freedom in the cell divided by 2
+                    const double alpha = m_sysdef->getNDimensions() * (np - 1) / (double)2.;
+
+                    // draw a random kinetic energy for the cell at the set temperature
+                    hoomd::GammaDistribution<double> gamma_gen(alpha, T_set);
+                    const double rand_ke = gamma_gen(rng);
+
+                    // generate the scale factor from the current temperature
+                    // (don't use the kinetic energy of this cell, since this
+                    // is total not relative to COM)
+                    const double cur_ke = alpha * cell_energy.y;
+                    factor = (cur_ke > 0.) ? fast::sqrt(rand_ke / cur_ke) : 1.;
                     }
+                h_factors->data[idx] = factor;
                 }
             }
-        }
+    };
+    hoomd::detail::forEachRange(*m_exec_conf, ci.getNumElements(), draw_range);
     }
 
 void mpcd::SRDCollisionMethod::rotate(uint64_t timestep)
@@ -167,78 +167,82 @@ void mpcd::SRDCollisionMethod::rotate(uint64_t timestep)
             new ArrayHandle<double>(m_factors, access_location::host, access_mode::read));
         }
 
-    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
-        {
-        double3 vel;
-        unsigned int cell;
-        // these properties are needed for the embedded particles only
-        unsigned int idx(0);
-        double mass(0);
-        if (cur_p < N_mpcd)
-            {
-            const Scalar4 vel_cell = h_vel.data[cur_p];
-            vel = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
-            cell = __scalar_as_int(vel_cell.w);
-            }
-        else
+    auto rotate_range = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int cur_p = first; cur_p < last; ++cur_p)
             {
-            idx = h_embed_group->data[cur_p - N_mpcd];
+            double3 vel;
+            unsigned int cell;
+            // these properties are needed for the embedded particles only
+            unsigned int idx(0);
+            double mass(0);
+            if (cur_p < N_mpcd)
+                {
+                const Scalar4 vel_cell = h_vel.data[cur_p];
+                vel = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
+                cell = __scalar_as_int(vel_cell.w);
+                }
+            else
+                {
+                idx = h_embed_group->data[cur_p - N_mpcd];
 
-            const Scalar4 vel_mass = h_vel_embed->data[idx];
-            vel = make_double3(vel_mass.x, vel_mass.y, vel_mass.z);
-            mass = vel_mass.w;
-            cell = h_embed_cell_ids->data[cur_p - N_mpcd];
-            }
+                const Scalar4 vel_mass = h_vel_embed->data[idx];
+                vel = make_double3(vel_mass.x, vel_mass.y, vel_mass.z);
+                mass = vel_mass.w;
+                cell = h_embed_cell_ids->data[cur_p - N_mpcd];
+                }
 
-        // subtract average velocity
-        const double4 avg_vel = h_cell_vel.data[cell];
-        vel.x -= avg_vel.x;
-        vel.y -= avg_vel.y;
-        vel.z -= avg_vel.z;
-
-        // get rotation vector
-        double3 rot_vec = h_rotvec.data[cell];
-
-        // perform the rotation in double precision
-        // TODO: should we optimize out the matrix construction for the CPU?
-        //       Or, consider using vectorization and/or Eigen?
-        double3 new_vel;
-        new_vel.x = (cos_a + rot_vec.x * rot_vec.x * one_minus_cos_a) * vel.x;
-        new_vel.x += (rot_vec.x * rot_vec.y * one_minus_cos_a - sin_a * rot_vec.z) * vel.y;
-        new_vel.x += (rot_vec.x * rot_vec.z * one_minus_cos_a + sin_a * rot_vec.y) * vel.z;
-
-        new_vel.y = (cos_a + rot_vec.y * rot_vec.y * one_minus_cos_a) * vel.y;
-        new_vel.y += (rot_vec.x * rot_vec.y * one_minus_cos_a + sin_a * rot_vec.z) * vel.x;
-        new_vel.y += (rot_vec.y * rot_vec.z * one_minus_cos_a - sin_a * rot_vec.x) * vel.z;
-
-        new_vel.z = (cos_a + rot_vec.z * rot_vec.z * one_minus_cos_a) * vel.z;
-        new_vel.z += (rot_vec.x * rot_vec.z * one_minus_cos_a - sin_a * rot_vec.y) * vel.x;
-        new_vel.z += (rot_vec.y * rot_vec.z * one_minus_cos_a + sin_a * rot_vec.x) * vel.y;
-
-        // rescale the temperature if thermostatting is enabled
-        if (use_thermostat)
-            {
-            double factor = h_factors->data[cell];
-            new_vel.x *= factor;
-            new_vel.y *= factor;
-            new_vel.z *= factor;
-            }
+            // subtract average velocity
+            const double4 avg_vel = h_cell_vel.data[cell];
+            vel.x -= avg_vel.x;
+            vel.y -= avg_vel.y;
+            vel.z -= avg_vel.z;
+
+            // get rotation vector
+            double3 rot_vec = h_rotvec.data[cell];
+
+            // perform the rotation in double precision
+            // TODO: should we optimize out the matrix construction for the CPU?
+            //       Or, consider using vectorization and/or Eigen?
+            double3 new_vel;
+            new_vel.x = (cos_a + rot_vec.x * rot_vec.x * one_minus_cos_a) * vel.x;
+            new_vel.x += (rot_vec.x * rot_vec.y * one_minus_cos_a - sin_a * rot_vec.z) * vel.y;
+            new_vel.x += (rot_vec.x * rot_vec.z * one_minus_cos_a + sin_a * rot_vec.y) * vel.z;
+
+            new_vel.y = (cos_a + rot_vec.y * rot_vec.y * one_minus_cos_a) * vel.y;
+            new_vel.y += (rot_vec.x * rot_vec.y * one_minus_cos_a + sin_a * rot_vec.z) * vel.x;
+            new_vel.y += (rot_vec.y * rot_vec.z * one_minus_cos_a - sin_a * rot_vec.x) * vel.z;
+
+            new_vel.z = (cos_a + rot_vec.z * rot_vec.z * one_minus_cos_a) * vel.z;
+            new_vel.z += (rot_vec.x * rot_vec.z * one_minus_cos_a - sin_a * rot_vec.y) * vel.x;
+            new_vel.z += (rot_vec.y * rot_vec.z * one_minus_cos_a + sin_a * rot_vec.x) * vel.y;
+
+            // rescale the temperature if thermostatting is enabled
+            if (use_thermostat)
+                {
+                double factor = h_factors->data[cell];
+                new_vel.x *= factor;
+                new_vel.y *= factor;
+                new_vel.z *= factor;
+                }
 
-        new_vel.x += avg_vel.x;
-        new_vel.y += avg_vel.y;
-        new_vel.z += avg_vel.z;
+            new_vel.x += avg_vel.x;
+            new_vel.y += avg_vel.y;
+            new_vel.z += avg_vel.z;
 
-        // set the new velocity
-        if (cur_p < N_mpcd)
-            {
-            h_vel.data[cur_p]
-                = make_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
-            }
-        else
-            {
-            h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
+            // set the new velocity
+            if (cur_p < N_mpcd)
+                {
+                h_vel.data[cur_p]
+                    = make_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
+                }
+            else
+                {
+                h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
+                }
             }
-        }
+    };
+    hoomd::detail::forEachRange(*m_exec_conf, N_tot, rotate_range);
     }
 
 void mpcd::SRDCollisionMethod::setCellList(std::shared_ptr<mpcd::CellList> cl)
@@ -22,7 +22,7 @@ mpcd::StreamingMethod::StreamingMethod(std::shared_ptr<SystemDefinition> sysdef,
                                        int phase)
     : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()),
       m_mpcd_pdata(m_sysdef->getMPCDParticleData()), m_exec_conf(m_pdata->getExecConf()),
-      m_mpcd_dt(0.0), m_period(period)
+      m_mpcd_dt(0.0), m_period(period), m_bin_during_stream(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD StreamingMethod" << std::endl;
 
@@ -124,7 +124,10 @@ void export_StreamingMethod(pybind11::module& m)
         m,
         "StreamingMethod")
         .def(pybind11::init<std::shared_ptr<SystemDefinition>, unsigned int, unsigned int, int>())
-        .def_property_readonly("period", &mpcd::StreamingMethod::getPeriod);
+        .def_property_readonly("period", &mpcd::StreamingMethod::getPeriod)
+        .def_property("bin_during_stream",
+                      &mpcd::StreamingMethod::getBinDuringStream,
+                      &mpcd::StreamingMethod::setBinDuringStream);
     }
     } // namespace detail
     } // namespace mpcd
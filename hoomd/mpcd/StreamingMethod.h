@@ -15,6 +15,7 @@
 
 #include "CellList.h"
 #include "hoomd/Autotuned.h"
+#include "hoomd/ForEachRange.h"
 #include "hoomd/SystemDefinition.h"
 
 #include <pybind11/pybind11.h>
@@ -79,6 +80,22 @@ class PYBIND11_EXPORT StreamingMethod : public Autotuned
         m_cl = cl;
         }
 
+    //! Get whether the MPCD particles are binned into cells while they are streamed
+    bool getBinDuringStream() const
+        {
+        return m_bin_during_stream;
+        }
+
+    //! Set whether the MPCD particles are binned into cells while they are streamed
+    /*!
+     * \param bin_during_stream If true, the streaming method caches the cell of each MPCD particle
+     *        for the next streaming timestep so the cell list does not need to bin them again.
+     */
+    void setBinDuringStream(bool bin_during_stream)
+        {
+        m_bin_during_stream = bin_during_stream;
+        }
+
     protected:
     std::shared_ptr<SystemDefinition> m_sysdef;                //!< HOOMD system definition
     std::shared_ptr<hoomd::ParticleData> m_pdata;              //!< HOOMD particle data
@@ -89,6 +106,7 @@ class PYBIND11_EXPORT StreamingMethod : public Autotuned
     Scalar m_mpcd_dt;         //!< Integration time step
     unsigned int m_period;    //!< Number of MD timesteps between streaming steps
     uint64_t m_next_timestep; //!< Timestep next streaming step should be performed
+    bool m_bin_during_stream; //!< If true, bin the MPCD particles while streaming
 
     //! Check if streaming should occur
     virtual bool shouldStream(uint64_t timestep);
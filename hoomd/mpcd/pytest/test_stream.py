@@ -84,6 +84,9 @@ class TestStreamingMethod:
         sim.run(0)
         assert ig.streaming_method is sm
         assert sm.period == 5
+        assert not sm.bin_during_stream
+        sm.bin_during_stream = True
+        assert sm.bin_during_stream
 
     def test_pickling(self, simulation_factory, snap, cls, init_args):
         sm = cls(period=5, **init_args)
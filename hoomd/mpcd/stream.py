@@ -64,6 +64,16 @@ class StreamingMethod(Operation):
             `StreamingMethod` is constructed, but its attributes can be
             modified.
 
+        bin_during_stream (bool): When True, assign the MPCD particles to
+            collision cells while they are streamed.
+
+            The cell list reuses these cells when the next collision occurs
+            on the next streaming step, saving a second pass over the MPCD
+            particles. The cells are discarded if the particles or cell
+            dimensions change in between, so this option never changes the
+            simulation result. It is only implemented on the CPU and is ignored
+            on the GPU. Defaults to False.
+
     """
 
     def __init__(self, period, mpcd_particle_force=None):
@@ -72,6 +82,7 @@ class StreamingMethod(Operation):
         param_dict = ParameterDict(
             period=int(period),
             mpcd_particle_force=OnlyTypes(BodyForce, allow_none=True),
+            bin_during_stream=bool(False),
         )
         param_dict["mpcd_particle_force"] = mpcd_particle_force
         self._param_dict.update(param_dict)
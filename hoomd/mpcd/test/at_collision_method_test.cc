@@ -175,6 +175,22 @@ UP_TEST(at_collision_method_embed)
     at_collision_method_embed_test<mpcd::ATCollisionMethod>(
         std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+#ifdef ENABLE_TBB
+//! basic test case for MPCD ATCollisionMethod class with threads
+UP_TEST(at_collision_method_basic_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    at_collision_method_basic_test<mpcd::ATCollisionMethod>(exec_conf);
+    }
+//! test embedding of particles into the MPCD ATCollisionMethod class with threads
+UP_TEST(at_collision_method_embed_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    at_collision_method_embed_test<mpcd::ATCollisionMethod>(exec_conf);
+    }
+#endif // ENABLE_TBB
 #ifdef ENABLE_HIP
 //! basic test case for MPCD ATCollisionMethodGPU class
 UP_TEST(at_collision_method_basic_gpu)
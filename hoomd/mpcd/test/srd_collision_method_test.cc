@@ -396,6 +396,28 @@ UP_TEST(srd_collision_method_thermostat)
     srd_collision_method_thermostat_test<mpcd::SRDCollisionMethod>(
         std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+#ifdef ENABLE_TBB
+//! basic test case for MPCD SRDCollisionMethod class with threads
+UP_TEST(srd_collision_method_basic_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    srd_collision_method_basic_test<mpcd::SRDCollisionMethod>(exec_conf);
+    }
+//! test distribution of random rotation vectors for the MPCD SRDCollisionMethod class with threads
+UP_TEST(srd_collision_method_rotvec_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    srd_collision_method_rotvec_test<mpcd::SRDCollisionMethod>(exec_conf);
+    }
+UP_TEST(srd_collision_method_thermostat_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    srd_collision_method_thermostat_test<mpcd::SRDCollisionMethod>(exec_conf);
+    }
+#endif // ENABLE_TBB
 #ifdef ENABLE_HIP
 //! basic test case for MPCD SRDCollisionMethodGPU class
 UP_TEST(srd_collision_method_basic_gpu)
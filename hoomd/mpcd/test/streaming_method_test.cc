@@ -109,12 +109,106 @@ void streaming_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_co
         }
     }
 
+//! Test that binning while streaming gives the same cell list as binning afterwards
+template<class SM>
+void streaming_method_bin_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SnapshotSystemData<Scalar>> snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = std::make_shared<BoxDim>(10.0);
+    snap->particle_data.type_mapping.push_back("A");
+
+    // many particles, spread through the box and moving in all directions
+    const unsigned int N = 5000;
+    snap->mpcd_data.resize(N);
+    snap->mpcd_data.type_mapping.push_back("A");
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        snap->mpcd_data.position[i] = vec3<Scalar>(10.0 * std::fmod(0.6180339887 * i, 1.0) - 5.0,
+                                                   10.0 * std::fmod(0.7548776662 * i, 1.0) - 5.0,
+                                                   10.0 * std::fmod(0.5698402910 * i, 1.0) - 5.0);
+        snap->mpcd_data.velocity[i]
+            = vec3<Scalar>(std::sin(Scalar(i)), std::cos(Scalar(3 * i)), std::sin(Scalar(5 * i)));
+        }
+
+    // two identical systems, the first binned while streaming
+    std::shared_ptr<mpcd::CellList> cl[2];
+    std::shared_ptr<SystemDefinition> sysdef[2];
+    for (unsigned int s = 0; s < 2; ++s)
+        {
+        sysdef[s] = std::make_shared<SystemDefinition>(snap, exec_conf);
+        auto stream = std::make_shared<SM>(sysdef[s], 0, 1, -1, nullptr);
+        cl[s] = std::make_shared<mpcd::CellList>(sysdef[s], 1.0, true);
+        stream->setCellList(cl[s]);
+        stream->setDeltaT(0.3);
+        stream->setBinDuringStream(s == 0);
+
+        for (uint64_t timestep = 0; timestep < 3; ++timestep)
+            {
+            cl[s]->compute(timestep);
+            stream->stream(timestep);
+            }
+        UP_ASSERT_EQUAL(sysdef[s]->getMPCDParticleData()->checkPrebinnedCellCache(3), s == 0);
+        cl[s]->compute(3);
+        }
+
+    // the cell lists should be identical
+    UP_ASSERT_EQUAL(cl[0]->getNCells(), cl[1]->getNCells());
+    UP_ASSERT_EQUAL(cl[0]->getCellListIndexer().getW(), cl[1]->getCellListIndexer().getW());
+    ArrayHandle<unsigned int> h_np_0(cl[0]->getCellSizeArray(),
+                                     access_location::host,
+                                     access_mode::read);
+    ArrayHandle<unsigned int> h_np_1(cl[1]->getCellSizeArray(),
+                                     access_location::host,
+                                     access_mode::read);
+    ArrayHandle<unsigned int> h_cl_0(cl[0]->getCellList(),
+                                     access_location::host,
+                                     access_mode::read);
+    ArrayHandle<unsigned int> h_cl_1(cl[1]->getCellList(),
+                                     access_location::host,
+                                     access_mode::read);
+    const Index2D& cli = cl[0]->getCellListIndexer();
+    for (unsigned int c = 0; c < cl[0]->getNCells(); ++c)
+        {
+        UP_ASSERT_EQUAL(h_np_0.data[c], h_np_1.data[c]);
+        for (unsigned int offset = 0; offset < h_np_0.data[c]; ++offset)
+            {
+            UP_ASSERT_EQUAL(h_cl_0.data[cli(offset, c)], h_cl_1.data[cli(offset, c)]);
+            }
+        }
+    }
+
 //! basic test case for MPCD StreamingMethod class
 UP_TEST(mpcd_streaming_method_basic)
     {
     streaming_method_basic_test<mpcd::BulkStreamingMethod<mpcd::NoForce>>(
         std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+
+//! test case for binning while streaming
+UP_TEST(mpcd_streaming_method_bin)
+    {
+    streaming_method_bin_test<mpcd::BulkStreamingMethod<mpcd::NoForce>>(
+        std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
+    }
+
+#ifdef ENABLE_TBB
+//! basic test case for MPCD StreamingMethod class with multiple threads
+UP_TEST(mpcd_streaming_method_basic_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    streaming_method_basic_test<mpcd::BulkStreamingMethod<mpcd::NoForce>>(exec_conf);
+    }
+
+//! test case for binning while streaming with multiple threads
+UP_TEST(mpcd_streaming_method_bin_threaded)
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    exec_conf->setNumThreads(4);
+    streaming_method_bin_test<mpcd::BulkStreamingMethod<mpcd::NoForce>>(exec_conf);
+    }
+#endif // ENABLE_TBB
+
 #ifdef ENABLE_HIP
 //! basic test case for MPCD StreamingMethod class
 UP_TEST(mpcd_streaming_method_setup)
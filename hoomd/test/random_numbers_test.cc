@@ -527,6 +527,42 @@ UP_TEST(rng_seeding)
     UP_ASSERT_EQUAL(g.getCounter()[3], 0x9876);
     }
 
+//! Test that RandomGeneratorBatch reproduces the streams of RandomGenerator
+UP_TEST(rng_batch)
+    {
+    auto s = hoomd::Seed(hoomd::RNGIdentifier::TwoStepLangevin, 0xabcdef1234567890, 0x5eed);
+    auto counter = [](unsigned int k) { return hoomd::Counter(0xfffffff0 + 3 * k, k); };
+
+    for (unsigned int n : {1u, hoomd::rng_batch_width / 2 + 1, hoomd::rng_batch_width})
+        {
+        hoomd::RandomGeneratorBatch<4> batch;
+        batch.generate(s, n, counter, 3);
+
+        for (unsigned int k = 0; k < n; k++)
+            {
+            hoomd::RandomGenerator rng(s, counter(k));
+            hoomd::BatchedRandomGenerator batch_rng = batch.getGenerator(k);
+
+            // the first 3 values come from the batch, the rest are generated one at a time
+            for (unsigned int i = 0; i < 5; i++)
+                {
+                auto u = rng();
+                auto v = batch_rng();
+                for (unsigned int w = 0; w < 4; w++)
+                    UP_ASSERT_EQUAL(v[w], u[w]);
+                }
+
+            // distributions draw the same values
+            hoomd::RandomGenerator rng_normal(s, counter(k));
+            batch_rng = batch.getGenerator(k);
+            UP_ASSERT_EQUAL(hoomd::NormalDistribution<double>(2.0)(batch_rng),
+                            hoomd::NormalDistribution<double>(2.0)(rng_normal));
+            UP_ASSERT_EQUAL(hoomd::UniformDistribution<float>(-1, 1)(batch_rng),
+                            hoomd::UniformDistribution<float>(-1, 1)(rng_normal));
+            }
+        }
+    }
+
 // //! Find performance crossover
 // /*! Note: this code was written for a one time use to find the empirical crossover. It requires
 // that the private:
@@ -583,3 +583,108 @@ UP_TEST(CellListGPU_large)
         new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 #endif
+
+//! Validate that a cell list with the given threads and layout matches a serial padded cell list
+void celllist_layout_test(unsigned int num_threads, bool compact_layout)
+    {
+    unsigned int N = 10000;
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr<SnapshotSystemData<Scalar>> snap = rand_init.getSnapshot();
+
+    std::vector<std::shared_ptr<CellList>> cls;
+    for (unsigned int i = 0; i < 2; i++)
+        {
+        std::shared_ptr<ExecutionConfiguration> exec_conf(
+            new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+        exec_conf->setNumThreads(i == 0 ? 1 : num_threads);
+#endif
+        std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+        std::shared_ptr<CellList> cl(new CellList(sysdef));
+        cl->setNominalWidth(Scalar(3.0));
+        cl->setRadius(1);
+        cl->setComputeIdx(true);
+        cl->setComputeTypeBody(true);
+        cl->setFlagIndex();
+        if (i == 1)
+            cl->setCompactLayout(compact_layout);
+        cl->compute(0);
+        cls.push_back(cl);
+        }
+
+    ArrayHandle<unsigned int> h_cell_size_ref(cls[0]->getCellSizeArray(),
+                                              access_location::host,
+                                              access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf_ref(cls[0]->getXYZFArray(),
+                                    access_location::host,
+                                    access_mode::read);
+    ArrayHandle<unsigned int> h_cell_size(cls[1]->getCellSizeArray(),
+                                          access_location::host,
+                                          access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf(cls[1]->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_idx(cls[1]->getIndexArray(),
+                                    access_location::host,
+                                    access_mode::read);
+    ArrayHandle<uint2> h_type_body(cls[1]->getTypeBodyArray(),
+                                   access_location::host,
+                                   access_mode::read);
+
+    Index2D cli_ref = cls[0]->getCellListIndexer();
+    unsigned int ncell = cls[0]->getCellIndexer().getNumElements();
+    CHECK_EQUAL_UINT(cls[1]->getCellIndexer().getNumElements(), ncell);
+
+    if (compact_layout)
+        {
+        // the compact layout has no padding
+        CHECK_EQUAL_UINT(cls[1]->getXYZFArray().getNumElements(), N);
+        UP_ASSERT_EXCEPTION(std::runtime_error, [&] { cls[1]->getCellListIndexer(); });
+        }
+
+    // every cell must list the same particles in the same order
+    unsigned int start = 0;
+    for (unsigned int cell = 0; cell < ncell; cell++)
+        {
+        CHECK_EQUAL_UINT(h_cell_size.data[cell], h_cell_size_ref.data[cell]);
+
+        if (compact_layout)
+            {
+            ArrayHandle<unsigned int> h_cell_start(cls[1]->getCellStartArray(),
+                                                   access_location::host,
+                                                   access_mode::read);
+            CHECK_EQUAL_UINT(h_cell_start.data[cell], start);
+            }
+
+        for (unsigned int offset = 0; offset < h_cell_size_ref.data[cell]; offset++)
+            {
+            unsigned int k = compact_layout ? start + offset
+                                            : cls[1]->getCellListIndexer()(offset, cell);
+            unsigned int p = __scalar_as_int(h_xyzf_ref.data[cli_ref(offset, cell)].w);
+            CHECK_EQUAL_UINT(__scalar_as_int(h_xyzf.data[k].w), p);
+            CHECK_EQUAL_UINT(h_idx.data[k], p);
+            CHECK_EQUAL_UINT(h_type_body.data[k].x, 0);
+            }
+        start += h_cell_size_ref.data[cell];
+        }
+    CHECK_EQUAL_UINT(start, N);
+    }
+
+//! test case for the compact cell list layout
+UP_TEST(CellList_compact)
+    {
+    celllist_layout_test(1, true);
+    }
+
+#ifdef ENABLE_TBB
+//! test case for the threaded cell list
+UP_TEST(CellList_threaded)
+    {
+    celllist_layout_test(4, false);
+    }
+
+//! test case for the threaded cell list in the compact layout
+UP_TEST(CellList_threaded_compact)
+    {
+    celllist_layout_test(4, true);
+    }
+#endif
@@ -0,0 +1,165 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include "hoomd/ForceScatterBuffers.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/*! \file test_force_scatter_buffers.cc
+    \brief Pins down the summation order of ForceScatterBuffers
+    \ingroup unit_tests
+*/
+
+using namespace std;
+using namespace hoomd;
+
+//! Number of particles in the test
+const unsigned int N = 5000;
+
+//! Number of work items, each of which writes to two particles
+const unsigned int n_items = 40000;
+
+//! Add the contributions of work items [first, last) to the given force and virial arrays
+/*! The contributions span many orders of magnitude so that the floating point sums depend on
+    their association. They are positive so that the sums do not cancel.
+*/
+void scatter_items(unsigned int first,
+                   unsigned int last,
+                   Scalar4* force,
+                   Scalar* virial,
+                   size_t virial_pitch)
+    {
+    for (unsigned int item = first; item < last; item++)
+        {
+        unsigned int i = item % N;
+        unsigned int j = (unsigned int)((uint64_t(item) * 7919 + 1) % N);
+        Scalar f = std::pow(Scalar(10.0), Scalar(int(item % 13) - 6)) * Scalar(1 + item % 7);
+
+        force[i].x += f;
+        force[i].y += Scalar(0.5) * f;
+        force[i].w += Scalar(0.25) * f;
+        force[j].x += Scalar(0.75) * f;
+        force[j].z += Scalar(1.5) * f;
+        for (unsigned int k = 0; k < 6; k++)
+            {
+            virial[k * virial_pitch + i] += Scalar(k + 1) * f;
+            virial[k * virial_pitch + j] += Scalar(0.5) * f;
+            }
+        }
+    }
+
+//! Per-particle results of a scatter
+struct scatter_result
+    {
+    std::vector<Scalar4> force;
+    std::vector<Scalar> virial;
+    };
+
+//! Sum the work items with \a n_chunks chunks, one chunk after the other
+scatter_result scatter_serial(unsigned int n_chunks)
+    {
+    hoomd::detail::ForceScatterBuffers buffers;
+    buffers.resize(n_chunks, N, false, true);
+    UP_ASSERT_EQUAL(buffers.getNumChunks(), n_chunks);
+
+    for (unsigned int c = 0; c < n_chunks; c++)
+        {
+        buffers.zeroChunk(c);
+        scatter_items(hoomd::detail::ForceScatterBuffers::getChunkBegin(c, n_chunks, n_items),
+                      hoomd::detail::ForceScatterBuffers::getChunkBegin(c + 1, n_chunks, n_items),
+                      buffers.getForce(c),
+                      buffers.getVirial(c),
+                      buffers.getVirialPitch());
+        }
+
+    scatter_result result;
+    result.force.assign(N, make_scalar4(0, 0, 0, 0));
+    result.virial.assign(6 * N, Scalar(0.0));
+    buffers.reduceRange(0, N, result.force.data(), nullptr, result.virial.data(), N);
+    return result;
+    }
+
+//! Check that two results are bitwise identical
+void check_identical(const scatter_result& a, const scatter_result& b)
+    {
+    UP_ASSERT(memcmp(a.force.data(), b.force.data(), sizeof(Scalar4) * N) == 0);
+    UP_ASSERT(memcmp(a.virial.data(), b.virial.data(), sizeof(Scalar) * 6 * N) == 0);
+    }
+
+//! A single chunk gives the same sums as scattering directly into the output arrays
+UP_TEST(force_scatter_buffers_one_chunk)
+    {
+    scatter_result direct;
+    direct.force.assign(N, make_scalar4(0, 0, 0, 0));
+    direct.virial.assign(6 * N, Scalar(0.0));
+    scatter_items(0, n_items, direct.force.data(), direct.virial.data(), N);
+
+    check_identical(direct, scatter_serial(1));
+    }
+
+#ifdef ENABLE_TBB
+//! Sum the work items with one chunk per thread, like the threaded force computes
+scatter_result scatter_threaded(unsigned int num_threads)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(num_threads);
+
+    hoomd::detail::ForceScatterBuffers buffers;
+    buffers.resize(exec_conf->getNumThreads(), N, false, true);
+
+    scatter_result result;
+    result.force.assign(N, make_scalar4(0, 0, 0, 0));
+    result.virial.assign(6 * N, Scalar(0.0));
+    exec_conf->getTaskArena()->execute(
+        [&]
+        {
+            buffers.parallelForChunks(n_items,
+                                      [&](unsigned int c, unsigned int first, unsigned int last)
+                                      {
+                                          scatter_items(first,
+                                                        last,
+                                                        buffers.getForce(c),
+                                                        buffers.getVirial(c),
+                                                        buffers.getVirialPitch());
+                                      });
+            buffers.reduce(result.force.data(), nullptr, result.virial.data(), N);
+        });
+    return result;
+    }
+
+//! The threaded sums are the chunk ordered sums with one chunk per thread
+/*! The results are reproducible for a given number of threads and differ from the serial sums only
+    by round off.
+*/
+UP_TEST(force_scatter_buffers_threads)
+    {
+    scatter_result serial = scatter_serial(1);
+
+    for (unsigned int num_threads : {2, 3, 8})
+        {
+        scatter_result threaded = scatter_threaded(num_threads);
+        check_identical(threaded, scatter_serial(num_threads));
+        check_identical(threaded, scatter_threaded(num_threads));
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            MY_CHECK_CLOSE(threaded.force[i].x, serial.force[i].x, tol_small);
+            MY_CHECK_CLOSE(threaded.force[i].y, serial.force[i].y, tol_small);
+            MY_CHECK_CLOSE(threaded.force[i].z, serial.force[i].z, tol_small);
+            MY_CHECK_CLOSE(threaded.force[i].w, serial.force[i].w, tol_small);
+            }
+        for (unsigned int i = 0; i < 6 * N; i++)
+            MY_CHECK_CLOSE(threaded.virial[i], serial.virial[i], tol_small);
+        }
+    }
+#endif
@@ -0,0 +1,123 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include "hoomd/ParticleGroup.h"
+
+#include <memory>
+#include <vector>
+
+/*! \file test_particle_group_rebuild.cc
+    \brief Checks the ParticleGroup index list rebuild with any number of threads
+    \ingroup unit_tests
+*/
+
+using namespace std;
+using namespace hoomd;
+
+//! Member index list and membership flags of a group after its index list is rebuilt
+struct group_indices
+    {
+    std::vector<unsigned int> member_idx;
+    std::vector<bool> is_member;
+    };
+
+//! Number of particles in the test system, enough that the rebuild is split into many chunks
+const unsigned int N = 60000;
+
+//! Build a group of the given tags in a scrambled system with \a num_threads threads
+group_indices rebuild_group(unsigned int num_threads, const std::vector<unsigned int>& member_tags)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+#endif
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(100.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef, member_tags));
+
+    // access the group once so that it builds its index list before the particles are reordered
+    UP_ASSERT_EQUAL(group->getNumMembers(), member_tags.size());
+
+        {
+        // scramble the particle order
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(),
+                                        access_location::host,
+                                        access_mode::readwrite);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(),
+                                         access_location::host,
+                                         access_mode::readwrite);
+        for (unsigned int idx = 0; idx < N; idx++)
+            {
+            unsigned int tag = (unsigned int)((uint64_t(idx) * 7919) % N);
+            h_tag.data[idx] = tag;
+            h_rtag.data[tag] = idx;
+            }
+        }
+    pdata->notifyParticleSort();
+
+    group_indices result;
+    for (unsigned int j = 0; j < group->getNumMembers(); j++)
+        result.member_idx.push_back(group->getMemberIndex(j));
+    for (unsigned int idx = 0; idx < N; idx++)
+        result.is_member.push_back(group->isMember(idx));
+    return result;
+    }
+
+//! Rebuild the index list serially, by scanning the particles in index order
+group_indices reference_group(const std::vector<unsigned int>& member_tags)
+    {
+    std::vector<bool> is_member_tag(N, false);
+    for (unsigned int tag : member_tags)
+        is_member_tag[tag] = true;
+
+    group_indices result;
+    for (unsigned int idx = 0; idx < N; idx++)
+        {
+        unsigned int tag = (unsigned int)((uint64_t(idx) * 7919) % N);
+        result.is_member.push_back(is_member_tag[tag]);
+        if (is_member_tag[tag])
+            result.member_idx.push_back(idx);
+        }
+    return result;
+    }
+
+//! Check the rebuilt index list against the serial rebuild at several thread counts
+void group_rebuild_test(const std::vector<unsigned int>& member_tags)
+    {
+    group_indices reference = reference_group(member_tags);
+    UP_ASSERT_EQUAL(reference.member_idx.size(), member_tags.size());
+
+    for (unsigned int num_threads : {1, 2, 3, 8})
+        {
+        group_indices result = rebuild_group(num_threads, member_tags);
+        UP_ASSERT(result.member_idx == reference.member_idx);
+        UP_ASSERT(result.is_member == reference.is_member);
+        }
+    }
+
+//! A large group is rebuilt by compacting the membership flags in chunks
+UP_TEST(ParticleGroup_rebuild_chunked)
+    {
+    std::vector<unsigned int> member_tags;
+    for (unsigned int tag = 0; tag < N; tag += 3)
+        member_tags.push_back(tag);
+    group_rebuild_test(member_tags);
+    }
+
+//! A small group is rebuilt from the member tags with a reverse tag lookup and a sort
+UP_TEST(ParticleGroup_rebuild_small)
+    {
+    // fewer than N / 16 members, in no particular order
+    std::vector<unsigned int> member_tags;
+    for (unsigned int i = 0; i < 1000; i++)
+        member_tags.push_back((i * 104729) % N);
+    group_rebuild_test(member_tags);
+    }
@@ -0,0 +1,111 @@
+// Copyright (c) 2009-2024 The Regents of the University of Michigan.
+// Part of HOOMD-blue, released under the BSD 3-Clause License.
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include "hoomd/SFCPackTuner.h"
+#include "hoomd/Trigger.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+/*! \file test_sfc_pack_tuner.cc
+    \brief Checks that SFCPackTuner sorts particles in the same order with any number of threads
+    \ingroup unit_tests
+*/
+
+using namespace std;
+using namespace hoomd;
+
+//! Sort a shuffled system \a n_sorts times with \a num_threads threads and return the tag order
+std::vector<unsigned int>
+sort_order(unsigned int num_threads, unsigned int n_dimensions, unsigned int n_sorts)
+    {
+    // enough particles that the radix sort splits the work into many chunks
+    const unsigned int N = 50000;
+    const unsigned int n = (unsigned int)ceil(cbrt((double)N));
+    const Scalar L = Scalar(60.0);
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(
+        new ExecutionConfiguration(ExecutionConfiguration::CPU));
+#ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+#endif
+    std::shared_ptr<SystemDefinition> sysdef(
+        new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    sysdef->setNDimensions(n_dimensions);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        // place the particles on a jittered lattice in a scrambled order
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(),
+                                   access_location::host,
+                                   access_mode::readwrite);
+        const Scalar a = L / n;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int j = (i * 7919) % N;
+            unsigned int ix = j % n, iy = (j / n) % n, iz = j / (n * n);
+            h_pos.data[i].x = -L / 2 + (ix + Scalar(0.5)) * a + Scalar(0.2) * a * sin(Scalar(i));
+            h_pos.data[i].y = -L / 2 + (iy + Scalar(0.5)) * a + Scalar(0.2) * a * cos(Scalar(i));
+            h_pos.data[i].z = n_dimensions == 2
+                                  ? Scalar(0.0)
+                                  : -L / 2 + (iz + Scalar(0.5)) * a
+                                        + Scalar(0.2) * a * sin(Scalar(3 * i));
+            h_vel.data[i].x = Scalar(i);
+            }
+        }
+
+    std::shared_ptr<SFCPackTuner> sorter(
+        new SFCPackTuner(sysdef, std::make_shared<PeriodicTrigger>(1)));
+    for (unsigned int timestep = 0; timestep < n_sorts; timestep++)
+        sorter->update(timestep);
+
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+
+    // the sort permutes the particles together with their tags and data
+    for (unsigned int i = 0; i < N; i++)
+        {
+        UP_ASSERT_EQUAL(h_rtag.data[h_tag.data[i]], i);
+        UP_ASSERT_EQUAL(h_vel.data[i].x, Scalar(h_tag.data[i]));
+        }
+
+    return std::vector<unsigned int>(h_tag.data, h_tag.data + N);
+    }
+
+//! The sort is a permutation that actually reorders the particles
+UP_TEST(sfc_pack_tuner_permutation)
+    {
+    std::vector<unsigned int> order = sort_order(1, 3, 1);
+    std::vector<unsigned int> sorted(order);
+    std::sort(sorted.begin(), sorted.end());
+    for (unsigned int i = 0; i < sorted.size(); i++)
+        UP_ASSERT_EQUAL(sorted[i], i);
+    UP_ASSERT(order != sorted);
+    }
+
+#ifdef ENABLE_TBB
+//! The radix sort gives the same order with 1 and several threads, in 2D and 3D
+UP_TEST(sfc_pack_tuner_threads)
+    {
+    for (unsigned int n_dimensions : {3, 2})
+        {
+        for (unsigned int n_sorts : {1, 2})
+            {
+            std::vector<unsigned int> serial = sort_order(1, n_dimensions, n_sorts);
+            for (unsigned int num_threads : {2, 3, 8})
+                UP_ASSERT(sort_order(num_threads, n_dimensions, n_sorts) == serial);
+            }
+        }
+    }
+#endif